@@ -3,6 +3,30 @@
 //
 
 #include "Application.h"
+#include "Platform/NumaTopology.h"
+#include <algorithm>
+#include <cstdio>
+
+Application::Application(ConfigReader::Config config, const Scheduler::Execution execution)
+    : mConfig(std::move(config)), mExecution(execution)
+{
+    if (mExecution == Scheduler::Execution::INLINE)
+    {
+        // Only the books, their reference data and risk: anything on a thread of its own would make
+        // the results depend on timing.
+        mConfig.numaAware = false;
+        mConfig.gatewayAddress.clear();
+        mConfig.shmName.clear();
+        mConfig.reportConsumers = 0;
+        mConfig.depthFeed = false;
+        mConfig.orderFeedPath.clear();
+        mConfig.barIntervalMs = 0;
+        mConfig.metricsFile.clear();
+        mConfig.metricsListen.clear();
+        mConfig.journalDir.clear();
+        mConfig.snapshotDir.clear();
+    }
+}
 
 void Application::start()
 {
@@ -14,42 +38,469 @@ void Application::start()
     mOrderBookScheduler = std::make_shared<OrderBookScheduler>(
         mConfig.obWorkerPrefix,
         mConfig.obWorkerCnt,
-        mp
+        mp,
+        mConfig.obWorkerBatchSize
     );
-    mOrderBookScheduler->start();
-
-    std::cout << "OrderBookScheduler started with " << mConfig.obWorkerCnt << " workers." << std::endl;
 
     mOrderInjectorScheduler = std::make_shared<OrderInjectorScheduler>(
         mConfig.oiWorkerPrefix,
         mConfig.oiWorkerCnt,
-        mOrderBookScheduler
+        mOrderBookScheduler,
+        mConfig.oiWorkerBatchSize
     );
+    mOrderBookScheduler->setExecution(mExecution);
+    mOrderInjectorScheduler->setExecution(mExecution);
+    IReportSink* reportSink = mExecution == Scheduler::Execution::INLINE
+        ? static_cast<IReportSink*>(&mDigest) : &mReportRouter;
+
+    // Books copy their reference data when they are created, i.e. when the book scheduler starts.
+    for (const auto& [symbol, spec] : mConfig.instruments)
+    {
+        if (const SymbolId id = SymbolTable::instance().find(symbol); mOrderBookScheduler->ownsSymbol(id))
+        {
+            ReferenceData::instance().set(id, spec);
+        }
+        else
+        {
+            std::cerr << "Reference data for untraded symbol " << symbol << " ignored." << std::endl;
+        }
+    }
+
+    // Book workers decide at start() whether orders go through pre-trade risk.
+    for (const auto& [account, limits] : mConfig.accounts)
+    {
+        RiskEngine::instance().set(account, limits);
+    }
+
+    // Workers bind themselves when their thread starts, so placement must happen before start().
+    if (mConfig.numaAware)
+    {
+        placeWorkers(mp);
+    }
+
+    mOrderBookScheduler->setReportSink(reportSink);
+    if (mConfig.reportConsumers > 0)
+    {
+        mReportStream = std::make_unique<ReportStream>(mConfig.obWorkerCnt, mConfig.reportRingSlots,
+                                                       mConfig.reportConsumers, mReportRouter);
+        mReportStream->start();
+        mOrderBookScheduler->setReportStream(mReportStream.get());
+    }
+    // The L2 feed goes out through the gateway; it is started once the gateway is up.
+    if (mConfig.depthFeed && !mConfig.gatewayAddress.empty())
+    {
+        mDepthPublisher = std::make_unique<ConflatingPublisher>(
+            mConfig.obWorkerCnt, mConfig.depthRingSlots, std::chrono::microseconds(mConfig.depthConflationUs));
+        mOrderBookScheduler->setDepthPublisher(mDepthPublisher.get());
+    }
+    if (!mConfig.orderFeedPath.empty())
+    {
+        try
+        {
+            mOrderFeed = std::make_unique<OrderFeedWriter>(mConfig.obWorkerCnt, mConfig.orderFeedRingSlots,
+                                                           mConfig.orderFeedPath);
+            mOrderFeed->start();
+            mOrderBookScheduler->setOrderFeed(mOrderFeed.get());
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Order feed disabled: " << e.what() << std::endl;
+            mOrderFeed.reset();
+        }
+    }
+    if (mConfig.barIntervalMs > 0)
+    {
+        mBars = std::make_unique<BarPublisher>(mConfig.obWorkerCnt, mConfig.barRingSlots,
+                                               std::chrono::milliseconds(mConfig.barIntervalMs));
+        mOrderBookScheduler->setBarPublisher(mBars.get());
+    }
+    const bool exportMetrics = !mConfig.metricsFile.empty() || !mConfig.metricsListen.empty();
+    if (exportMetrics)
+    {
+        mOrderBookScheduler->setMetrics(mMetrics);
+    }
+    mOrderBookScheduler->start();
+    if (mBars)
+    {
+        mBars->start([obs = mOrderBookScheduler.get()](const uint64_t startNs, const uint64_t endNs)
+        {
+            obs->closeBars(startNs, endNs);
+        });
+    }
+
+    std::cout << "OrderBookScheduler started with " << mConfig.obWorkerCnt << " workers." << std::endl;
+
+    // Rebuild the books from the journal before any new input. Unlike the feeds, a journal that
+    // cannot be read or written is not skipped: the engine would come up with books missing orders.
+    SessionId recoveredSessions = NO_SESSION;
+    if (!mConfig.journalDir.empty())
+    {
+        mJournal = std::make_unique<Journal>(Journal::Options{
+            mConfig.journalDir, mConfig.obWorkerCnt, Journal::ParseDurability(mConfig.journalDurability),
+            mConfig.journalSegmentBytes, std::chrono::microseconds(mConfig.journalGroupCommitUs),
+            mConfig.journalGroupCommitBytes});
+
+        // The newest snapshot of each worker's books is loaded first; only the journal after it is replayed.
+        std::vector<uint64_t> covered;
+        if (!mConfig.snapshotDir.empty())
+        {
+            mSnapshots = std::make_unique<SnapshotStore>(SnapshotStore::Options{
+                mConfig.snapshotDir, mConfig.obWorkerCnt, std::chrono::seconds(mConfig.snapshotIntervalSec),
+                mConfig.snapshotKeep});
+            std::vector<SnapshotStore::Image> images(mConfig.obWorkerCnt);
+            covered.assign(mConfig.obWorkerCnt, 0);
+            for (size_t i = 0; i < images.size(); i++)
+            {
+                if (auto loaded = mSnapshots->load(i))
+                {
+                    covered[i] = loaded->seq;
+                    images[i] = std::move(loaded->image);
+                }
+            }
+            const auto loadStart = std::chrono::steady_clock::now();
+            const uint64_t restored = mOrderBookScheduler->loadSnapshots(images);
+            const std::chrono::duration<double> took = std::chrono::steady_clock::now() - loadStart;
+            std::cout << "Snapshots " << mConfig.snapshotDir << ": " << restored << " resting orders restored in "
+                      << took.count() << " s (" << (restored ? took.count() * 1e3 * 1e6 / static_cast<double>(restored) : 0)
+                      << " ms per million orders)." << std::endl;
+        }
+
+        const auto replayStart = std::chrono::steady_clock::now();
+        const uint64_t replayed = mJournal->recover([injector = mOrderInjectorScheduler.get()](const InboundMessage& m)
+        {
+            injector->replayJournaled(m);
+        }, covered);
+        mOrderBookScheduler->drain();
+        recoveredSessions = mOrderBookScheduler->highestSession();
+        const std::chrono::duration<double> took = std::chrono::steady_clock::now() - replayStart;
+        std::cout << "Journal " << mConfig.journalDir << ": " << replayed << " messages replayed in "
+                  << took.count() << " s, durability " << mConfig.journalDurability << "." << std::endl;
+
+        mJournal->start([injector = mOrderInjectorScheduler.get()](const InboundMessage& m, OrderPtr order)
+        {
+            injector->apply(m, std::move(order));
+        });
+        mOrderInjectorScheduler->setJournal(mJournal.get());
+        if (mSnapshots)
+        {
+            mSnapshots->start([this] { snapshotBooks(); });
+        }
+    }
+    else if (!mConfig.snapshotDir.empty())
+    {
+        std::cerr << "Snapshots disabled: they need the journal." << std::endl;
+    }
+
+    mOrderInjectorScheduler->setReportSink(reportSink);
     mOrderInjectorScheduler->start();
 
     std::cout << "mOrderInjectorScheduler started with " << mConfig.oiWorkerCnt << " workers." << std::endl;
 
+    if (exportMetrics)
+    {
+        mMetrics.addGauge("ome_queue_depth", "Tasks waiting in a worker's queue.", "worker",
+            [books = mOrderBookScheduler.get(), injectors = mOrderInjectorScheduler.get()]
+            {
+                std::vector<std::pair<std::string, double>> depths;
+                for (const auto* scheduler : {static_cast<const Scheduler*>(books), static_cast<const Scheduler*>(injectors)})
+                {
+                    for (const auto& [wid, depth] : scheduler->queueDepths())
+                    {
+                        depths.emplace_back(wid, static_cast<double>(depth));
+                    }
+                }
+                return depths;
+            });
+        try
+        {
+            mMetricsExporter = std::make_unique<MetricsExporter>(
+                mMetrics, MetricsExporter::Options{mConfig.metricsFile, mConfig.metricsListen,
+                                                   std::chrono::milliseconds(mConfig.metricsPeriodMs)});
+            mMetricsExporter->start();
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Metrics export disabled: " << e.what() << std::endl;
+            mMetricsExporter.reset();
+        }
+    }
+
+    if (!mConfig.gatewayAddress.empty())
+    {
+        try
+        {
+            IoBackend::Options io;
+            io.kind = IoBackend::ParseKind(mConfig.gatewayIoBackend);
+            io.sqpoll = mConfig.gatewaySqPoll;
+            mGateway = std::make_unique<Gateway>(Endpoint::Parse(mConfig.gatewayAddress), mOrderInjectorScheduler, io);
+            mGateway->start(mReportRouter, recoveredSessions);
+            if (mDepthPublisher)
+            {
+                mDepthPublisher->start(*mGateway);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Gateway disabled: " << e.what() << std::endl;
+            if (mDepthPublisher)
+            {
+                std::cerr << "Depth feed has no outlet, its updates are dropped." << std::endl;
+            }
+            mGateway.reset();
+        }
+    }
+
+    if (!mConfig.shmName.empty())
+    {
+        try
+        {
+            mShmIngress = std::make_unique<ShmIngress>(
+                ShmIngress::Options{mConfig.shmName, static_cast<uint32_t>(mConfig.shmClients),
+                                    static_cast<uint32_t>(mConfig.shmRingSlots)},
+                mOrderInjectorScheduler);
+            mShmIngress->start(mReportRouter, recoveredSessions);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Shared-memory ingress disabled: " << e.what() << std::endl;
+            mShmIngress.reset();
+        }
+    }
+
     std::cout << "Application started successfully." << std::endl;
 }
 
+void Application::placeWorkers(const OrderBookScheduler::SymbolToWorkerMap& symbolToWorker)
+{
+    const size_t nodes = NumaTopology::nodeCount();
+    const bool bind = NumaTopology::available() && nodes > 1;
+
+    struct NodePlacement
+    {
+        std::vector<std::string> bookWorkers;
+        std::vector<size_t> injectors; ///< Indices
+        std::vector<Symbol> symbols;
+    };
+    std::vector<NodePlacement> plan(nodes);
+    std::unordered_map<std::string, size_t> bookWorkerNode;
+
+    // Book workers: round-robin over the nodes.
+    for (size_t i = 0; i < mConfig.obWorkerCnt; i++)
+    {
+        const std::string wid = mConfig.obWorkerPrefix + "_" + std::to_string(i);
+        const size_t node = i % nodes;
+        bookWorkerNode[wid] = node;
+        plan[node].bookWorkers.push_back(wid);
+    }
+    for (const auto& [symbol, wid] : symbolToWorker)
+    {
+        if (const auto it = bookWorkerNode.find(wid); it != bookWorkerNode.end())
+        {
+            plan[it->second].symbols.push_back(symbol);
+        }
+    }
+
+    // Injectors: proportional to the symbols each node owns (largest remainder), matching the
+    // sessionless flow routed to them below.
+    size_t totalLoad = 0;
+    std::vector<size_t> load(nodes);
+    for (size_t n = 0; n < nodes; n++)
+    {
+        load[n] = plan[n].bookWorkers.empty() ? 0 : std::max<size_t>(plan[n].symbols.size(), 1);
+        totalLoad += load[n];
+    }
+    std::vector<size_t> share(nodes, 0);
+    std::vector<std::pair<size_t, size_t>> remainders; // (remainder, node)
+    size_t assigned = 0;
+    for (size_t n = 0; n < nodes && totalLoad > 0; n++)
+    {
+        share[n] = mConfig.oiWorkerCnt * load[n] / totalLoad;
+        assigned += share[n];
+        remainders.emplace_back(mConfig.oiWorkerCnt * load[n] % totalLoad, n);
+    }
+    std::sort(remainders.begin(), remainders.end(), std::greater<>());
+    for (size_t i = 0; assigned < mConfig.oiWorkerCnt && !remainders.empty(); i++, assigned++)
+    {
+        share[remainders[i % remainders.size()].second]++;
+    }
+
+    size_t injector = 0;
+    for (size_t n = 0; n < nodes; n++)
+    {
+        for (size_t k = 0; k < share[n]; k++, injector++)
+        {
+            plan[n].injectors.push_back(injector);
+        }
+    }
+
+    // Sessionless messages (replay, IPC) are routed by symbol, so send each symbol's to an injector on
+    // its book's node, the node's symbols dealt round-robin over its injectors. A node left without
+    // an injector keeps the default route. Session traffic (gateway, shared memory) cannot follow:
+    // a session's messages stay on one injector, in order, whatever books they are for.
+    std::vector<size_t> routing(SymbolTable::instance().size());
+    for (SymbolId id = 0; id < routing.size(); id++)
+    {
+        routing[id] = id % mConfig.oiWorkerCnt;
+    }
+    size_t local = 0;
+    size_t total = 0;
+    for (const auto& node : plan)
+    {
+        size_t dealt = 0;
+        for (const auto& symbol : node.symbols)
+        {
+            const SymbolId id = SymbolTable::instance().find(symbol);
+            if (id == INVALID_SYMBOL_ID || id >= routing.size())
+            {
+                continue;
+            }
+            total++;
+            if (!node.injectors.empty())
+            {
+                routing[id] = node.injectors[dealt++ % node.injectors.size()];
+                local++;
+            }
+        }
+    }
+    mOrderInjectorScheduler->setSymbolRouting(std::move(routing));
+
+    for (size_t n = 0; n < nodes; n++)
+    {
+        if (!bind)
+        {
+            break;
+        }
+        for (const auto& wid : plan[n].bookWorkers)
+        {
+            mOrderBookScheduler->bindWorkerToNode(wid, static_cast<int>(n));
+        }
+        for (const size_t i : plan[n].injectors)
+        {
+            mOrderInjectorScheduler->bindWorkerToNode(mOrderInjectorScheduler->workerIdAt(i), static_cast<int>(n));
+        }
+    }
+
+    // Placement report
+    std::cout << "NUMA placement: " << nodes << " node(s), "
+              << (bind ? "threads bound" : "single-node fallback, threads not bound") << std::endl;
+    for (size_t n = 0; n < nodes; n++)
+    {
+        std::cout << "  node " << n << ": book workers [";
+        for (size_t i = 0; i < plan[n].bookWorkers.size(); i++)
+        {
+            std::cout << (i ? ", " : "") << plan[n].bookWorkers[i];
+        }
+        std::cout << "] injectors [";
+        for (size_t i = 0; i < plan[n].injectors.size(); i++)
+        {
+            std::cout << (i ? ", " : "") << mOrderInjectorScheduler->workerIdAt(plan[n].injectors[i]);
+        }
+        std::cout << "] symbols [";
+        for (size_t i = 0; i < plan[n].symbols.size(); i++)
+        {
+            std::cout << (i ? ", " : "") << plan[n].symbols[i];
+        }
+        std::cout << "]" << std::endl;
+    }
+    std::cout << "  sessionless messages reach an injector on their book's node for " << local << " of " << total
+              << " symbol(s); gateway sessions and shared-memory rings stay on one injector each, whatever node"
+              << " their books are on" << std::endl;
+}
+
 
 void Application::shutdown()
 {
     std::cout << "Application shutting down..." << std::endl;
 
+    // Stop taking input first; the gateway object itself outlives the book workers that report to it.
+    if (mGateway) {
+        mGateway->stop();
+    }
+    if (mShmIngress) {
+        mShmIngress->stop(); // the pollers run on the injector workers
+    }
+
+    if (mJournal) {
+        // Nothing is appended once the injectors are idle; the last group commit then applies what
+        // is still pending while the book workers run.
+        if (mOrderInjectorScheduler) {
+            mOrderInjectorScheduler->drain();
+        }
+        if (mSnapshots) {
+            snapshotBooks(); // taken by the journal's last pass, so the next start replays nothing
+        }
+        mJournal->stop();
+        std::cout << "Journal stopped: " << mJournal->appended() << " messages journaled, "
+                  << mJournal->syncs() << " fdatasyncs." << std::endl;
+    }
+    if (mSnapshots) {
+        mOrderBookScheduler->drain(); // the book workers encode their last snapshot
+        mSnapshots->stop();
+        std::cout << "Snapshots stopped: " << mSnapshots->written() << " written, last one "
+                  << mSnapshots->lastBytes() << " bytes." << std::endl;
+        mSnapshots.reset();
+    }
+    if (mBars) {
+        mBars->stop(); // posts the close of the last, partial interval while the book workers still run
+    }
     if (mOrderBookScheduler) {
         mOrderBookScheduler->shutdown();
         std::cout << "OrderBookScheduler shut down." << std::endl;
+        // Book workers are done, so the last file update has the final counts. Its gauges sample
+        // the schedulers, so it stops before they go away.
+        if (mMetricsExporter) {
+            mMetricsExporter->stop();
+            mMetricsExporter.reset();
+        }
         mOrderBookScheduler.reset();
     }
+    if (mReportStream) {
+        mReportStream->stop(); // delivers what the book workers left in their rings
+        std::cout << "Report stream stopped: " << mReportStream->delivered() << " reports delivered, "
+                  << mReportStream->dropped() << " dropped (" << mReportStream->unsignalled()
+                  << " without a REPORTS_LOST marker)." << std::endl;
+        mReportStream.reset();
+    }
+    if (mDepthPublisher) {
+        mDepthPublisher->stop(); // publishes what the book workers left in their rings
+        std::cout << "Depth feed stopped: " << mDepthPublisher->received() << " level updates, "
+                  << mDepthPublisher->published() << " published after conflation, "
+                  << mDepthPublisher->dropped() << " dropped." << std::endl;
+        mDepthPublisher.reset();
+    }
+    if (mOrderFeed) {
+        mOrderFeed->stop(); // writes what the book workers left in their rings
+        std::cout << "Order feed stopped: " << mOrderFeed->written() << " events (" << mOrderFeed->bytes()
+                  << " bytes) written, " << mOrderFeed->dropped() << " dropped." << std::endl;
+        mOrderFeed.reset();
+    }
+    if (mBars) {
+        std::cout << "Bars: " << mBars->published() << " published." << std::endl;
+        mBars.reset();
+    }
     if (mOrderInjectorScheduler) {
         mOrderInjectorScheduler->shutdown();
         std::cout << "mOrderInjectorScheduler shut down." << std::endl;
         mOrderInjectorScheduler.reset();
     }
+    mJournal.reset(); // after the injectors, which hold a pointer to it
+    mGateway.reset();
+    mShmIngress.reset(); // like the gateway, a report sink until the book workers are done
     std::cout << "Application shut down successfully." << std::endl;
 }
 
+void Application::snapshotBooks()
+{
+    mJournal->checkpoint([books = mOrderBookScheduler.get(), store = mSnapshots.get()](const size_t shard,
+                                                                                       const uint64_t seq)
+    {
+        books->snapshot(shard, [store, shard, seq](SnapshotStore::Image image)
+        {
+            store->submit(shard, seq, std::move(image));
+        });
+    });
+}
+
 void Application::simulate()
 {
     std::vector<std::string> messages = {
@@ -65,3 +516,68 @@ void Application::simulate()
     }
 
 }
+
+ReplaySource::Report Application::replay(const std::string& path, const ReplaySource::Pacing pacing,
+                                         const double speed)
+{
+    ReplaySource source(path);
+    std::cout << "Replaying " << path << " (" << (source.timestamped() ? "recorded" : "text")
+              << ", " << (pacing == ReplaySource::Pacing::ORIGINAL ? "original pacing" : "max speed")
+              << ")" << std::endl;
+
+    const auto report = source.run(*mOrderInjectorScheduler, *mOrderBookScheduler, pacing, speed);
+
+    std::cout << "Replay done: " << report.messages << " messages in " << report.seconds << " s ("
+              << static_cast<uint64_t>(report.msgsPerSec) << " msg/s)";
+    if (report.malformed)
+    {
+        std::cout << ", truncated tail skipped";
+    }
+    if (report.throttled)
+    {
+        std::cout << ", held back " << report.throttled << " times by full injector queues";
+    }
+    std::cout << std::endl;
+    std::cout << "End-to-end latency: " << report.latency << std::endl;
+    return report;
+}
+
+ReplaySource::Report Application::backtest(const std::string& path)
+{
+    if (mExecution != Scheduler::Execution::INLINE)
+    {
+        throw std::logic_error("Application: a backtest needs an inline engine");
+    }
+    ReplaySource source(path);
+    std::cout << "Backtesting " << path << " (" << (source.timestamped() ? "recorded" : "text")
+              << ", inline, " << mConfig.obWorkerCnt << " book workers)" << std::endl;
+
+    const auto report = source.run(*mOrderInjectorScheduler, *mOrderBookScheduler);
+
+    // Inline, each worker's books are encoded and folded in before snapshot() returns.
+    for (size_t i = 0; i < mOrderBookScheduler->workerIds().size(); i++)
+    {
+        mOrderBookScheduler->snapshot(i, [this](const SnapshotStore::Image& image)
+        {
+            mDigest.add(image.data(), image.size());
+        });
+    }
+
+    std::cout << "Backtest done: " << report.messages << " messages in " << report.seconds << " s ("
+              << static_cast<uint64_t>(report.msgsPerSec) << " simulated msg/s";
+    if (report.recordedNs && report.seconds > 0)
+    {
+        std::cout << ", " << static_cast<double>(report.recordedNs) / 1e9 / report.seconds << "x the recorded pace";
+    }
+    std::cout << ")";
+    if (report.malformed)
+    {
+        std::cout << ", truncated tail skipped";
+    }
+    std::cout << std::endl;
+    char digest[17];
+    std::snprintf(digest, sizeof(digest), "%016llx", static_cast<unsigned long long>(mDigest.value()));
+    std::cout << "Results: " << mDigest.reports() << " reports, " << mDigest.trades() << " fill reports, digest "
+              << digest << std::endl;
+    return report;
+}
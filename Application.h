@@ -10,6 +10,19 @@
 #include "Scheduler/OrderBookScheduler.h"
 #include "Scheduler/OrderInjectorScheduler.h"
 #include "Config/ConfigReader.h"
+#include "Ingress/ReplaySource.h"
+#include "Ingress/Gateway.h"
+#include "Ingress/ShmIngress.h"
+#include "Reports/ReportRouter.h"
+#include "Reports/ReportStream.h"
+#include "Reports/ReportDigest.h"
+#include "MarketData/ConflatingPublisher.h"
+#include "MarketData/OrderFeedWriter.h"
+#include "MarketData/BarPublisher.h"
+#include "Metrics/MetricsRegistry.h"
+#include "Metrics/MetricsExporter.h"
+#include "Journal/Journal.h"
+#include "Journal/Snapshot.h"
 
 /**
  * @class Application
@@ -18,12 +31,50 @@
  */
 class Application {
  ConfigReader::Config mConfig;
+ Scheduler::Execution mExecution; ///< INLINE = backtest engine, see backtest()
  std::shared_ptr<OrderBookScheduler> mOrderBookScheduler;
  std::shared_ptr<OrderInjectorScheduler> mOrderInjectorScheduler;
+ ReportRouter mReportRouter; ///< Routes execution reports from the books to the source of each session
+ ReportDigest mDigest; ///< Backtest: receives every report in place of mReportRouter
+ std::unique_ptr<ReportStream> mReportStream; ///< Carries reports from the book workers to mReportRouter, null = direct
+ std::unique_ptr<ConflatingPublisher> mDepthPublisher; ///< L2 updates from the book workers to mGateway, null = off
+ std::unique_ptr<OrderFeedWriter> mOrderFeed; ///< L3 order events from the book workers to a file, null = off
+ std::unique_ptr<BarPublisher> mBars; ///< Bar clock and completed OHLCV bars of every book, null = off
+ MetricsRegistry mMetrics; ///< Book worker counters and queue depths, filled in start()
+ std::unique_ptr<MetricsExporter> mMetricsExporter; ///< Publishes mMetrics, null = not exported
+ std::unique_ptr<Journal> mJournal; ///< Write-ahead log of accepted messages, null = books are not recoverable
+ std::unique_ptr<SnapshotStore> mSnapshots; ///< Periodic snapshots of the books, null = recovery replays the whole journal
+ std::unique_ptr<Gateway> mGateway; ///< Order entry gateway, null when not configured
+ std::unique_ptr<ShmIngress> mShmIngress; ///< Shared-memory order entry, null when not configured
+
+ /**
+  * @brief Binds every worker to a NUMA node before the schedulers are started and prints the
+  * resulting per-node placement.
+  *
+  * @details
+  * Order book workers are spread round-robin over the nodes. Injector workers are then shared out
+  * in proportion to the number of symbols each node's book workers own, and sessionless messages
+  * (replay, IPC) are routed by symbol to an injector on their book's node. Gateway sessions and
+  * shared-memory rings keep one injector each for ordering, so they reach books on every node. With
+  * a single node (or no libnuma) nothing is bound and only the report is printed.
+  */
+ void placeWorkers(const OrderBookScheduler::SymbolToWorkerMap& symbolToWorker);
+
+ /**
+  * @brief Starts a round of snapshots: at the journal's next pass each book worker encodes its books
+  * as of its shard's last applied message and mSnapshots writes them out.
+  */
+ void snapshotBooks();
 public:
 
- /** @brief Constructor */
- explicit Application(ConfigReader::Config config) : mConfig(std::move(config)) {}
+ /**
+  * @brief Constructor
+  * @param execution Execution::INLINE builds a backtest engine: both schedulers run their tasks on
+  * the calling thread, and everything with a thread of its own (journal, snapshots, gateway, shared
+  * memory, report stream, feeds, bars, metrics, NUMA binding) is left off whatever the config says.
+  */
+ explicit Application(ConfigReader::Config config,
+                      Scheduler::Execution execution = Scheduler::Execution::THREADED);
 
  /**
   *@brief Initializes and starts all schedulers and worker threads.
@@ -37,6 +88,23 @@ public:
 
 
  void simulate();
+
+ /**
+  * @brief Replays a recorded order-flow file (see ReplaySource) and prints throughput and
+  * end-to-end latency once every message has been applied.
+  * @throws std::runtime_error if the file cannot be mapped.
+  */
+ ReplaySource::Report replay(const std::string& path, ReplaySource::Pacing pacing, double speed = 1.0);
+
+ /**
+  * @brief Streams a recorded order-flow file through the books of an INLINE engine at full speed,
+  * then prints the simulated message rate and a digest of the results: every execution report in
+  * order, then the final state of every book. Runs over the same file and config must print the
+  * same digest.
+  * @throws std::logic_error if the engine was not built with Execution::INLINE.
+  * @throws std::runtime_error if the file cannot be mapped.
+  */
+ ReplaySource::Report backtest(const std::string& path);
 };
 
 
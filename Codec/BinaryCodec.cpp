@@ -0,0 +1,343 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "BinaryCodec.h"
+#include "../OrderBook/SymbolTable.h"
+
+namespace
+{
+    bool isValidTif(const uint8_t tif) noexcept
+    {
+        switch (tif)
+        {
+            case TIF::DAY:
+            case TIF::ALL_OR_NONE:
+            case TIF::IMMEDIATE_OR_CANCEL:
+            case TIF::FILL_OR_KILL:
+            case TIF::GOOD_TILL_CANCELED:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
+DecodeError BinaryCodec::decode(const uint8_t* data, const size_t len, InboundMessage& out, size_t& consumed) noexcept
+{
+    if (len < HEADER_SIZE)
+    {
+        return len == 0 ? DecodeError::EMPTY_MESSAGE : DecodeError::TRUNCATED;
+    }
+    if (data[0] != MAGIC)
+    {
+        return DecodeError::BAD_MSG_TYPE;
+    }
+
+    const auto kind = static_cast<MessageKind>(data[1]);
+    const size_t expected = sizeOf(kind);
+    if (expected == 0)
+    {
+        return DecodeError::BAD_MSG_TYPE;
+    }
+    if (load<uint16_t>(data + 2) != expected)
+    {
+        return DecodeError::BAD_LENGTH;
+    }
+    if (len < expected)
+    {
+        return DecodeError::TRUNCATED;
+    }
+
+    out = InboundMessage{};
+    out.kind = kind;
+    out.symbolId = load<uint32_t>(data + 4);
+
+    const SymbolTable& symbols = SymbolTable::instance();
+    if (out.symbolId != INVALID_SYMBOL_ID)
+    {
+        if (!symbols.contains(out.symbolId))
+        {
+            return DecodeError::UNKNOWN_SYMBOL;
+        }
+        out.order.symbol = symbols.name(out.symbolId);
+    }
+    else if (kind != MessageKind::MASS_CANCEL)
+    {
+        return DecodeError::UNKNOWN_SYMBOL;
+    }
+
+    switch (kind)
+    {
+        case MessageKind::NEW_ORDER:
+        {
+            out.order.id = load<uint64_t>(data + 8);
+            out.order.qty = load<uint64_t>(data + 16);
+            out.order.price = load<int64_t>(data + 24);
+            out.order.stopPrice = load<int64_t>(data + 32);
+            if (data[40] > Side::SELL)
+            {
+                return DecodeError::BAD_SIDE;
+            }
+            out.order.side = static_cast<Side>(data[40]);
+            if (data[41] > Type::STOP_LIMIT)
+            {
+                return DecodeError::BAD_TYPE;
+            }
+            out.order.type = static_cast<Type>(data[41]);
+            if (!isValidTif(data[42]))
+            {
+                return DecodeError::BAD_TIF;
+            }
+            out.order.tif = static_cast<TIF>(data[42]);
+            out.order.account = load<uint32_t>(data + 44);
+            break;
+        }
+        case MessageKind::CANCEL:
+            out.order.id = load<uint64_t>(data + 8);
+            break;
+        case MessageKind::AMEND:
+        case MessageKind::REPLACE:
+            out.order.id = load<uint64_t>(data + 8);
+            out.order.qty = load<uint64_t>(data + 16);
+            out.order.price = load<int64_t>(data + 24);
+            break;
+        case MessageKind::MASS_CANCEL:
+            if (data[8] > static_cast<uint8_t>(SideFilter::SELL_ONLY))
+            {
+                return DecodeError::BAD_SIDE;
+            }
+            out.sideFilter = static_cast<SideFilter>(data[8]);
+            break;
+    }
+
+    consumed = expected;
+    return DecodeError::NONE;
+}
+
+size_t BinaryCodec::encode(const InboundMessage& m, uint8_t* buf, const size_t cap) noexcept
+{
+    const size_t size = sizeOf(m.kind);
+    if (size == 0 || cap < size)
+    {
+        return 0;
+    }
+    std::memset(buf, 0, size);
+
+    buf[0] = MAGIC;
+    buf[1] = static_cast<uint8_t>(m.kind);
+    store<uint16_t>(buf + 2, static_cast<uint16_t>(size));
+    store<uint32_t>(buf + 4, m.symbolId);
+
+    switch (m.kind)
+    {
+        case MessageKind::NEW_ORDER:
+            store<uint64_t>(buf + 8, m.order.id);
+            store<uint64_t>(buf + 16, m.order.qty);
+            store<int64_t>(buf + 24, m.order.price);
+            store<int64_t>(buf + 32, m.order.stopPrice);
+            buf[40] = static_cast<uint8_t>(m.order.side);
+            buf[41] = static_cast<uint8_t>(m.order.type);
+            buf[42] = static_cast<uint8_t>(m.order.tif);
+            store<uint32_t>(buf + 44, m.order.account);
+            break;
+        case MessageKind::CANCEL:
+            store<uint64_t>(buf + 8, m.order.id);
+            break;
+        case MessageKind::AMEND:
+        case MessageKind::REPLACE:
+            store<uint64_t>(buf + 8, m.order.id);
+            store<uint64_t>(buf + 16, m.order.qty);
+            store<int64_t>(buf + 24, m.order.price);
+            break;
+        case MessageKind::MASS_CANCEL:
+            buf[8] = static_cast<uint8_t>(m.sideFilter);
+            break;
+    }
+    return size;
+}
+
+size_t BinaryCodec::encodeReport(const ExecReport& r, uint8_t* buf, const size_t cap) noexcept
+{
+    if (cap < EXEC_REPORT_SIZE)
+    {
+        return 0;
+    }
+    std::memset(buf, 0, EXEC_REPORT_SIZE);
+
+    buf[0] = MAGIC;
+    buf[1] = EXEC_REPORT_TYPE;
+    store<uint16_t>(buf + 2, static_cast<uint16_t>(EXEC_REPORT_SIZE));
+    store<uint32_t>(buf + 4, r.symbolId);
+    store<uint64_t>(buf + 8, r.orderId);
+    store<uint64_t>(buf + 16, r.lastQty);
+    store<int64_t>(buf + 24, r.lastPrice);
+    store<uint64_t>(buf + 32, r.leavesQty);
+    buf[40] = static_cast<uint8_t>(r.type);
+    buf[41] = static_cast<uint8_t>(r.side);
+    store<uint16_t>(buf + 42, static_cast<uint16_t>(r.reason));
+    buf[44] = static_cast<uint8_t>(r.status);
+    return EXEC_REPORT_SIZE;
+}
+
+DecodeError BinaryCodec::decodeReport(const uint8_t* data, const size_t len, ExecReport& out) noexcept
+{
+    if (len < EXEC_REPORT_SIZE)
+    {
+        return len == 0 ? DecodeError::EMPTY_MESSAGE : DecodeError::TRUNCATED;
+    }
+    if (data[0] != MAGIC || data[1] != EXEC_REPORT_TYPE)
+    {
+        return DecodeError::BAD_MSG_TYPE;
+    }
+    if (load<uint16_t>(data + 2) != EXEC_REPORT_SIZE)
+    {
+        return DecodeError::BAD_LENGTH;
+    }
+    out.symbolId = load<uint32_t>(data + 4);
+    out.orderId = load<uint64_t>(data + 8);
+    out.lastQty = load<uint64_t>(data + 16);
+    out.lastPrice = load<int64_t>(data + 24);
+    out.leavesQty = load<uint64_t>(data + 32);
+    out.type = static_cast<ExecType>(data[40]);
+    if (data[41] > Side::SELL)
+    {
+        return DecodeError::BAD_SIDE;
+    }
+    out.side = static_cast<Side>(data[41]);
+    out.reason = static_cast<RejectReason>(load<uint16_t>(data + 42));
+    out.status = static_cast<Status>(data[44]);
+    out.session = NO_SESSION; // implied by the connection
+    return DecodeError::NONE;
+}
+
+size_t BinaryCodec::encodeDepth(const DepthUpdate& u, uint8_t* buf, const size_t cap) noexcept
+{
+    if (cap < DEPTH_UPDATE_SIZE)
+    {
+        return 0;
+    }
+    std::memset(buf, 0, DEPTH_UPDATE_SIZE);
+
+    buf[0] = MAGIC;
+    buf[1] = DEPTH_UPDATE_TYPE;
+    store<uint16_t>(buf + 2, static_cast<uint16_t>(DEPTH_UPDATE_SIZE));
+    store<uint32_t>(buf + 4, u.symbolId);
+    store<uint64_t>(buf + 8, u.seq);
+    store<int64_t>(buf + 16, u.price);
+    store<uint64_t>(buf + 24, u.qty);
+    store<uint32_t>(buf + 32, static_cast<uint32_t>(std::min<Count>(u.orders, UINT32_MAX)));
+    buf[36] = static_cast<uint8_t>(u.side);
+    return DEPTH_UPDATE_SIZE;
+}
+
+DecodeError BinaryCodec::decodeDepth(const uint8_t* data, const size_t len, DepthUpdate& out) noexcept
+{
+    if (len < DEPTH_UPDATE_SIZE)
+    {
+        return len == 0 ? DecodeError::EMPTY_MESSAGE : DecodeError::TRUNCATED;
+    }
+    if (data[0] != MAGIC || data[1] != DEPTH_UPDATE_TYPE)
+    {
+        return DecodeError::BAD_MSG_TYPE;
+    }
+    if (load<uint16_t>(data + 2) != DEPTH_UPDATE_SIZE)
+    {
+        return DecodeError::BAD_LENGTH;
+    }
+    if (data[36] > Side::SELL)
+    {
+        return DecodeError::BAD_SIDE;
+    }
+    out.symbolId = load<uint32_t>(data + 4);
+    out.seq = load<uint64_t>(data + 8);
+    out.price = load<int64_t>(data + 16);
+    out.qty = load<uint64_t>(data + 24);
+    out.orders = load<uint32_t>(data + 32);
+    out.side = static_cast<Side>(data[36]);
+    return DecodeError::NONE;
+}
+
+size_t BinaryCodec::encodeOrderEvent(const OrderEvent& e, uint8_t* buf, const size_t cap) noexcept
+{
+    const size_t size = sizeOf(e.type);
+    if (size == 0 || cap < size)
+    {
+        return 0;
+    }
+    buf[0] = MAGIC;
+    buf[1] = static_cast<uint8_t>(ORDER_ADD_TYPE + static_cast<uint8_t>(e.type) - 1);
+    store<uint16_t>(buf + 2, static_cast<uint16_t>(size));
+    store<uint32_t>(buf + 4, e.symbolId);
+    store<uint64_t>(buf + 8, e.seq);
+    store<uint64_t>(buf + 16, e.orderId);
+    switch (e.type)
+    {
+        case OrderEventType::ADD:
+            store<int64_t>(buf + 24, e.price);
+            store<uint64_t>(buf + 32, e.qty);
+            std::memset(buf + 40, 0, 8);
+            buf[40] = static_cast<uint8_t>(e.side);
+            break;
+        case OrderEventType::EXECUTE:
+            store<uint64_t>(buf + 24, e.qty);
+            store<int64_t>(buf + 32, e.price);
+            break;
+        case OrderEventType::REDUCE:
+        case OrderEventType::DELETE:
+            store<uint64_t>(buf + 24, e.qty);
+            break;
+    }
+    return size;
+}
+
+DecodeError BinaryCodec::decodeOrderEvent(const uint8_t* data, const size_t len, OrderEvent& out,
+                                          size_t& consumed) noexcept
+{
+    if (len < HEADER_SIZE)
+    {
+        return len == 0 ? DecodeError::EMPTY_MESSAGE : DecodeError::TRUNCATED;
+    }
+    if (data[0] != MAGIC || data[1] < ORDER_ADD_TYPE || data[1] > ORDER_DELETE_TYPE)
+    {
+        return DecodeError::BAD_MSG_TYPE;
+    }
+    const auto type = static_cast<OrderEventType>(data[1] - ORDER_ADD_TYPE + 1);
+    const size_t size = sizeOf(type);
+    if (load<uint16_t>(data + 2) != size)
+    {
+        return DecodeError::BAD_LENGTH;
+    }
+    if (len < size)
+    {
+        return DecodeError::TRUNCATED;
+    }
+
+    out = OrderEvent{};
+    out.type = type;
+    out.symbolId = load<uint32_t>(data + 4);
+    out.seq = load<uint64_t>(data + 8);
+    out.orderId = load<uint64_t>(data + 16);
+    switch (type)
+    {
+        case OrderEventType::ADD:
+            if (data[40] > Side::SELL)
+            {
+                return DecodeError::BAD_SIDE;
+            }
+            out.price = load<int64_t>(data + 24);
+            out.qty = load<uint64_t>(data + 32);
+            out.side = static_cast<Side>(data[40]);
+            break;
+        case OrderEventType::EXECUTE:
+            out.qty = load<uint64_t>(data + 24);
+            out.price = load<int64_t>(data + 32);
+            break;
+        case OrderEventType::REDUCE:
+        case OrderEventType::DELETE:
+            out.qty = load<uint64_t>(data + 24);
+            break;
+    }
+    consumed = size;
+    return DecodeError::NONE;
+}
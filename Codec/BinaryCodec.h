@@ -0,0 +1,196 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef BINARYCODEC_H
+#define BINARYCODEC_H
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "OrderMessage.h"
+#include "../Reports/ExecReport.h"
+#include "../MarketData/DepthUpdate.h"
+#include "../MarketData/OrderEvent.h"
+
+/**
+ * @class BinaryCodec
+ * @brief Fixed-width, little-endian binary order entry format with a zero-copy decoder.
+ *
+ * @details
+ * Every message starts with the same 8 byte header, followed by a body at fixed offsets. Symbols
+ * travel as `SymbolId`s (see SymbolTable) and prices as integer ticks, so decoding is a handful of
+ * loads: no text, no intermediate strings, no allocation.
+ *
+ * Header (all messages)
+ * | Offset | Size | Field                              |
+ * |--------|------|------------------------------------|
+ * | 0      | 1    | magic `0xB7`                       |
+ * | 1      | 1    | msgType (MessageKind)              |
+ * | 2      | 2    | length, total bytes incl. header   |
+ * | 4      | 4    | symbolId (0xFFFFFFFF = all, mass cancel only) |
+ *
+ * NEW_ORDER (48 bytes): 8 orderId u64, 16 qty u64, 24 price i64, 32 stopPrice i64,
+ *                       40 side u8, 41 type u8, 42 tif u8, 43 reserved, 44 account u32
+ * CANCEL (16 bytes):    8 orderId u64
+ * AMEND (32 bytes):     8 orderId u64, 16 newOpenQty u64, 24 newPrice i64
+ * REPLACE (32 bytes):   8 orderId u64, 16 newTotalQty u64, 24 newPrice i64
+ * MASS_CANCEL (16 bytes): 8 sideFilter u8, 9..15 reserved
+ *
+ * Outbound, same header with msgType EXEC_REPORT_TYPE:
+ * EXEC_REPORT (48 bytes): 8 orderId u64, 16 lastQty u64, 24 lastPrice i64, 32 leavesQty u64,
+ *                         40 execType u8, 41 side u8, 42 rejectReason u16, 44 orderStatus u8,
+ *                         45..47 reserved
+ *
+ * Market data, same header with msgType DEPTH_UPDATE_TYPE:
+ * DEPTH_UPDATE (40 bytes): 8 seq u64, 16 price i64, 24 qty u64 (0 = level gone), 32 orders u32,
+ *                          36 side u8, 37..39 reserved
+ *
+ * Order events (L3), sized by type; later events carry only what the order id does not imply:
+ * ORDER_ADD (48 bytes):     8 seq u64, 16 orderId u64, 24 price i64, 32 qty u64, 40 side u8, 41..47 reserved
+ * ORDER_EXECUTE (40 bytes): 8 seq u64, 16 orderId u64, 24 qty u64, 32 price i64
+ * ORDER_REDUCE (32 bytes):  8 seq u64, 16 orderId u64, 24 qty u64 (reduced by)
+ * ORDER_DELETE (32 bytes):  8 seq u64, 16 orderId u64, 24 qty u64 (open quantity removed)
+ *
+ * The magic byte is never printable ASCII, which lets a transport carry binary and the legacy text
+ * format side by side (see isBinary()).
+ */
+class BinaryCodec {
+public:
+    static constexpr uint8_t MAGIC = 0xB7;
+    static constexpr size_t HEADER_SIZE = 8;
+    static constexpr size_t NEW_ORDER_SIZE = 48;
+    static constexpr size_t CANCEL_SIZE = 16;
+    static constexpr size_t AMEND_SIZE = 32;
+    static constexpr size_t MASS_CANCEL_SIZE = 16;
+    static constexpr size_t MAX_MESSAGE_SIZE = NEW_ORDER_SIZE;
+    static constexpr uint8_t EXEC_REPORT_TYPE = 0x10; ///< Outside MessageKind, responses only
+    static constexpr size_t EXEC_REPORT_SIZE = 48;
+    static constexpr uint8_t DEPTH_UPDATE_TYPE = 0x11; ///< Outside MessageKind, market data only
+    static constexpr size_t DEPTH_UPDATE_SIZE = 40;
+    static constexpr uint8_t ORDER_ADD_TYPE = 0x12; ///< Order event types, ORDER_ADD_TYPE + OrderEventType - 1
+    static constexpr uint8_t ORDER_EXECUTE_TYPE = 0x13;
+    static constexpr uint8_t ORDER_REDUCE_TYPE = 0x14;
+    static constexpr uint8_t ORDER_DELETE_TYPE = 0x15;
+    static constexpr size_t ORDER_ADD_SIZE = 48;
+    static constexpr size_t ORDER_EXECUTE_SIZE = 40;
+    static constexpr size_t ORDER_REDUCE_SIZE = 32;
+    static constexpr size_t ORDER_DELETE_SIZE = 32;
+    static constexpr size_t MAX_ORDER_EVENT_SIZE = ORDER_ADD_SIZE;
+
+    /** @brief True if the buffer starts like a binary message (as opposed to the text format). */
+    static bool isBinary(const void* data, const size_t len) noexcept
+    {
+        return len > 0 && *static_cast<const uint8_t*>(data) == MAGIC;
+    }
+
+    /** @brief Fixed size of a message type, or 0 for an unknown type. */
+    static constexpr size_t sizeOf(const MessageKind kind) noexcept
+    {
+        switch (kind)
+        {
+            case MessageKind::NEW_ORDER: return NEW_ORDER_SIZE;
+            case MessageKind::CANCEL: return CANCEL_SIZE;
+            case MessageKind::AMEND:
+            case MessageKind::REPLACE: return AMEND_SIZE;
+            case MessageKind::MASS_CANCEL: return MASS_CANCEL_SIZE;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Decodes one message from the front of `data`.
+     * @param data Buffer holding at least one message.
+     * @param len Bytes available in `data`.
+     * @param[out] out Decoded message. `out.order.symbol` views the SymbolTable entry.
+     * @param[out] consumed Bytes taken by the message, valid when the result is NONE.
+     * @return DecodeError::NONE on success.
+     */
+    static DecodeError decode(const uint8_t* data, size_t len, InboundMessage& out, size_t& consumed) noexcept;
+
+    /**
+     * @brief Encodes a message. Used by tests, load generators and client libraries.
+     * @return Bytes written, or 0 when `cap` is too small or the kind is unknown.
+     */
+    static size_t encode(const InboundMessage& m, uint8_t* buf, size_t cap) noexcept;
+
+    /**
+     * @brief Encodes an execution report.
+     * @return EXEC_REPORT_SIZE, or 0 when `cap` is too small.
+     */
+    static size_t encodeReport(const ExecReport& r, uint8_t* buf, size_t cap) noexcept;
+
+    /**
+     * @brief Decodes an execution report (client side).
+     * @return DecodeError::NONE on success.
+     */
+    static DecodeError decodeReport(const uint8_t* data, size_t len, ExecReport& out) noexcept;
+
+    /**
+     * @brief Encodes a price level update.
+     * @return DEPTH_UPDATE_SIZE, or 0 when `cap` is too small.
+     */
+    static size_t encodeDepth(const DepthUpdate& u, uint8_t* buf, size_t cap) noexcept;
+
+    /**
+     * @brief Decodes a price level update (client side).
+     * @return DecodeError::NONE on success.
+     */
+    static DecodeError decodeDepth(const uint8_t* data, size_t len, DepthUpdate& out) noexcept;
+
+    /** @brief Encoded size of an order event of the given type, 0 for an unknown type. */
+    static constexpr size_t sizeOf(const OrderEventType type) noexcept
+    {
+        switch (type)
+        {
+            case OrderEventType::ADD: return ORDER_ADD_SIZE;
+            case OrderEventType::EXECUTE: return ORDER_EXECUTE_SIZE;
+            case OrderEventType::REDUCE: return ORDER_REDUCE_SIZE;
+            case OrderEventType::DELETE: return ORDER_DELETE_SIZE;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Encodes an order event.
+     * @return Bytes written (see sizeOf()), or 0 when `cap` is too small.
+     */
+    static size_t encodeOrderEvent(const OrderEvent& e, uint8_t* buf, size_t cap) noexcept;
+
+    /**
+     * @brief Decodes one order event from the front of `data` (consumer side).
+     * @param[out] consumed Bytes taken by the event, valid when the result is NONE.
+     * @return DecodeError::NONE on success.
+     */
+    static DecodeError decodeOrderEvent(const uint8_t* data, size_t len, OrderEvent& out, size_t& consumed) noexcept;
+
+    // <===== Little-endian field access =====>
+
+    template <typename T>
+    static T load(const uint8_t* p) noexcept
+    {
+        T v;
+        std::memcpy(&v, p, sizeof(T));
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            auto* b = reinterpret_cast<uint8_t*>(&v);
+            std::reverse(b, b + sizeof(T));
+        }
+        return v;
+    }
+
+    template <typename T>
+    static void store(uint8_t* p, T v) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::big)
+        {
+            auto* b = reinterpret_cast<uint8_t*>(&v);
+            std::reverse(b, b + sizeof(T));
+        }
+        std::memcpy(p, &v, sizeof(T));
+    }
+};
+
+#endif //BINARYCODEC_H
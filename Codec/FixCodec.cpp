@@ -0,0 +1,381 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "FixCodec.h"
+#include "../OrderBook/SymbolTable.h"
+
+#include <charconv>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OME_FIX_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    /**
+     * Scanner contract: records the offset of every SOH in [p, p + n) into `soh` and returns the
+     * byte sum of the range in `sum`. Returns the number of delimiters, or `max + 1` on overflow.
+     */
+    using ScanFn = size_t (*)(const char* p, size_t n, uint16_t* soh, size_t max, uint32_t& sum);
+
+    size_t scanScalar(const char* p, const size_t n, uint16_t* soh, const size_t max, uint32_t& sum)
+    {
+        uint32_t total = 0;
+        size_t cnt = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            const auto c = static_cast<uint8_t>(p[i]);
+            total += c;
+            if (c == static_cast<uint8_t>(FixCodec::SOH))
+            {
+                if (cnt == max)
+                {
+                    return max + 1;
+                }
+                soh[cnt++] = static_cast<uint16_t>(i);
+            }
+        }
+        sum = total;
+        return cnt;
+    }
+
+#ifdef OME_FIX_X86_SIMD
+    // Compiled for SSE2/AVX2 through target attributes and picked at runtime, so the binary does
+    // not need -mavx2 and still runs on older CPUs.
+
+    __attribute__((target("sse2")))
+    size_t scanSse2(const char* p, const size_t n, uint16_t* soh, const size_t max, uint32_t& sum)
+    {
+        const __m128i delim = _mm_set1_epi8(FixCodec::SOH);
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        size_t cnt = 0;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero)); // two 64-bit partial byte sums
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, delim)));
+            while (mask)
+            {
+                if (cnt == max)
+                {
+                    return max + 1;
+                }
+                soh[cnt++] = static_cast<uint16_t>(i + __builtin_ctz(mask));
+                mask &= mask - 1;
+            }
+        }
+        alignas(16) uint64_t lanes[2];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+
+        uint32_t tailSum = 0;
+        const size_t tailCnt = scanScalar(p + i, n - i, soh + cnt, max - cnt, tailSum);
+        if (tailCnt > max - cnt)
+        {
+            return max + 1;
+        }
+        for (size_t k = 0; k < tailCnt; k++)
+        {
+            soh[cnt + k] = static_cast<uint16_t>(soh[cnt + k] + i);
+        }
+        sum = static_cast<uint32_t>(lanes[0] + lanes[1]) + tailSum;
+        return cnt + tailCnt;
+    }
+
+    __attribute__((target("avx2")))
+    size_t scanAvx2(const char* p, const size_t n, uint16_t* soh, const size_t max, uint32_t& sum)
+    {
+        const __m256i delim = _mm256_set1_epi8(FixCodec::SOH);
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc = zero;
+        size_t cnt = 0;
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, zero)); // four 64-bit partial byte sums
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, delim)));
+            while (mask)
+            {
+                if (cnt == max)
+                {
+                    return max + 1;
+                }
+                soh[cnt++] = static_cast<uint16_t>(i + __builtin_ctz(mask));
+                mask &= mask - 1;
+            }
+        }
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+
+        uint32_t tailSum = 0;
+        const size_t tailCnt = scanScalar(p + i, n - i, soh + cnt, max - cnt, tailSum);
+        if (tailCnt > max - cnt)
+        {
+            return max + 1;
+        }
+        for (size_t k = 0; k < tailCnt; k++)
+        {
+            soh[cnt + k] = static_cast<uint16_t>(soh[cnt + k] + i);
+        }
+        sum = static_cast<uint32_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + tailSum;
+        return cnt + tailCnt;
+    }
+#endif
+
+    struct Scanner
+    {
+        ScanFn fn;
+        const char* name;
+    };
+
+    const Scanner& bestScanner()
+    {
+        static const Scanner scanner = []
+        {
+#ifdef OME_FIX_X86_SIMD
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+            {
+                return Scanner{scanAvx2, "avx2"};
+            }
+            if (__builtin_cpu_supports("sse2"))
+            {
+                return Scanner{scanSse2, "sse2"};
+            }
+#endif
+            return Scanner{scanScalar, "scalar"};
+        }();
+        return scanner;
+    }
+
+    template <typename T>
+    bool parseNumber(const std::string_view v, T& out) noexcept
+    {
+        if (v.empty())
+        {
+            return false;
+        }
+        const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), out);
+        return ec == std::errc() && ptr == v.data() + v.size();
+    }
+
+    /**
+     * @brief "175.25" -> 17525 with 2 decimals. Rejects prices finer than the tick and prices past
+     * the Price range. Only the whole part may carry a sign.
+     */
+    bool parsePrice(std::string_view v, const int decimals, Price& out) noexcept
+    {
+        const bool negative = !v.empty() && v.front() == '-';
+        if (negative)
+        {
+            v.remove_prefix(1);
+        }
+        const size_t dot = v.find('.');
+        uint64_t whole = 0;
+        if (!parseNumber(v.substr(0, dot), whole))
+        {
+            return false;
+        }
+        std::string_view frac = dot == std::string_view::npos ? std::string_view{} : v.substr(dot + 1);
+        while (!frac.empty() && frac.back() == '0')
+        {
+            frac.remove_suffix(1);
+        }
+        if (frac.size() > static_cast<size_t>(decimals))
+        {
+            return false;
+        }
+        uint64_t fracTicks = 0;
+        if (!frac.empty() && !parseNumber(frac, fracTicks))
+        {
+            return false;
+        }
+        for (size_t k = frac.size(); k < static_cast<size_t>(decimals); k++)
+        {
+            fracTicks *= 10;
+        }
+        uint64_t scale = 1;
+        for (int k = 0; k < decimals; k++)
+        {
+            scale *= 10;
+        }
+        constexpr auto MAX = static_cast<uint64_t>(std::numeric_limits<Price>::max());
+        if (whole > (MAX - fracTicks) / scale)
+        {
+            return false;
+        }
+        const auto ticks = static_cast<Price>(whole * scale + fracTicks);
+        out = negative ? -ticks : ticks;
+        return true;
+    }
+
+    DecodeError decodeWith(const ScanFn scan, const std::string_view msg, InboundMessage& out,
+                           const int priceDecimals) noexcept
+    {
+        // Trailer is always "10=ddd<SOH>", 7 bytes, preceded by the SOH of the last body field.
+        constexpr size_t TRAILER = 7;
+        const size_t n = msg.size();
+        if (n < TRAILER + 1 || n > UINT16_MAX)
+        {
+            return n == 0 ? DecodeError::EMPTY_MESSAGE : DecodeError::TRUNCATED;
+        }
+        const std::string_view trailer = msg.substr(n - TRAILER);
+        if (trailer.substr(0, 3) != "10=" || trailer.back() != FixCodec::SOH || msg[n - TRAILER - 1] != FixCodec::SOH)
+        {
+            return DecodeError::BAD_CHECKSUM;
+        }
+        uint32_t declaredSum = 0;
+        if (!parseNumber(trailer.substr(3, 3), declaredSum))
+        {
+            return DecodeError::BAD_CHECKSUM;
+        }
+
+        // One pass: delimiter offsets + checksum.
+        uint16_t soh[FixCodec::MAX_FIELDS];
+        uint32_t sum = 0;
+        const size_t fields = scan(msg.data(), n - TRAILER, soh, FixCodec::MAX_FIELDS, sum);
+        if (fields > FixCodec::MAX_FIELDS)
+        {
+            return DecodeError::MALFORMED_FIELD;
+        }
+        if (sum % 256 != declaredSum)
+        {
+            return DecodeError::BAD_CHECKSUM;
+        }
+
+        std::string_view msgType, symbol, clOrdId, origClOrdId, side, qty, ordType, price, stopPx, tif, execInst, account;
+        size_t start = 0;
+        for (size_t f = 0; f < fields; f++)
+        {
+            const std::string_view field = msg.substr(start, soh[f] - start);
+            start = soh[f] + 1;
+
+            const size_t eq = field.find('=');
+            uint32_t tag = 0;
+            if (eq == std::string_view::npos || !parseNumber(field.substr(0, eq), tag))
+            {
+                return DecodeError::MALFORMED_FIELD;
+            }
+            const std::string_view value = field.substr(eq + 1);
+
+            // Standard header order: 8, 9, 35.
+            if (f == 0)
+            {
+                if (tag != 8 || value != "FIX.4.4") return DecodeError::BAD_BEGIN_STRING;
+                continue;
+            }
+            if (f == 1)
+            {
+                size_t bodyLength = 0;
+                if (tag != 9 || !parseNumber(value, bodyLength) || bodyLength != (n - TRAILER) - start)
+                {
+                    return DecodeError::BAD_BODY_LENGTH;
+                }
+                continue;
+            }
+            if (f == 2 && tag != 35)
+            {
+                return DecodeError::BAD_MSG_TYPE;
+            }
+            switch (tag)
+            {
+                case 35: msgType = value; break;
+                case 11: clOrdId = value; break;
+                case 41: origClOrdId = value; break;
+                case 55: symbol = value; break;
+                case 54: side = value; break;
+                case 38: qty = value; break;
+                case 40: ordType = value; break;
+                case 44: price = value; break;
+                case 99: stopPx = value; break;
+                case 59: tif = value; break;
+                case 18: execInst = value; break;
+                case 1: account = value; break;
+                default: break; // header/trailer fields the engine does not use (49, 56, 34, 52, ...)
+            }
+        }
+        if (fields < 3)
+        {
+            return DecodeError::TRUNCATED;
+        }
+
+        out = InboundMessage{};
+        if (msgType == "D") out.kind = MessageKind::NEW_ORDER;
+        else if (msgType == "F") out.kind = MessageKind::CANCEL;
+        else if (msgType == "G") out.kind = MessageKind::REPLACE;
+        else return DecodeError::BAD_MSG_TYPE;
+
+        if (symbol.empty()) return DecodeError::MISSING_SYMBOL;
+        out.symbolId = SymbolTable::instance().find(symbol);
+        if (out.symbolId == INVALID_SYMBOL_ID) return DecodeError::UNKNOWN_SYMBOL;
+        out.order.symbol = SymbolTable::instance().name(out.symbolId);
+
+        if (out.kind != MessageKind::NEW_ORDER)
+        {
+            if (origClOrdId.empty()) return DecodeError::MISSING_ID;
+            if (!parseNumber(origClOrdId, out.order.id)) return DecodeError::BAD_ID;
+            if (out.kind == MessageKind::REPLACE)
+            {
+                if (qty.empty()) return DecodeError::MISSING_QTY;
+                if (!parseNumber(qty, out.order.qty)) return DecodeError::BAD_QTY;
+                if (!parsePrice(price, priceDecimals, out.order.price)) return DecodeError::BAD_PRICE;
+            }
+            return DecodeError::NONE;
+        }
+
+        if (clOrdId.empty()) return DecodeError::MISSING_ID;
+        if (!parseNumber(clOrdId, out.order.id)) return DecodeError::BAD_ID;
+
+        if (!account.empty() && !parseNumber(account, out.order.account)) return DecodeError::BAD_ACCOUNT;
+
+        if (side.empty()) return DecodeError::MISSING_SIDE;
+        if (side == "1") out.order.side = Side::BUY;
+        else if (side == "2") out.order.side = Side::SELL;
+        else return DecodeError::BAD_SIDE;
+
+        if (qty.empty()) return DecodeError::MISSING_QTY;
+        if (!parseNumber(qty, out.order.qty)) return DecodeError::BAD_QTY;
+
+        if (ordType == "1") out.order.type = Type::MARKET;
+        else if (ordType == "2") out.order.type = Type::LIMIT;
+        else if (ordType == "3") out.order.type = Type::STOP;
+        else if (ordType == "4") out.order.type = Type::STOP_LIMIT;
+        else return DecodeError::BAD_TYPE;
+
+        if (!price.empty() && !parsePrice(price, priceDecimals, out.order.price)) return DecodeError::BAD_PRICE;
+        if (!stopPx.empty() && !parsePrice(stopPx, priceDecimals, out.order.stopPrice)) return DecodeError::BAD_PRICE;
+
+        if (tif.empty() || tif == "0") out.order.tif = TIF::DAY;
+        else if (tif == "1") out.order.tif = TIF::GOOD_TILL_CANCELED;
+        else if (tif == "3") out.order.tif = TIF::IMMEDIATE_OR_CANCEL;
+        else if (tif == "4") out.order.tif = TIF::FILL_OR_KILL;
+        else return DecodeError::BAD_TIF;
+
+        if (execInst.find('G') != std::string_view::npos)
+        {
+            if (out.order.tif != TIF::DAY && out.order.tif != TIF::GOOD_TILL_CANCELED) return DecodeError::BAD_TIF;
+            out.order.tif = TIF::ALL_OR_NONE;
+        }
+        return DecodeError::NONE;
+    }
+}
+
+DecodeError FixCodec::decode(const std::string_view msg, InboundMessage& out, const int priceDecimals) noexcept
+{
+    return decodeWith(bestScanner().fn, msg, out, priceDecimals);
+}
+
+DecodeError FixCodec::decodeScalar(const std::string_view msg, InboundMessage& out, const int priceDecimals) noexcept
+{
+    return decodeWith(scanScalar, msg, out, priceDecimals);
+}
+
+const char* FixCodec::scannerName() noexcept
+{
+    return bestScanner().name;
+}
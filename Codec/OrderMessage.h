@@ -0,0 +1,145 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef ORDERMESSAGE_H
+#define ORDERMESSAGE_H
+
+#include <cstdint>
+#include <string_view>
+#include "../OrderBook/Order/Types.h"
+
+/**
+ * @struct OrderMessage
+ * @brief Decoded, allocation-free view of an inbound order message.
+ *
+ * Produced by the wire decoders and consumed by the injector to build `Order` objects.
+ * @warning `symbol` points into the decoded buffer and is only valid while that buffer lives.
+ */
+struct OrderMessage
+{
+    OrderId id{0};
+    Side side{Side::BUY};
+    Type type{Type::MARKET};
+    TIF tif{TIF::DEFAULT};
+    Quantity qty{0};
+    Price price{0};
+    Price stopPrice{0};
+    AccountId account{NO_ACCOUNT};
+    std::string_view symbol;
+};
+
+/**
+ * @brief Kind of inbound request carried by a message.
+ */
+enum class MessageKind : uint8_t
+{
+    NEW_ORDER = 1,
+    CANCEL = 2,
+    AMEND = 3,
+    MASS_CANCEL = 4,
+    REPLACE = 5
+};
+
+/**
+ * @brief Side selector of a mass cancel.
+ */
+enum class SideFilter : uint8_t
+{
+    BOTH = 0,
+    BUY_ONLY = 1,
+    SELL_ONLY = 2
+};
+
+/**
+ * @struct InboundMessage
+ * @brief Any decoded inbound request, independent of the wire format it came from.
+ *
+ * - NEW_ORDER:   `order` holds the full order.
+ * - CANCEL:      `order.id` is the order to cancel.
+ * - AMEND:       `order.id` is the order to amend, `order.qty` its new open quantity and
+ *                `order.price` its new limit price.
+ * - REPLACE:     same as AMEND, except that `order.qty` is the new total quantity, filled quantity
+ *                included, as FIX OrderQty (38) is on a cancel/replace. The book derives the open
+ *                quantity from it, see OrderBook::replaceOrder().
+ * - MASS_CANCEL: `sideFilter` selects the sides; `symbolId` == INVALID_SYMBOL_ID means all symbols.
+ *
+ * `symbolId` is INVALID_SYMBOL_ID when the wire format carries the symbol as text; the router then
+ * resolves `order.symbol` through the SymbolTable.
+ *
+ * `session` and `ingressNs` are not part of any wire format: the ingress layer fills them after
+ * decoding. `session` identifies the connection reports go back to (NO_SESSION for none) and
+ * `ingressNs` (LatencyHistogram::nowNs()) lets the book stage measure end-to-end latency, 0 means
+ * not stamped.
+ */
+struct InboundMessage
+{
+    MessageKind kind{MessageKind::NEW_ORDER};
+    SymbolId symbolId{INVALID_SYMBOL_ID};
+    SideFilter sideFilter{SideFilter::BOTH};
+    OrderMessage order;
+    SessionId session{NO_SESSION};
+    uint64_t ingressNs{0};
+};
+
+/**
+ * @brief Reason a message could not be decoded. Decoders report these instead of throwing.
+ */
+enum class DecodeError : uint8_t
+{
+    NONE = 0,
+    EMPTY_MESSAGE,
+    MALFORMED_FIELD,   // field without '=' or with an empty tag
+    MISSING_ID,
+    MISSING_SIDE,
+    MISSING_QTY,
+    MISSING_SYMBOL,
+    BAD_ID,
+    BAD_SIDE,
+    BAD_QTY,
+    BAD_PRICE,
+    BAD_TYPE,
+    BAD_TIF,
+    TRUNCATED,         // binary buffer shorter than its declared / fixed length
+    BAD_LENGTH,        // declared length does not match the message type
+    BAD_MSG_TYPE,
+    UNKNOWN_SYMBOL,
+    BAD_BEGIN_STRING,  // FIX: not FIX.4.4
+    BAD_BODY_LENGTH,   // FIX: tag 9 does not match the message
+    BAD_CHECKSUM,      // FIX: tag 10 missing or wrong
+    BAD_ACCOUNT        // account not an unsigned 32 bit integer
+};
+
+/** @brief Human-readable name of a decode error, for logs and reject texts. */
+constexpr const char* toString(const DecodeError e)
+{
+    switch (e)
+    {
+        case DecodeError::NONE: return "NONE";
+        case DecodeError::EMPTY_MESSAGE: return "EMPTY_MESSAGE";
+        case DecodeError::MALFORMED_FIELD: return "MALFORMED_FIELD";
+        case DecodeError::MISSING_ID: return "MISSING_ID";
+        case DecodeError::MISSING_SIDE: return "MISSING_SIDE";
+        case DecodeError::MISSING_QTY: return "MISSING_QTY";
+        case DecodeError::MISSING_SYMBOL: return "MISSING_SYMBOL";
+        case DecodeError::BAD_ID: return "BAD_ID";
+        case DecodeError::BAD_SIDE: return "BAD_SIDE";
+        case DecodeError::BAD_QTY: return "BAD_QTY";
+        case DecodeError::BAD_PRICE: return "BAD_PRICE";
+        case DecodeError::BAD_TYPE: return "BAD_TYPE";
+        case DecodeError::BAD_TIF: return "BAD_TIF";
+        case DecodeError::TRUNCATED: return "TRUNCATED";
+        case DecodeError::BAD_LENGTH: return "BAD_LENGTH";
+        case DecodeError::BAD_MSG_TYPE: return "BAD_MSG_TYPE";
+        case DecodeError::UNKNOWN_SYMBOL: return "UNKNOWN_SYMBOL";
+        case DecodeError::BAD_BEGIN_STRING: return "BAD_BEGIN_STRING";
+        case DecodeError::BAD_BODY_LENGTH: return "BAD_BODY_LENGTH";
+        case DecodeError::BAD_CHECKSUM: return "BAD_CHECKSUM";
+        case DecodeError::BAD_ACCOUNT: return "BAD_ACCOUNT";
+    }
+    return "UNKNOWN";
+}
+
+#endif //ORDERMESSAGE_H
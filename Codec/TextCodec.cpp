@@ -0,0 +1,146 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "TextCodec.h"
+
+#include <charconv>
+
+namespace
+{
+    template <typename T>
+    bool parseNumber(const std::string_view v, T& out) noexcept
+    {
+        if (v.empty())
+        {
+            return false;
+        }
+        const auto [ptr, ec] = std::from_chars(v.data(), v.data() + v.size(), out);
+        return ec == std::errc() && ptr == v.data() + v.size();
+    }
+
+    bool parseSide(const std::string_view v, Side& out) noexcept
+    {
+        if (v == "BUY") { out = Side::BUY; return true; }
+        if (v == "SELL") { out = Side::SELL; return true; }
+        return false;
+    }
+
+    bool parseType(const std::string_view v, Type& out) noexcept
+    {
+        if (v == "LIMIT") { out = Type::LIMIT; return true; }
+        if (v == "MARKET") { out = Type::MARKET; return true; }
+        if (v == "STOP") { out = Type::STOP; return true; }
+        if (v == "STOP_LIMIT") { out = Type::STOP_LIMIT; return true; }
+        return false;
+    }
+
+    bool parseTif(const std::string_view v, TIF& out) noexcept
+    {
+        if (v == "DAY") { out = TIF::DAY; return true; }
+        if (v == "GTC") { out = TIF::GOOD_TILL_CANCELED; return true; }
+        if (v == "IOC") { out = TIF::IMMEDIATE_OR_CANCEL; return true; }
+        if (v == "FOK") { out = TIF::FILL_OR_KILL; return true; }
+        if (v == "AON") { out = TIF::ALL_OR_NONE; return true; }
+        return false;
+    }
+
+    // Bit per required tag, to report what is missing without a second pass.
+    enum Seen : uint8_t { SEEN_ID = 1, SEEN_SIDE = 2, SEEN_QTY = 4, SEEN_SYMBOL = 8 };
+}
+
+DecodeError TextCodec::decode(std::string_view msg, OrderMessage& out) noexcept
+{
+    if (msg.empty())
+    {
+        return DecodeError::EMPTY_MESSAGE;
+    }
+
+    out = OrderMessage{};
+    uint8_t seen = 0;
+
+    while (!msg.empty())
+    {
+        const size_t end = msg.find(';');
+        const std::string_view field = msg.substr(0, end);
+        msg = (end == std::string_view::npos) ? std::string_view{} : msg.substr(end + 1);
+
+        if (field.empty())
+        {
+            continue; // tolerate trailing / doubled separators
+        }
+
+        const size_t eq = field.find('=');
+        if (eq == std::string_view::npos || eq == 0)
+        {
+            return DecodeError::MALFORMED_FIELD;
+        }
+        const std::string_view tag = field.substr(0, eq);
+        const std::string_view value = field.substr(eq + 1);
+
+        // Fixed tag set: dispatch on length, then one compare.
+        switch (tag.size())
+        {
+            case 2:
+                if (tag == "id")
+                {
+                    if (!parseNumber(value, out.id)) return DecodeError::BAD_ID;
+                    seen |= SEEN_ID;
+                }
+                break;
+            case 3:
+                if (tag == "qty")
+                {
+                    if (!parseNumber(value, out.qty)) return DecodeError::BAD_QTY;
+                    seen |= SEEN_QTY;
+                }
+                else if (tag == "tif")
+                {
+                    if (!parseTif(value, out.tif)) return DecodeError::BAD_TIF;
+                }
+                break;
+            case 4:
+                if (tag == "side")
+                {
+                    if (!parseSide(value, out.side)) return DecodeError::BAD_SIDE;
+                    seen |= SEEN_SIDE;
+                }
+                else if (tag == "type")
+                {
+                    if (!parseType(value, out.type)) return DecodeError::BAD_TYPE;
+                }
+                else if (tag == "stop")
+                {
+                    if (!parseNumber(value, out.stopPrice)) return DecodeError::BAD_PRICE;
+                }
+                break;
+            case 5:
+                if (tag == "price")
+                {
+                    if (!parseNumber(value, out.price)) return DecodeError::BAD_PRICE;
+                }
+                break;
+            case 6:
+                if (tag == "symbol" && !value.empty())
+                {
+                    out.symbol = value;
+                    seen |= SEEN_SYMBOL;
+                }
+                break;
+            case 7:
+                if (tag == "account")
+                {
+                    if (!parseNumber(value, out.account)) return DecodeError::BAD_ACCOUNT;
+                }
+                break;
+            default:
+                break; // unknown tag
+        }
+    }
+
+    if (!(seen & SEEN_ID)) return DecodeError::MISSING_ID;
+    if (!(seen & SEEN_SIDE)) return DecodeError::MISSING_SIDE;
+    if (!(seen & SEEN_QTY)) return DecodeError::MISSING_QTY;
+    if (!(seen & SEEN_SYMBOL)) return DecodeError::MISSING_SYMBOL;
+    return DecodeError::NONE;
+}
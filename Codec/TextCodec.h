@@ -0,0 +1,47 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef TEXTCODEC_H
+#define TEXTCODEC_H
+
+#include "OrderMessage.h"
+
+/**
+ * @class TextCodec
+ * @brief Zero-copy decoder for the engine's `key=value;key=value` text order format.
+ *
+ * @details
+ * Example: `id=1;side=BUY;qty=100;symbol=TESLA;price=17500;type=LIMIT;tif=IOC`
+ *
+ * The decoder walks the message once over a std::string_view: no copies, no std::stringstream,
+ * no temporary map. Tags come from a small fixed set and are dispatched with a switch on the tag
+ * length followed by a single comparison. Numbers are converted with std::from_chars. Unknown tags
+ * are ignored, so producers can add fields without breaking older engines.
+ *
+ * | Tag    | Value                                   | Required        |
+ * |--------|-----------------------------------------|-----------------|
+ * | id     | unsigned integer                        | yes             |
+ * | side   | BUY / SELL                              | yes             |
+ * | qty    | unsigned integer                        | yes             |
+ * | symbol | text                                    | yes             |
+ * | price  | integer (ticks)                         | LIMIT/STOP_LIMIT|
+ * | stop   | integer (ticks)                         | STOP/STOP_LIMIT |
+ * | type   | LIMIT / MARKET / STOP / STOP_LIMIT      | no (MARKET)     |
+ * | tif    | DAY / GTC / IOC / FOK / AON             | no (DAY)        |
+ * | account| unsigned integer                        | no (none)       |
+ */
+class TextCodec {
+public:
+    /**
+     * @brief Decodes one message.
+     * @param msg Raw message. `out.symbol` views into it.
+     * @param[out] out Decoded fields. Unspecified content on error.
+     * @return DecodeError::NONE on success, otherwise the first error found.
+     */
+    static DecodeError decode(std::string_view msg, OrderMessage& out) noexcept;
+};
+
+#endif //TEXTCODEC_H
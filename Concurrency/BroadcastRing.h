@@ -0,0 +1,131 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef BROADCASTRING_H
+#define BROADCASTRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @class BroadcastRing
+ * @brief Bounded, lock-free single-producer ring that any number of readers can follow, each at its
+ * own pace, without consuming what they read.
+ *
+ * @details
+ * - The producer never waits and never fails: it overwrites the oldest slot. A reader that falls more
+ *   than `capacity` values behind has lost the overwritten ones and is told so (tryRead() returns
+ *   LAPPED), it never slows the producer down.
+ * - Each slot is a small seqlock, like TopOfBook: the slot's stamp is odd while the producer writes
+ *   it and names the value's sequence number once written. A reader copies the slot and keeps the copy
+ *   only if the stamp did not move meanwhile. Readers never write shared memory.
+ * - Values are stored as relaxed atomic words so a read racing an overwrite is defined behaviour.
+ *
+ * @tparam T Element type, trivially copyable, size a multiple of 8.
+ */
+template <typename T>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable_v<T>, "BroadcastRing elements are copied without constructors");
+    static_assert(sizeof(T) % sizeof(uint64_t) == 0, "BroadcastRing elements are copied in 8-byte words");
+
+    static constexpr size_t WORDS = sizeof(T) / sizeof(uint64_t);
+
+    struct Slot
+    {
+        std::atomic<uint64_t> stamp{0}; ///< 2 * seq + 1 while value seq is written, 2 * seq + 2 once written
+        std::atomic<uint64_t> words[WORDS];
+    };
+
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    enum class ReadResult
+    {
+        OK,       ///< The value was copied
+        NOT_YET,  ///< Nothing was published under that sequence number yet
+        LAPPED    ///< The value was overwritten; the oldest one still readable is at published() - capacity()
+    };
+
+    /** @throws std::invalid_argument unless `capacity` is a power of two >= 2. */
+    explicit BroadcastRing(const size_t capacity) : mMask(capacity - 1), mSlots(std::make_unique<Slot[]>(capacity))
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+        {
+            throw std::invalid_argument("BroadcastRing: capacity must be a power of two >= 2");
+        }
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    size_t capacity() const { return mMask + 1; }
+
+    /** @brief Appends a value, overwriting the oldest one once the ring is full. Producer thread only. */
+    void publish(const T& value) noexcept
+    {
+        const uint64_t seq = mNext++;
+        Slot& slot = mSlots[seq & mMask];
+        uint64_t words[WORDS];
+        std::memcpy(words, &value, sizeof(T));
+
+        slot.stamp.store(2 * seq + 1, std::memory_order_relaxed);
+        // Orders the odd stamp before the word stores below (pairs with the reader's acquire fence).
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++)
+        {
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        }
+        slot.stamp.store(2 * seq + 2, std::memory_order_release);
+        mPublished.store(seq + 1, std::memory_order_release);
+    }
+
+    /** @brief Number of values published so far; the next one gets this sequence number. */
+    uint64_t published() const { return mPublished.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Copies the value with sequence number `seq` (0-based). Any thread; wait-free.
+     * @return OK, or why `out` was not written.
+     */
+    ReadResult tryRead(const uint64_t seq, T& out) const
+    {
+        if (seq >= published())
+        {
+            return ReadResult::NOT_YET;
+        }
+        const Slot& slot = mSlots[seq & mMask];
+        const uint64_t stamp = slot.stamp.load(std::memory_order_acquire);
+        if (stamp != 2 * seq + 2)
+        {
+            return ReadResult::LAPPED;
+        }
+        uint64_t words[WORDS];
+        for (size_t i = 0; i < WORDS; i++)
+        {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        // Keeps the word loads above from moving below the second stamp load.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.stamp.load(std::memory_order_relaxed) != stamp)
+        {
+            return ReadResult::LAPPED;
+        }
+        std::memcpy(&out, words, sizeof(T));
+        return ReadResult::OK;
+    }
+
+private:
+    const size_t mMask;
+    std::unique_ptr<Slot[]> mSlots;
+    uint64_t mNext{0}; ///< Producer only
+    alignas(CACHE_LINE) std::atomic<uint64_t> mPublished{0};
+};
+
+#endif //BROADCASTRING_H
@@ -0,0 +1,154 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef EPOCHDOMAIN_H
+#define EPOCHDOMAIN_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * @class EpochDomain
+ * @brief Minimal epoch-based reclamation for read-mostly, copy-on-write structures.
+ *
+ * Readers announce the current global epoch in a per-thread, cache-line sized slot before loading a
+ * shared pointer, and clear it when they are done. A writer that replaces a published object tags the
+ * old one with the epoch at which it was unlinked and frees it only once every active reader has
+ * announced a later epoch.
+ *
+ * @details
+ * - Entering/leaving a read section is two stores into the reader's own slot: readers never write a
+ *   shared cache line and never wait on writers (wait-free).
+ * - A thread claims a slot the first time it reads from a domain and releases it when it exits.
+ * - Writers must be serialised externally; the domain only answers "is it safe to free this yet".
+ */
+class EpochDomain {
+public:
+    static constexpr size_t MAX_READERS = 512; ///< Max threads reading concurrently from one domain
+    static constexpr uint64_t IDLE = std::numeric_limits<uint64_t>::max(); ///< Slot not in a read section
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<uint64_t> epoch{IDLE};
+        std::atomic<bool> used{false};
+    };
+
+    /** @brief Slots claimed by the calling thread, released when the thread exits. */
+    struct ThreadSlots
+    {
+        std::vector<std::pair<const EpochDomain*, Slot*>> slots;
+        ~ThreadSlots()
+        {
+            for (auto& [_, slot] : slots)
+            {
+                slot->epoch.store(IDLE, std::memory_order_release);
+                slot->used.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    alignas(64) std::atomic<uint64_t> mGlobalEpoch{1};
+    Slot mSlots[MAX_READERS];
+
+    Slot* threadSlot()
+    {
+        thread_local ThreadSlots owned;
+        thread_local const EpochDomain* lastDomain = nullptr;
+        thread_local Slot* lastSlot = nullptr;
+
+        if (lastDomain == this)
+        {
+            return lastSlot;
+        }
+        for (auto& [domain, slot] : owned.slots)
+        {
+            if (domain == this)
+            {
+                lastDomain = this;
+                lastSlot = slot;
+                return slot;
+            }
+        }
+        for (auto& slot : mSlots)
+        {
+            bool expected = false;
+            if (!slot.used.load(std::memory_order_relaxed) &&
+                slot.used.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+            {
+                owned.slots.emplace_back(this, &slot);
+                lastDomain = this;
+                lastSlot = &slot;
+                return &slot;
+            }
+        }
+        throw std::runtime_error("EpochDomain: more than MAX_READERS concurrent reader threads");
+    }
+
+public:
+    /**
+     * @class Guard
+     * @brief RAII read section. Objects loaded while the guard is alive stay valid until it is destroyed.
+     */
+    class Guard
+    {
+        Slot* mSlot;
+    public:
+        explicit Guard(Slot* slot) : mSlot(slot) {}
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard()
+        {
+            mSlot->epoch.store(IDLE, std::memory_order_release);
+        }
+    };
+
+    EpochDomain() = default;
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    /**
+     * @brief Enters a read section.
+     * @remarks Not re-entrant: a thread must not nest read sections of the same domain.
+     */
+    [[nodiscard]] Guard enter()
+    {
+        Slot* slot = threadSlot();
+        // seq_cst: the announcement must be visible before the caller loads the protected pointer.
+        slot->epoch.store(mGlobalEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+        return Guard(slot);
+    }
+
+    /**
+     * @brief Called by a writer right after unlinking an object.
+     * @return Retire epoch to pass to isSafeToFree() for that object.
+     */
+    uint64_t retire()
+    {
+        return mGlobalEpoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief True when no reader can still hold an object retired at `retireEpoch`.
+     */
+    bool isSafeToFree(const uint64_t retireEpoch) const
+    {
+        for (const auto& slot : mSlots)
+        {
+            if (slot.epoch.load(std::memory_order_seq_cst) <= retireEpoch)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+#endif //EPOCHDOMAIN_H
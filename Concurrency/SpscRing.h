@@ -0,0 +1,129 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @class SpscRing
+ * @brief Bounded, lock-free single-producer / single-consumer queue of trivially copyable values.
+ *
+ * @details
+ * - Capacity is a power of two fixed at construction; the slots are allocated once, so pushing and
+ *   popping never allocate.
+ * - `head` (written by the producer) and `tail` (written by the consumer) live on their own cache
+ *   lines. Each side also keeps a private copy of the other side's counter and only reloads the
+ *   shared one when its copy says the ring is full (producer) or empty (consumer), so in steady state
+ *   the two threads do not exchange a cache line per element.
+ * - tryPush() fails instead of waiting when the ring is full; what to do then is the caller's policy.
+ *
+ * @tparam T Element type, copied in and out with plain assignment.
+ */
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements are copied without constructors");
+
+public:
+    static constexpr size_t CACHE_LINE = 64;
+
+    /** @throws std::invalid_argument unless `capacity` is a power of two >= 2. */
+    explicit SpscRing(const size_t capacity) : mMask(capacity - 1), mSlots(std::make_unique<T[]>(capacity))
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+        {
+            throw std::invalid_argument("SpscRing: capacity must be a power of two >= 2");
+        }
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * @brief Appends a value. Producer thread only.
+     * @return false if the ring is full; nothing was written.
+     */
+    bool tryPush(const T& value) noexcept
+    {
+        const uint64_t head = mProducer.head;
+        if (head - mProducer.cachedTail > mMask)
+        {
+            mProducer.cachedTail = mTail.load(std::memory_order_acquire);
+            if (head - mProducer.cachedTail > mMask)
+            {
+                return false;
+            }
+        }
+        mSlots[head & mMask] = value;
+        mProducer.head = head + 1;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Hands every element available right now, at most `max`, to `f` in order. Consumer thread only.
+     * @return Number of elements consumed.
+     */
+    template <typename F>
+    size_t drain(F&& f, const size_t max = SIZE_MAX)
+    {
+        uint64_t tail = mConsumer.tail;
+        if (tail == mConsumer.cachedHead)
+        {
+            mConsumer.cachedHead = mHead.load(std::memory_order_acquire);
+            if (tail == mConsumer.cachedHead)
+            {
+                return 0;
+            }
+        }
+        const uint64_t end = mConsumer.cachedHead - tail > max ? tail + max : mConsumer.cachedHead;
+        const size_t n = end - tail;
+        for (; tail != end; tail++)
+        {
+            f(mSlots[tail & mMask]);
+        }
+        // One release for the whole batch: the producer sees the slots free only once all are read.
+        mConsumer.tail = tail;
+        mTail.store(tail, std::memory_order_release);
+        return n;
+    }
+
+    /** @brief True if nothing is waiting. Exact on the consumer thread, a snapshot elsewhere. */
+    bool empty() const noexcept
+    {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const noexcept { return mMask + 1; }
+
+private:
+    struct alignas(CACHE_LINE) ProducerState
+    {
+        uint64_t head{0};       ///< Next slot to write
+        uint64_t cachedTail{0}; ///< Last tail seen, refreshed when the ring looks full
+    };
+
+    struct alignas(CACHE_LINE) ConsumerState
+    {
+        uint64_t tail{0};       ///< Next slot to read
+        uint64_t cachedHead{0}; ///< Last head seen, refreshed when the ring looks empty
+    };
+
+    const uint64_t mMask;
+    std::unique_ptr<T[]> mSlots;
+    alignas(CACHE_LINE) std::atomic<uint64_t> mHead{0}; ///< Published by the producer
+    alignas(CACHE_LINE) std::atomic<uint64_t> mTail{0}; ///< Published by the consumer
+    ProducerState mProducer;
+    ConsumerState mConsumer;
+};
+
+#endif //SPSCRING_H
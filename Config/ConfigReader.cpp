@@ -43,6 +43,27 @@ size_t ConfigReader::GetRequiredElementSizeT(const XMLElement* parent, const cha
     }
 }
 
+size_t ConfigReader::GetOptionalElementSizeT(const XMLElement* parent, const char* childName,
+                                             const size_t defaultValue)
+{
+    if (!parent || !parent->FirstChildElement(childName))
+    {
+        return defaultValue;
+    }
+    return GetRequiredElementSizeT(parent, childName);
+}
+
+std::string ConfigReader::GetOptionalElementText(const XMLElement* parent, const char* childName,
+                                                const std::string& defaultValue)
+{
+    const XMLElement* child = parent ? parent->FirstChildElement(childName) : nullptr;
+    if (!child || !child->GetText())
+    {
+        return defaultValue;
+    }
+    return child->GetText();
+}
+
 ConfigReader::Config ConfigReader::LoadConfig(const std::string& path)
 {
     XMLDocument doc;
@@ -70,6 +91,7 @@ ConfigReader::Config ConfigReader::LoadConfig(const std::string& path)
 
     config.obWorkerPrefix = GetRequiredElementText(obsConfig, "WorkerPrefix");
     config.obWorkerCnt = GetRequiredElementSizeT(obsConfig, "WorkerCount");
+    config.obWorkerBatchSize = GetOptionalElementSizeT(obsConfig, "MaxBatchSize", config.obWorkerBatchSize);
 
     // --- OrderInjectorScheduler Configuration ---
     const XMLElement* oisConfig = root->FirstChildElement("OrderInjectorScheduler");
@@ -80,6 +102,110 @@ ConfigReader::Config ConfigReader::LoadConfig(const std::string& path)
 
     config.oiWorkerPrefix = GetRequiredElementText(oisConfig, "WorkerPrefix");
     config.oiWorkerCnt = GetRequiredElementSizeT(oisConfig, "WorkerCount");
+    config.oiWorkerBatchSize = GetOptionalElementSizeT(oisConfig, "MaxBatchSize", config.oiWorkerBatchSize);
+
+    // --- Optional platform settings ---
+    config.numaAware = GetOptionalElementSizeT(root, "NumaAware", config.numaAware ? 1 : 0) != 0;
+
+    // --- Optional order entry gateway ---
+    if (const XMLElement* gwConfig = root->FirstChildElement("Gateway"))
+    {
+        config.gatewayAddress = GetOptionalElementText(gwConfig, "Address", config.gatewayAddress);
+        config.gatewayIoBackend = GetOptionalElementText(gwConfig, "IoBackend", config.gatewayIoBackend);
+        config.gatewaySqPoll = GetOptionalElementSizeT(gwConfig, "SqPoll", config.gatewaySqPoll ? 1 : 0) != 0;
+    }
+
+    // --- Optional shared-memory ingress ---
+    if (const XMLElement* shmConfig = root->FirstChildElement("SharedMemory"))
+    {
+        config.shmName = GetOptionalElementText(shmConfig, "Name", config.shmName);
+        config.shmClients = GetOptionalElementSizeT(shmConfig, "Clients", config.shmClients);
+        config.shmRingSlots = GetOptionalElementSizeT(shmConfig, "RingSlots", config.shmRingSlots);
+    }
+
+    // --- Optional execution report stream ---
+    if (const XMLElement* reportConfig = root->FirstChildElement("Reports"))
+    {
+        config.reportRingSlots = GetOptionalElementSizeT(reportConfig, "RingSlots", config.reportRingSlots);
+        config.reportConsumers = GetOptionalElementSizeT(reportConfig, "Consumers", config.reportConsumers);
+    }
+
+    // --- Optional market data ---
+    if (const XMLElement* mdConfig = root->FirstChildElement("MarketData"))
+    {
+        config.depthFeed = GetOptionalElementSizeT(mdConfig, "Depth", config.depthFeed ? 1 : 0) != 0;
+        config.depthConflationUs = GetOptionalElementSizeT(mdConfig, "ConflationMicros", config.depthConflationUs);
+        config.depthRingSlots = GetOptionalElementSizeT(mdConfig, "RingSlots", config.depthRingSlots);
+        config.orderFeedPath = GetOptionalElementText(mdConfig, "OrderFeedFile", config.orderFeedPath);
+        config.orderFeedRingSlots = GetOptionalElementSizeT(mdConfig, "OrderFeedRingSlots", config.orderFeedRingSlots);
+        config.barIntervalMs = GetOptionalElementSizeT(mdConfig, "BarIntervalMillis", config.barIntervalMs);
+        config.barRingSlots = GetOptionalElementSizeT(mdConfig, "BarRingSlots", config.barRingSlots);
+    }
+
+    // --- Optional metrics export ---
+    if (const XMLElement* metricsConfig = root->FirstChildElement("Metrics"))
+    {
+        config.metricsFile = GetOptionalElementText(metricsConfig, "File", config.metricsFile);
+        config.metricsListen = GetOptionalElementText(metricsConfig, "Listen", config.metricsListen);
+        config.metricsPeriodMs = GetOptionalElementSizeT(metricsConfig, "PeriodMillis", config.metricsPeriodMs);
+    }
+
+    // --- Optional write-ahead journal ---
+    if (const XMLElement* journalConfig = root->FirstChildElement("Journal"))
+    {
+        config.journalDir = GetOptionalElementText(journalConfig, "Directory", config.journalDir);
+        config.journalDurability = GetOptionalElementText(journalConfig, "Durability", config.journalDurability);
+        config.journalSegmentBytes = GetOptionalElementSizeT(journalConfig, "SegmentBytes", config.journalSegmentBytes);
+        config.journalGroupCommitUs = GetOptionalElementSizeT(journalConfig, "GroupCommitMicros",
+                                                              config.journalGroupCommitUs);
+        config.journalGroupCommitBytes = GetOptionalElementSizeT(journalConfig, "GroupCommitBytes",
+                                                                 config.journalGroupCommitBytes);
+    }
+
+    // --- Optional book snapshots ---
+    if (const XMLElement* snapshotConfig = root->FirstChildElement("Snapshot"))
+    {
+        config.snapshotDir = GetOptionalElementText(snapshotConfig, "Directory", config.snapshotDir);
+        config.snapshotIntervalSec = GetOptionalElementSizeT(snapshotConfig, "IntervalSeconds",
+                                                             config.snapshotIntervalSec);
+        config.snapshotKeep = GetOptionalElementSizeT(snapshotConfig, "Keep", config.snapshotKeep);
+    }
+
+    // --- Optional per-symbol reference data ---
+    if (const XMLElement* refConfig = root->FirstChildElement("ReferenceData"))
+    {
+        for (const XMLElement* inst = refConfig->FirstChildElement("Instrument"); inst;
+             inst = inst->NextSiblingElement("Instrument"))
+        {
+            InstrumentSpec spec;
+            spec.tickSize = static_cast<Price>(GetOptionalElementSizeT(inst, "TickSize", spec.tickSize));
+            spec.lotSize = GetOptionalElementSizeT(inst, "LotSize", spec.lotSize);
+            spec.minQty = GetOptionalElementSizeT(inst, "MinQty", spec.minQty);
+            spec.maxQty = GetOptionalElementSizeT(inst, "MaxQty", spec.maxQty);
+            spec.bandBps = static_cast<uint32_t>(GetOptionalElementSizeT(inst, "BandBps", spec.bandBps));
+            spec.referencePrice = static_cast<Price>(GetOptionalElementSizeT(inst, "ReferencePrice", spec.referencePrice));
+            config.instruments[GetRequiredElementText(inst, "Symbol")] = spec;
+        }
+    }
+
+    // --- Optional per-account pre-trade risk limits ---
+    if (const XMLElement* riskConfig = root->FirstChildElement("Risk"))
+    {
+        for (const XMLElement* acc = riskConfig->FirstChildElement("Account"); acc;
+             acc = acc->NextSiblingElement("Account"))
+        {
+            const auto limit = [acc](const char* name)
+            {
+                const size_t v = GetOptionalElementSizeT(acc, name, RiskLimits::UNLIMITED);
+                return static_cast<int64_t>(std::min<size_t>(v, RiskLimits::UNLIMITED));
+            };
+            RiskLimits limits;
+            limits.maxNotional = limit("MaxNotional");
+            limits.maxOpenOrders = limit("MaxOpenOrders");
+            limits.maxPosition = limit("MaxPosition");
+            config.accounts[static_cast<AccountId>(GetRequiredElementSizeT(acc, "Id"))] = limits;
+        }
+    }
 
     return config;
 }
@@ -8,7 +8,10 @@
 #include <stdexcept>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
 #include "tinyxml2.h"
+#include "../OrderBook/ReferenceData.h"
+#include "../Risk/PreTradeRisk.h"
 #ifndef CONFIGREADER_H
 #define CONFIGREADER_H
 
@@ -35,14 +38,62 @@ class ConfigReader {
   */
  static size_t GetRequiredElementSizeT(const tinyxml2::XMLElement* parent, const char* childName);
 
+ /**
+  * @brief Helper function to get an optional integer value from a child element.
+  * @param parent The parent XML element.
+  * @param childName The name of the optional child element.
+  * @param defaultValue Value returned when the element is absent.
+  * @return The integer value of the child element, or `defaultValue`.
+  */
+ static size_t GetOptionalElementSizeT(const tinyxml2::XMLElement* parent, const char* childName,
+                                       size_t defaultValue);
+
+ /**
+  * @brief Helper function to get an optional element's text from a parent XML element.
+  * @return The text content of the child element, or `defaultValue` when absent or empty.
+  */
+ static std::string GetOptionalElementText(const tinyxml2::XMLElement* parent, const char* childName,
+                                           const std::string& defaultValue);
+
 public:
  // Configuration structure for the application
  struct Config
  {
   std::string obWorkerPrefix;
   size_t obWorkerCnt;
+  size_t obWorkerBatchSize{1}; ///< Max tasks an order book worker drains per lock (1 = no batching)
   std::string oiWorkerPrefix;
   size_t oiWorkerCnt;
+  size_t oiWorkerBatchSize{1}; ///< Max tasks an injector worker drains per lock (1 = no batching)
+  bool numaAware{true}; ///< Bind workers to NUMA nodes at startup (no-op on single-node hosts)
+  std::string gatewayAddress; ///< Order entry gateway endpoint (`unix:<path>` or `tcp:<host>:<port>`), empty = disabled
+  std::string gatewayIoBackend{"auto"}; ///< Gateway socket backend: `auto`, `epoll` or `io_uring`
+  bool gatewaySqPoll{false}; ///< io_uring kernel-side submission polling (costs a kernel thread per gateway)
+  std::string shmName; ///< Shared-memory ingress region name (e.g. `/ome-ingress`), empty = disabled
+  size_t shmClients{8}; ///< Rings in the shared-memory region, one per client
+  size_t shmRingSlots{4096}; ///< Messages per ring
+  size_t reportRingSlots{65536}; ///< Execution reports buffered per book worker, a power of two
+  size_t reportConsumers{1}; ///< Threads delivering execution reports, 0 = book workers deliver them directly
+  bool depthFeed{false}; ///< Publish L2 price level updates to gateway sessions (needs the gateway)
+  size_t depthConflationUs{1000}; ///< L2 conflation window in microseconds, 0 = publish as fast as drained
+  size_t depthRingSlots{65536}; ///< L2 updates buffered per book worker, a power of two
+  std::string orderFeedPath; ///< File the L3 order events are written to, empty = disabled
+  size_t orderFeedRingSlots{65536}; ///< L3 events buffered per book worker, a power of two
+  size_t barIntervalMs{0}; ///< OHLCV bar length in milliseconds, 0 = no bars
+  size_t barRingSlots{4096}; ///< Completed bars kept per book worker for readers, a power of two
+  std::string metricsFile; ///< Prometheus text file rewritten every metricsPeriodMs, empty = none
+  std::string metricsListen; ///< Endpoint serving the metrics over HTTP (e.g. `tcp:127.0.0.1:9464`), empty = none
+  size_t metricsPeriodMs{1000}; ///< How often metricsFile is rewritten
+  std::string journalDir; ///< Directory of the write-ahead journal, empty = no journal
+  std::string journalDurability{"sync"}; ///< When a message may reach its book: `async` (written) or `sync` (fdatasync'ed)
+  size_t journalSegmentBytes{64 << 20}; ///< Size of each preallocated journal segment file
+  size_t journalGroupCommitUs{200}; ///< Longest a journaled message waits for its fdatasync
+  size_t journalGroupCommitBytes{256 << 10}; ///< Unsynced bytes of a shard that trigger an early fdatasync
+  std::string snapshotDir; ///< Directory of the book snapshots, empty = none (needs the journal)
+  size_t snapshotIntervalSec{60}; ///< Seconds between two snapshots of every book, 0 = only at shutdown
+  size_t snapshotKeep{2}; ///< Snapshots kept per book worker
+  std::unordered_map<Symbol, InstrumentSpec> instruments; ///< Reference data by symbol, unlisted symbols use the defaults
+  std::unordered_map<AccountId, RiskLimits> accounts; ///< Pre-trade limits by account, unlisted accounts are not checked
  };
  static Config LoadConfig(const std::string& path);
 };
@@ -0,0 +1,152 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "Endpoint.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    [[noreturn]] void throwErrno(const std::string& what, const int fd)
+    {
+        const int err = errno;
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        throw std::runtime_error(what + ": " + std::strerror(err));
+    }
+
+    sockaddr_un unixAddress(const std::string& path)
+    {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path))
+        {
+            throw std::invalid_argument("Endpoint: unix socket path too long: " + path);
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return addr;
+    }
+
+    sockaddr_in tcpAddress(const std::string& host, const uint16_t port)
+    {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1)
+        {
+            throw std::invalid_argument("Endpoint: not a numeric IPv4 address: " + host);
+        }
+        return addr;
+    }
+}
+
+Endpoint Endpoint::Parse(const std::string& spec)
+{
+    Endpoint ep;
+    if (spec.rfind("unix:", 0) == 0 && spec.size() > 5)
+    {
+        ep.kind = Kind::UNIX;
+        ep.path = spec.substr(5);
+        return ep;
+    }
+    if (spec.rfind("tcp:", 0) == 0)
+    {
+        const auto colon = spec.rfind(':');
+        if (colon > 4)
+        {
+            ep.kind = Kind::TCP;
+            ep.host = spec.substr(4, colon - 4);
+            const unsigned long port = std::stoul(spec.substr(colon + 1));
+            if (port == 0 || port > 65535)
+            {
+                throw std::invalid_argument("Endpoint: bad port in " + spec);
+            }
+            ep.port = static_cast<uint16_t>(port);
+            return ep;
+        }
+    }
+    throw std::invalid_argument("Endpoint: expected unix:<path> or tcp:<host>:<port>, got " + spec);
+}
+
+int Endpoint::listen(const int backlog) const
+{
+    int fd = -1;
+    if (kind == Kind::UNIX)
+    {
+        const sockaddr_un addr = unixAddress(path);
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            throwErrno("Endpoint: socket", fd);
+        }
+        ::unlink(path.c_str()); // left behind by a previous run
+        if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            throwErrno("Endpoint: bind " + toString(), fd);
+        }
+    }
+    else
+    {
+        const sockaddr_in addr = tcpAddress(host, port);
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            throwErrno("Endpoint: socket", fd);
+        }
+        constexpr int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            throwErrno("Endpoint: bind " + toString(), fd);
+        }
+    }
+    if (::listen(fd, backlog) != 0)
+    {
+        throwErrno("Endpoint: listen " + toString(), fd);
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+int Endpoint::connect() const
+{
+    int fd = -1;
+    if (kind == Kind::UNIX)
+    {
+        const sockaddr_un addr = unixAddress(path);
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            throwErrno("Endpoint: connect " + toString(), fd);
+        }
+    }
+    else
+    {
+        const sockaddr_in addr = tcpAddress(host, port);
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            throwErrno("Endpoint: connect " + toString(), fd);
+        }
+        constexpr int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+std::string Endpoint::toString() const
+{
+    return kind == Kind::UNIX ? "unix:" + path : "tcp:" + host + ":" + std::to_string(port);
+}
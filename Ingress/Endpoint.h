@@ -0,0 +1,49 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef ENDPOINT_H
+#define ENDPOINT_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @struct Endpoint
+ * @brief Local stream socket address: a Unix domain socket path or a TCP host/port.
+ *
+ * Written as `unix:/tmp/ome.sock` or `tcp:127.0.0.1:9000` in configuration and on command lines.
+ */
+struct Endpoint
+{
+    enum class Kind { UNIX, TCP };
+
+    Kind kind{Kind::UNIX};
+    std::string path; ///< UNIX
+    std::string host; ///< TCP, numeric IPv4
+    uint16_t port{0}; ///< TCP
+
+    /**
+     * @brief Parses `unix:<path>` or `tcp:<host>:<port>`.
+     * @throws std::invalid_argument on any other form.
+     */
+    static Endpoint Parse(const std::string& spec);
+
+    /**
+     * @brief Creates a non-blocking listening socket. A stale Unix socket file is replaced.
+     * @throws std::runtime_error if the socket cannot be bound.
+     */
+    int listen(int backlog = 128) const;
+
+    /**
+     * @brief Connects a blocking client socket (TCP_NODELAY for TCP).
+     * @throws std::runtime_error if the connection fails.
+     */
+    int connect() const;
+
+    std::string toString() const;
+};
+
+#endif //ENDPOINT_H
@@ -0,0 +1,284 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "EpollBackend.h"
+
+#ifdef __linux__
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    // epoll user data of the two non-connection descriptors; connection ids start at 1.
+    constexpr uint64_t LISTEN_TAG = 0;
+    constexpr uint64_t WAKE_TAG = ~uint64_t{0};
+
+    constexpr int MAX_EVENTS = 256;
+}
+
+EpollBackend::EpollBackend(const Options& options)
+    : mOptions(options)
+{
+    mEpollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    mWakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (mEpollFd < 0 || mWakeFd < 0)
+    {
+        const std::string err = std::strerror(errno);
+        shutdown();
+        throw std::runtime_error("EpollBackend: epoll/eventfd: " + err);
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_TAG;
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mWakeFd, &ev);
+}
+
+EpollBackend::~EpollBackend()
+{
+    shutdown();
+}
+
+void EpollBackend::open(const int listenFd, Handler& handler)
+{
+    mListenFd = listenFd;
+    mHandler = &handler;
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = LISTEN_TAG;
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, mListenFd, &ev);
+}
+
+void EpollBackend::wake()
+{
+    constexpr uint64_t one = 1;
+    [[maybe_unused]] const auto n = ::write(mWakeFd, &one, sizeof(one));
+}
+
+void EpollBackend::run(const std::atomic<bool>& running)
+{
+    epoll_event events[MAX_EVENTS];
+    while (running.load(std::memory_order_relaxed))
+    {
+        const int n = ::epoll_wait(mEpollFd, events, MAX_EVENTS, -1);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "[EpollBackend]: epoll_wait: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        for (int i = 0; i < n; i++)
+        {
+            const uint64_t tag = events[i].data.u64;
+            if (tag == LISTEN_TAG)
+            {
+                acceptAll();
+            }
+            else if (tag == WAKE_TAG)
+            {
+                uint64_t ignored;
+                [[maybe_unused]] const auto r = ::read(mWakeFd, &ignored, sizeof(ignored));
+                mHandler->onWake();
+            }
+            else
+            {
+                if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                {
+                    readAll(tag);
+                }
+                const auto it = mConns.find(tag);
+                if (it != mConns.end() && (events[i].events & EPOLLOUT))
+                {
+                    flush(tag, it->second);
+                }
+            }
+        }
+    }
+}
+
+void EpollBackend::acceptAll()
+{
+    for (;;)
+    {
+        const int fd = ::accept4(mListenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                std::cerr << "[EpollBackend]: accept: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+        const ConnId id = mNextId++;
+        Conn& c = mConns[id];
+        c.fd = fd;
+        c.in.resize(mOptions.readBufferSize);
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        ev.data.u64 = id;
+        ::epoll_ctl(mEpollFd, EPOLL_CTL_ADD, fd, &ev);
+        mHandler->onAccept(id, fd);
+    }
+}
+
+void EpollBackend::readAll(const ConnId id)
+{
+    for (;;)
+    {
+        // The handler may close the connection from onData(), so look it up on every pass.
+        const auto it = mConns.find(id);
+        if (it == mConns.end())
+        {
+            return;
+        }
+        Conn& c = it->second;
+        if (c.inLen == c.in.size())
+        {
+            std::cerr << "[EpollBackend]: connection " << id << " overflowed its read buffer, closing" << std::endl;
+            drop(id, true);
+            return;
+        }
+        const ssize_t n = ::recv(c.fd, c.in.data() + c.inLen, c.in.size() - c.inLen, 0);
+        if (n == 0)
+        {
+            drop(id, true); // orderly shutdown by the peer
+            return;
+        }
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                drop(id, true);
+            }
+            return;
+        }
+        c.inLen += static_cast<size_t>(n);
+
+        const size_t consumed = mHandler->onData(id, c.in.data(), c.inLen);
+        const auto again = mConns.find(id);
+        if (again == mConns.end())
+        {
+            return;
+        }
+        Conn& cc = again->second;
+        std::memmove(cc.in.data(), cc.in.data() + consumed, cc.inLen - consumed);
+        cc.inLen -= consumed;
+    }
+}
+
+void EpollBackend::write(const ConnId id, const char* data, const size_t len)
+{
+    const auto it = mConns.find(id);
+    if (it == mConns.end())
+    {
+        return;
+    }
+    it->second.out.append(data, len);
+    flush(id, it->second);
+}
+
+size_t EpollBackend::pendingOutput(const ConnId id) const
+{
+    const auto it = mConns.find(id);
+    return it == mConns.end() ? 0 : it->second.out.size();
+}
+
+void EpollBackend::flush(const ConnId id, Conn& c)
+{
+    size_t sent = 0;
+    bool failed = false;
+    while (sent < c.out.size())
+    {
+        const ssize_t n = ::send(c.fd, c.out.data() + sent, c.out.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0)
+        {
+            sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        failed = n < 0 && errno != EAGAIN && errno != EWOULDBLOCK;
+        break;
+    }
+    if (failed)
+    {
+        drop(id, true);
+        return;
+    }
+    c.out.erase(0, sent);
+    setWantWrite(id, c, !c.out.empty());
+}
+
+void EpollBackend::setWantWrite(const ConnId id, Conn& c, const bool on) const
+{
+    if (c.wantWrite == on)
+    {
+        return;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (on ? EPOLLOUT : 0u);
+    ev.data.u64 = id;
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_MOD, c.fd, &ev);
+    c.wantWrite = on;
+}
+
+void EpollBackend::close(const ConnId id)
+{
+    drop(id, false);
+}
+
+void EpollBackend::drop(const ConnId id, const bool notify)
+{
+    const auto it = mConns.find(id);
+    if (it == mConns.end())
+    {
+        return;
+    }
+    ::epoll_ctl(mEpollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    ::close(it->second.fd);
+    mConns.erase(it);
+    if (notify)
+    {
+        mHandler->onClose(id);
+    }
+}
+
+void EpollBackend::shutdown()
+{
+    for (const auto& [_, c] : mConns)
+    {
+        ::close(c.fd);
+    }
+    mConns.clear();
+    for (int* fd : {&mListenFd, &mWakeFd, &mEpollFd})
+    {
+        if (*fd >= 0)
+        {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+#endif // __linux__
@@ -0,0 +1,66 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef EPOLLBACKEND_H
+#define EPOLLBACKEND_H
+
+#include "IoBackend.h"
+
+#ifdef __linux__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class EpollBackend
+ * @brief IoBackend on an edge-triggered epoll loop with an eventfd for wake-ups.
+ *
+ * Each readable connection is read until EAGAIN; output is sent immediately and whatever the socket
+ * does not take is kept and sent on EPOLLOUT.
+ */
+class EpollBackend final : public IoBackend {
+public:
+    explicit EpollBackend(const Options& options);
+    ~EpollBackend() override;
+
+    const char* name() const override { return "epoll"; }
+    void open(int listenFd, Handler& handler) override;
+    void run(const std::atomic<bool>& running) override;
+    void wake() override;
+    void write(ConnId id, const char* data, size_t len) override;
+    size_t pendingOutput(ConnId id) const override;
+    void close(ConnId id) override;
+    void shutdown() override;
+
+private:
+    struct Conn
+    {
+        int fd{-1};
+        std::vector<char> in;
+        size_t inLen{0};
+        std::string out;        ///< Not yet accepted by the socket
+        bool wantWrite{false};  ///< EPOLLOUT armed
+    };
+
+    Options mOptions;
+    Handler* mHandler{nullptr};
+    int mListenFd{-1};
+    int mEpollFd{-1};
+    int mWakeFd{-1};
+    ConnId mNextId{1};
+    std::unordered_map<ConnId, Conn> mConns;
+
+    void acceptAll();
+    void readAll(ConnId id);
+    void flush(ConnId id, Conn& c);
+    void setWantWrite(ConnId id, Conn& c, bool on) const;
+    void drop(ConnId id, bool notify);
+};
+
+#endif // __linux__
+
+#endif //EPOLLBACKEND_H
@@ -0,0 +1,68 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef FRAMING_H
+#define FRAMING_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "../Codec/BinaryCodec.h"
+
+/**
+ * @class Framing
+ * @brief Length-prefixed framing used on stream transports (gateway sockets).
+ *
+ * Each frame is a u32 little-endian payload length followed by the payload. Requests carry any
+ * wire format the injector decodes; responses carry encoded execution reports.
+ */
+class Framing {
+public:
+    static constexpr size_t HEADER_SIZE = 4;
+    static constexpr size_t MAX_PAYLOAD = 16 * 1024; ///< Larger frames are a protocol error
+
+    enum class Status
+    {
+        OK,         ///< `payload` holds the next frame, `p` moved past it
+        INCOMPLETE, ///< Not enough bytes for a whole frame yet
+        OVERSIZED   ///< Declared length above MAX_PAYLOAD, the stream cannot be resynchronised
+    };
+
+    /** @brief Appends one frame holding `payload` to `out`. */
+    static void append(std::string& out, const std::string_view payload)
+    {
+        uint8_t header[HEADER_SIZE];
+        BinaryCodec::store<uint32_t>(header, static_cast<uint32_t>(payload.size()));
+        out.append(reinterpret_cast<const char*>(header), HEADER_SIZE);
+        out.append(payload);
+    }
+
+    /**
+     * @brief Extracts the frame starting at `p`.
+     * @param[in,out] p Read position, advanced past the frame on OK.
+     */
+    static Status next(const char*& p, const char* end, std::string_view& payload) noexcept
+    {
+        if(static_cast<size_t>(end - p) < HEADER_SIZE)
+        {
+            return Status::INCOMPLETE;
+        }
+        const auto len = BinaryCodec::load<uint32_t>(reinterpret_cast<const uint8_t*>(p));
+        if(len > MAX_PAYLOAD)
+        {
+            return Status::OVERSIZED;
+        }
+        if(static_cast<size_t>(end - p) - HEADER_SIZE < len)
+        {
+            return Status::INCOMPLETE;
+        }
+        payload = {p + HEADER_SIZE, len};
+        p += HEADER_SIZE + len;
+        return Status::OK;
+    }
+};
+
+#endif //FRAMING_H
@@ -0,0 +1,354 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "Gateway.h"
+#include "Framing.h"
+#include "../Scheduler/OrderInjectorScheduler.h"
+#include "../Metrics/LatencyHistogram.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr size_t MAX_PENDING_OUTPUT = 8 * 1024 * 1024; ///< Slow consumer limit per connection
+}
+
+Gateway::Gateway(Endpoint endpoint, std::shared_ptr<OrderInjectorScheduler> injectors, const IoBackend::Options io)
+    : mEndpoint(std::move(endpoint)), mInjectors(std::move(injectors)), mIoOptions(io)
+{
+}
+
+Gateway::~Gateway()
+{
+    stop();
+}
+
+size_t Gateway::sessionCount() const
+{
+    std::shared_lock<std::shared_mutex> rlk(mSessionsMtx);
+    return mSessions.size();
+}
+
+Gateway::ConnectionPtr Gateway::find(const SessionId session) const
+{
+    std::shared_lock<std::shared_mutex> rlk(mSessionsMtx);
+    const auto it = mSessions.find(session);
+    return it == mSessions.end() ? nullptr : it->second;
+}
+
+#ifdef __linux__
+
+void Gateway::start(ReportRouter& router, const SessionId sessionsAfter)
+{
+    if (mRunning)
+    {
+        return;
+    }
+    mBackend = IoBackend::Create(mIoOptions);
+    mBackend->open(mEndpoint.listen(), *this);
+
+    mRouter = &router;
+    mSource = router.registerSource(this);
+    mNextLocal = (sessionsAfter & ReportRouter::LOCAL_MASK) + 1;
+    mRunning = true;
+    mThread = std::thread([this] { mBackend->run(mRunning); });
+    std::cout << "Gateway listening on " << mEndpoint.toString() << " (" << mBackend->name() << ")" << std::endl;
+}
+
+void Gateway::stop()
+{
+    if (!mRunning.exchange(false))
+    {
+        return;
+    }
+    mBackend->wake();
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+    mRouter->unregisterSource(mSource);
+
+    std::vector<ConnectionPtr> open;
+    open.reserve(mConns.size());
+    for (const auto& [_, c] : mConns)
+    {
+        open.push_back(c);
+    }
+    for (const auto& c : open)
+    {
+        closeConnection(c, true);
+    }
+    mBackend->shutdown();
+    if (mEndpoint.kind == Endpoint::Kind::UNIX)
+    {
+        ::unlink(mEndpoint.path.c_str());
+    }
+}
+
+void Gateway::onAccept(const IoBackend::ConnId id, const int fd)
+{
+    if (mEndpoint.kind == Endpoint::Kind::TCP)
+    {
+        constexpr int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    auto c = std::make_shared<Connection>();
+    c->conn = id;
+    {
+        std::unique_lock<std::shared_mutex> wlk(mSessionsMtx);
+        do
+        {
+            c->session = ReportRouter::makeSession(mSource, mNextLocal++);
+        } while ((c->session & ReportRouter::LOCAL_MASK) == 0 || mSessions.contains(c->session));
+        mSessions.emplace(c->session, c);
+    }
+    mConns.emplace(id, std::move(c));
+}
+
+size_t Gateway::onData(const IoBackend::ConnId id, const char* data, const size_t len)
+{
+    const auto it = mConns.find(id);
+    if (it == mConns.end())
+    {
+        return len;
+    }
+    const ConnectionPtr c = it->second;
+
+    // Hand every complete frame of this read to the injectors as one batch.
+    const char* p = data;
+    const char* end = data + len;
+    std::string_view payload;
+    Framing::Status st;
+    while ((st = Framing::next(p, end, payload)) == Framing::Status::OK) {}
+    if (st == Framing::Status::OVERSIZED)
+    {
+        std::cerr << "[Gateway]: session " << c->session << " sent an oversized frame, closing" << std::endl;
+        closeConnection(c, true);
+        return 0;
+    }
+    const auto consumed = static_cast<size_t>(p - data);
+    if (consumed != 0)
+    {
+        mInjectors->processFrames(std::string(data, consumed), c->session, LatencyHistogram::nowNs());
+    }
+    return consumed;
+}
+
+void Gateway::onClose(const IoBackend::ConnId id)
+{
+    if (const auto it = mConns.find(id); it != mConns.end())
+    {
+        closeConnection(it->second, false);
+    }
+}
+
+void Gateway::onWake()
+{
+    std::vector<ConnectionPtr> pending;
+    {
+        std::lock_guard<std::mutex> lk(mPendingMtx);
+        pending.swap(mPending);
+    }
+    std::string out;
+    for (const auto& c : pending)
+    {
+        bool slow;
+        {
+            std::lock_guard<std::mutex> lk(c->outMtx);
+            c->queued = false;
+            if (c->closed)
+            {
+                continue;
+            }
+            slow = c->slow;
+            out.swap(c->out);
+        }
+        if (!slow)
+        {
+            mBackend->write(c->conn, out.data(), out.size());
+            slow = mBackend->pendingOutput(c->conn) >= MAX_PENDING_OUTPUT;
+        }
+        out.clear();
+        if (slow)
+        {
+            std::cerr << "[Gateway]: session " << c->session << " is not reading its reports or lost some, closing"
+                      << std::endl;
+            closeConnection(c, true);
+        }
+    }
+}
+
+void Gateway::closeConnection(const ConnectionPtr c, const bool closeInBackend)
+{
+    {
+        std::lock_guard<std::mutex> lk(c->outMtx);
+        if (c->closed)
+        {
+            return;
+        }
+        c->closed = true;
+    }
+    mConns.erase(c->conn);
+    {
+        std::unique_lock<std::shared_mutex> wlk(mSessionsMtx);
+        mSessions.erase(c->session);
+    }
+    if (closeInBackend)
+    {
+        mBackend->close(c->conn);
+    }
+}
+
+void Gateway::onReport(const ExecReport& report)
+{
+    ConnectionPtr c = find(report.session);
+    if (!c)
+    {
+        return;
+    }
+    if (report.type == ExecType::REPORTS_LOST)
+    {
+        // The client's view of its orders has a hole: treat it like one that stopped reading.
+        markSlow(std::move(c));
+        return;
+    }
+
+    uint8_t frame[Framing::HEADER_SIZE + BinaryCodec::EXEC_REPORT_SIZE];
+    BinaryCodec::store<uint32_t>(frame, static_cast<uint32_t>(BinaryCodec::EXEC_REPORT_SIZE));
+    BinaryCodec::encodeReport(report, frame + Framing::HEADER_SIZE, BinaryCodec::EXEC_REPORT_SIZE);
+    enqueue(std::move(c), frame, sizeof(frame));
+}
+
+void Gateway::onDepth(const DepthUpdate& update)
+{
+    uint8_t frame[Framing::HEADER_SIZE + BinaryCodec::DEPTH_UPDATE_SIZE];
+    BinaryCodec::store<uint32_t>(frame, static_cast<uint32_t>(BinaryCodec::DEPTH_UPDATE_SIZE));
+    BinaryCodec::encodeDepth(update, frame + Framing::HEADER_SIZE, BinaryCodec::DEPTH_UPDATE_SIZE);
+
+    // Copied out so the frame is queued without holding the sessions lock; reused between updates.
+    thread_local std::vector<ConnectionPtr> sessions;
+    sessions.clear();
+    {
+        std::shared_lock<std::shared_mutex> rlk(mSessionsMtx);
+        for (const auto& [_, c] : mSessions)
+        {
+            sessions.push_back(c);
+        }
+    }
+    for (auto& c : sessions)
+    {
+        enqueue(std::move(c), frame, sizeof(frame));
+    }
+    sessions.clear();
+}
+
+void Gateway::enqueue(ConnectionPtr c, const uint8_t* frame, const size_t len)
+{
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lk(c->outMtx);
+        if (c->closed)
+        {
+            return;
+        }
+        if (c->out.size() >= MAX_PENDING_OUTPUT)
+        {
+            // The client stopped reading: bound its backlog and let the I/O thread disconnect it.
+            c->slow = true;
+        }
+        else
+        {
+            c->out.append(reinterpret_cast<const char*>(frame), len);
+        }
+        if (!c->queued)
+        {
+            c->queued = true;
+            notify = true;
+        }
+    }
+    if (notify)
+    {
+        schedule(std::move(c));
+    }
+}
+
+void Gateway::markSlow(ConnectionPtr c)
+{
+    bool notify = false;
+    {
+        std::lock_guard<std::mutex> lk(c->outMtx);
+        if (c->closed)
+        {
+            return;
+        }
+        c->slow = true;
+        if (!c->queued)
+        {
+            c->queued = true;
+            notify = true;
+        }
+    }
+    if (notify)
+    {
+        schedule(std::move(c));
+    }
+}
+
+void Gateway::schedule(ConnectionPtr c)
+{
+    {
+        std::lock_guard<std::mutex> lk(mPendingMtx);
+        mPending.push_back(std::move(c));
+    }
+    mBackend->wake();
+}
+
+#else // !__linux__
+
+void Gateway::start(ReportRouter&, SessionId)
+{
+    throw std::runtime_error("Gateway: the order entry gateway is only available on Linux");
+}
+
+void Gateway::stop()
+{
+}
+
+void Gateway::onReport(const ExecReport&)
+{
+}
+
+void Gateway::onDepth(const DepthUpdate&)
+{
+}
+
+void Gateway::onAccept(IoBackend::ConnId, int)
+{
+}
+
+size_t Gateway::onData(IoBackend::ConnId, const char*, const size_t len)
+{
+    return len;
+}
+
+void Gateway::onClose(IoBackend::ConnId)
+{
+}
+
+void Gateway::onWake()
+{
+}
+
+#endif
@@ -0,0 +1,139 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "Endpoint.h"
+#include "IoBackend.h"
+#include "../Reports/ReportRouter.h"
+#include "../MarketData/DepthUpdate.h"
+
+class OrderInjectorScheduler;
+
+/**
+ * @class Gateway
+ * @brief Order entry gateway: accepts client connections on a local socket, feeds their messages to
+ * the injectors and writes execution reports back on the same connection.
+ *
+ * @details
+ * One I/O thread runs an IoBackend (io_uring, or edge-triggered epoll as fallback) over the
+ * listening socket and every client connection.
+ * - Inbound: the backend reads each connection into its own buffer. All complete frames (see
+ *   Framing) of a read are handed to the injectors as one batch, so the cost is one copy and one
+ *   task per read rather than per message. A partial frame stays in the buffer.
+ * - Outbound: the report stream's consumers (or the book workers, without a stream) and the
+ *   injectors call onReport() concurrently. The report is encoded into the session's
+ *   output buffer and, if that buffer was idle, the connection is queued and the I/O thread woken
+ *   to hand it to the backend. A client whose unsent backlog reaches 8 MiB is disconnected rather
+ *   than buffered without bound, and so is one whose reports the stream had to drop (an
+ *   ExecType::REPORTS_LOST marker): its view of its orders is no longer complete.
+ * - Market data: when it is given the L2 feed (see ConflatingPublisher), onDepth() appends every
+ *   price level update to every connected session, through the same buffers.
+ *
+ * Every connection is a session (see ReportRouter::makeSession); orders it sends are tagged with that
+ * session so fills of resting orders reach the connection that placed them.
+ *
+ * @remarks Linux only (epoll, io_uring). Elsewhere start() throws.
+ */
+class Gateway final : public IReportSink, public IDepthSink, private IoBackend::Handler {
+public:
+    Gateway(Endpoint endpoint, std::shared_ptr<OrderInjectorScheduler> injectors, IoBackend::Options io = {});
+
+    Gateway(const Gateway&) = delete;
+    Gateway& operator=(const Gateway&) = delete;
+
+    /** @brief Stops the I/O thread and closes every connection. */
+    ~Gateway() override;
+
+    /**
+     * @brief Registers with `router`, binds the endpoint and starts the I/O thread.
+     * @param sessionsAfter Sessions are numbered from sessionsAfter + 1: above every session orders
+     * restored from a snapshot or the journal are still tagged with (OrderBookScheduler::highestSession()),
+     * so a new connection never inherits the orders of one from before the restart.
+     * @throws std::runtime_error if the endpoint cannot be bound (or on non-Linux platforms).
+     */
+    void start(ReportRouter& router, SessionId sessionsAfter = NO_SESSION);
+
+    /** @brief Stops accepting, closes all connections and joins the I/O thread. Idempotent. */
+    void stop();
+
+    /** @brief Queues a report for its session's connection. Thread-safe; reports for closed sessions are dropped. */
+    void onReport(const ExecReport& report) override;
+
+    /** @brief Queues a price level update for every connected session. Thread-safe. */
+    void onDepth(const DepthUpdate& update) override;
+
+    /** @brief Number of connected sessions. */
+    size_t sessionCount() const;
+
+    /** @brief Name of the I/O backend in use, empty before start(). */
+    std::string backendName() const { return mBackend ? mBackend->name() : ""; }
+
+private:
+    struct Connection
+    {
+        IoBackend::ConnId conn{0};
+        SessionId session{NO_SESSION};
+
+        std::mutex outMtx;      ///< Guards out / queued / closed, taken by book workers and the I/O thread
+        std::string out;        ///< Encoded report frames not yet handed to the backend
+        bool queued{false};     ///< Already in mPending
+        bool closed{false};
+        bool slow{false};       ///< Output backlog hit its limit or reports were lost, the I/O thread disconnects it
+    };
+    using ConnectionPtr = std::shared_ptr<Connection>;
+
+    Endpoint mEndpoint;
+    std::shared_ptr<OrderInjectorScheduler> mInjectors;
+    IoBackend::Options mIoOptions;
+    std::unique_ptr<IoBackend> mBackend;
+    ReportRouter* mRouter{nullptr};
+    ReportRouter::SourceId mSource{0};
+
+    std::thread mThread;
+    std::atomic<bool> mRunning{false};
+    SessionId mNextLocal{1}; ///< I/O thread only
+    std::unordered_map<IoBackend::ConnId, ConnectionPtr> mConns; ///< I/O thread only
+
+    mutable std::shared_mutex mSessionsMtx;
+    std::unordered_map<SessionId, ConnectionPtr> mSessions;
+
+    std::mutex mPendingMtx;
+    std::vector<ConnectionPtr> mPending; ///< Connections with fresh output to flush
+
+    // IoBackend::Handler, I/O thread
+    void onAccept(IoBackend::ConnId id, int fd) override;
+    size_t onData(IoBackend::ConnId id, const char* data, size_t len) override;
+    void onClose(IoBackend::ConnId id) override;
+    void onWake() override;
+
+    /**
+     * @brief Forgets the connection; also closes it in the backend unless the backend reported the close.
+     * Takes `c` by value since the caller's reference may be the map entry erased here.
+     */
+    void closeConnection(ConnectionPtr c, bool closeInBackend);
+
+    /** @brief Appends one encoded frame to the connection's output and wakes the I/O thread if needed. */
+    void enqueue(ConnectionPtr c, const uint8_t* frame, size_t len);
+
+    /** @brief Has the I/O thread disconnect the connection, without queueing anything more to it. */
+    void markSlow(ConnectionPtr c);
+
+    /** @brief Queues the connection for the I/O thread and wakes it. */
+    void schedule(ConnectionPtr c);
+    ConnectionPtr find(SessionId session) const;
+};
+
+#endif //GATEWAY_H
@@ -0,0 +1,86 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "GatewayClient.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <unistd.h>
+
+GatewayClient::GatewayClient(const Endpoint& endpoint)
+    : mFd(endpoint.connect()), mIn(64 * 1024)
+{
+}
+
+GatewayClient::~GatewayClient()
+{
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+    }
+}
+
+void GatewayClient::appendMessage(std::string& out, const InboundMessage& m)
+{
+    uint8_t buf[BinaryCodec::MAX_MESSAGE_SIZE];
+    const size_t n = BinaryCodec::encode(m, buf, sizeof(buf));
+    Framing::append(out, {reinterpret_cast<const char*>(buf), n});
+}
+
+void GatewayClient::send(const std::string_view frames)
+{
+    size_t sent = 0;
+    while (sent < frames.size())
+    {
+#ifdef MSG_NOSIGNAL
+        const ssize_t n = ::send(mFd, frames.data() + sent, frames.size() - sent, MSG_NOSIGNAL);
+#else
+        const ssize_t n = ::send(mFd, frames.data() + sent, frames.size() - sent, 0);
+#endif
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error(std::string("GatewayClient: send: ") + std::strerror(errno));
+        }
+        sent += static_cast<size_t>(n);
+    }
+}
+
+void GatewayClient::shutdownWrite()
+{
+    ::shutdown(mFd, SHUT_WR);
+}
+
+void GatewayClient::disconnect()
+{
+    ::shutdown(mFd, SHUT_RDWR);
+}
+
+long GatewayClient::receive()
+{
+    for (;;)
+    {
+        const ssize_t n = ::recv(mFd, mIn.data() + mInLen, mIn.size() - mInLen, 0);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n > 0)
+        {
+            mInLen += static_cast<size_t>(n);
+        }
+        return static_cast<long>(n);
+    }
+}
+
+void GatewayClient::consume(const size_t n)
+{
+    std::memmove(mIn.data(), mIn.data() + n, mInLen - n);
+    mInLen -= n;
+}
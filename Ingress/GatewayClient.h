@@ -0,0 +1,89 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef GATEWAYCLIENT_H
+#define GATEWAYCLIENT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Endpoint.h"
+#include "Framing.h"
+
+/**
+ * @class GatewayClient
+ * @brief Minimal blocking client of the order entry Gateway, for tools, load generators and tests.
+ *
+ * Requests are framed binary messages (see BinaryCodec); replies are framed execution reports.
+ * Sending and receiving may run on two different threads.
+ */
+class GatewayClient {
+public:
+    /** @throws std::runtime_error if the connection fails. */
+    explicit GatewayClient(const Endpoint& endpoint);
+
+    GatewayClient(const GatewayClient&) = delete;
+    GatewayClient& operator=(const GatewayClient&) = delete;
+
+    ~GatewayClient();
+
+    /** @brief Appends `m` to `out` as one binary frame. */
+    static void appendMessage(std::string& out, const InboundMessage& m);
+
+    /**
+     * @brief Writes already framed bytes, blocking until everything is sent.
+     * @throws std::runtime_error if the connection broke.
+     */
+    void send(std::string_view frames);
+
+    /** @brief Tells the gateway nothing more will be sent; reports keep arriving. */
+    void shutdownWrite();
+
+    /** @brief Shuts both directions down, which makes a blocked poll() return false. */
+    void disconnect();
+
+    /**
+     * @brief Blocks for the next chunk of data and calls `onReport(const ExecReport&)` for every
+     * complete report received.
+     * @return false once the gateway closed the connection.
+     */
+    template <typename F>
+    bool poll(F&& onReport)
+    {
+        const long n = receive();
+        if (n <= 0)
+        {
+            return false;
+        }
+        const char* p = mIn.data();
+        const char* end = p + mInLen;
+        std::string_view payload;
+        while (Framing::next(p, end, payload) == Framing::Status::OK)
+        {
+            ExecReport r;
+            if (BinaryCodec::decodeReport(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), r)
+                == DecodeError::NONE)
+            {
+                onReport(r);
+            }
+        }
+        consume(static_cast<size_t>(p - mIn.data()));
+        return true;
+    }
+
+private:
+    int mFd{-1};
+    std::vector<char> mIn;
+    size_t mInLen{0};
+
+    /** @brief One recv() into the free part of mIn. @return bytes read, 0 on EOF, -1 on error. */
+    long receive();
+
+    /** @brief Drops the first `n` bytes of mIn. */
+    void consume(size_t n);
+};
+
+#endif //GATEWAYCLIENT_H
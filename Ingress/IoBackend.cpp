@@ -0,0 +1,57 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "IoBackend.h"
+#include "EpollBackend.h"
+#include "UringBackend.h"
+
+#include <iostream>
+#include <stdexcept>
+
+std::unique_ptr<IoBackend> IoBackend::Create(const Options& options)
+{
+#ifdef OME_HAVE_IO_URING
+    if (options.kind != Kind::EPOLL)
+    {
+        try
+        {
+            if (UringBackend::Supported())
+            {
+                return std::make_unique<UringBackend>(options);
+            }
+            if (options.kind == Kind::IO_URING)
+            {
+                std::cerr << "[IoBackend]: io_uring unavailable on this kernel, falling back to epoll" << std::endl;
+            }
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "[IoBackend]: " << e.what() << ", falling back to epoll" << std::endl;
+        }
+    }
+#endif
+#ifdef __linux__
+    return std::make_unique<EpollBackend>(options);
+#else
+    (void)options;
+    throw std::runtime_error("IoBackend: no socket backend on this platform (epoll / io_uring are Linux only)");
+#endif
+}
+
+IoBackend::Kind IoBackend::ParseKind(const std::string& name)
+{
+    if (name == "auto")
+    {
+        return Kind::AUTO;
+    }
+    if (name == "epoll")
+    {
+        return Kind::EPOLL;
+    }
+    if (name == "io_uring")
+    {
+        return Kind::IO_URING;
+    }
+    throw std::invalid_argument("IoBackend: unknown backend '" + name + "' (expected auto, epoll or io_uring)");
+}
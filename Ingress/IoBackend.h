@@ -0,0 +1,111 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef IOBACKEND_H
+#define IOBACKEND_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define OME_HAVE_IO_URING 1
+#endif
+#endif
+
+/**
+ * @class IoBackend
+ * @brief Socket event loop behind the Gateway: accepts connections on a listening socket, reads each
+ * connection into its own buffer and writes queued output, reporting to a Handler.
+ *
+ * @details
+ * Two implementations:
+ * - EpollBackend: edge-triggered readiness loop, one recv/send syscall per operation.
+ * - UringBackend: io_uring completion loop. Receives and sends of a whole event round are submitted
+ *   with one io_uring_enter, sockets are fixed files, read buffers are registered once, and with
+ *   SQPOLL a kernel thread picks up submissions so a busy loop makes no syscalls at all.
+ *
+ * Create() picks io_uring when it is compiled in and the kernel allows it, else falls back to epoll.
+ *
+ * Threading: run(), write(), close() and every Handler callback happen on the I/O thread; wake()
+ * may be called from any thread.
+ */
+class IoBackend {
+public:
+    using ConnId = uint64_t; ///< Backend-chosen connection id, never 0
+
+    enum class Kind { AUTO, EPOLL, IO_URING };
+
+    struct Options
+    {
+        Kind kind{Kind::AUTO};
+        bool sqpoll{false};            ///< io_uring only: kernel-side submission polling
+        size_t maxConnections{128};    ///< io_uring only: size of the fixed file / buffer tables
+        size_t readBufferSize{32 * 1024}; ///< Per connection; must hold the largest frame
+    };
+
+    /** @brief Receives the events of a backend. All calls are made on the I/O thread. */
+    class Handler {
+    public:
+        virtual ~Handler() = default;
+
+        /** @brief A connection was accepted. `fd` is only meant for socket options. */
+        virtual void onAccept(ConnId id, int fd) = 0;
+
+        /**
+         * @brief New bytes arrived. `data` holds everything received and not yet consumed.
+         * @return Bytes consumed from the front; the rest is presented again with the next read.
+         * A connection whose buffer fills up without anything being consumed is closed.
+         */
+        virtual size_t onData(ConnId id, const char* data, size_t len) = 0;
+
+        /** @brief The peer closed the connection or it failed. Not called for close(). */
+        virtual void onClose(ConnId id) = 0;
+
+        /** @brief wake() was called. */
+        virtual void onWake() = 0;
+    };
+
+    virtual ~IoBackend() = default;
+
+    /**
+     * @brief Picks a backend for `options.kind`; AUTO and IO_URING fall back to epoll when io_uring
+     * is unavailable.
+     * @throws std::runtime_error if no backend exists on this platform.
+     */
+    static std::unique_ptr<IoBackend> Create(const Options& options);
+
+    /** @brief Parses `auto`, `epoll` or `io_uring`. @throws std::invalid_argument otherwise. */
+    static Kind ParseKind(const std::string& name);
+
+    virtual const char* name() const = 0;
+
+    /** @brief Takes ownership of the listening socket and starts accepting once run() is called. */
+    virtual void open(int listenFd, Handler& handler) = 0;
+
+    /** @brief Runs the event loop until `running` is false (checked after every event round). */
+    virtual void run(const std::atomic<bool>& running) = 0;
+
+    /** @brief Makes run() call Handler::onWake() soon. Thread-safe. */
+    virtual void wake() = 0;
+
+    /** @brief Queues `len` bytes for `id`, sending what the socket accepts right away. */
+    virtual void write(ConnId id, const char* data, size_t len) = 0;
+
+    /** @brief Bytes queued for `id` and not yet written. */
+    virtual size_t pendingOutput(ConnId id) const = 0;
+
+    /** @brief Closes one connection; its pending input and output are dropped. */
+    virtual void close(ConnId id) = 0;
+
+    /** @brief Closes every connection and the listening socket. Call after run() returned. */
+    virtual void shutdown() = 0;
+};
+
+#endif //IOBACKEND_H
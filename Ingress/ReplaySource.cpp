@@ -0,0 +1,171 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "ReplaySource.h"
+#include "../Scheduler/OrderInjectorScheduler.h"
+#include "../Codec/BinaryCodec.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ReplaySource::ReplaySource(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        throw std::runtime_error("ReplaySource: cannot open " + path + ": " + std::strerror(errno));
+    }
+    struct stat st{};
+    if(::fstat(fd, &st) != 0)
+    {
+        const int err = errno;
+        ::close(fd);
+        throw std::runtime_error("ReplaySource: cannot stat " + path + ": " + std::strerror(err));
+    }
+    mSize = static_cast<size_t>(st.st_size);
+    if(mSize > 0)
+    {
+        void* p = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(p == MAP_FAILED)
+        {
+            const int err = errno;
+            ::close(fd);
+            throw std::runtime_error("ReplaySource: cannot map " + path + ": " + std::strerror(err));
+        }
+        // Read once front to back: let the kernel read ahead aggressively and drop pages behind us.
+        ::madvise(p, mSize, MADV_SEQUENTIAL);
+        mData = static_cast<const char*>(p);
+    }
+    ::close(fd); // the mapping keeps the file referenced
+
+    mTimestamped = mSize >= sizeof(MAGIC) && std::memcmp(mData, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+ReplaySource::~ReplaySource()
+{
+    if(mData)
+    {
+        ::munmap(const_cast<char*>(mData), mSize);
+    }
+}
+
+void ReplaySource::appendRecord(std::string& out, const uint64_t timestampNs, const std::string_view payload)
+{
+    uint8_t header[RECORD_HEADER_SIZE];
+    BinaryCodec::store<uint64_t>(header, timestampNs);
+    BinaryCodec::store<uint32_t>(header + 8, static_cast<uint32_t>(payload.size()));
+    out.append(reinterpret_cast<const char*>(header), sizeof(header));
+    out.append(payload);
+}
+
+void ReplaySource::waitUntil(const uint64_t targetNs)
+{
+    constexpr uint64_t SPIN_NS = 50'000; // sleep granularity is far coarser than inter-arrival gaps
+    const uint64_t now = LatencyHistogram::nowNs();
+    if(targetNs > now + SPIN_NS)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(targetNs - now - SPIN_NS));
+    }
+    while(LatencyHistogram::nowNs() < targetNs) {}
+}
+
+void ReplaySource::submit(OrderInjectorScheduler& injectors, const std::string_view message, Report& report)
+{
+    const size_t index = injectors.workerIndexFor(message);
+    if(injectors.queueDepth(index) >= MAX_QUEUED)
+    {
+        report.throttled++;
+        do
+        {
+            std::this_thread::yield();
+        }
+        while(injectors.queueDepth(index) >= MAX_QUEUED);
+    }
+    injectors.processIncomingView(message, LatencyHistogram::nowNs(), index);
+}
+
+ReplaySource::Report ReplaySource::run(OrderInjectorScheduler& injectors, OrderBookScheduler& books,
+                                       const Pacing pacing, const double speed)
+{
+    Report report;
+    LatencyHistogram latency;
+    books.setLatencyHistogram(&latency);
+
+    const bool paced = pacing == Pacing::ORIGINAL && mTimestamped && speed > 0;
+    const uint64_t startNs = LatencyHistogram::nowNs();
+
+    if(mTimestamped)
+    {
+        const auto* p = reinterpret_cast<const uint8_t*>(mData) + sizeof(MAGIC);
+        const auto* end = reinterpret_cast<const uint8_t*>(mData) + mSize;
+        uint64_t firstTs = 0;
+        bool first = true;
+        while(p < end)
+        {
+            if(static_cast<size_t>(end - p) < RECORD_HEADER_SIZE)
+            {
+                report.malformed++;
+                break;
+            }
+            const auto ts = BinaryCodec::load<uint64_t>(p);
+            const auto len = BinaryCodec::load<uint32_t>(p + 8);
+            p += RECORD_HEADER_SIZE;
+            if(static_cast<size_t>(end - p) < len)
+            {
+                report.malformed++; // cut-off tail of a capture
+                break;
+            }
+            if(first)
+            {
+                firstTs = ts;
+                first = false;
+            }
+            report.recordedNs = ts > firstTs ? ts - firstTs : report.recordedNs;
+            if(paced)
+            {
+                const auto offset = ts > firstTs ? static_cast<double>(ts - firstTs) / speed : 0.0;
+                waitUntil(startNs + static_cast<uint64_t>(offset));
+            }
+            submit(injectors, {reinterpret_cast<const char*>(p), len}, report);
+            report.messages++;
+            p += len;
+        }
+    }
+    else
+    {
+        const char* p = mData;
+        const char* end = mData + mSize;
+        while(p < end)
+        {
+            const auto* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+            const char* lineEnd = nl ? nl : end;
+            size_t len = static_cast<size_t>(lineEnd - p);
+            if(len && p[len - 1] == '\r')
+            {
+                len--;
+            }
+            if(len)
+            {
+                submit(injectors, {p, len}, report);
+                report.messages++;
+            }
+            p = nl ? nl + 1 : end;
+        }
+    }
+
+    injectors.drain();
+    books.drain();
+    books.setLatencyHistogram(nullptr);
+
+    report.seconds = static_cast<double>(LatencyHistogram::nowNs() - startNs) / 1e9;
+    report.msgsPerSec = report.seconds > 0 ? static_cast<double>(report.messages) / report.seconds : 0;
+    report.latency = latency.summary();
+    return report;
+}
@@ -0,0 +1,108 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef REPLAYSOURCE_H
+#define REPLAYSOURCE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "../Metrics/LatencyHistogram.h"
+
+class OrderInjectorScheduler;
+class OrderBookScheduler;
+
+/**
+ * @class ReplaySource
+ * @brief Replays a recorded order-flow file through the injector stage, without copying messages.
+ *
+ * @details
+ * The file is memory-mapped read-only and every message is handed to the injectors as a view into
+ * the mapping (OrderInjectorScheduler::processIncomingView), so a day of flow costs page faults, not
+ * allocations. Two file layouts are accepted:
+ *
+ * - Recorded: starts with the 8-byte MAGIC, followed by records of
+ *   `u64 timestampNs | u32 length | payload[length]` (little-endian). The payload is any wire format
+ *   the injector decodes (binary, FIX, text). Timestamps only need to be non-decreasing.
+ * - Text: anything else is read as one message per line (`\n` or `\r\n`), without timestamps.
+ *
+ * Every message of one symbol goes to the same injector (see OrderInjectorScheduler::workerIndexFor()),
+ * so a book applies its messages in file order. Before submitting, the source waits while that
+ * injector has MAX_QUEUED tasks waiting: a file replays at the speed the engine sustains rather than
+ * piling up in the queues, which would only show up as queueing in the latency report.
+ *
+ * Each message is stamped when submitted; the book workers record the time until they have applied
+ * it, which gives the end-to-end latency distribution in the report.
+ */
+class ReplaySource {
+public:
+    static constexpr char MAGIC[8] = {'O', 'M', 'E', 'R', 'E', 'C', '0', '1'};
+    static constexpr size_t RECORD_HEADER_SIZE = 12; ///< timestamp + length
+    static constexpr size_t MAX_QUEUED = 16384; ///< Injector tasks waiting before the source holds back
+
+    enum class Pacing
+    {
+        MAX_SPEED, ///< Submit as fast as the injectors accept
+        ORIGINAL   ///< Reproduce the recorded inter-arrival times (scaled by `speed`)
+    };
+
+    struct Report
+    {
+        uint64_t messages{0};    ///< Messages submitted
+        uint64_t malformed{0};   ///< Truncated records that were skipped
+        uint64_t throttled{0};   ///< Messages held back because their injector had MAX_QUEUED tasks waiting
+        double seconds{0};       ///< First submit until both stages drained
+        double msgsPerSec{0};
+        uint64_t recordedNs{0};  ///< Time between the first and last recorded timestamps, 0 for text
+        LatencyHistogram::Summary latency;
+    };
+
+    /**
+     * @brief Maps `path` read-only.
+     * @throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    explicit ReplaySource(const std::string& path);
+
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+
+    /** @brief Unmaps the file. */
+    ~ReplaySource();
+
+    /** @brief True if the file uses the recorded (timestamped) layout. */
+    bool timestamped() const { return mTimestamped; }
+
+    /**
+     * @brief Feeds every message to `injectors`, then waits until both stages are drained.
+     *
+     * @details
+     * Injectors are drained before books, since injectors are the ones posting book tasks. The
+     * mapping stays valid for the whole call, which is what makes handing out views safe.
+     * ORIGINAL pacing on a text file has no timestamps to follow and runs at max speed.
+     * @param speed Replay speed multiplier for ORIGINAL pacing (2.0 = twice as fast).
+     */
+    Report run(OrderInjectorScheduler& injectors, OrderBookScheduler& books,
+               Pacing pacing = Pacing::MAX_SPEED, double speed = 1.0);
+
+    /**
+     * @brief Appends one record in the recorded layout to `out`. Used by recorders and tools that
+     * convert captures; the caller writes MAGIC first.
+     */
+    static void appendRecord(std::string& out, uint64_t timestampNs, std::string_view payload);
+
+private:
+    const char* mData{nullptr};
+    size_t mSize{0};
+    bool mTimestamped{false};
+
+    /** @brief Waits until `targetNs` (LatencyHistogram::nowNs() clock). Sleeps, then spins the last stretch. */
+    static void waitUntil(uint64_t targetNs);
+
+    /** @brief Hands one message to its injector once that injector is below MAX_QUEUED. */
+    static void submit(OrderInjectorScheduler& injectors, std::string_view message, Report& report);
+};
+
+#endif //REPLAYSOURCE_H
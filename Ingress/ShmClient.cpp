@@ -0,0 +1,107 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "ShmClient.h"
+#include "../Metrics/LatencyHistogram.h"
+
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+ShmClient::ShmClient(const std::string& name)
+    : mRegion(ShmRegion::Open(name))
+{
+    const auto pid = static_cast<uint32_t>(::getpid());
+    const uint32_t n = mRegion.clientCount();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        ShmRegion::Ring& r = mRegion.ring(i);
+        uint64_t seen = r.owner.load(std::memory_order_acquire);
+        if (ShmRegion::stateOf(seen) != ShmRegion::ClientState::FREE)
+        {
+            continue;
+        }
+        const uint32_t token = mRegion.takeToken();
+        const uint64_t claiming = ShmRegion::ownerWord(pid, token, ShmRegion::ClientState::CLAIMING);
+        if (!r.owner.compare_exchange_strong(seen, claiming, std::memory_order_acq_rel))
+        {
+            continue;
+        }
+        r.heartbeatNs.store(LatencyHistogram::nowNs(), std::memory_order_relaxed);
+        // The engine frees a ring left CLAIMING for too long, and another client may have claimed
+        // it since; that claim has another token, so only a claim that is still ours becomes ACTIVE.
+        const uint64_t active = ShmRegion::ownerWord(pid, token, ShmRegion::ClientState::ACTIVE);
+        seen = claiming;
+        if (!r.owner.compare_exchange_strong(seen, active, std::memory_order_acq_rel))
+        {
+            continue;
+        }
+        mRing = i;
+        mOwner = active;
+        mProducer = mRegion.producer(i);
+        return;
+    }
+    throw std::runtime_error("ShmClient: every ring of " + name + " is in use");
+}
+
+ShmClient::~ShmClient()
+{
+    uint64_t expected = mOwner;
+    mRegion.ring(mRing).owner.compare_exchange_strong(expected,
+        ShmRegion::ownerWord(ShmRegion::pidOf(mOwner), ShmRegion::tokenOf(mOwner), ShmRegion::ClientState::CLOSING),
+        std::memory_order_acq_rel);
+}
+
+bool ShmClient::tryPush(const InboundMessage& m)
+{
+    ShmRegion::Slot* slot = mProducer.tryClaim();
+    if (!slot)
+    {
+        return false;
+    }
+    const size_t n = BinaryCodec::encode(m, slot->payload, sizeof(slot->payload));
+    if (n == 0)
+    {
+        throw std::invalid_argument("ShmClient: message cannot be encoded");
+    }
+    mProducer.publish(slot, static_cast<uint32_t>(n), LatencyHistogram::nowNs());
+    return true;
+}
+
+void ShmClient::push(const InboundMessage& m)
+{
+    while (!tryPush(m))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void ShmClient::heartbeat()
+{
+    mProducer.heartbeat(LatencyHistogram::nowNs());
+}
+
+bool ShmClient::tryPoll(ExecReport& out)
+{
+    // The engine encodes every report itself; one that does not decode is skipped, not returned.
+    bool decoded = false;
+    while (!decoded)
+    {
+        const bool taken = mRegion.takeReport(mRing, [&decoded, &out](const std::string_view payload)
+        {
+            decoded = BinaryCodec::decodeReport(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(),
+                                                out) == DecodeError::NONE;
+        });
+        if (!taken)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t ShmClient::reportsLost() const
+{
+    return mRegion.ring(mRing).reportsLost.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,73 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef SHMCLIENT_H
+#define SHMCLIENT_H
+
+#include <string>
+#include "ShmRegion.h"
+#include "../Codec/BinaryCodec.h"
+
+/**
+ * @class ShmClient
+ * @brief Client side of the shared-memory ingress (see ShmIngress): claims one ring of the engine's
+ * region and writes binary-encoded messages straight into it.
+ *
+ * A push is an encode into the slot and one release store, with no syscall and no allocation.
+ * Pushing also refreshes the heartbeat; a client that goes quiet for longer than
+ * ShmIngress::HEARTBEAT_TIMEOUT_NS should call heartbeat() so it is not mistaken for a dead one.
+ *
+ * The claim is a session of its own: the client may only cancel or amend orders it sent, and gets
+ * their execution reports back on the ring's report ring (tryPoll()). The engine never waits for a
+ * client to poll; reports that find the report ring full are lost and counted (reportsLost()).
+ *
+ * @remarks Not thread-safe: one ring has exactly one producer. Use one client per thread.
+ */
+class ShmClient {
+public:
+    /**
+     * @brief Attaches to the region `name` and claims a free ring.
+     * @throws std::runtime_error if the region is missing or every ring is taken.
+     */
+    explicit ShmClient(const std::string& name);
+
+    ShmClient(const ShmClient&) = delete;
+    ShmClient& operator=(const ShmClient&) = delete;
+
+    /** @brief Releases the ring; the engine still consumes what was already pushed. */
+    ~ShmClient();
+
+    /** @return false if the ring is full (the engine is a ring behind). */
+    bool tryPush(const InboundMessage& m);
+
+    /** @brief Spins until there is room for `m`. */
+    void push(const InboundMessage& m);
+
+    /** @brief Tells the engine this producer is still alive. */
+    void heartbeat();
+
+    /**
+     * @brief Takes the oldest execution report the engine sent this client.
+     * @return false if there is none.
+     */
+    bool tryPoll(ExecReport& out);
+
+    /** @brief Reports this client will never get; once non-zero its view of its orders is incomplete. */
+    uint64_t reportsLost() const;
+
+    /** @brief Index of the claimed ring. */
+    uint32_t ring() const { return mRing; }
+
+private:
+    static_assert(BinaryCodec::MAX_MESSAGE_SIZE <= ShmRegion::SLOT_PAYLOAD, "binary messages must fit a slot");
+
+    ShmRegion mRegion;
+    uint32_t mRing{0};
+    uint64_t mOwner{0}; ///< Owner word of our claim, see ShmRegion::ownerWord()
+    ShmRegion::Producer mProducer;
+};
+
+#endif //SHMCLIENT_H
@@ -0,0 +1,250 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "ShmIngress.h"
+#include "../Scheduler/OrderInjectorScheduler.h"
+#include "../Metrics/LatencyHistogram.h"
+#include "../Codec/BinaryCodec.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    bool processGone(const uint32_t pid)
+    {
+        return pid != 0 && ::kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH;
+    }
+}
+
+ShmIngress::ShmIngress(Options options, std::shared_ptr<OrderInjectorScheduler> injectors)
+    : mOptions(std::move(options)), mInjectors(std::move(injectors))
+{
+}
+
+ShmIngress::~ShmIngress()
+{
+    stop();
+}
+
+void ShmIngress::start(ReportRouter& router, const SessionId sessionsAfter)
+{
+    if (mRunning)
+    {
+        return;
+    }
+    mRegion = std::make_unique<ShmRegion>(ShmRegion::Create(mOptions.name, mOptions.clients, mOptions.ringSlots,
+                                                            sessionsAfter & ReportRouter::LOCAL_MASK));
+    mClaims.assign(mRegion->clientCount(), ClaimSeen{});
+    mReportMtx = std::vector<std::mutex>(mRegion->clientCount());
+    mRouter = &router;
+    mSource = router.registerSource(this);
+    mRunning = true;
+
+    const size_t pollers = std::min<size_t>(mInjectors->workerCount(), mRegion->clientCount());
+    mPollers = pollers;
+    for (size_t i = 0; i < pollers; i++)
+    {
+        repost(PollState{i});
+    }
+    std::cout << "Shared-memory ingress " << mOptions.name << ": " << mRegion->clientCount() << " rings x "
+              << mRegion->ringSlots() << " slots, polled by " << pollers << " injector workers" << std::endl;
+}
+
+void ShmIngress::stop()
+{
+    if (!mRunning.exchange(false))
+    {
+        return;
+    }
+    for (size_t n = mPollers.load(); n != 0; n = mPollers.load())
+    {
+        mPollers.wait(n);
+    }
+    mRouter->unregisterSource(mSource);
+}
+
+size_t ShmIngress::activeClients() const
+{
+    if (!mRegion)
+    {
+        return 0;
+    }
+    size_t n = 0;
+    for (uint32_t i = 0; i < mRegion->clientCount(); i++)
+    {
+        const uint64_t owner = mRegion->ring(i).owner.load(std::memory_order_relaxed);
+        n += ShmRegion::stateOf(owner) == ShmRegion::ClientState::ACTIVE ? 1 : 0;
+    }
+    return n;
+}
+
+void ShmIngress::onReport(const ExecReport& report)
+{
+    if (!mRunning.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    // Rings are few: finding the claim by its token is cheaper than keeping a map in step with it.
+    const uint32_t token = report.session & ReportRouter::LOCAL_MASK;
+    for (uint32_t c = 0; c < mRegion->clientCount(); c++)
+    {
+        ShmRegion::Ring& r = mRegion->ring(c);
+        if (ShmRegion::tokenOf(r.owner.load(std::memory_order_acquire)) != token)
+        {
+            continue;
+        }
+        std::lock_guard<std::mutex> lk(mReportMtx[c]);
+        const uint64_t owner = r.owner.load(std::memory_order_acquire);
+        if (ShmRegion::tokenOf(owner) != token || ShmRegion::stateOf(owner) != ShmRegion::ClientState::ACTIVE)
+        {
+            return;
+        }
+        if (report.type == ExecType::REPORTS_LOST)
+        {
+            r.reportsLost.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        uint8_t buf[BinaryCodec::EXEC_REPORT_SIZE];
+        BinaryCodec::encodeReport(report, buf, sizeof(buf));
+        mRegion->publishReport(c, buf, sizeof(buf));
+        return;
+    }
+}
+
+void ShmIngress::repost(PollState st)
+{
+    try
+    {
+        mInjectors->submitTo(mInjectors->workerIdAt(st.index),
+            [this, st](const CancelToken&) { poll(st); },
+            "ShmIngress: poll");
+    }
+    catch (const std::exception& e)
+    {
+        // The injectors are already shutting down.
+        std::cerr << "[ShmIngress]: poller " << st.index << " stopped (" << e.what() << ")" << std::endl;
+        exitPoller();
+    }
+}
+
+void ShmIngress::exitPoller()
+{
+    mPollers.fetch_sub(1);
+    mPollers.notify_all();
+}
+
+void ShmIngress::poll(PollState st)
+{
+    if (!mRunning.load(std::memory_order_relaxed))
+    {
+        exitPoller();
+        return;
+    }
+
+    const uint32_t clients = mRegion->clientCount();
+    const size_t stride = mInjectors->workerCount();
+    size_t consumed = 0;
+    for (auto c = static_cast<uint32_t>(st.index); c < clients; c += static_cast<uint32_t>(stride))
+    {
+        consumed += drain(c);
+    }
+
+    const uint64_t now = LatencyHistogram::nowNs();
+    if (now >= st.nextLivenessNs)
+    {
+        for (auto c = static_cast<uint32_t>(st.index); c < clients; c += static_cast<uint32_t>(stride))
+        {
+            checkLiveness(c, now);
+        }
+        st.nextLivenessNs = now + LIVENESS_PERIOD_NS;
+    }
+
+    if (consumed != 0)
+    {
+        st.idleRounds = 0;
+    }
+    else if (++st.idleRounds >= IDLE_SPINS && mInjectors->queueDepth(st.index) == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(IDLE_SLEEP_US));
+    }
+    repost(st);
+}
+
+size_t ShmIngress::drain(const uint32_t client)
+{
+    const uint64_t owner = mRegion->ring(client).owner.load(std::memory_order_acquire);
+    if (ShmRegion::stateOf(owner) == ShmRegion::ClientState::FREE)
+    {
+        return 0;
+    }
+    // Only this poller frees the ring, so everything in it was published under this claim.
+    const SessionId session = ReportRouter::makeSession(mSource, ShmRegion::tokenOf(owner));
+    return mRegion->drain(client,
+        [this, session](const std::string_view payload, const uint64_t sendNs)
+        {
+            mInjectors->handleMessage(payload, session, sendNs);
+        },
+        MAX_BURST);
+}
+
+void ShmIngress::checkLiveness(const uint32_t client, const uint64_t nowNs)
+{
+    ShmRegion::Ring& r = mRegion->ring(client);
+    uint64_t owner = r.owner.load(std::memory_order_acquire);
+    const ShmRegion::ClientState s = ShmRegion::stateOf(owner);
+    ClaimSeen& claim = mClaims[client];
+    const char* why = nullptr;
+    if (s != ShmRegion::ClientState::CLAIMING)
+    {
+        claim = ClaimSeen{};
+    }
+    if (s == ShmRegion::ClientState::CLOSING)
+    {
+        why = "released";
+    }
+    else if (s == ShmRegion::ClientState::CLAIMING)
+    {
+        // The heartbeat may still be the previous owner's: only the time this very claim (same
+        // token) has spent in CLAIMING tells a client that died mid-claim.
+        if (claim.owner != owner)
+        {
+            claim = ClaimSeen{owner, nowNs};
+        }
+        else if (nowNs - claim.sinceNs > CLAIM_TIMEOUT_NS)
+        {
+            why = "claim abandoned";
+        }
+    }
+    else if (s != ShmRegion::ClientState::FREE)
+    {
+        const uint64_t beat = r.heartbeatNs.load(std::memory_order_relaxed);
+        if (nowNs > beat && nowNs - beat > HEARTBEAT_TIMEOUT_NS && processGone(ShmRegion::pidOf(owner)))
+        {
+            why = "producer died";
+        }
+    }
+    if (!why)
+    {
+        return;
+    }
+
+    // Whatever was published before the client went away is still processed.
+    while (drain(client) != 0) {}
+    // Only the owner word that was judged is freed: a ring that changed hands since keeps its new
+    // owner. Its report ring is emptied first, under the report lock, so the next owner never sees
+    // reports of this one.
+    std::lock_guard<std::mutex> lk(mReportMtx[client]);
+    mRegion->resetReports(client);
+    if (r.owner.compare_exchange_strong(owner, ShmRegion::ownerWord(0, 0, ShmRegion::ClientState::FREE),
+                                        std::memory_order_acq_rel))
+    {
+        std::cout << "[ShmIngress]: ring " << client << " freed (" << why << ")" << std::endl;
+    }
+    claim = ClaimSeen{};
+}
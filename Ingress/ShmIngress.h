@@ -0,0 +1,128 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef SHMINGRESS_H
+#define SHMINGRESS_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ShmRegion.h"
+#include "../Reports/ReportRouter.h"
+
+class OrderInjectorScheduler;
+
+/**
+ * @class ShmIngress
+ * @brief Shared-memory order entry for co-located clients: owns the ShmRegion and lets the injector
+ * workers poll its rings directly.
+ *
+ * @details
+ * Ring `i` belongs to injector worker `i % workerCount`, so each ring keeps a single consumer and
+ * its messages stay in order. Every injector worker runs one poll task that drains its rings in
+ * bursts, decodes each binary message in place (OrderInjectorScheduler::handleMessage) and then
+ * reposts itself, so other tasks queued on the worker still get their turn between bursts. After
+ * IDLE_SPINS empty rounds the task sleeps IDLE_SLEEP_US before reposting, trading a few
+ * microseconds of wake-up latency for not burning an idle core. It only sleeps while nothing else
+ * is queued on its worker: the worker is shared with the other ingress paths, whose tasks must not
+ * wait behind an idle poller.
+ *
+ * The slot timestamp written by the client is used as the ingress time, so the book latency
+ * histogram (when enabled) measures from the client's write.
+ *
+ * Sessions: every claim of a ring is a session, ReportRouter::makeSession(source, claim token), so
+ * a co-located client may only cancel or amend its own orders, like a gateway client. Its execution
+ * reports come back through onReport() onto the ring's report ring, under a per-ring lock since
+ * several report threads may write to one ring. A report whose session no longer owns its ring is
+ * dropped; one that finds the report ring full is counted in the ring's `reportsLost`, as is a
+ * REPORTS_LOST marker, and the engine moves on (see ShmClient).
+ *
+ * Liveness: every LIVENESS_PERIOD_NS each poller looks at its rings' heartbeats. A ring whose
+ * producer has been silent for HEARTBEAT_TIMEOUT_NS and whose process no longer exists is drained
+ * and freed for a new client, as is a ring its client released. A ring still CLAIMING after
+ * CLAIM_TIMEOUT_NS belongs to a client that died while claiming it and is freed as well; a
+ * client that was merely that slow loses the ring (see ShmClient). Every check and free works on
+ * the ring's whole owner word, claim token included, so a ring that changed hands in between is
+ * never freed on the strength of what its previous owner did. Reports its client did not take are
+ * discarded when the ring is freed.
+ */
+class ShmIngress final : public IReportSink {
+public:
+    static constexpr uint64_t HEARTBEAT_TIMEOUT_NS = 2'000'000'000;
+    static constexpr uint64_t LIVENESS_PERIOD_NS = 100'000'000;
+    static constexpr uint64_t CLAIM_TIMEOUT_NS = 1'000'000'000; ///< A claim takes a few stores
+    static constexpr size_t MAX_BURST = 256;   ///< Messages per ring per poll round
+    static constexpr size_t IDLE_SPINS = 1024;
+    static constexpr unsigned IDLE_SLEEP_US = 50;
+
+    struct Options
+    {
+        std::string name{"/ome-ingress"};
+        uint32_t clients{8};
+        uint32_t ringSlots{4096};
+    };
+
+    ShmIngress(Options options, std::shared_ptr<OrderInjectorScheduler> injectors);
+
+    ShmIngress(const ShmIngress&) = delete;
+    ShmIngress& operator=(const ShmIngress&) = delete;
+
+    ~ShmIngress();
+
+    /**
+     * @brief Creates the region, registers with `router` and starts one poll task per injector worker.
+     * @param sessionsAfter Sessions are numbered from sessionsAfter + 1, as in Gateway::start().
+     * @throws std::runtime_error if the region cannot be created.
+     */
+    void start(ReportRouter& router, SessionId sessionsAfter = NO_SESSION);
+
+    /**
+     * @brief Stops polling, waits for every poll task to exit and stops taking reports. Idempotent.
+     * @remarks Call before the injectors are shut down. The region stays mapped until destruction,
+     * so keep the object alive until the book workers and report consumers are done.
+     */
+    void stop();
+
+    /** @brief Copies a report onto the report ring of the session's ring, if that claim still owns it. */
+    void onReport(const ExecReport& report) override;
+
+    /** @brief Rings currently owned by a client. */
+    size_t activeClients() const;
+
+private:
+    struct PollState
+    {
+        size_t index;          ///< Injector worker index
+        size_t idleRounds{0};
+        uint64_t nextLivenessNs{0};
+    };
+
+    struct ClaimSeen
+    {
+        uint64_t owner{0};   ///< Owner word of the claim being timed, 0 = none
+        uint64_t sinceNs{0}; ///< When that word was first seen
+    };
+
+    Options mOptions;
+    std::shared_ptr<OrderInjectorScheduler> mInjectors;
+    std::unique_ptr<ShmRegion> mRegion;
+    ReportRouter* mRouter{nullptr};
+    ReportRouter::SourceId mSource{0};
+    std::vector<std::mutex> mReportMtx; ///< Per ring, one report publisher at a time; also held to free it
+    std::atomic<bool> mRunning{false};
+    std::atomic<size_t> mPollers{0}; ///< Poll tasks still alive, stop() waits for 0
+    std::vector<ClaimSeen> mClaims; ///< Per ring, the CLAIMING owner word being timed; its poller only
+
+    void poll(PollState st);
+    void repost(PollState st);
+    void exitPoller();
+    size_t drain(uint32_t client);
+    void checkLiveness(uint32_t client, uint64_t nowNs);
+};
+
+#endif //SHMINGRESS_H
@@ -0,0 +1,148 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "ShmRegion.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace
+{
+    [[noreturn]] void fail(const std::string& what, const std::string& name)
+    {
+        throw std::runtime_error("ShmRegion: " + what + " " + name + ": " + std::strerror(errno));
+    }
+
+    uint32_t roundUpPow2(uint32_t v)
+    {
+        uint32_t p = 1;
+        while (p < v)
+        {
+            p <<= 1;
+        }
+        return p;
+    }
+}
+
+ShmRegion ShmRegion::Create(const std::string& name, const uint32_t clients, const uint32_t ringSlots,
+                            const uint32_t tokensAfter)
+{
+    if (clients == 0 || ringSlots == 0)
+    {
+        throw std::invalid_argument("ShmRegion: clients and ring slots must be positive");
+    }
+    const uint32_t slotsPerRing = roundUpPow2(ringSlots);
+    const uint64_t stride = sizeof(Ring) + 2 * uint64_t{slotsPerRing} * sizeof(Slot);
+    const size_t size = CACHE_LINE + clients * stride;
+
+    // A region left behind by an engine that crashed is replaced; clients still attached to it keep
+    // their (now orphaned) mapping and have to reconnect.
+    ::shm_unlink(name.c_str());
+    const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        fail("shm_open", name);
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        fail("ftruncate", name);
+    }
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        ::shm_unlink(name.c_str());
+        fail("mmap", name);
+    }
+
+    auto* base = static_cast<uint8_t*>(p);
+    auto* h = new (base) Header{};
+    h->version = VERSION;
+    h->clientCount = clients;
+    h->ringSlots = slotsPerRing;
+    h->ringStride = stride;
+    h->nextToken.store(tokensAfter & TOKEN_MASK, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < clients; i++)
+    {
+        auto* r = new (base + CACHE_LINE + i * stride) Ring{};
+        r->owner.store(ownerWord(0, 0, ClientState::FREE), std::memory_order_relaxed);
+    }
+    h->magic.store(MAGIC, std::memory_order_release);
+    return {name, base, size, true};
+}
+
+ShmRegion ShmRegion::Open(const std::string& name)
+{
+    const int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+    {
+        fail("shm_open", name);
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        fail("fstat", name);
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    if (size < CACHE_LINE)
+    {
+        ::close(fd);
+        throw std::runtime_error("ShmRegion: " + name + " is not an ingress region");
+    }
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+    {
+        fail("mmap", name);
+    }
+
+    ShmRegion region(name, static_cast<uint8_t*>(p), size, false);
+    const Header& h = region.header();
+    if (h.magic.load(std::memory_order_acquire) != MAGIC || h.version != VERSION || h.ringSlots == 0
+        || (h.ringSlots & (h.ringSlots - 1)) != 0
+        || h.ringStride != sizeof(Ring) + 2 * uint64_t{h.ringSlots} * sizeof(Slot)
+        || CACHE_LINE + h.clientCount * h.ringStride > size)
+    {
+        throw std::runtime_error("ShmRegion: " + name + " is not a compatible ingress region");
+    }
+    return region;
+}
+
+ShmRegion::ShmRegion(ShmRegion&& other) noexcept
+    : mName(std::move(other.mName)), mBase(other.mBase), mSize(other.mSize), mOwner(other.mOwner)
+{
+    other.mBase = nullptr;
+    other.mOwner = false;
+}
+
+ShmRegion& ShmRegion::operator=(ShmRegion&& other) noexcept
+{
+    std::swap(mName, other.mName);
+    std::swap(mBase, other.mBase);
+    std::swap(mSize, other.mSize);
+    std::swap(mOwner, other.mOwner);
+    return *this;
+}
+
+ShmRegion::~ShmRegion()
+{
+    if (mBase)
+    {
+        ::munmap(mBase, mSize);
+    }
+    if (mOwner)
+    {
+        ::shm_unlink(mName.c_str());
+    }
+}
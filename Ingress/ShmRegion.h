@@ -0,0 +1,321 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef SHMREGION_H
+#define SHMREGION_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/**
+ * @class ShmRegion
+ * @brief Named POSIX shared-memory region (`shm_open` + `mmap`) holding one single-producer /
+ * single-consumer ring per client, used for same-host order entry without a syscall per message.
+ *
+ * @details
+ * Layout (all offsets fixed at creation, no pointers inside the region):
+ *
+ *     Header                      one cache line
+ *     Ring 0                      control | head | tail | report head | report tail lines,
+ *                                 slots[ringSlots] (orders in), report slots[ringSlots] (reports out)
+ *     Ring 1 ...                  every ring is `ringStride` bytes
+ *
+ * - A slot is one cache line: send timestamp, length and a payload big enough for any BinaryCodec
+ *   message, so a message never straddles two lines and never wraps.
+ * - `head` (with the producer heartbeat) and `tail` live on their own cache lines, so producer and
+ *   consumer only share a line when one of them actually has to look at the other's counter.
+ * - Every ring has a second ring running the other way: the engine publishes the client's
+ *   execution reports into it (publishReport()), the client takes them (takeReport()).
+ * - A ring is claimed by a client (FREE -> CLAIMING -> ACTIVE), released with CLOSING, and returned
+ *   to FREE by the engine once everything published has been consumed.
+ * - Who owns a ring and in which state is one 64-bit word (see ownerWord()): the owner's pid, a
+ *   claim token and the state, always changed by CAS. Every claim takes a new token from the header,
+ *   so a client or engine acting on a word it read before the ring changed hands fails its CAS
+ *   instead of taking over somebody else's claim.
+ *
+ * The engine creates the region (Create()), clients attach to it (Open()). Timestamps are
+ * `steady_clock` nanoseconds, which are comparable across processes on Linux and macOS.
+ */
+class ShmRegion {
+public:
+    static constexpr uint64_t MAGIC = 0x31304d4853454d4fULL; ///< "OMESHM01"
+    static constexpr uint32_t VERSION = 3;
+    static constexpr size_t CACHE_LINE = 64;
+    static constexpr size_t SLOT_PAYLOAD = 48; ///< >= BinaryCodec::MAX_MESSAGE_SIZE
+
+    enum class ClientState : uint32_t
+    {
+        FREE = 0,     ///< Unowned, head == tail
+        CLAIMING = 1, ///< A client won the ring and is publishing its heartbeat (bounded in time)
+        ACTIVE = 2,   ///< Owned by a live client
+        CLOSING = 3   ///< Released by its client, the engine frees it once drained
+    };
+
+    static constexpr unsigned TOKEN_BITS = 24;
+    static constexpr uint32_t TOKEN_MASK = (uint32_t{1} << TOKEN_BITS) - 1;
+
+    /** @brief A ring's owner word: `pid` (bits 32-63), claim `token` (8-31) and `state` (0-7). */
+    static constexpr uint64_t ownerWord(const uint32_t pid, const uint32_t token, const ClientState state)
+    {
+        return uint64_t{pid} << 32 | uint64_t{token & TOKEN_MASK} << 8 | static_cast<uint8_t>(state);
+    }
+
+    static constexpr ClientState stateOf(const uint64_t owner) { return static_cast<ClientState>(owner & 0xff); }
+    static constexpr uint32_t tokenOf(const uint64_t owner) { return static_cast<uint32_t>(owner >> 8) & TOKEN_MASK; }
+    static constexpr uint32_t pidOf(const uint64_t owner) { return static_cast<uint32_t>(owner >> 32); }
+
+    struct Header
+    {
+        std::atomic<uint64_t> magic; ///< Written last by the creator, checked first by clients
+        uint32_t version;
+        uint32_t clientCount;
+        uint32_t ringSlots;          ///< Power of two
+        std::atomic<uint32_t> nextToken; ///< Claim tokens taken so far (see takeToken())
+        uint64_t ringStride;         ///< Bytes per ring, control lines included
+    };
+
+    struct Slot
+    {
+        uint64_t sendNs;             ///< Producer timestamp, also its latest heartbeat
+        uint32_t len;                ///< Payload bytes used
+        uint32_t reserved;
+        uint8_t payload[SLOT_PAYLOAD];
+    };
+
+    struct Ring
+    {
+        // Control line: written when the ring changes hands.
+        alignas(CACHE_LINE) std::atomic<uint64_t> owner;       ///< ownerWord(): pid, claim token, ClientState
+        // Producer line.
+        alignas(CACHE_LINE) std::atomic<uint64_t> head;        ///< Next slot to publish
+        std::atomic<uint64_t> heartbeatNs;     ///< Last sign of life of the producer
+        // Consumer line.
+        alignas(CACHE_LINE) std::atomic<uint64_t> tail;        ///< Next slot to consume
+        // Report lines: the engine publishes, the client consumes.
+        alignas(CACHE_LINE) std::atomic<uint64_t> reportHead;  ///< Next report slot to publish
+        std::atomic<uint64_t> reportsLost;     ///< Reports the current owner will never get
+        alignas(CACHE_LINE) std::atomic<uint64_t> reportTail;  ///< Next report slot to take
+    };
+
+    static_assert(sizeof(Slot) == CACHE_LINE, "a slot must be exactly one cache line");
+    static_assert(sizeof(Ring) == 5 * CACHE_LINE, "ring control block must be five cache lines");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+                  "shared-memory counters must be address-free");
+
+    /**
+     * @class Producer
+     * @brief Client-side writer of one ring. Keeps a private copy of `head` and of the last `tail`
+     * it saw, so the consumer's line is only read when the ring looks full.
+     */
+    class Producer {
+    public:
+        Producer() = default;
+        Producer(Ring& ring, Slot* slots, uint32_t ringSlots)
+            : mRing(&ring), mSlots(slots), mSize(ringSlots), mMask(ringSlots - 1),
+              mHead(ring.head.load(std::memory_order_relaxed)),
+              mCachedTail(ring.tail.load(std::memory_order_acquire))
+        {
+        }
+
+        /** @return The next free slot, or nullptr if the consumer is a full ring behind. */
+        Slot* tryClaim()
+        {
+            if (mHead - mCachedTail >= mSize)
+            {
+                mCachedTail = mRing->tail.load(std::memory_order_acquire);
+                if (mHead - mCachedTail >= mSize)
+                {
+                    return nullptr;
+                }
+            }
+            return &mSlots[mHead & mMask];
+        }
+
+        /** @brief Makes the slot returned by tryClaim() visible to the consumer. */
+        void publish(Slot* slot, const uint32_t len, const uint64_t nowNs)
+        {
+            slot->len = len;
+            slot->sendNs = nowNs;
+            mRing->heartbeatNs.store(nowNs, std::memory_order_relaxed);
+            mRing->head.store(++mHead, std::memory_order_release);
+        }
+
+        void heartbeat(const uint64_t nowNs) const
+        {
+            mRing->heartbeatNs.store(nowNs, std::memory_order_relaxed);
+        }
+
+    private:
+        Ring* mRing{nullptr};
+        Slot* mSlots{nullptr};
+        uint64_t mSize{0};
+        uint64_t mMask{0};
+        uint64_t mHead{0};
+        uint64_t mCachedTail{0};
+    };
+
+    /**
+     * @brief Creates (or replaces a stale) region named `name`, e.g. "/ome-ingress".
+     * @param clients Number of rings.
+     * @param ringSlots Slots per ring (and per report ring), rounded up to a power of two.
+     * @param tokensAfter Claim tokens start above it, see takeToken().
+     * @throws std::runtime_error if the region cannot be created or mapped.
+     */
+    static ShmRegion Create(const std::string& name, uint32_t clients, uint32_t ringSlots,
+                            uint32_t tokensAfter = 0);
+
+    /**
+     * @brief Attaches to an existing region.
+     * @throws std::runtime_error if it does not exist or was not created by a compatible engine.
+     */
+    static ShmRegion Open(const std::string& name);
+
+    ShmRegion(ShmRegion&& other) noexcept;
+    ShmRegion& operator=(ShmRegion&& other) noexcept;
+    ShmRegion(const ShmRegion&) = delete;
+    ShmRegion& operator=(const ShmRegion&) = delete;
+
+    /** @brief Unmaps; the creator also removes the name. */
+    ~ShmRegion();
+
+    uint32_t clientCount() const { return header().clientCount; }
+    uint32_t ringSlots() const { return header().ringSlots; }
+    const std::string& name() const { return mName; }
+
+    Ring& ring(const uint32_t client) const
+    {
+        return *reinterpret_cast<Ring*>(mBase + CACHE_LINE + client * header().ringStride);
+    }
+
+    Slot* slots(const uint32_t client) const
+    {
+        return reinterpret_cast<Slot*>(reinterpret_cast<uint8_t*>(&ring(client)) + sizeof(Ring));
+    }
+
+    Slot* reportSlots(const uint32_t client) const
+    {
+        return slots(client) + ringSlots();
+    }
+
+    Producer producer(const uint32_t client) const
+    {
+        return Producer(ring(client), slots(client), ringSlots());
+    }
+
+    /** @brief A claim token no earlier claim of this region got (until 2^24 claims wrap it); never 0. */
+    uint32_t takeToken() const
+    {
+        std::atomic<uint32_t>& next = reinterpret_cast<Header*>(mBase)->nextToken;
+        uint32_t token;
+        do
+        {
+            token = (next.fetch_add(1, std::memory_order_relaxed) + 1) & TOKEN_MASK;
+        } while (token == 0);
+        return token;
+    }
+
+    /**
+     * @brief Consumer side: calls `fn(std::string_view payload, uint64_t sendNs)` for up to `max`
+     * published messages of ring `client`, then releases their slots in one store.
+     *
+     * The payload view is only valid during the call. A length the producer corrupted is clamped to
+     * the slot, so a misbehaving client can only hurt its own messages.
+     * @return Messages consumed.
+     */
+    template <typename F>
+    size_t drain(const uint32_t client, F&& fn, const size_t max) const
+    {
+        Ring& r = ring(client);
+        const Slot* s = slots(client);
+        const uint64_t mask = ringSlots() - 1;
+        const uint64_t tail = r.tail.load(std::memory_order_relaxed);
+        const uint64_t end = std::min<uint64_t>(r.head.load(std::memory_order_acquire), tail + max);
+        for (uint64_t t = tail; t < end; t++)
+        {
+            const Slot& slot = s[t & mask];
+            fn(std::string_view(reinterpret_cast<const char*>(slot.payload),
+                                std::min<size_t>(slot.len, SLOT_PAYLOAD)), slot.sendNs);
+        }
+        if (end != tail)
+        {
+            r.tail.store(end, std::memory_order_release);
+        }
+        return static_cast<size_t>(end - tail);
+    }
+
+    /**
+     * @brief Engine side: copies one encoded report into ring `client`'s report ring.
+     * @return false, and counts it in `reportsLost`, when the client is a full ring behind.
+     * @remarks One publisher per ring at a time.
+     */
+    bool publishReport(const uint32_t client, const uint8_t* data, const uint32_t len) const
+    {
+        Ring& r = ring(client);
+        const uint64_t head = r.reportHead.load(std::memory_order_relaxed);
+        if (head - r.reportTail.load(std::memory_order_acquire) >= ringSlots())
+        {
+            r.reportsLost.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Slot& slot = reportSlots(client)[head & (ringSlots() - 1)];
+        slot.len = std::min<uint32_t>(len, SLOT_PAYLOAD);
+        std::memcpy(slot.payload, data, slot.len);
+        r.reportHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Client side: calls `fn(std::string_view payload)` with the oldest report of ring
+     * `client` not taken yet, then releases its slot.
+     * @return false if there is none.
+     */
+    template <typename F>
+    bool takeReport(const uint32_t client, F&& fn) const
+    {
+        Ring& r = ring(client);
+        const uint64_t tail = r.reportTail.load(std::memory_order_relaxed);
+        if (tail == r.reportHead.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        const Slot& slot = reportSlots(client)[tail & (ringSlots() - 1)];
+        fn(std::string_view(reinterpret_cast<const char*>(slot.payload), std::min<size_t>(slot.len, SLOT_PAYLOAD)));
+        r.reportTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Engine side, before a ring is freed: drops the reports its client did not take and
+     * clears `reportsLost`, so the next owner starts with an empty report ring.
+     * @remarks Nothing may publish to the ring meanwhile.
+     */
+    void resetReports(const uint32_t client) const
+    {
+        Ring& r = ring(client);
+        r.reportTail.store(r.reportHead.load(std::memory_order_relaxed), std::memory_order_release);
+        r.reportsLost.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    ShmRegion(std::string name, uint8_t* base, size_t size, bool owner)
+        : mName(std::move(name)), mBase(base), mSize(size), mOwner(owner)
+    {
+    }
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(mBase); }
+
+    std::string mName;
+    uint8_t* mBase{nullptr};
+    size_t mSize{0};
+    bool mOwner{false};
+};
+
+#endif //SHMREGION_H
@@ -0,0 +1,655 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "UringBackend.h"
+
+#ifdef OME_HAVE_IO_URING
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <linux/io_uring.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr unsigned LISTEN_INDEX = 0; ///< Fixed file index of the listening socket
+    constexpr unsigned WAKE_INDEX = 1;   ///< ... of the eventfd; connection slot i uses 2 + i
+    constexpr unsigned FIRST_CONN_INDEX = 2;
+    constexpr unsigned SQ_THREAD_IDLE_MS = 1000;
+    constexpr int SPIN_BEFORE_BLOCK = 20000; ///< SQPOLL only: CQ polls before sleeping in the kernel
+
+    int ioUringSetup(const unsigned entries, io_uring_params* p)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+    }
+
+    int ioUringEnter(const int fd, const unsigned toSubmit, const unsigned minComplete, const unsigned flags)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    int ioUringRegister(const int fd, const unsigned opcode, const void* arg, const unsigned nrArgs)
+    {
+        return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+    }
+
+    unsigned loadAcquire(const unsigned* p)
+    {
+        return std::atomic_ref<const unsigned>(*p).load(std::memory_order_acquire);
+    }
+
+    void storeRelease(unsigned* p, const unsigned v)
+    {
+        std::atomic_ref<unsigned>(*p).store(v, std::memory_order_release);
+    }
+
+    uint64_t userData(const uint8_t op, const uint32_t slot = 0)
+    {
+        return (uint64_t{op} << 56) | slot;
+    }
+}
+
+bool UringBackend::Supported()
+{
+    io_uring_params p{};
+    const int fd = ioUringSetup(4, &p);
+    if (fd < 0)
+    {
+        return false;
+    }
+    // Probe for every opcode used (ACCEPT and SEND need 5.5 / 5.6).
+    const size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    std::vector<uint8_t> buf(probeSize, 0);
+    auto* probe = reinterpret_cast<io_uring_probe*>(buf.data());
+    bool ok = ioUringRegister(fd, IORING_REGISTER_PROBE, probe, 256) == 0;
+    for (const unsigned op : {IORING_OP_ACCEPT, IORING_OP_READ, IORING_OP_READ_FIXED, IORING_OP_RECV, IORING_OP_SEND})
+    {
+        ok = ok && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+    ::close(fd);
+    return ok;
+}
+
+UringBackend::UringBackend(const Options& options)
+    : mOptions(options)
+{
+    if (mOptions.maxConnections == 0)
+    {
+        throw std::invalid_argument("UringBackend: maxConnections must be positive");
+    }
+
+    // At most one receive and one send per connection, plus accept and wake-up.
+    unsigned entries = 1;
+    while (entries < 2 * mOptions.maxConnections + 2)
+    {
+        entries <<= 1;
+    }
+
+    io_uring_params p{};
+    if (mOptions.sqpoll)
+    {
+        p.flags = IORING_SETUP_SQPOLL;
+        p.sq_thread_idle = SQ_THREAD_IDLE_MS;
+        mRingFd = ioUringSetup(entries, &p);
+        if (mRingFd < 0)
+        {
+            std::cerr << "[UringBackend]: SQPOLL unavailable (" << std::strerror(errno) << "), using plain submission"
+                      << std::endl;
+            p = io_uring_params{};
+        }
+        mSqPoll = mRingFd >= 0;
+    }
+    if (mRingFd < 0)
+    {
+        mRingFd = ioUringSetup(entries, &p);
+    }
+    if (mRingFd < 0)
+    {
+        throw std::runtime_error(std::string("UringBackend: io_uring_setup: ") + std::strerror(errno));
+    }
+
+    mSqRingLen = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    mCqRingLen = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    const bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+    if (single)
+    {
+        mSqRingLen = mCqRingLen = std::max(mSqRingLen, mCqRingLen);
+    }
+    mSqRing = ::mmap(nullptr, mSqRingLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd,
+                     IORING_OFF_SQ_RING);
+    mCqRing = single ? mSqRing
+                     : ::mmap(nullptr, mCqRingLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd,
+                              IORING_OFF_CQ_RING);
+    mSqesLen = p.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, mSqesLen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, mRingFd,
+                        IORING_OFF_SQES);
+    if (mSqRing == MAP_FAILED || mCqRing == MAP_FAILED || sqes == MAP_FAILED)
+    {
+        const std::string err = std::strerror(errno);
+        if (mSqRing == MAP_FAILED) mSqRing = nullptr;
+        if (mCqRing == MAP_FAILED) mCqRing = nullptr;
+        if (sqes != MAP_FAILED) ::munmap(sqes, mSqesLen);
+        shutdown();
+        throw std::runtime_error("UringBackend: mmap: " + err);
+    }
+    mSqes = static_cast<io_uring_sqe*>(sqes);
+
+    auto* sq = static_cast<uint8_t*>(mSqRing);
+    mSqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+    mSqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    mSqFlags = reinterpret_cast<unsigned*>(sq + p.sq_off.flags);
+    mSqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    mSqMask = *reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    mSqEntries = p.sq_entries;
+    mSqLocalTail = *mSqTail;
+    auto* cq = static_cast<uint8_t*>(mCqRing);
+    mCqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    mCqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    mCqMask = *reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    mCqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+
+    mWakeFd = ::eventfd(0, EFD_CLOEXEC);
+    mBuffersLen = mOptions.maxConnections * mOptions.readBufferSize;
+    void* buffers = ::mmap(nullptr, mBuffersLen, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mWakeFd < 0 || buffers == MAP_FAILED)
+    {
+        const std::string err = std::strerror(errno);
+        shutdown();
+        throw std::runtime_error("UringBackend: eventfd/buffers: " + err);
+    }
+    mBuffers = static_cast<char*>(buffers);
+
+    // One registered region covers every connection's read buffer.
+    const iovec iov{mBuffers, mBuffersLen};
+    mFixedBuffers = ioUringRegister(mRingFd, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+    if (!mFixedBuffers)
+    {
+        std::cerr << "[UringBackend]: buffer registration failed (" << std::strerror(errno)
+                  << "), using plain receives" << std::endl;
+    }
+
+    mSlots.resize(mOptions.maxConnections);
+    for (size_t i = mOptions.maxConnections; i-- > 0;)
+    {
+        mFreeSlots.push_back(static_cast<uint32_t>(i));
+    }
+}
+
+UringBackend::~UringBackend()
+{
+    shutdown();
+}
+
+void UringBackend::open(const int listenFd, Handler& handler)
+{
+    mHandler = &handler;
+    mListenFd = listenFd;
+    // Accept completes when a connection arrives; a non-blocking socket would only add retries.
+    ::fcntl(mListenFd, F_SETFL, ::fcntl(mListenFd, F_GETFL) & ~O_NONBLOCK);
+
+    std::vector<int> files(FIRST_CONN_INDEX + mOptions.maxConnections, -1);
+    files[LISTEN_INDEX] = mListenFd;
+    files[WAKE_INDEX] = mWakeFd;
+    mFixedFiles = ioUringRegister(mRingFd, IORING_REGISTER_FILES, files.data(), static_cast<unsigned>(files.size())) == 0;
+    if (!mFixedFiles)
+    {
+        std::cerr << "[UringBackend]: file registration failed (" << std::strerror(errno)
+                  << "), using plain descriptors" << std::endl;
+    }
+    armAccept();
+    armWake();
+}
+
+void UringBackend::registerFile(const uint32_t index, const int fd) const
+{
+    if (!mFixedFiles)
+    {
+        return;
+    }
+    int value = fd;
+    io_uring_files_update update{};
+    update.offset = index;
+    update.fds = reinterpret_cast<uint64_t>(&value);
+    ioUringRegister(mRingFd, IORING_REGISTER_FILES_UPDATE, &update, 1);
+}
+
+io_uring_sqe* UringBackend::nextSqe()
+{
+    while (mSqLocalTail - loadAcquire(mSqHead) >= mSqEntries)
+    {
+        submit(false); // full: hand what is queued to the kernel first
+    }
+    const unsigned idx = mSqLocalTail & mSqMask;
+    io_uring_sqe* sqe = &mSqes[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    mSqArray[idx] = idx;
+    mSqLocalTail++;
+    mToSubmit++;
+    mInflight++;
+    return sqe;
+}
+
+void UringBackend::submit(const bool wait)
+{
+    storeRelease(mSqTail, mSqLocalTail);
+    unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+    if (mSqPoll)
+    {
+        // The kernel thread picks the entries up by itself unless it went to sleep.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (std::atomic_ref<unsigned>(*mSqFlags).load(std::memory_order_relaxed) & IORING_SQ_NEED_WAKEUP)
+        {
+            flags |= IORING_ENTER_SQ_WAKEUP;
+        }
+        mToSubmit = 0;
+        if (flags == 0)
+        {
+            return;
+        }
+    }
+    else if (mToSubmit == 0 && !wait)
+    {
+        return;
+    }
+    const int n = ioUringEnter(mRingFd, mToSubmit, wait ? 1 : 0, flags);
+    if (n < 0)
+    {
+        if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            std::cerr << "[UringBackend]: io_uring_enter: " << std::strerror(errno) << std::endl;
+        }
+        return;
+    }
+    if (!mSqPoll)
+    {
+        mToSubmit -= std::min<unsigned>(mToSubmit, static_cast<unsigned>(n));
+    }
+}
+
+bool UringBackend::completionsReady() const
+{
+    return *mCqHead != loadAcquire(mCqTail);
+}
+
+void UringBackend::run(const std::atomic<bool>& running)
+{
+    while (running.load(std::memory_order_relaxed))
+    {
+        if (!completionsReady())
+        {
+            if (mSqPoll)
+            {
+                submit(false);
+                for (int i = 0; i < SPIN_BEFORE_BLOCK && !completionsReady(); i++) {}
+            }
+            if (!completionsReady())
+            {
+                submit(true); // submits this round's requests and waits for the next completion
+            }
+        }
+        else
+        {
+            submit(false);
+        }
+        reap();
+    }
+    drainInflight();
+}
+
+void UringBackend::reap()
+{
+    unsigned head = *mCqHead;
+    const unsigned tail = loadAcquire(mCqTail);
+    while (head != tail)
+    {
+        const io_uring_cqe& cqe = mCqes[head & mCqMask];
+        const uint64_t data = cqe.user_data;
+        const int res = cqe.res;
+        head++;
+        storeRelease(mCqHead, head);
+        handle(data, res);
+    }
+}
+
+void UringBackend::handle(const uint64_t data, const int res)
+{
+    mInflight--;
+    const auto op = static_cast<uint8_t>(data >> 56);
+    const auto slot = static_cast<uint32_t>(data);
+    switch (op)
+    {
+        case OP_ACCEPT:
+            if (res >= 0)
+            {
+                onAccepted(res);
+            }
+            else if (res != -EAGAIN && res != -EINTR && !mDraining)
+            {
+                std::cerr << "[UringBackend]: accept: " << std::strerror(-res) << std::endl;
+            }
+            if (!mDraining)
+            {
+                armAccept();
+            }
+            break;
+        case OP_WAKE:
+            if (!mDraining)
+            {
+                armWake();
+                mHandler->onWake();
+            }
+            break;
+        case OP_READ:
+            onRead(slot, res);
+            break;
+        case OP_SEND:
+            onSent(slot, res);
+            break;
+        default:
+            break;
+    }
+}
+
+void UringBackend::armAccept()
+{
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = mFixedFiles ? static_cast<int>(LISTEN_INDEX) : mListenFd;
+    sqe->flags = mFixedFiles ? IOSQE_FIXED_FILE : 0;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = userData(OP_ACCEPT);
+}
+
+void UringBackend::armWake()
+{
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = mFixedFiles ? static_cast<int>(WAKE_INDEX) : mWakeFd;
+    sqe->flags = mFixedFiles ? IOSQE_FIXED_FILE : 0;
+    sqe->addr = reinterpret_cast<uint64_t>(&mWakeValue);
+    sqe->len = sizeof(mWakeValue);
+    sqe->user_data = userData(OP_WAKE);
+}
+
+void UringBackend::armRead(const uint32_t slot)
+{
+    Slot& s = mSlots[slot];
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = mFixedBuffers ? IORING_OP_READ_FIXED : IORING_OP_RECV;
+    sqe->fd = mFixedFiles ? static_cast<int>(FIRST_CONN_INDEX + slot) : s.fd;
+    sqe->flags = mFixedFiles ? IOSQE_FIXED_FILE : 0;
+    sqe->addr = reinterpret_cast<uint64_t>(readBuffer(slot) + s.inLen);
+    sqe->len = static_cast<uint32_t>(mOptions.readBufferSize - s.inLen);
+    sqe->buf_index = 0;
+    sqe->user_data = userData(OP_READ, slot);
+    s.reading = true;
+}
+
+void UringBackend::armSend(const uint32_t slot)
+{
+    Slot& s = mSlots[slot];
+    if (s.sentOff == s.inFlight.size())
+    {
+        s.inFlight.clear();
+        s.sentOff = 0;
+        if (s.out.empty())
+        {
+            return;
+        }
+        s.inFlight.swap(s.out);
+    }
+    io_uring_sqe* sqe = nextSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = mFixedFiles ? static_cast<int>(FIRST_CONN_INDEX + slot) : s.fd;
+    sqe->flags = mFixedFiles ? IOSQE_FIXED_FILE : 0;
+    sqe->addr = reinterpret_cast<uint64_t>(s.inFlight.data() + s.sentOff);
+    sqe->len = static_cast<uint32_t>(s.inFlight.size() - s.sentOff);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = userData(OP_SEND, slot);
+    s.sending = true;
+}
+
+void UringBackend::onAccepted(const int fd)
+{
+    if (mDraining || mFreeSlots.empty())
+    {
+        if (!mDraining)
+        {
+            std::cerr << "[UringBackend]: connection limit (" << mOptions.maxConnections << ") reached, refusing"
+                      << std::endl;
+        }
+        ::close(fd);
+        return;
+    }
+    const uint32_t slot = mFreeSlots.back();
+    mFreeSlots.pop_back();
+    Slot& s = mSlots[slot];
+    s.fd = fd;
+    s.gen++;
+    s.open = true;
+    s.inLen = 0;
+    registerFile(FIRST_CONN_INDEX + slot, fd);
+    mHandler->onAccept(makeId(slot, s.gen), fd);
+    if (s.open)
+    {
+        armRead(slot);
+    }
+}
+
+void UringBackend::onRead(const uint32_t slot, const int res)
+{
+    Slot& s = mSlots[slot];
+    s.reading = false;
+    if (!s.open)
+    {
+        maybeRelease(slot);
+        return;
+    }
+    if (res == -EAGAIN || res == -EINTR)
+    {
+        armRead(slot);
+        return;
+    }
+    if (res <= 0)
+    {
+        drop(slot, true); // EOF or error
+        return;
+    }
+    s.inLen += static_cast<size_t>(res);
+    char* buf = readBuffer(slot);
+    const size_t consumed = mHandler->onData(makeId(slot, s.gen), buf, s.inLen);
+    if (!s.open)
+    {
+        return; // closed by the handler
+    }
+    std::memmove(buf, buf + consumed, s.inLen - consumed);
+    s.inLen -= consumed;
+    if (s.inLen == mOptions.readBufferSize)
+    {
+        std::cerr << "[UringBackend]: connection " << makeId(slot, s.gen) << " overflowed its read buffer, closing"
+                  << std::endl;
+        drop(slot, true);
+        return;
+    }
+    armRead(slot);
+}
+
+void UringBackend::onSent(const uint32_t slot, const int res)
+{
+    Slot& s = mSlots[slot];
+    s.sending = false;
+    if (!s.open)
+    {
+        maybeRelease(slot);
+        return;
+    }
+    if (res < 0 && res != -EAGAIN && res != -EINTR)
+    {
+        drop(slot, true);
+        return;
+    }
+    s.sentOff += static_cast<size_t>(std::max(res, 0));
+    armSend(slot);
+}
+
+void UringBackend::wake()
+{
+    constexpr uint64_t one = 1;
+    [[maybe_unused]] const auto n = ::write(mWakeFd, &one, sizeof(one));
+}
+
+long UringBackend::slotOf(const ConnId id) const
+{
+    const auto slot = static_cast<uint32_t>(id & 0xffffffffu) - 1;
+    if (slot >= mSlots.size() || mSlots[slot].gen != static_cast<uint32_t>(id >> 32) || !mSlots[slot].open)
+    {
+        return -1;
+    }
+    return slot;
+}
+
+void UringBackend::write(const ConnId id, const char* data, const size_t len)
+{
+    const long slot = slotOf(id);
+    if (slot < 0)
+    {
+        return;
+    }
+    Slot& s = mSlots[slot];
+    s.out.append(data, len);
+    if (!s.sending)
+    {
+        armSend(static_cast<uint32_t>(slot));
+    }
+}
+
+size_t UringBackend::pendingOutput(const ConnId id) const
+{
+    const long slot = slotOf(id);
+    if (slot < 0)
+    {
+        return 0;
+    }
+    const Slot& s = mSlots[slot];
+    return s.out.size() + s.inFlight.size() - s.sentOff;
+}
+
+void UringBackend::close(const ConnId id)
+{
+    if (const long slot = slotOf(id); slot >= 0)
+    {
+        drop(static_cast<uint32_t>(slot), false);
+    }
+}
+
+void UringBackend::drop(const uint32_t slot, const bool notify)
+{
+    Slot& s = mSlots[slot];
+    if (!s.open)
+    {
+        return;
+    }
+    s.open = false;
+    // Completes the receive (and any send) still in flight; the slot is reused once both are back.
+    ::shutdown(s.fd, SHUT_RDWR);
+    if (notify)
+    {
+        mHandler->onClose(makeId(slot, s.gen));
+    }
+    maybeRelease(slot);
+}
+
+void UringBackend::maybeRelease(const uint32_t slot)
+{
+    Slot& s = mSlots[slot];
+    if (s.open || s.reading || s.sending || s.fd < 0)
+    {
+        return;
+    }
+    registerFile(FIRST_CONN_INDEX + slot, -1);
+    ::close(s.fd);
+    s.fd = -1;
+    s.inLen = 0;
+    s.out.clear();
+    s.inFlight.clear();
+    s.sentOff = 0;
+    mFreeSlots.push_back(slot);
+}
+
+void UringBackend::drainInflight()
+{
+    // Runs on the I/O thread once the loop stops, so no request outlives the buffers it points into.
+    mDraining = true;
+    for (uint32_t i = 0; i < mSlots.size(); i++)
+    {
+        drop(i, false);
+    }
+    if (mListenFd >= 0)
+    {
+        ::shutdown(mListenFd, SHUT_RDWR);
+    }
+    wake();
+    while (mInflight > 0)
+    {
+        submit(true);
+        reap();
+    }
+}
+
+void UringBackend::shutdown()
+{
+    for (Slot& s : mSlots)
+    {
+        if (s.fd >= 0)
+        {
+            ::close(s.fd);
+            s.fd = -1;
+        }
+        s.open = false;
+    }
+    if (mRingFd >= 0)
+    {
+        ::close(mRingFd);
+        mRingFd = -1;
+    }
+    if (mSqes)
+    {
+        ::munmap(mSqes, mSqesLen);
+        mSqes = nullptr;
+    }
+    if (mCqRing && mCqRing != mSqRing)
+    {
+        ::munmap(mCqRing, mCqRingLen);
+    }
+    mCqRing = nullptr;
+    if (mSqRing)
+    {
+        ::munmap(mSqRing, mSqRingLen);
+        mSqRing = nullptr;
+    }
+    if (mBuffers)
+    {
+        ::munmap(mBuffers, mBuffersLen);
+        mBuffers = nullptr;
+    }
+    for (int* fd : {&mListenFd, &mWakeFd})
+    {
+        if (*fd >= 0)
+        {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+#endif // OME_HAVE_IO_URING
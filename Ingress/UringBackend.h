@@ -0,0 +1,134 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef URINGBACKEND_H
+#define URINGBACKEND_H
+
+#include "IoBackend.h"
+
+#ifdef OME_HAVE_IO_URING
+
+#include <string>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * @class UringBackend
+ * @brief IoBackend on io_uring, driven through the raw syscalls (no liburing dependency).
+ *
+ * @details
+ * - Every connection owns a slot: a fixed file index and a slice of one registered buffer region.
+ *   Receives are READ_FIXED into that slice, so the kernel does not pin and unpin pages per read.
+ * - Exactly one receive and at most one send are in flight per connection. Output queued while a
+ *   send is in flight goes out with the next one, so a burst of reports costs one send.
+ * - All submissions produced while handling one batch of completions are submitted together by the
+ *   io_uring_enter that waits for the next batch.
+ * - With SQPOLL a kernel thread consumes the submission queue and the loop spins on the completion
+ *   queue before blocking, so a busy gateway makes no syscalls.
+ *
+ * Anything the kernel refuses (fixed files, registered buffers, SQPOLL) is disabled individually with
+ * a log line; the constructor only throws when io_uring itself is unavailable.
+ */
+class UringBackend final : public IoBackend {
+public:
+    /** @throws std::runtime_error if io_uring cannot be set up. */
+    explicit UringBackend(const Options& options);
+    ~UringBackend() override;
+
+    /** @brief True when the kernel allows io_uring and knows every opcode used here. */
+    static bool Supported();
+
+    const char* name() const override { return mSqPoll ? "io_uring+sqpoll" : "io_uring"; }
+    void open(int listenFd, Handler& handler) override;
+    void run(const std::atomic<bool>& running) override;
+    void wake() override;
+    void write(ConnId id, const char* data, size_t len) override;
+    size_t pendingOutput(ConnId id) const override;
+    void close(ConnId id) override;
+    void shutdown() override;
+
+private:
+    enum Op : uint8_t { OP_ACCEPT = 1, OP_WAKE, OP_READ, OP_SEND };
+
+    struct Slot
+    {
+        int fd{-1};
+        uint32_t gen{0};
+        bool open{false};      ///< Owned by the handler
+        bool reading{false};
+        bool sending{false};
+        size_t inLen{0};
+        std::string out;       ///< Queued behind the send in flight
+        std::string inFlight;  ///< Bytes of the send in flight, stable until it completes
+        size_t sentOff{0};
+    };
+
+    Options mOptions;
+    Handler* mHandler{nullptr};
+    bool mSqPoll{false};
+    bool mFixedFiles{false};
+    bool mFixedBuffers{false};
+    bool mDraining{false};
+
+    int mRingFd{-1};
+    void* mSqRing{nullptr};
+    size_t mSqRingLen{0};
+    void* mCqRing{nullptr};
+    size_t mCqRingLen{0};
+    io_uring_sqe* mSqes{nullptr};
+    size_t mSqesLen{0};
+    unsigned* mSqHead{nullptr};
+    unsigned* mSqTail{nullptr};
+    unsigned* mSqFlags{nullptr};
+    unsigned* mSqArray{nullptr};
+    unsigned mSqMask{0};
+    unsigned mSqEntries{0};
+    unsigned* mCqHead{nullptr};
+    unsigned* mCqTail{nullptr};
+    unsigned mCqMask{0};
+    io_uring_cqe* mCqes{nullptr};
+    unsigned mSqLocalTail{0};
+    unsigned mToSubmit{0};
+    size_t mInflight{0};
+
+    char* mBuffers{nullptr};
+    size_t mBuffersLen{0};
+    std::vector<Slot> mSlots;
+    std::vector<uint32_t> mFreeSlots;
+
+    int mListenFd{-1};
+    int mWakeFd{-1};
+    uint64_t mWakeValue{0};
+
+    io_uring_sqe* nextSqe();
+    void submit(bool wait);
+    bool completionsReady() const;
+    void reap();
+    void handle(uint64_t userData, int res);
+
+    void armAccept();
+    void armWake();
+    void armRead(uint32_t slot);
+    void armSend(uint32_t slot);
+    void onAccepted(int fd);
+    void onRead(uint32_t slot, int res);
+    void onSent(uint32_t slot, int res);
+
+    void registerFile(uint32_t index, int fd) const;
+    void drop(uint32_t slot, bool notify);
+    void maybeRelease(uint32_t slot);
+    void drainInflight();
+    /** @return Slot of a live connection, or -1 if `id` is closed or stale. */
+    long slotOf(ConnId id) const;
+    char* readBuffer(uint32_t slot) const { return mBuffers + slot * mOptions.readBufferSize; }
+    static ConnId makeId(uint32_t slot, uint32_t gen) { return (uint64_t{gen} << 32) | (slot + 1u); }
+};
+
+#endif // OME_HAVE_IO_URING
+
+#endif //URINGBACKEND_H
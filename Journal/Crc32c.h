@@ -0,0 +1,73 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief CRC-32C (Castagnoli) of journal records and snapshot files.
+ * @details Slicing-by-8: eight table lookups per 8 bytes instead of one per byte, portable and about
+ * eight times faster than the bytewise loop, which matters for snapshot images of tens of megabytes.
+ */
+namespace Crc32c
+{
+    using Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+    constexpr Tables makeTables()
+    {
+        Tables t{};
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+            {
+                c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1; // reflected polynomial
+            }
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            for (size_t k = 1; k < 8; k++)
+            {
+                t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xFF];
+            }
+        }
+        return t;
+    }
+
+    inline constexpr Tables TABLES = makeTables();
+
+    inline uint32_t load32(const uint8_t* p)
+    {
+        return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8
+            | static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+    }
+
+    /** @param seed Checksum of the bytes before `p`, to checksum a buffer in pieces; 0 to start. */
+    inline uint32_t compute(const uint8_t* p, size_t len, const uint32_t seed = 0)
+    {
+        const auto& t = TABLES;
+        uint32_t c = ~seed;
+        for (; len >= 8; p += 8, len -= 8)
+        {
+            const uint32_t lo = load32(p) ^ c;
+            const uint32_t hi = load32(p + 4);
+            c = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+                ^ t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        }
+        while (len--)
+        {
+            c = t[0][(c ^ *p++) & 0xFF] ^ (c >> 8);
+        }
+        return ~c;
+    }
+}
+
+#endif //CRC32C_H
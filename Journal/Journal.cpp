@@ -0,0 +1,481 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "Journal.h"
+#include "Crc32c.h"
+#include "../Codec/BinaryCodec.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr uint64_t MAGIC = 0x314C4E524A454D4FULL; ///< "OMEJRNL1" little-endian
+    constexpr uint32_t VERSION = 2;
+
+    // Segment header: 0 magic u64, 8 version u32, 12 shard u32, 16 firstSeq u64, 24..63 reserved.
+    constexpr size_t HEADER_SIZE = 64;
+
+    // Record: 0 length u32 (message bytes), 4 crc32c u32 (of seq, session and message), 8 seq u64,
+    // 16 session u32, 20 message.
+    constexpr size_t RECORD_HEADER = 20;
+    constexpr size_t MAX_RECORD = RECORD_HEADER + BinaryCodec::MAX_MESSAGE_SIZE;
+
+    constexpr size_t recordSize(const size_t len) { return (RECORD_HEADER + len + 7) & ~size_t{7}; }
+
+    std::string segmentName(const size_t shard, const uint32_t number)
+    {
+        char name[48];
+        std::snprintf(name, sizeof(name), "shard%03zu-%08u.journal", shard, number);
+        return name;
+    }
+
+    /**
+     * A failed fdatasync leaves no way to tell which pages reached the disk, and retrying can report
+     * success for data that was dropped. Applying the pending messages would break the durability
+     * promise, so the engine stops here.
+     */
+    void syncOrDie(const int fd)
+    {
+        if (::fdatasync(fd) != 0)
+        {
+            std::cerr << "Journal: fdatasync failed: " << std::strerror(errno) << ", aborting" << std::endl;
+            std::abort();
+        }
+    }
+}
+
+Journal::Durability Journal::ParseDurability(const std::string& name)
+{
+    if (name == "async")
+    {
+        return Durability::ASYNC;
+    }
+    if (name == "sync")
+    {
+        return Durability::SYNC;
+    }
+    throw std::invalid_argument("Journal: unknown durability '" + name + "' (expected async or sync)");
+}
+
+Journal::Journal(Options options) : mOptions(std::move(options))
+{
+    if (mOptions.shards == 0)
+    {
+        throw std::invalid_argument("Journal: needs at least one shard");
+    }
+    if (mOptions.segmentBytes < HEADER_SIZE + MAX_RECORD)
+    {
+        throw std::invalid_argument("Journal: segment too small for a record");
+    }
+    std::filesystem::create_directories(mOptions.directory);
+    mDirFd = ::open(mOptions.directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (mDirFd < 0)
+    {
+        throw std::runtime_error("Journal: cannot open " + mOptions.directory + ": " + std::strerror(errno));
+    }
+    mShards = std::make_unique<Shard[]>(mOptions.shards);
+}
+
+Journal::~Journal()
+{
+    stop();
+    for (size_t i = 0; i < mOptions.shards; i++)
+    {
+        Shard& s = mShards[i];
+        for (auto& segment : s.retired)
+        {
+            release(segment);
+        }
+        release(s.current);
+        release(s.spare);
+    }
+    ::close(mDirFd);
+}
+
+uint64_t Journal::recover(const ReplayFn& replay, const std::vector<uint64_t>& after)
+{
+    struct Found
+    {
+        uint64_t firstSeq;
+        uint32_t number;
+        std::string path;
+    };
+    std::vector<std::vector<Found>> found(mOptions.shards);
+    uint32_t nextNumber = 0;
+
+    for (const auto& entry : std::filesystem::directory_iterator(mOptions.directory))
+    {
+        size_t shard = 0;
+        uint32_t number = 0;
+        int consumed = 0;
+        const std::string name = entry.path().filename().string();
+        if (std::sscanf(name.c_str(), "shard%zu-%u.journal%n", &shard, &number, &consumed) != 2
+            || static_cast<size_t>(consumed) != name.size())
+        {
+            continue;
+        }
+        nextNumber = std::max(nextNumber, number + 1);
+
+        uint8_t header[HEADER_SIZE] = {};
+        const int fd = ::open(entry.path().c_str(), O_RDONLY | O_CLOEXEC);
+        const bool read = fd >= 0 && ::pread(fd, header, HEADER_SIZE, 0) == static_cast<ssize_t>(HEADER_SIZE);
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        if (read && std::all_of(header, header + HEADER_SIZE, [](const uint8_t b) { return b == 0; }))
+        {
+            std::filesystem::remove(entry.path()); // a spare that was never used
+            continue;
+        }
+        if (!read || BinaryCodec::load<uint64_t>(header) != MAGIC
+            || BinaryCodec::load<uint32_t>(header + 8) != VERSION
+            || BinaryCodec::load<uint32_t>(header + 12) != shard)
+        {
+            throw std::runtime_error("Journal: " + entry.path().string() + " is not a journal segment");
+        }
+        if (shard >= mOptions.shards)
+        {
+            throw std::runtime_error("Journal: " + name + " belongs to shard " + std::to_string(shard)
+                                     + ", only " + std::to_string(mOptions.shards) + " configured");
+        }
+        found[shard].push_back({BinaryCodec::load<uint64_t>(header + 16), number, entry.path().string()});
+    }
+    mNextSegment.store(nextNumber, std::memory_order_relaxed);
+
+    uint64_t replayed = 0;
+    for (size_t shard = 0; shard < mOptions.shards; shard++)
+    {
+        auto& segments = found[shard];
+        // A segment that stayed empty shares its first sequence with the next one; file numbers
+        // only grow, so they order those.
+        std::sort(segments.begin(), segments.end(), [](const Found& a, const Found& b)
+        {
+            return a.firstSeq != b.firstSeq ? a.firstSeq < b.firstSeq : a.number < b.number;
+        });
+        const uint64_t covered = shard < after.size() ? after[shard] : 0; // in the shard's snapshot
+        uint64_t expected = segments.empty() ? 1 : segments.front().firstSeq;
+        for (size_t k = 0; k < segments.size(); k++)
+        {
+            const auto& f = segments[k];
+            if (f.firstSeq != expected)
+            {
+                // With ASYNC durability a snapshot can hold records a power loss took from the journal.
+                if (f.firstSeq < expected || f.firstSeq > covered + 1)
+                {
+                    throw std::runtime_error("Journal: " + f.path + " starts at " + std::to_string(f.firstSeq)
+                                             + ", expected " + std::to_string(expected));
+                }
+                expected = f.firstSeq;
+            }
+            if (k + 1 < segments.size() && segments[k + 1].firstSeq <= covered + 1)
+            {
+                expected = segments[k + 1].firstSeq; // every record of f is in the snapshot
+                continue;
+            }
+            const int fd = ::open(f.path.c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st{};
+            if (fd < 0 || ::fstat(fd, &st) != 0)
+            {
+                throw std::runtime_error("Journal: cannot read " + f.path + ": " + std::strerror(errno));
+            }
+            const auto size = static_cast<size_t>(st.st_size);
+            void* mem = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mem == MAP_FAILED)
+            {
+                throw std::runtime_error("Journal: cannot map " + f.path + ": " + std::strerror(errno));
+            }
+            ::madvise(mem, size, MADV_SEQUENTIAL);
+
+            const auto* base = static_cast<const uint8_t*>(mem);
+            for (size_t off = HEADER_SIZE; off + RECORD_HEADER <= size;)
+            {
+                const uint32_t len = BinaryCodec::load<uint32_t>(base + off);
+                if (len == 0 || RECORD_HEADER + len > MAX_RECORD || off + recordSize(len) > size
+                    || BinaryCodec::load<uint32_t>(base + off + 4) != Crc32c::compute(base + off + 8, RECORD_HEADER - 8 + len)
+                    || BinaryCodec::load<uint64_t>(base + off + 8) != expected)
+                {
+                    break; // end of the segment, or the torn tail of a crash
+                }
+                if (expected > covered)
+                {
+                    InboundMessage m;
+                    size_t consumed = 0;
+                    if (BinaryCodec::decode(base + off + RECORD_HEADER, len, m, consumed) != DecodeError::NONE)
+                    {
+                        break;
+                    }
+                    m.session = BinaryCodec::load<uint32_t>(base + off + 16);
+                    if (replay)
+                    {
+                        replay(m);
+                    }
+                    replayed++;
+                }
+                expected++;
+                off += recordSize(len);
+            }
+            ::munmap(mem, size);
+        }
+        mShards[shard].nextSeq = std::max(expected, covered + 1);
+    }
+    mRecovered = true;
+    return replayed;
+}
+
+void Journal::start(ApplyFn apply)
+{
+    if (!mRecovered)
+    {
+        recover({});
+    }
+    mApply = std::move(apply);
+    for (size_t i = 0; i < mOptions.shards; i++)
+    {
+        Shard& s = mShards[i];
+        std::lock_guard<std::mutex> lk(s.mutex);
+        s.current = createSegment(i);
+        roll(i, s);
+    }
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        mRunning = true;
+    }
+    mThread = std::thread([this] { run(); });
+}
+
+void Journal::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        mRunning = false;
+    }
+    mCv.notify_all();
+    if (mThread.joinable())
+    {
+        mThread.join(); // its last pass syncs and applies everything appended before
+    }
+}
+
+uint64_t Journal::appended() const
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < mOptions.shards; i++)
+    {
+        std::lock_guard<std::mutex> lk(mShards[i].mutex);
+        total += mShards[i].appended;
+    }
+    return total;
+}
+
+void Journal::append(const size_t shard, const InboundMessage& m, OrderPtr order)
+{
+    Shard& s = mShards[shard];
+    const size_t len = BinaryCodec::sizeOf(m.kind);
+    const size_t need = recordSize(len);
+    bool flush = false;
+    {
+        std::lock_guard<std::mutex> lk(s.mutex);
+        if (s.offset + need > s.current.size)
+        {
+            roll(shard, s);
+        }
+        uint8_t* p = s.current.base + s.offset;
+        BinaryCodec::encode(m, p + RECORD_HEADER, len);
+        BinaryCodec::store<uint64_t>(p + 8, s.nextSeq++);
+        BinaryCodec::store<uint32_t>(p + 16, m.session);
+        BinaryCodec::store<uint32_t>(p + 4, Crc32c::compute(p + 8, RECORD_HEADER - 8 + len));
+        BinaryCodec::store<uint32_t>(p, static_cast<uint32_t>(len));
+        s.offset += need;
+        s.appended++;
+        flush = s.unsynced < mOptions.groupCommitBytes && s.unsynced + need >= mOptions.groupCommitBytes;
+        s.unsynced += need;
+
+        // Applied under the lock: two injectors appending to the same shard reach the book in the
+        // order of their sequence numbers, which is the order replay will use.
+        if (mOptions.durability == Durability::ASYNC)
+        {
+            mApply(m, std::move(order));
+        }
+        else
+        {
+            s.pending.push_back({m, std::move(order)});
+            s.pending.back().msg.order.symbol = {}; // may point into the caller's buffer
+        }
+    }
+    if (flush)
+    {
+        {
+            std::lock_guard<std::mutex> lk(mMutex);
+            mFlushRequested = true;
+        }
+        mCv.notify_one();
+    }
+}
+
+void Journal::checkpoint(CheckpointFn fn)
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        mCheckpoint = std::move(fn);
+        mFlushRequested = true;
+    }
+    mCv.notify_one();
+}
+
+void Journal::run()
+{
+    std::unique_lock<std::mutex> lk(mMutex);
+    while (true)
+    {
+        mCv.wait_for(lk, mOptions.groupCommitWindow, [this] { return !mRunning || mFlushRequested; });
+        const bool last = !mRunning;
+        mFlushRequested = false;
+        const CheckpointFn checkpoint = std::move(mCheckpoint);
+        mCheckpoint = nullptr;
+        lk.unlock();
+        for (size_t i = 0; i < mOptions.shards; i++)
+        {
+            syncShard(i, !last, checkpoint);
+        }
+        lk.lock();
+        if (last)
+        {
+            return;
+        }
+    }
+}
+
+void Journal::syncShard(const size_t shard, const bool prepareSpare, const CheckpointFn& checkpoint)
+{
+    Shard& s = mShards[shard];
+    size_t bytes = 0;
+    int fd = -1;
+    bool needSpare = false;
+    uint64_t lastSeq = 0;
+    {
+        std::lock_guard<std::mutex> lk(s.mutex);
+        s.drainedSegments.swap(s.retired);
+        s.drainedPending.swap(s.pending);
+        bytes = s.unsynced;
+        s.unsynced = 0;
+        fd = s.current.fd;
+        // Mapping a segment stalls this pass (the pages are populated), so only once it will be needed.
+        needSpare = prepareSpare && !s.spare.base && s.offset > s.current.size / 2;
+        lastSeq = s.nextSeq - 1;
+        if (checkpoint && mOptions.durability == Durability::ASYNC)
+        {
+            checkpoint(shard, lastSeq); // appenders apply under this lock, none can slip in
+        }
+    }
+
+    // Appenders keep writing meanwhile. Only this thread unmaps and closes segments, so `fd` stays
+    // open even if the segment is retired under us.
+    for (auto& segment : s.drainedSegments)
+    {
+        syncOrDie(segment.fd);
+        mSyncs.fetch_add(1, std::memory_order_relaxed);
+        release(segment);
+    }
+    s.drainedSegments.clear();
+    if (bytes > 0)
+    {
+        syncOrDie(fd);
+        mSyncs.fetch_add(1, std::memory_order_relaxed);
+    }
+    for (auto& p : s.drainedPending)
+    {
+        mApply(p.msg, std::move(p.order));
+    }
+    s.drainedPending.clear();
+    if (checkpoint && mOptions.durability == Durability::SYNC)
+    {
+        checkpoint(shard, lastSeq); // only this thread applies, and it has applied up to lastSeq
+    }
+
+    if (needSpare)
+    {
+        try
+        {
+            Segment spare = createSegment(shard);
+            std::lock_guard<std::mutex> lk(s.mutex);
+            std::swap(s.spare, spare);
+            release(spare); // only non-empty if the shard got one meanwhile
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Journal: cannot preallocate a segment: " << e.what() << std::endl;
+        }
+    }
+}
+
+Journal::Segment Journal::createSegment(const size_t shard)
+{
+    const std::string path = mOptions.directory + "/" + segmentName(shard, mNextSegment.fetch_add(1));
+    Segment segment;
+    segment.fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (segment.fd < 0)
+    {
+        throw std::runtime_error("Journal: cannot create " + path + ": " + std::strerror(errno));
+    }
+    segment.size = mOptions.segmentBytes;
+    if (const int err = ::posix_fallocate(segment.fd, 0, static_cast<off_t>(segment.size)); err != 0)
+    {
+        ::close(segment.fd);
+        throw std::runtime_error("Journal: cannot preallocate " + path + ": " + std::strerror(err));
+    }
+    // Populated up front so appending never page-faults.
+    void* mem = ::mmap(nullptr, segment.size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, segment.fd, 0);
+    if (mem == MAP_FAILED)
+    {
+        ::close(segment.fd);
+        throw std::runtime_error("Journal: cannot map " + path + ": " + std::strerror(errno));
+    }
+    segment.base = static_cast<uint8_t*>(mem);
+    // The file's directory entry must be durable before any record in it is reported durable.
+    ::fsync(mDirFd);
+    return segment;
+}
+
+void Journal::roll(const size_t shard, Shard& s)
+{
+    if (s.offset > 0) // 0: the first segment of this run, nothing to retire
+    {
+        const Segment next = s.spare.base ? s.spare : createSegment(shard);
+        s.spare = {};
+        s.retired.push_back(s.current);
+        s.current = next;
+    }
+    uint8_t* h = s.current.base;
+    BinaryCodec::store<uint64_t>(h, MAGIC);
+    BinaryCodec::store<uint32_t>(h + 8, VERSION);
+    BinaryCodec::store<uint32_t>(h + 12, static_cast<uint32_t>(shard));
+    BinaryCodec::store<uint64_t>(h + 16, s.nextSeq);
+    s.offset = HEADER_SIZE;
+}
+
+void Journal::release(Segment& segment)
+{
+    if (segment.base)
+    {
+        ::munmap(segment.base, segment.size);
+    }
+    if (segment.fd >= 0)
+    {
+        ::close(segment.fd);
+    }
+    segment = {};
+}
@@ -0,0 +1,211 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Codec/OrderMessage.h"
+#include "../OrderBook/Order/Order.h"
+
+/**
+ * @class Journal
+ * @brief Write-ahead log of the accepted inbound messages, one sequence per shard (book worker), so
+ * the books can be rebuilt after a crash by replaying it.
+ *
+ * @details
+ * - Each shard appends to its own preallocated, memory-mapped segment files in the journal directory.
+ *   A record is `[u32 length][u32 crc32c][u64 seq][u32 session][message]`, padded to 8 bytes, where
+ *   the message is the BinaryCodec encoding with the symbol id resolved. The session is kept so that a
+ *   replayed cancel or amend is refused or applied exactly as it was live (see
+ *   OrderBook::cancelOrder()). Appending is a copy under the shard's lock: no system call, no
+ *   allocation.
+ * - A single syncer thread group-commits: it `fdatasync`s every shard with unsynced records once per
+ *   `groupCommitWindow`, or as soon as a shard has `groupCommitBytes` waiting, so one flush covers
+ *   every order that arrived meanwhile. It also preallocates the next segment of each shard off the
+ *   hot path.
+ * - Durability decides when a message may reach its book (see Durability). Either way a shard applies
+ *   its messages in sequence order, so replaying the journal rebuilds the same books.
+ * - Segments are never reused or deleted here; the symbol to worker assignment must stay the same for
+ *   as long as the journal directory is kept.
+ */
+class Journal {
+public:
+    enum class Durability : uint8_t
+    {
+        ASYNC, ///< Applied once written to the mapping: survives an engine crash, not a power loss
+        SYNC   ///< Applied once fdatasync returned: survives both, costs up to one group-commit window
+    };
+
+    /**
+     * @brief Parses `async` or `sync`.
+     * @throws std::invalid_argument for anything else.
+     */
+    static Durability ParseDurability(const std::string& name);
+
+    struct Options
+    {
+        std::string directory;  ///< Created if missing
+        size_t shards{1};       ///< One per book worker, in worker id order
+        Durability durability{Durability::SYNC};
+        size_t segmentBytes{64 << 20}; ///< Size of each preallocated segment file
+        std::chrono::microseconds groupCommitWindow{200}; ///< Longest a record waits for its fdatasync
+        size_t groupCommitBytes{256 << 10}; ///< Unsynced bytes of a shard that trigger a flush early
+    };
+
+    /** @brief Routes an accepted message (and its order, for NEW_ORDER) to its book. */
+    using ApplyFn = std::function<void(const InboundMessage&, OrderPtr)>;
+
+    /** @brief Receives a journaled message during recover(), in the shard's sequence order. */
+    using ReplayFn = std::function<void(const InboundMessage&)>;
+
+    /**
+     * @brief Told, per shard, the sequence number of the last message handed to the apply function,
+     * at a point where no later message of the shard has been (see checkpoint()).
+     */
+    using CheckpointFn = std::function<void(size_t shard, uint64_t seq)>;
+
+    /**
+     * @throws std::invalid_argument for a zero shard count or a segment too small for one record.
+     * @throws std::runtime_error if the directory cannot be created.
+     */
+    explicit Journal(Options options);
+
+    /** @brief Stops the syncer (see stop()) and unmaps the segments. */
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    /**
+     * @brief Replays every intact record of the directory, shard by shard, and continues each shard's
+     * sequence after its last one. Reading stops at the first torn or corrupt record of a shard (the
+     * tail of a crash); the next run writes into a fresh segment.
+     * @param after Per shard, the sequence number a snapshot of its books was taken at: only later
+     * records are replayed, and segments holding none of them are not read at all. Empty, or a
+     * shorter vector, replays the missing shards from the start.
+     * @return Messages replayed.
+     * @throws std::runtime_error if a shard's segments do not follow each other (a segment is missing)
+     * where the gap is not covered by `after`.
+     * @remarks Call once, before start(); start() recovers without replaying if it was not called.
+     */
+    uint64_t recover(const ReplayFn& replay, const std::vector<uint64_t>& after = {});
+
+    /**
+     * @brief Starts the syncer.
+     * @param apply Called for every appended message once it is journaled in the configured
+     * durability: on the appending thread (ASYNC) or on the syncer thread (SYNC).
+     */
+    void start(ApplyFn apply);
+
+    /**
+     * @brief Stamps `m` with the shard's next sequence number, writes it to the shard's segment and
+     * hands it on to the apply function according to the durability.
+     * @param shard Index of the book worker owning `m.symbolId`.
+     * @param m Message with its symbol id resolved; the symbol name is not kept.
+     * @param order The validated order of a NEW_ORDER, null otherwise.
+     * @warning Only between start() and stop().
+     */
+    void append(size_t shard, const InboundMessage& m, OrderPtr order);
+
+    /**
+     * @brief Asks the syncer to call `fn` once per shard, on its next pass, with the shard's last
+     * applied sequence number. With ASYNC durability it is called under the shard's lock, with SYNC
+     * right after the pass applied the shard's pending messages: either way the apply function has
+     * seen exactly the messages up to that number, so a task `fn` queues behind them on the book
+     * worker sees the books as of that number. A second call before the pass replaces the first.
+     * @remarks `fn` runs on the syncer thread and must not append.
+     */
+    void checkpoint(CheckpointFn fn);
+
+    /**
+     * @brief Flushes and applies what is still pending, then stops the syncer.
+     * @remarks Stop the producers (injectors) first: nothing may be appended afterwards.
+     */
+    void stop();
+
+    /** @brief Messages appended since start(), every shard. */
+    uint64_t appended() const;
+
+    /** @brief fdatasync calls made by the syncer. */
+    uint64_t syncs() const { return mSyncs.load(std::memory_order_relaxed); }
+
+    size_t shards() const { return mOptions.shards; }
+
+private:
+    struct Segment
+    {
+        int fd{-1};
+        uint8_t* base{nullptr};
+        size_t size{0};
+    };
+
+    struct Pending
+    {
+        InboundMessage msg;
+        OrderPtr order;
+    };
+
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;
+        Segment current;          ///< Segment being appended to
+        size_t offset{0};         ///< Next write position in current
+        Segment spare;            ///< Preallocated by the syncer, taken when current is full
+        std::vector<Segment> retired; ///< Full segments the syncer still has to sync and unmap
+        std::vector<Pending> pending; ///< SYNC: journaled but not yet durable, in sequence order
+        size_t unsynced{0};       ///< Bytes appended since the syncer last took them
+        uint64_t nextSeq{1};
+        uint64_t appended{0};
+        // Syncer only
+        std::vector<Segment> drainedSegments;
+        std::vector<Pending> drainedPending;
+    };
+
+    Options mOptions;
+    ApplyFn mApply;
+    std::unique_ptr<Shard[]> mShards;
+    int mDirFd{-1};
+    bool mRecovered{false};
+    std::atomic<uint32_t> mNextSegment{0}; ///< File number of the next segment created, any shard
+    std::atomic<uint64_t> mSyncs{0};
+
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mCv;
+    bool mRunning{false};        ///< Guarded by mMutex
+    bool mFlushRequested{false}; ///< Guarded by mMutex
+    CheckpointFn mCheckpoint;    ///< Guarded by mMutex, taken by the syncer's next pass
+
+    void run();
+
+    /**
+     * @brief Syncs what the shard has appended so far, then releases its pending messages.
+     * @param prepareSpare Also preallocate the shard's next segment if it has none and the current
+     * one is half full.
+     * @param checkpoint Called with the shard's last applied sequence number, if set.
+     */
+    void syncShard(size_t shard, bool prepareSpare, const CheckpointFn& checkpoint);
+
+    /** @brief Creates, preallocates and maps a new segment file of `shard`. */
+    Segment createSegment(size_t shard);
+
+    /** @brief Makes the spare (or a new segment) current, retiring the full one. Holds the shard lock. */
+    void roll(size_t shard, Shard& s);
+
+    static void release(Segment& segment);
+};
+
+#endif //JOURNAL_H
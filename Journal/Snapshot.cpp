@@ -0,0 +1,296 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "Snapshot.h"
+#include "Crc32c.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr uint64_t MAGIC = 0x3150414E53454D4FULL; ///< "OMESNAP1" little-endian
+    constexpr uint32_t VERSION = 2;
+
+    // Header: 0 magic u64, 8 version u32, 12 shard u32, 16 seq u64, 24 image length u64.
+    constexpr size_t HEADER_SIZE = 32;
+    constexpr size_t TRAILER_SIZE = 4; // crc32c u32 of header and image
+
+    std::string snapshotName(const size_t shard, const uint64_t seq)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "shard%03zu-%020llu.snapshot", shard, static_cast<unsigned long long>(seq));
+        return name;
+    }
+
+    bool writeAll(const int fd, const uint8_t* data, size_t len)
+    {
+        while (len > 0)
+        {
+            const ssize_t n = ::write(fd, data, len);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+SnapshotStore::SnapshotStore(Options options) : mOptions(std::move(options))
+{
+    if (mOptions.shards == 0 || mOptions.keep == 0)
+    {
+        throw std::invalid_argument("SnapshotStore: needs at least one shard and one snapshot kept");
+    }
+    std::filesystem::create_directories(mOptions.directory);
+    mDirFd = ::open(mOptions.directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (mDirFd < 0)
+    {
+        throw std::runtime_error("SnapshotStore: cannot open " + mOptions.directory + ": " + std::strerror(errno));
+    }
+    for (const auto& entry : std::filesystem::directory_iterator(mOptions.directory))
+    {
+        if (entry.path().extension() == ".tmp")
+        {
+            std::filesystem::remove(entry.path()); // a write the process did not live to finish
+        }
+    }
+}
+
+SnapshotStore::~SnapshotStore()
+{
+    stop();
+    ::close(mDirFd);
+}
+
+std::vector<std::pair<uint64_t, std::string>> SnapshotStore::list(const size_t shard) const
+{
+    std::vector<std::pair<uint64_t, std::string>> files;
+    for (const auto& entry : std::filesystem::directory_iterator(mOptions.directory))
+    {
+        size_t fileShard = 0;
+        unsigned long long seq = 0;
+        int consumed = 0;
+        const std::string name = entry.path().filename().string();
+        if (std::sscanf(name.c_str(), "shard%zu-%llu.snapshot%n", &fileShard, &seq, &consumed) == 2
+            && static_cast<size_t>(consumed) == name.size() && fileShard == shard)
+        {
+            files.emplace_back(seq, entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    return files;
+}
+
+std::optional<SnapshotStore::Loaded> SnapshotStore::load(const size_t shard) const
+{
+    for (const auto& [seq, path] : list(shard))
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st{};
+        if (fd < 0 || ::fstat(fd, &st) != 0)
+        {
+            std::cerr << "SnapshotStore: cannot read " << path << ": " << std::strerror(errno) << std::endl;
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            continue;
+        }
+        Image file(static_cast<size_t>(st.st_size));
+        size_t got = 0;
+        while (got < file.size())
+        {
+            const ssize_t n = ::pread(fd, file.data() + got, file.size() - got, static_cast<off_t>(got));
+            if (n <= 0)
+            {
+                break;
+            }
+            got += static_cast<size_t>(n);
+        }
+        ::close(fd);
+
+        const bool ok = got == file.size() && file.size() >= HEADER_SIZE + TRAILER_SIZE
+            && BinaryCodec::load<uint64_t>(file.data()) == MAGIC
+            && BinaryCodec::load<uint32_t>(file.data() + 8) == VERSION
+            && BinaryCodec::load<uint32_t>(file.data() + 12) == shard
+            && BinaryCodec::load<uint64_t>(file.data() + 16) == seq
+            && BinaryCodec::load<uint64_t>(file.data() + 24) == file.size() - HEADER_SIZE - TRAILER_SIZE
+            && BinaryCodec::load<uint32_t>(file.data() + file.size() - TRAILER_SIZE)
+               == Crc32c::compute(file.data(), file.size() - TRAILER_SIZE);
+        if (!ok)
+        {
+            std::cerr << "SnapshotStore: " << path << " is damaged, trying an older snapshot" << std::endl;
+            continue;
+        }
+        Loaded loaded;
+        loaded.seq = seq;
+        loaded.path = path;
+        loaded.image.assign(file.begin() + HEADER_SIZE, file.end() - TRAILER_SIZE);
+        return loaded;
+    }
+    return std::nullopt;
+}
+
+void SnapshotStore::start(TriggerFn trigger)
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        if (mRunning)
+        {
+            return;
+        }
+        mRunning = true;
+        mTrigger = std::move(trigger);
+    }
+    mThread = std::thread([this] { run(); });
+}
+
+void SnapshotStore::request()
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        mRequested = true;
+    }
+    mCv.notify_one();
+}
+
+void SnapshotStore::submit(const size_t shard, const uint64_t seq, Image image)
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        if (!mRunning)
+        {
+            return;
+        }
+        mQueue.push_back({shard, seq, std::move(image)});
+    }
+    mCv.notify_one();
+}
+
+void SnapshotStore::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        mRunning = false;
+    }
+    mCv.notify_all();
+    if (mThread.joinable())
+    {
+        mThread.join(); // writes the queue before it returns
+    }
+}
+
+uint64_t SnapshotStore::written() const
+{
+    std::lock_guard<std::mutex> lk(mMutex);
+    return mWritten;
+}
+
+uint64_t SnapshotStore::lastBytes() const
+{
+    std::lock_guard<std::mutex> lk(mMutex);
+    return mLastBytes;
+}
+
+void SnapshotStore::run()
+{
+    const bool periodic = mOptions.interval.count() > 0;
+    auto next = std::chrono::steady_clock::now() + mOptions.interval;
+    std::unique_lock<std::mutex> lk(mMutex);
+    while (true)
+    {
+        const auto ready = [this] { return !mRunning || mRequested || !mQueue.empty(); };
+        if (periodic)
+        {
+            mCv.wait_until(lk, next, ready);
+        }
+        else
+        {
+            mCv.wait(lk, ready);
+        }
+        if (!mQueue.empty())
+        {
+            Job job = std::move(mQueue.front());
+            mQueue.pop_front();
+            lk.unlock();
+            const uint64_t bytes = write(job);
+            lk.lock();
+            mWritten += bytes > 0;
+            mLastBytes = bytes ? bytes : mLastBytes;
+            continue;
+        }
+        if (!mRunning)
+        {
+            return;
+        }
+        if (mRequested || (periodic && std::chrono::steady_clock::now() >= next))
+        {
+            mRequested = false;
+            next = std::chrono::steady_clock::now() + mOptions.interval;
+            lk.unlock();
+            if (mTrigger)
+            {
+                mTrigger();
+            }
+            lk.lock();
+        }
+    }
+}
+
+uint64_t SnapshotStore::write(const Job& job) const
+{
+    const std::string path = mOptions.directory + "/" + snapshotName(job.shard, job.seq);
+    const std::string tmp = path + ".tmp";
+
+    uint8_t header[HEADER_SIZE] = {};
+    BinaryCodec::store<uint64_t>(header, MAGIC);
+    BinaryCodec::store<uint32_t>(header + 8, VERSION);
+    BinaryCodec::store<uint32_t>(header + 12, static_cast<uint32_t>(job.shard));
+    BinaryCodec::store<uint64_t>(header + 16, job.seq);
+    BinaryCodec::store<uint64_t>(header + 24, job.image.size());
+    uint8_t trailer[TRAILER_SIZE];
+    BinaryCodec::store<uint32_t>(trailer, Crc32c::compute(job.image.data(), job.image.size(),
+                                                          Crc32c::compute(header, HEADER_SIZE)));
+
+    const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool ok = fd >= 0;
+    ok = ok && writeAll(fd, header, HEADER_SIZE) && writeAll(fd, job.image.data(), job.image.size())
+        && writeAll(fd, trailer, TRAILER_SIZE) && ::fsync(fd) == 0;
+    if (fd >= 0)
+    {
+        ok = ::close(fd) == 0 && ok;
+    }
+    // Renamed only once durable, and the rename made durable before older snapshots go.
+    ok = ok && std::rename(tmp.c_str(), path.c_str()) == 0 && ::fsync(mDirFd) == 0;
+    if (!ok)
+    {
+        std::cerr << "SnapshotStore: cannot write " << path << ": " << std::strerror(errno) << std::endl;
+        std::error_code ignored;
+        std::filesystem::remove(tmp, ignored);
+        return 0;
+    }
+
+    const auto files = list(job.shard);
+    for (size_t i = mOptions.keep; i < files.size(); i++)
+    {
+        std::error_code ignored;
+        std::filesystem::remove(files[i].second, ignored);
+    }
+    return HEADER_SIZE + job.image.size() + TRAILER_SIZE;
+}
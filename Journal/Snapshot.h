@@ -0,0 +1,226 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Codec/BinaryCodec.h"
+
+/**
+ * @class SnapshotWriter
+ * @brief Appends little-endian fields to a snapshot image.
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& out) : mOut(out) {}
+
+    template <typename T>
+    void put(const T v)
+    {
+        const size_t at = mOut.size();
+        mOut.resize(at + sizeof(T));
+        BinaryCodec::store<T>(mOut.data() + at, v);
+    }
+
+    void putString(const std::string& s)
+    {
+        put<uint32_t>(static_cast<uint32_t>(s.size()));
+        mOut.insert(mOut.end(), s.begin(), s.end());
+    }
+
+    /**
+     * @brief Grows the image by `bytes` and returns where they start, for a large section of
+     * fixed-size entries written with BinaryCodec::store(). Valid until the next call.
+     */
+    uint8_t* extend(const size_t bytes)
+    {
+        const size_t at = mOut.size();
+        mOut.resize(at + bytes);
+        return mOut.data() + at;
+    }
+
+private:
+    std::vector<uint8_t>& mOut;
+};
+
+/**
+ * @class SnapshotReader
+ * @brief Reads back what a SnapshotWriter appended.
+ * @throws std::runtime_error on reading past the end: the image is cut short.
+ */
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, const size_t size) : mPos(data), mEnd(data + size) {}
+
+    template <typename T>
+    T get()
+    {
+        need(sizeof(T));
+        const T v = BinaryCodec::load<T>(mPos);
+        mPos += sizeof(T);
+        return v;
+    }
+
+    std::string getString()
+    {
+        const auto len = get<uint32_t>();
+        need(len);
+        std::string s(reinterpret_cast<const char*>(mPos), len);
+        mPos += len;
+        return s;
+    }
+
+    /** @brief Skips `bytes` and returns where they start, the counterpart of SnapshotWriter::extend(). */
+    const uint8_t* take(const size_t bytes)
+    {
+        need(bytes);
+        const uint8_t* p = mPos;
+        mPos += bytes;
+        return p;
+    }
+
+    /** @brief Bytes not read yet. */
+    size_t remaining() const { return static_cast<size_t>(mEnd - mPos); }
+
+private:
+    const uint8_t* mPos;
+    const uint8_t* mEnd;
+
+    void need(const size_t bytes) const
+    {
+        if (remaining() < bytes)
+        {
+            throw std::runtime_error("Snapshot: image is truncated");
+        }
+    }
+};
+
+/**
+ * @class SnapshotStore
+ * @brief Snapshot files of the books, one per shard (book worker) and journal position.
+ *
+ * @details
+ * - A shard's image is encoded by its book worker (see OrderBookScheduler::snapshot()) and handed
+ *   over with submit(); the store's thread writes it to a temporary file, fsyncs and renames it, so
+ *   a file under its final name is always complete. The newest `keep` files of a shard are kept,
+ *   older ones are deleted once a newer one is durable.
+ * - A file is `shard<NNN>-<seq>.snapshot`: a 32-byte header (magic, version, shard, journal sequence
+ *   number, image length), the image and a crc32c of both. `seq` is the last journal record of the
+ *   shard the image includes; recovery replays the journal after it (see Journal::recover()).
+ * - The same thread calls the trigger every `interval`; the trigger starts a round of snapshots,
+ *   normally through Journal::checkpoint().
+ */
+class SnapshotStore {
+public:
+    using Image = std::vector<uint8_t>;
+
+    struct Options
+    {
+        std::string directory;  ///< Created if missing
+        size_t shards{1};       ///< One per book worker, in worker id order
+        std::chrono::seconds interval{60}; ///< Between two rounds of snapshots, 0 = only on request()
+        size_t keep{2};         ///< Snapshots kept per shard, at least 1
+    };
+
+    /** @brief Newest intact snapshot of a shard. */
+    struct Loaded
+    {
+        uint64_t seq{0}; ///< Journal sequence number the image is as of
+        Image image;
+        std::string path;
+    };
+
+    /** @brief Starts a round of snapshots; called on the store's thread. */
+    using TriggerFn = std::function<void()>;
+
+    /**
+     * @brief Opens (creates) the directory and removes temporary files of interrupted writes.
+     * @throws std::invalid_argument for zero shards or keep.
+     * @throws std::runtime_error if the directory cannot be opened.
+     */
+    explicit SnapshotStore(Options options);
+
+    /** @brief Stops the thread (see stop()). */
+    ~SnapshotStore();
+
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    /**
+     * @brief Reads the newest snapshot of `shard` whose checksum holds, skipping (and reporting)
+     * damaged ones.
+     * @return std::nullopt if the shard has none.
+     */
+    std::optional<Loaded> load(size_t shard) const;
+
+    /** @brief Starts the thread that calls `trigger` every interval and writes submitted images. */
+    void start(TriggerFn trigger);
+
+    /** @brief Calls the trigger on the store's thread as soon as possible. */
+    void request();
+
+    /**
+     * @brief Queues `image`, the books of `shard` as of journal sequence number `seq`, for writing.
+     * @remarks Thread-safe; called by the book workers.
+     */
+    void submit(size_t shard, uint64_t seq, Image image);
+
+    /** @brief Writes what was submitted so far, then stops the thread. Later images are dropped. */
+    void stop();
+
+    /** @brief Snapshot files written since start(). */
+    uint64_t written() const;
+
+    /** @brief Size in bytes of the last snapshot file written. */
+    uint64_t lastBytes() const;
+
+    size_t shards() const { return mOptions.shards; }
+
+private:
+    struct Job
+    {
+        size_t shard;
+        uint64_t seq;
+        Image image;
+    };
+
+    Options mOptions;
+    int mDirFd{-1};
+    TriggerFn mTrigger;
+
+    std::thread mThread;
+    mutable std::mutex mMutex;
+    std::condition_variable mCv;
+    std::deque<Job> mQueue;      ///< Guarded by mMutex
+    bool mRunning{false};        ///< Guarded by mMutex
+    bool mRequested{false};      ///< Guarded by mMutex
+    uint64_t mWritten{0};        ///< Guarded by mMutex
+    uint64_t mLastBytes{0};      ///< Guarded by mMutex
+
+    void run();
+
+    /**
+     * @brief Writes one snapshot durably and prunes the shard's older ones.
+     * @return File size, 0 if it could not be written (reported, the previous snapshots stay).
+     */
+    uint64_t write(const Job& job) const;
+
+    /** @brief Snapshot files of `shard` in the directory, newest first. */
+    std::vector<std::pair<uint64_t, std::string>> list(size_t shard) const;
+};
+
+#endif //SNAPSHOT_H
@@ -0,0 +1,107 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef BAR_H
+#define BAR_H
+
+#include <algorithm>
+#include "../OrderBook/Order/Types.h"
+
+/**
+ * @struct Bar
+ * @brief Trades of one symbol over one interval: open, high, low, close, volume, VWAP and count.
+ *
+ * Plain data, like DepthUpdate, so it can be copied into rings without allocating.
+ */
+struct Bar
+{
+    uint64_t startNs{0};  ///< Interval start, nanoseconds since the epoch
+    uint64_t endNs{0};    ///< Interval end (exclusive)
+    Price open{0};
+    Price high{0};
+    Price low{0};
+    Price close{0};
+    Quantity volume{0};   ///< Quantity traded
+    uint64_t trades{0};   ///< Fills in the interval
+    double notional{0};   ///< Sum of price * quantity over the fills
+    SymbolId symbolId{INVALID_SYMBOL_ID};
+    uint32_t reserved{0};
+
+    /** @brief Volume-weighted average price, 0 for a bar without trades. */
+    double vwap() const { return volume ? notional / static_cast<double>(volume) : 0.0; }
+};
+
+/**
+ * @class IBarSink
+ * @brief Receives completed bars.
+ * @remarks Called on the book worker that owns the symbol.
+ */
+class IBarSink {
+public:
+    virtual ~IBarSink() = default;
+    virtual void onBar(const Bar& bar) = 0;
+};
+
+/**
+ * @class BarBuilder
+ * @brief One book's bar in progress. Owned by the book: every fill updates it in O(1), and the close
+ * task the scheduler posts at each interval boundary hands it to the sink and starts the next one.
+ *
+ * @details
+ * Bars are cut where the close task lands in the book worker's queue, so a bar holds exactly the
+ * fills of the orders processed before it, whatever the timer's jitter. An interval without fills
+ * produces no bar.
+ */
+class BarBuilder {
+public:
+    explicit BarBuilder(const SymbolId symbolId) { mBar.symbolId = symbolId; }
+
+    /** @brief Sets where completed bars go (nullptr to stop building them). Owning worker only. */
+    void setSink(IBarSink* sink) { mSink = sink; }
+
+    bool enabled() const { return mSink != nullptr; }
+
+    /** @brief Adds one fill to the current bar. */
+    void onFill(const Price price, const Quantity qty)
+    {
+        if (mBar.trades == 0)
+        {
+            mBar.open = mBar.high = mBar.low = price;
+        }
+        else
+        {
+            mBar.high = std::max(mBar.high, price);
+            mBar.low = std::min(mBar.low, price);
+        }
+        mBar.close = price;
+        mBar.volume += qty;
+        mBar.notional += static_cast<double>(price) * static_cast<double>(qty);
+        mBar.trades++;
+    }
+
+    /**
+     * @brief Closes the current bar as [startNs, endNs), hands it to the sink if it has fills, and
+     * starts an empty one.
+     */
+    void close(const uint64_t startNs, const uint64_t endNs)
+    {
+        if (mSink && mBar.trades > 0)
+        {
+            mBar.startNs = startNs;
+            mBar.endNs = endNs;
+            mSink->onBar(mBar);
+        }
+        const SymbolId symbolId = mBar.symbolId;
+        mBar = Bar{};
+        mBar.symbolId = symbolId;
+    }
+
+private:
+    Bar mBar;
+    IBarSink* mSink{nullptr};
+};
+
+#endif //BAR_H
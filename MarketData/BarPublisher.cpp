@@ -0,0 +1,112 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "BarPublisher.h"
+
+#include <stdexcept>
+
+namespace
+{
+    uint64_t toNs(const std::chrono::system_clock::time_point t)
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count());
+    }
+}
+
+BarPublisher::BarPublisher(const size_t producers, const size_t slots, const std::chrono::milliseconds interval) :
+    mInterval(interval)
+{
+    if (producers == 0)
+    {
+        throw std::invalid_argument("BarPublisher: needs at least one producer");
+    }
+    if (interval < std::chrono::milliseconds(1))
+    {
+        throw std::invalid_argument("BarPublisher: interval must be at least 1 ms");
+    }
+    mProducers.reserve(producers);
+    for (size_t i = 0; i < producers; i++)
+    {
+        mProducers.push_back(std::make_unique<Producer>(slots));
+    }
+}
+
+BarPublisher::~BarPublisher()
+{
+    stop();
+}
+
+void BarPublisher::start(BoundaryFn onBoundary)
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        if (mRunning)
+        {
+            return;
+        }
+        mRunning = true;
+    }
+    mOnBoundary = std::move(onBoundary);
+    mThread = std::thread([this] { run(); });
+}
+
+void BarPublisher::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        mRunning = false;
+    }
+    mCv.notify_all();
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+BarPublisher::Reader BarPublisher::reader() const
+{
+    Reader r(*this);
+    for (size_t i = 0; i < mProducers.size(); i++)
+    {
+        const auto& ring = mProducers[i]->mRing;
+        const uint64_t published = ring.published();
+        r.mCursors[i] = published > ring.capacity() ? published - ring.capacity() : 0;
+    }
+    return r;
+}
+
+uint64_t BarPublisher::published() const
+{
+    uint64_t total = 0;
+    for (const auto& p : mProducers)
+    {
+        total += p->mRing.published();
+    }
+    return total;
+}
+
+void BarPublisher::run()
+{
+    using Clock = std::chrono::system_clock;
+    const auto interval = std::chrono::duration_cast<Clock::duration>(mInterval);
+    // Boundaries are whole multiples of the interval since the epoch.
+    auto start = Clock::time_point(Clock::now().time_since_epoch() / interval * interval);
+
+    std::unique_lock<std::mutex> lk(mMutex);
+    while (true)
+    {
+        const auto end = start + interval;
+        const bool stopped = mCv.wait_until(lk, end, [this] { return !mRunning; });
+        // The last interval ends when the publisher stops, its bars carry the real end.
+        const auto closedAt = stopped ? Clock::now() : end;
+        lk.unlock();
+        mOnBoundary(toNs(start), toNs(closedAt));
+        lk.lock();
+        if (stopped)
+        {
+            return;
+        }
+        start = end;
+    }
+}
@@ -0,0 +1,157 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef BARPUBLISHER_H
+#define BARPUBLISHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Bar.h"
+#include "../Concurrency/BroadcastRing.h"
+
+/**
+ * @class BarPublisher
+ * @brief Keeps the interval clock for the books' bars and exposes the completed bars to any number of
+ * readers.
+ *
+ * @details
+ * - Each book worker publishes its completed bars into its own BroadcastRing: a copy and a release
+ *   store, never a lock or an allocation, and never blocked by a reader. Readers (Reader) follow the
+ *   rings at their own pace and see every bar unless they fall a whole ring behind.
+ * - The timer thread wakes at every multiple of the interval (wall clock, so bars of all symbols line
+ *   up on round times) and calls the boundary callback, which posts the close to the book workers
+ *   (OrderBookScheduler::closeBars()). Books never scan trades: each fill was folded into its bar as
+ *   it happened.
+ */
+class BarPublisher {
+public:
+    static constexpr size_t DEFAULT_RING_SLOTS = 4096;
+
+    /** @brief Closes every book's bar for [startNs, endNs); called on the timer thread. */
+    using BoundaryFn = std::function<void(uint64_t startNs, uint64_t endNs)>;
+
+    /** @brief The publishing end of one ring; an IBarSink a book can be given. */
+    class Producer final : public IBarSink {
+    public:
+        explicit Producer(const size_t slots) : mRing(slots) {}
+
+        void onBar(const Bar& bar) override { mRing.publish(bar); }
+
+    private:
+        friend class BarPublisher;
+        BroadcastRing<Bar> mRing;
+    };
+
+    /**
+     * @class Reader
+     * @brief One consumer's position in every ring. Any thread; a reader is used by one thread at a time.
+     */
+    class Reader {
+    public:
+        /**
+         * @brief Hands every bar published since the last call to `f`; bars of one worker in order.
+         * @return Number of bars handed over.
+         */
+        template <typename F>
+        size_t poll(F&& f)
+        {
+            size_t n = 0;
+            Bar bar;
+            for (size_t i = 0; i < mCursors.size(); i++)
+            {
+                const auto& ring = mPublisher->mProducers[i]->mRing;
+                uint64_t& cursor = mCursors[i];
+                while (true)
+                {
+                    const auto r = ring.tryRead(cursor, bar);
+                    if (r == BroadcastRing<Bar>::ReadResult::NOT_YET)
+                    {
+                        break;
+                    }
+                    if (r == BroadcastRing<Bar>::ReadResult::LAPPED)
+                    {
+                        // Skip to the oldest bar still there, leaving room for the producer moving on.
+                        const uint64_t oldest = ring.published() - ring.capacity() / 2;
+                        mLost += oldest - cursor;
+                        cursor = oldest;
+                        continue;
+                    }
+                    f(bar);
+                    cursor++;
+                    n++;
+                }
+            }
+            return n;
+        }
+
+        /** @brief Bars this reader missed because it fell a whole ring behind. */
+        uint64_t lost() const { return mLost; }
+
+    private:
+        friend class BarPublisher;
+        explicit Reader(const BarPublisher& publisher) : mPublisher(&publisher), mCursors(publisher.producers()) {}
+
+        const BarPublisher* mPublisher;
+        std::vector<uint64_t> mCursors;
+        uint64_t mLost{0};
+    };
+
+    /**
+     * @param producers Number of rings, one per book worker.
+     * @param slots Bars kept per ring for readers, a power of two.
+     * @param interval Bar length.
+     * @throws std::invalid_argument if the interval is shorter than a millisecond.
+     */
+    BarPublisher(size_t producers, size_t slots, std::chrono::milliseconds interval);
+
+    /** @brief Stops the timer thread (see stop()). */
+    ~BarPublisher();
+
+    BarPublisher(const BarPublisher&) = delete;
+    BarPublisher& operator=(const BarPublisher&) = delete;
+
+    /** @brief Starts the timer thread; `onBoundary` is called at every interval boundary. */
+    void start(BoundaryFn onBoundary);
+
+    /**
+     * @brief Closes the interval in progress early (ending now) and stops the timer thread.
+     * @remarks Call while the book workers still run, so they can close their last bars.
+     */
+    void stop();
+
+    /** @brief Publishing end of ring `i`, for the books of one worker. */
+    Producer& producer(const size_t i) { return *mProducers.at(i); }
+
+    size_t producers() const { return mProducers.size(); }
+
+    /** @brief A reader positioned at the oldest bar still in each ring. */
+    Reader reader() const;
+
+    /** @brief Bars published so far, over all producers. Any thread. */
+    uint64_t published() const;
+
+    std::chrono::milliseconds interval() const { return mInterval; }
+
+private:
+    std::vector<std::unique_ptr<Producer>> mProducers;
+    std::chrono::milliseconds mInterval;
+    BoundaryFn mOnBoundary;
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mCv;
+    bool mRunning{false}; ///< Guarded by mMutex
+
+    /** @brief Timer loop: sleeps to each boundary and reports it, until stopped. */
+    void run();
+};
+
+#endif //BARPUBLISHER_H
@@ -0,0 +1,156 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "ConflatingPublisher.h"
+#include <algorithm>
+#include <stdexcept>
+
+ConflatingPublisher::ConflatingPublisher(const size_t producers, const size_t slots,
+                                         const std::chrono::microseconds window) :
+    mWindow(std::max(window, std::chrono::microseconds(0)))
+{
+    if (producers == 0)
+    {
+        throw std::invalid_argument("ConflatingPublisher: needs at least one producer");
+    }
+    mProducers.reserve(producers);
+    for (size_t i = 0; i < producers; i++)
+    {
+        mProducers.push_back(std::make_unique<Producer>(slots));
+    }
+}
+
+ConflatingPublisher::~ConflatingPublisher()
+{
+    stop();
+}
+
+void ConflatingPublisher::start(IDepthSink& downstream)
+{
+    if (mRunning.exchange(true))
+    {
+        return;
+    }
+    mDownstream = &downstream;
+    mThread = std::thread([this] { run(); });
+}
+
+void ConflatingPublisher::stop()
+{
+    mRunning.store(false, std::memory_order_release);
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+uint64_t ConflatingPublisher::dropped() const
+{
+    uint64_t total = 0;
+    for (const auto& p : mProducers)
+    {
+        total += p->mDropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void ConflatingPublisher::take(const DepthUpdate& update)
+{
+    if (update.symbolId >= mBooks.size())
+    {
+        mBooks.resize(update.symbolId + 1);
+    }
+    BookSequence& book = mBooks[update.symbolId];
+    if (book.lastIn != 0 && update.seq != book.lastIn + 1)
+    {
+        book.gap = true;
+    }
+    book.lastIn = update.seq;
+    mPending[LevelKey{update.symbolId, update.side, update.price}] = update;
+}
+
+void ConflatingPublisher::flush()
+{
+    if (mPending.empty())
+    {
+        return;
+    }
+    mBatch.clear();
+    for (const auto& [_, update] : mPending)
+    {
+        mBatch.push_back(update);
+    }
+    mPending.clear();
+
+    // Book order: a level emptied before another one appeared is still published first.
+    std::sort(mBatch.begin(), mBatch.end(), [](const DepthUpdate& a, const DepthUpdate& b)
+    {
+        return a.symbolId != b.symbolId ? a.symbolId < b.symbolId : a.seq < b.seq;
+    });
+    for (DepthUpdate& update : mBatch)
+    {
+        BookSequence& book = mBooks[update.symbolId];
+        if (book.gap)
+        {
+            book.lastOut++;
+            book.gap = false;
+        }
+        update.seq = ++book.lastOut;
+        mDownstream->onDepth(update);
+    }
+    mPublished.fetch_add(mBatch.size(), std::memory_order_relaxed);
+}
+
+void ConflatingPublisher::run()
+{
+    constexpr unsigned SPINS = 64;
+    constexpr unsigned YIELDS = 16;
+    unsigned idle = 0;
+    const auto take = [this](const DepthUpdate& u) { this->take(u); };
+    auto nextFlush = std::chrono::steady_clock::now() + mWindow;
+
+    while (true)
+    {
+        // Read before draining: once it is false, a pass that finds every ring empty is the last one.
+        const bool running = mRunning.load(std::memory_order_acquire);
+        size_t n = 0;
+        for (const auto& p : mProducers)
+        {
+            n += p->mRing.drain(take, MAX_BATCH);
+        }
+        mReceived.fetch_add(n, std::memory_order_relaxed);
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextFlush)
+        {
+            flush();
+            nextFlush = now + mWindow;
+        }
+        if (n > 0)
+        {
+            idle = 0;
+            continue;
+        }
+        if (!running)
+        {
+            flush();
+            return;
+        }
+        if (++idle <= SPINS)
+        {
+            continue;
+        }
+        if (idle <= SPINS + YIELDS)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            // Never sleep through the end of a window that has something to publish.
+            const auto wait = mPending.empty() ? std::chrono::steady_clock::duration(IDLE_SLEEP)
+                                               : std::min<std::chrono::steady_clock::duration>(IDLE_SLEEP, nextFlush - now);
+            std::this_thread::sleep_for(wait);
+        }
+    }
+}
@@ -0,0 +1,149 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef CONFLATINGPUBLISHER_H
+#define CONFLATINGPUBLISHER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "DepthUpdate.h"
+#include "../Concurrency/SpscRing.h"
+
+/**
+ * @class ConflatingPublisher
+ * @brief Carries L2 updates from the book workers to one downstream sink and collapses the updates of
+ * a level within a conflation window into one.
+ *
+ * @details
+ * - Each book worker publishes into its own SPSC ring, like ReportStream: a copy and a release
+ *   store, never a lock or an allocation. An update that finds its ring full is dropped and counted.
+ * - One publisher thread drains the rings and keeps only the latest state of every (symbol, side,
+ *   price) it saw. Every `window` it sends those states downstream in the order the books produced
+ *   them, so a burst of changes to one level goes out as a single update. A window of 0 sends each
+ *   pass's updates right away; pending updates are still collapsed within a pass.
+ * - Sequence numbers are re-stamped per book on the way out: consumers see 1, 2, 3... per symbol,
+ *   however many updates conflation folded. When the publisher notices that updates of a book were
+ *   dropped (a hole in the book's own sequence), it skips one number in that book's output, so the
+ *   consumer sees the gap too and knows its copy of the book may be stale.
+ */
+class ConflatingPublisher {
+public:
+    static constexpr size_t DEFAULT_RING_SLOTS = 65536;
+    static constexpr size_t MAX_BATCH = 256; ///< Updates taken from one ring before moving on
+    static constexpr auto IDLE_SLEEP = std::chrono::microseconds(50);
+
+    /** @brief The publishing end of one ring; an IDepthSink a book can be given. */
+    class Producer final : public IDepthSink {
+    public:
+        explicit Producer(const size_t slots) : mRing(slots) {}
+
+        void onDepth(const DepthUpdate& update) override
+        {
+            if (!mRing.tryPush(update))
+            {
+                // Single writer: load + store, no locked RMW.
+                mDropped.store(mDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        friend class ConflatingPublisher;
+        SpscRing<DepthUpdate> mRing;
+        std::atomic<uint64_t> mDropped{0};
+    };
+
+    /**
+     * @param producers Number of rings, one per book worker.
+     * @param slots Capacity of each ring, a power of two.
+     * @param window Conflation window.
+     */
+    ConflatingPublisher(size_t producers, size_t slots, std::chrono::microseconds window);
+
+    /** @brief Stops the publisher thread (see stop()). */
+    ~ConflatingPublisher();
+
+    ConflatingPublisher(const ConflatingPublisher&) = delete;
+    ConflatingPublisher& operator=(const ConflatingPublisher&) = delete;
+
+    /** @brief Starts the publisher thread; `downstream` receives the conflated updates on it. */
+    void start(IDepthSink& downstream);
+
+    /**
+     * @brief Publishes what is left in the rings and stops the publisher thread.
+     * @pre No producer publishes any more (the book workers are shut down).
+     */
+    void stop();
+
+    /** @brief Publishing end of ring `i`, for the books of one worker. */
+    Producer& producer(const size_t i) { return *mProducers.at(i); }
+
+    size_t producers() const { return mProducers.size(); }
+
+    /** @brief Updates taken from the rings so far. */
+    uint64_t received() const { return mReceived.load(std::memory_order_relaxed); }
+
+    /** @brief Updates sent downstream so far; received() - published() were conflated away. */
+    uint64_t published() const { return mPublished.load(std::memory_order_relaxed); }
+
+    /** @brief Updates dropped on a full ring so far, over all producers. */
+    uint64_t dropped() const;
+
+private:
+    /** @brief Identifies a price level across books. */
+    struct LevelKey
+    {
+        SymbolId symbolId;
+        Side side;
+        Price price;
+
+        bool operator==(const LevelKey&) const = default;
+    };
+
+    struct LevelKeyHash
+    {
+        size_t operator()(const LevelKey& k) const noexcept
+        {
+            const uint64_t h = static_cast<uint64_t>(k.price) * 0x9E3779B97F4A7C15ULL;
+            return h ^ (static_cast<uint64_t>(k.symbolId) << 1 | static_cast<uint64_t>(k.side == Side::SELL));
+        }
+    };
+
+    /** @brief Sequence state of one book, publisher thread only. */
+    struct BookSequence
+    {
+        uint64_t lastIn{0};  ///< Last book sequence number received
+        uint64_t lastOut{0}; ///< Last sequence number published
+        bool gap{false};     ///< Updates were lost since the last publish
+    };
+
+    std::vector<std::unique_ptr<Producer>> mProducers;
+    std::chrono::microseconds mWindow;
+    IDepthSink* mDownstream{nullptr};
+    std::thread mThread;
+    std::atomic<bool> mRunning{false};
+    std::atomic<uint64_t> mReceived{0};
+    std::atomic<uint64_t> mPublished{0};
+
+    // Publisher thread only
+    std::unordered_map<LevelKey, DepthUpdate, LevelKeyHash> mPending; ///< Latest state per level this window
+    std::vector<DepthUpdate> mBatch; ///< Scratch buffer for sorting a flush
+    std::vector<BookSequence> mBooks; ///< By SymbolId
+
+    /** @brief Publisher loop: drains the rings, flushes every window, until stopped and drained. */
+    void run();
+
+    /** @brief Folds one update into the pending state. */
+    void take(const DepthUpdate& update);
+
+    /** @brief Sends the pending state downstream in book order and clears it. */
+    void flush();
+};
+
+#endif //CONFLATINGPUBLISHER_H
@@ -0,0 +1,79 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef DEPTHUPDATE_H
+#define DEPTHUPDATE_H
+
+#include "../OrderBook/Order/Types.h"
+
+/**
+ * @struct DepthUpdate
+ * @brief New state of one price level (market by price, L2).
+ *
+ * Plain data, like ExecReport, so it can be copied into rings and encoded without allocating.
+ */
+struct DepthUpdate
+{
+    uint64_t seq{0}; ///< Per-book sequence number, starts at 1 and has no holes unless updates were lost
+    SymbolId symbolId{INVALID_SYMBOL_ID};
+    Side side{Side::BUY};
+    Price price{0};
+    Quantity qty{0};  ///< Aggregate open quantity at the level, 0 = the level is gone
+    Count orders{0};  ///< Orders resting at the level
+};
+
+/**
+ * @class IDepthSink
+ * @brief Receives price level updates.
+ * @remarks Called on the book worker that owns the symbol, or on a ConflatingPublisher's thread.
+ */
+class IDepthSink {
+public:
+    virtual ~IDepthSink() = default;
+    virtual void onDepth(const DepthUpdate& update) = 0;
+};
+
+/**
+ * @class DepthFeed
+ * @brief One book's L2 output: stamps level changes with the book's symbol and sequence number
+ * and hands them to the sink. Owned by the book, used by its two OrderTrackers.
+ */
+class DepthFeed {
+public:
+    explicit DepthFeed(const SymbolId symbolId) : mSymbolId(symbolId) {}
+
+    /** @brief Sets where updates go (nullptr to stop publishing). Owning worker only. */
+    void setSink(IDepthSink* sink) { mSink = sink; }
+
+    bool enabled() const { return mSink != nullptr; }
+
+    /** @brief Sequence number of the last update published. */
+    uint64_t sequence() const { return mSeq; }
+
+    /** @brief Publishes the new state of a level, if anybody listens. */
+    void level(const Side side, const Price price, const Quantity qty, const Count orders)
+    {
+        if (!mSink)
+        {
+            return;
+        }
+        DepthUpdate u;
+        u.seq = ++mSeq;
+        u.symbolId = mSymbolId;
+        u.side = side;
+        u.price = price;
+        u.qty = qty;
+        u.orders = orders;
+        mSink->onDepth(u);
+    }
+
+private:
+    SymbolId mSymbolId;
+    uint64_t mSeq{0};
+    IDepthSink* mSink{nullptr};
+};
+
+#endif //DEPTHUPDATE_H
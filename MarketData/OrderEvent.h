@@ -0,0 +1,110 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef ORDEREVENT_H
+#define ORDEREVENT_H
+
+#include "../OrderBook/Order/Types.h"
+
+/**
+ * @brief What happened to a resting order (market by order, L3).
+ */
+enum class OrderEventType : uint8_t
+{
+    ADD = 1,     ///< Order rests in the book: side, price and open `qty`
+    EXECUTE = 2, ///< `qty` of the order traded at `price`; the order is gone once its open quantity reaches 0
+    REDUCE = 3,  ///< Open quantity went down by `qty` in place, the order keeps its priority
+    DELETE = 4   ///< Order left the book with `qty` still open (cancel, mass cancel, or replace)
+};
+
+/**
+ * @struct OrderEvent
+ * @brief One change to one resting order, keyed by order id.
+ *
+ * Applying every event of a book in sequence order rebuilds the book order by order, in
+ * price-time priority: ADDs append to the back of their level.
+ */
+struct OrderEvent
+{
+    uint64_t seq{0}; ///< Per-book sequence number, starts at 1 and has no holes unless events were lost
+    OrderId orderId{0};
+    Price price{0};  ///< ADD: limit price, EXECUTE: trade price, otherwise unused
+    Quantity qty{0};
+    SymbolId symbolId{INVALID_SYMBOL_ID};
+    OrderEventType type{OrderEventType::ADD};
+    Side side{Side::BUY}; ///< ADD only; later events of the order are identified by id
+};
+
+/**
+ * @class IOrderEventSink
+ * @brief Receives L3 order events.
+ * @remarks Called on the book worker that owns the symbol.
+ */
+class IOrderEventSink {
+public:
+    virtual ~IOrderEventSink() = default;
+    virtual void onOrderEvent(const OrderEvent& event) = 0;
+};
+
+/**
+ * @class OrderFeed
+ * @brief One book's L3 output: stamps order events with the book's symbol and sequence number and
+ * hands them to the sink. Owned by the book, used by its two OrderTrackers.
+ */
+class OrderFeed {
+public:
+    explicit OrderFeed(const SymbolId symbolId) : mSymbolId(symbolId) {}
+
+    /** @brief Sets where events go (nullptr to stop publishing). Owning worker only. */
+    void setSink(IOrderEventSink* sink) { mSink = sink; }
+
+    /** @brief Sequence number of the last event published. */
+    uint64_t sequence() const { return mSeq; }
+
+    void add(const OrderId id, const Side side, const Price price, const Quantity qty)
+    {
+        emit(OrderEventType::ADD, id, side, price, qty);
+    }
+
+    void execute(const OrderId id, const Side side, const Price price, const Quantity qty)
+    {
+        emit(OrderEventType::EXECUTE, id, side, price, qty);
+    }
+
+    void reduce(const OrderId id, const Side side, const Quantity qty)
+    {
+        emit(OrderEventType::REDUCE, id, side, 0, qty);
+    }
+
+    void remove(const OrderId id, const Side side, const Quantity qty)
+    {
+        emit(OrderEventType::DELETE, id, side, 0, qty);
+    }
+
+private:
+    SymbolId mSymbolId;
+    uint64_t mSeq{0};
+    IOrderEventSink* mSink{nullptr};
+
+    void emit(const OrderEventType type, const OrderId id, const Side side, const Price price, const Quantity qty)
+    {
+        if (!mSink)
+        {
+            return;
+        }
+        OrderEvent e;
+        e.seq = ++mSeq;
+        e.orderId = id;
+        e.price = price;
+        e.qty = qty;
+        e.symbolId = mSymbolId;
+        e.type = type;
+        e.side = side;
+        mSink->onOrderEvent(e);
+    }
+};
+
+#endif //ORDEREVENT_H
@@ -0,0 +1,143 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "OrderFeedWriter.h"
+#include "../Codec/BinaryCodec.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+OrderFeedWriter::OrderFeedWriter(const size_t producers, const size_t slots, const std::string& path) :
+    mBuffer(FLUSH_BYTES + BinaryCodec::MAX_ORDER_EVENT_SIZE)
+{
+    if (producers == 0)
+    {
+        throw std::invalid_argument("OrderFeedWriter: needs at least one producer");
+    }
+    mProducers.reserve(producers);
+    for (size_t i = 0; i < producers; i++)
+    {
+        mProducers.push_back(std::make_unique<Producer>(slots));
+    }
+    mFd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (mFd < 0)
+    {
+        throw std::runtime_error("OrderFeedWriter: cannot open " + path + ": " + std::strerror(errno));
+    }
+}
+
+OrderFeedWriter::~OrderFeedWriter()
+{
+    stop();
+    if (mFd >= 0)
+    {
+        ::close(mFd);
+    }
+}
+
+void OrderFeedWriter::start()
+{
+    if (mRunning.exchange(true))
+    {
+        return;
+    }
+    mThread = std::thread([this] { run(); });
+}
+
+void OrderFeedWriter::stop()
+{
+    mRunning.store(false, std::memory_order_release);
+    if (mThread.joinable())
+    {
+        mThread.join();
+    }
+}
+
+uint64_t OrderFeedWriter::dropped() const
+{
+    uint64_t total = 0;
+    for (const auto& p : mProducers)
+    {
+        total += p->mDropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void OrderFeedWriter::flush()
+{
+    size_t off = 0;
+    while (off < mBuffered)
+    {
+        const ssize_t n = ::write(mFd, mBuffer.data() + off, mBuffered - off);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            // Nothing upstream can act on it: report once per failed flush and lose the batch.
+            std::cerr << "OrderFeedWriter: write failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        off += static_cast<size_t>(n);
+    }
+    mBytes.fetch_add(off, std::memory_order_relaxed);
+    mBuffered = 0;
+}
+
+void OrderFeedWriter::run()
+{
+    constexpr unsigned SPINS = 64;
+    constexpr unsigned YIELDS = 16;
+    unsigned idle = 0;
+    const auto encode = [this](const OrderEvent& e)
+    {
+        mBuffered += BinaryCodec::encodeOrderEvent(e, mBuffer.data() + mBuffered, mBuffer.size() - mBuffered);
+        if (mBuffered >= FLUSH_BYTES)
+        {
+            flush();
+        }
+    };
+
+    while (true)
+    {
+        // Read before draining: once it is false, a pass that finds every ring empty is the last one.
+        const bool running = mRunning.load(std::memory_order_acquire);
+        size_t n = 0;
+        for (const auto& p : mProducers)
+        {
+            n += p->mRing.drain(encode, MAX_BATCH);
+        }
+        if (n > 0)
+        {
+            mWritten.fetch_add(n, std::memory_order_relaxed);
+            idle = 0;
+            continue;
+        }
+        if (mBuffered > 0)
+        {
+            flush();
+        }
+        if (!running)
+        {
+            return;
+        }
+        if (++idle <= SPINS)
+        {
+            continue;
+        }
+        if (idle <= SPINS + YIELDS)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+    }
+}
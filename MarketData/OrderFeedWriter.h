@@ -0,0 +1,113 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef ORDERFEEDWRITER_H
+#define ORDERFEEDWRITER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "OrderEvent.h"
+#include "../Concurrency/SpscRing.h"
+
+/**
+ * @class OrderFeedWriter
+ * @brief Carries L3 order events from the book workers into a file, encoded with
+ * BinaryCodec::encodeOrderEvent() back to back.
+ *
+ * @details
+ * - Each book worker publishes into its own SPSC ring, like ReportStream: a copy and a release
+ *   store, never a lock or an allocation. An event that finds its ring full is dropped and counted;
+ *   the hole it leaves in its book's sequence tells the consumer its copy of the book is stale.
+ * - One writer thread drains the rings, encodes into a buffer and writes it out whenever it holds
+ *   FLUSH_BYTES or the rings run dry. Events of one book stay in order; books interleave.
+ * - The file can be a regular file consumers tail, or a FIFO a consumer reads live.
+ */
+class OrderFeedWriter {
+public:
+    static constexpr size_t DEFAULT_RING_SLOTS = 65536;
+    static constexpr size_t MAX_BATCH = 256;           ///< Events taken from one ring before moving on
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;   ///< Buffered output written in one go
+    static constexpr auto IDLE_SLEEP = std::chrono::microseconds(50);
+
+    /** @brief The publishing end of one ring; an IOrderEventSink a book can be given. */
+    class Producer final : public IOrderEventSink {
+    public:
+        explicit Producer(const size_t slots) : mRing(slots) {}
+
+        void onOrderEvent(const OrderEvent& event) override
+        {
+            if (!mRing.tryPush(event))
+            {
+                // Single writer: load + store, no locked RMW.
+                mDropped.store(mDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        friend class OrderFeedWriter;
+        SpscRing<OrderEvent> mRing;
+        std::atomic<uint64_t> mDropped{0};
+    };
+
+    /**
+     * @param producers Number of rings, one per book worker.
+     * @param slots Capacity of each ring, a power of two.
+     * @param path File the events are written to, created or truncated.
+     * @throws std::runtime_error if the file cannot be opened.
+     */
+    OrderFeedWriter(size_t producers, size_t slots, const std::string& path);
+
+    /** @brief Stops the writer thread (see stop()) and closes the file. */
+    ~OrderFeedWriter();
+
+    OrderFeedWriter(const OrderFeedWriter&) = delete;
+    OrderFeedWriter& operator=(const OrderFeedWriter&) = delete;
+
+    /** @brief Starts the writer thread. */
+    void start();
+
+    /**
+     * @brief Writes what is left in the rings and stops the writer thread.
+     * @pre No producer publishes any more (the book workers are shut down).
+     */
+    void stop();
+
+    /** @brief Publishing end of ring `i`, for the books of one worker. */
+    Producer& producer(const size_t i) { return *mProducers.at(i); }
+
+    size_t producers() const { return mProducers.size(); }
+
+    /** @brief Events taken from the rings and encoded for the file so far. */
+    uint64_t written() const { return mWritten.load(std::memory_order_relaxed); }
+
+    /** @brief Encoded bytes written to the file so far. */
+    uint64_t bytes() const { return mBytes.load(std::memory_order_relaxed); }
+
+    /** @brief Events dropped on a full ring so far, over all producers. */
+    uint64_t dropped() const;
+
+private:
+    std::vector<std::unique_ptr<Producer>> mProducers;
+    int mFd{-1};
+    std::thread mThread;
+    std::atomic<bool> mRunning{false};
+    std::atomic<uint64_t> mWritten{0};
+    std::atomic<uint64_t> mBytes{0};
+    std::vector<uint8_t> mBuffer; ///< Writer thread only
+    size_t mBuffered{0};          ///< Bytes used in mBuffer
+
+    /** @brief Writer loop: drains and encodes until stopped and drained. */
+    void run();
+
+    /** @brief Writes the buffered bytes to the file. */
+    void flush();
+};
+
+#endif //ORDERFEEDWRITER_H
@@ -0,0 +1,122 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef TOPOFBOOK_H
+#define TOPOFBOOK_H
+
+#include <atomic>
+#include "../OrderBook/Order/Types.h"
+
+/**
+ * @struct Quote
+ * @brief Best bid, best ask and last trade of one book at one point in time.
+ *
+ * A side with no resting orders has price and quantity 0; so does the last trade before the first one.
+ */
+struct Quote
+{
+    uint64_t version{0}; ///< Number of changes published before this one was; 0 = nothing published yet
+    Price bidPrice{0};
+    Quantity bidQty{0};  ///< Aggregate open quantity at the best bid
+    Price askPrice{0};
+    Quantity askQty{0};  ///< Aggregate open quantity at the best ask
+    Price lastPrice{0};
+    Quantity lastQty{0};
+
+    /** @brief True if the market data is the same; `version` is not compared. */
+    bool sameAs(const Quote& other) const
+    {
+        return bidPrice == other.bidPrice && bidQty == other.bidQty && askPrice == other.askPrice
+            && askQty == other.askQty && lastPrice == other.lastPrice && lastQty == other.lastQty;
+    }
+};
+
+/**
+ * @class TopOfBook
+ * @brief A book's Quote, written by the book's worker and readable from any thread (seqlock).
+ *
+ * @details
+ * - The writer makes the sequence odd, stores the fields and makes it even again. A reader takes
+ *   the sequence, copies the fields and checks that the sequence is even and has not moved; if it
+ *   has, the copy may be torn and is thrown away.
+ * - Readers only load. They never write a shared cache line, so any number of them cannot slow the
+ *   writer down beyond the line moving to their core and back.
+ * - Sequence and fields share one 64-byte line: a publish dirties one line, a read fetches one.
+ * - The fields are relaxed atomics so a read that races a write is defined behaviour; on x86-64 and
+ *   AArch64 they compile to plain loads and stores.
+ */
+class alignas(64) TopOfBook {
+public:
+    /**
+     * @brief Publishes a new quote. Owning worker only.
+     * @return Version the quote was published under.
+     */
+    uint64_t publish(const Quote& q)
+    {
+        const uint64_t seq = mSeq.load(std::memory_order_relaxed);
+        mSeq.store(seq + 1, std::memory_order_relaxed);
+        // Orders the odd sequence before the field stores below (pairs with the reader's acquire fence).
+        std::atomic_thread_fence(std::memory_order_release);
+        mBidPrice.store(q.bidPrice, std::memory_order_relaxed);
+        mBidQty.store(q.bidQty, std::memory_order_relaxed);
+        mAskPrice.store(q.askPrice, std::memory_order_relaxed);
+        mAskQty.store(q.askQty, std::memory_order_relaxed);
+        mLastPrice.store(q.lastPrice, std::memory_order_relaxed);
+        mLastQty.store(q.lastQty, std::memory_order_relaxed);
+        mSeq.store(seq + 2, std::memory_order_release);
+        return seq / 2 + 1;
+    }
+
+    /**
+     * @brief One attempt at a consistent copy. Wait-free: a fixed number of loads, no loop.
+     * @return false if a publish was in progress or completed meanwhile; `out` is then unspecified.
+     */
+    bool tryRead(Quote& out) const
+    {
+        const uint64_t before = mSeq.load(std::memory_order_acquire);
+        if (before & 1)
+        {
+            return false;
+        }
+        out.bidPrice = mBidPrice.load(std::memory_order_relaxed);
+        out.bidQty = mBidQty.load(std::memory_order_relaxed);
+        out.askPrice = mAskPrice.load(std::memory_order_relaxed);
+        out.askQty = mAskQty.load(std::memory_order_relaxed);
+        out.lastPrice = mLastPrice.load(std::memory_order_relaxed);
+        out.lastQty = mLastQty.load(std::memory_order_relaxed);
+        // Keeps the field loads above from moving below the second sequence load.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        out.version = before / 2;
+        return mSeq.load(std::memory_order_relaxed) == before;
+    }
+
+    /**
+     * @brief A consistent copy, retrying while the writer is mid-publish.
+     * @remarks A publish is a handful of stores, so a retry is rare and short; a reader that must
+     * bound its own latency calls tryRead() and decides itself.
+     */
+    Quote read() const
+    {
+        Quote q;
+        while (!tryRead(q))
+        {
+        }
+        return q;
+    }
+
+private:
+    std::atomic<uint64_t> mSeq{0}; ///< Odd while a publish is in progress
+    std::atomic<Price> mBidPrice{0};
+    std::atomic<Quantity> mBidQty{0};
+    std::atomic<Price> mAskPrice{0};
+    std::atomic<Quantity> mAskQty{0};
+    std::atomic<Price> mLastPrice{0};
+    std::atomic<Quantity> mLastQty{0};
+};
+
+static_assert(sizeof(TopOfBook) == 64, "TopOfBook must fill exactly one cache line");
+
+#endif //TOPOFBOOK_H
@@ -0,0 +1,178 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @class LatencyHistogram
+ * @brief Fixed-size log-linear histogram of nanosecond latencies, safe to record from many threads.
+ *
+ * @details
+ * Values below 16 ns get one bucket each; above that every power of two is split into 16 linear
+ * sub-buckets, so a reported percentile is at most ~6% above the true value. The whole range of
+ * uint64_t fits in 976 buckets, so recording never allocates and never branches on range.
+ * Buckets are relaxed atomics: recording is one fetch_add, reading is only meaningful once the
+ * writers are quiescent (or as an approximate live view). A histogram with a single writer can use
+ * recordOwned() instead, which updates with plain loads and stores and no locked instruction.
+ */
+class LatencyHistogram {
+ static constexpr unsigned SUB_BITS = 4;
+ static constexpr uint64_t SUB_COUNT = 1u << SUB_BITS;
+ static constexpr size_t BUCKETS = SUB_COUNT + (64 - SUB_BITS) * SUB_COUNT;
+
+ std::array<std::atomic<uint64_t>, BUCKETS> mBuckets{};
+ std::atomic<uint64_t> mCount{0};
+ std::atomic<uint64_t> mSum{0};
+ std::atomic<uint64_t> mMax{0};
+
+ static void bump(std::atomic<uint64_t>& a, const uint64_t n) noexcept
+ {
+  a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+ }
+
+ static size_t bucketOf(const uint64_t v) noexcept
+ {
+  if(v < SUB_COUNT)
+  {
+   return static_cast<size_t>(v);
+  }
+  const unsigned exp = 63 - std::countl_zero(v); // >= SUB_BITS
+  const uint64_t sub = (v >> (exp - SUB_BITS)) & (SUB_COUNT - 1);
+  return SUB_COUNT + (exp - SUB_BITS) * SUB_COUNT + sub;
+ }
+
+ /** @brief Largest value that falls into bucket `b`. */
+ static uint64_t upperBoundOf(const size_t b) noexcept
+ {
+  if(b < SUB_COUNT)
+  {
+   return b;
+  }
+  const unsigned exp = static_cast<unsigned>((b - SUB_COUNT) / SUB_COUNT) + SUB_BITS;
+  const uint64_t sub = (b - SUB_COUNT) % SUB_COUNT;
+  const uint64_t width = uint64_t{1} << (exp - SUB_BITS);
+  return (uint64_t{1} << exp) + (sub + 1) * width - 1;
+ }
+
+public:
+ struct Summary
+ {
+  uint64_t count{0};
+  uint64_t p50{0};
+  uint64_t p90{0};
+  uint64_t p99{0};
+  uint64_t p999{0};
+  uint64_t max{0};
+ };
+
+ /** @brief Monotonic timestamp in nanoseconds, the clock every recorded latency is measured on. */
+ static uint64_t nowNs() noexcept
+ {
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+ }
+
+ void record(const uint64_t ns) noexcept
+ {
+  mBuckets[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+  mCount.fetch_add(1, std::memory_order_relaxed);
+  mSum.fetch_add(ns, std::memory_order_relaxed);
+  uint64_t prev = mMax.load(std::memory_order_relaxed);
+  while(ns > prev && !mMax.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+ }
+
+ /**
+  * @brief record() for a histogram only the calling thread writes: no read-modify-write, so a
+  * sample costs a few plain stores. Other threads may still read it.
+  */
+ void recordOwned(const uint64_t ns) noexcept
+ {
+  bump(mBuckets[bucketOf(ns)], 1);
+  bump(mCount, 1);
+  bump(mSum, ns);
+  if(ns > mMax.load(std::memory_order_relaxed))
+  {
+   mMax.store(ns, std::memory_order_relaxed);
+  }
+ }
+
+ /** @brief Records the time elapsed since `startNs` (a nowNs() value). */
+ void recordSince(const uint64_t startNs) noexcept
+ {
+  const uint64_t now = nowNs();
+  record(now > startNs ? now - startNs : 0);
+ }
+
+ uint64_t count() const noexcept
+ {
+  return mCount.load(std::memory_order_relaxed);
+ }
+
+ /** @brief Sum of every recorded value, in nanoseconds. */
+ uint64_t sum() const noexcept
+ {
+  return mSum.load(std::memory_order_relaxed);
+ }
+
+ /**
+  * @brief Smallest bucket bound below which at least `q` (0..1) of the samples fall.
+  * @return 0 when empty.
+  */
+ uint64_t percentile(const double q) const noexcept
+ {
+  const uint64_t total = count();
+  if(total == 0)
+  {
+   return 0;
+  }
+  const auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+  uint64_t seen = 0;
+  for(size_t b = 0; b < BUCKETS; b++)
+  {
+   seen += mBuckets[b].load(std::memory_order_relaxed);
+   if(seen >= rank)
+   {
+    const uint64_t bound = upperBoundOf(b);
+    const uint64_t mx = mMax.load(std::memory_order_relaxed);
+    return bound < mx ? bound : mx;
+   }
+  }
+  return mMax.load(std::memory_order_relaxed);
+ }
+
+ Summary summary() const noexcept
+ {
+  return {count(), percentile(0.50), percentile(0.90), percentile(0.99), percentile(0.999),
+          mMax.load(std::memory_order_relaxed)};
+ }
+
+ void reset() noexcept
+ {
+  for(auto& b : mBuckets)
+  {
+   b.store(0, std::memory_order_relaxed);
+  }
+  mCount.store(0, std::memory_order_relaxed);
+  mSum.store(0, std::memory_order_relaxed);
+  mMax.store(0, std::memory_order_relaxed);
+ }
+};
+
+inline std::ostream& operator<<(std::ostream& os, const LatencyHistogram::Summary& s)
+{
+ return os << "n=" << s.count << " p50=" << s.p50 << "ns p90=" << s.p90 << "ns p99=" << s.p99
+           << "ns p99.9=" << s.p999 << "ns max=" << s.max << "ns";
+}
+
+#endif //LATENCYHISTOGRAM_H
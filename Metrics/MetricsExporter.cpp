@@ -0,0 +1,177 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "MetricsExporter.h"
+#include "../Ingress/Endpoint.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    constexpr int REQUEST_WAIT_MS = 100; ///< How long a scraper gets to send its request line
+
+    bool writeAll(const int fd, const char* data, size_t len)
+    {
+        while (len > 0)
+        {
+            const ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            data += n;
+            len -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+}
+
+MetricsExporter::MetricsExporter(const MetricsRegistry& registry, Options options) :
+    mRegistry(registry), mOptions(std::move(options))
+{
+    if (mOptions.file.empty() && mOptions.listen.empty())
+    {
+        throw std::invalid_argument("MetricsExporter: needs a file or an endpoint");
+    }
+    if (!mOptions.listen.empty())
+    {
+        mListenFd = Endpoint::Parse(mOptions.listen).listen(16);
+    }
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+    if (mListenFd >= 0)
+    {
+        ::close(mListenFd);
+    }
+}
+
+void MetricsExporter::start()
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        if (mRunning)
+        {
+            return;
+        }
+        mRunning = true;
+    }
+    mThread = std::thread([this] { run(); });
+}
+
+void MetricsExporter::stop()
+{
+    {
+        std::lock_guard<std::mutex> lk(mMutex);
+        mRunning = false;
+    }
+    mCv.notify_all();
+    if (mThread.joinable())
+    {
+        mThread.join();
+        if (!mOptions.file.empty())
+        {
+            writeFile();
+        }
+    }
+}
+
+std::string MetricsExporter::render() const
+{
+    std::string out;
+    out.reserve(16 * 1024);
+    mRegistry.render(out);
+    return out;
+}
+
+void MetricsExporter::writeFile() const
+{
+    const std::string tmp = mOptions.file + ".tmp";
+    const std::string text = render();
+    FILE* f = std::fopen(tmp.c_str(), "w");
+    if (!f)
+    {
+        std::cerr << "MetricsExporter: cannot write " << tmp << ": " << std::strerror(errno) << std::endl;
+        return;
+    }
+    const bool ok = std::fwrite(text.data(), 1, text.size(), f) == text.size();
+    if (std::fclose(f) != 0 || !ok || std::rename(tmp.c_str(), mOptions.file.c_str()) != 0)
+    {
+        std::cerr << "MetricsExporter: cannot write " << mOptions.file << ": " << std::strerror(errno) << std::endl;
+    }
+}
+
+void MetricsExporter::serve() const
+{
+    while (true)
+    {
+        const int fd = ::accept(mListenFd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            return; // EAGAIN: nothing pending
+        }
+        // Only GETs are expected; the request itself does not matter, every path gets the metrics.
+        pollfd p{fd, POLLIN, 0};
+        char request[1024];
+        if (::poll(&p, 1, REQUEST_WAIT_MS) > 0)
+        {
+            [[maybe_unused]] const ssize_t ignored = ::recv(fd, request, sizeof(request), 0);
+        }
+        const std::string body = render();
+        const std::string head = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+            + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+        if (writeAll(fd, head.data(), head.size()))
+        {
+            writeAll(fd, body.data(), body.size());
+        }
+        ::close(fd);
+    }
+}
+
+void MetricsExporter::run()
+{
+    auto next = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lk(mMutex);
+    while (mRunning)
+    {
+        if (std::chrono::steady_clock::now() >= next)
+        {
+            next += mOptions.period;
+            if (!mOptions.file.empty())
+            {
+                lk.unlock();
+                writeFile();
+                lk.lock();
+            }
+        }
+        if (mListenFd < 0)
+        {
+            mCv.wait_until(lk, next, [this] { return !mRunning; });
+            continue;
+        }
+        // Wait for a scraper until the next file write; stop() is noticed within one wait slice.
+        lk.unlock();
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(next - std::chrono::steady_clock::now());
+        pollfd p{mListenFd, POLLIN, 0};
+        if (::poll(&p, 1, static_cast<int>(std::clamp<int64_t>(left.count(), 0, 100))) > 0)
+        {
+            serve();
+        }
+        lk.lock();
+    }
+}
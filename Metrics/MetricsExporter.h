@@ -0,0 +1,77 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef METRICSEXPORTER_H
+#define METRICSEXPORTER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "MetricsRegistry.h"
+
+/**
+ * @class MetricsExporter
+ * @brief Background thread that renders a MetricsRegistry in Prometheus text format and makes it
+ * available to a scraper: as a file (node_exporter textfile collector style), on a local socket
+ * answering HTTP GETs, or both.
+ *
+ * @details
+ * - The file is rewritten every `period` through a temporary file and a rename, so a reader never
+ *   sees a half-written file.
+ * - The socket is served by the same thread: each connection gets a freshly rendered page and is
+ *   closed. Scrapes are rare and small, one thread is plenty and keeps the workers untouched.
+ * - Rendering only reads the registry (see MetricsRegistry), the book workers are never paused.
+ */
+class MetricsExporter {
+public:
+    struct Options
+    {
+        std::string file;   ///< File to rewrite every period, empty = none
+        std::string listen; ///< Endpoint spec to serve on (`tcp:127.0.0.1:9464`, `unix:/tmp/ome-metrics.sock`), empty = none
+        std::chrono::milliseconds period{1000};
+    };
+
+    /**
+     * @throws std::invalid_argument if neither a file nor an endpoint is given.
+     * @throws std::runtime_error if the endpoint cannot be bound.
+     */
+    MetricsExporter(const MetricsRegistry& registry, Options options);
+
+    /** @brief Stops the thread (see stop()) and closes the socket. */
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    void start();
+
+    /** @brief Writes the file one last time and stops the thread. */
+    void stop();
+
+    /** @brief Renders the registry now, on the calling thread. */
+    std::string render() const;
+
+private:
+    const MetricsRegistry& mRegistry;
+    Options mOptions;
+    int mListenFd{-1};
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mCv;
+    bool mRunning{false}; ///< Guarded by mMutex
+
+    void run();
+
+    /** @brief Replaces the file with a fresh rendering. */
+    void writeFile() const;
+
+    /** @brief Accepts whatever connections are pending and answers each with a rendering. */
+    void serve() const;
+};
+
+#endif //METRICSEXPORTER_H
@@ -0,0 +1,119 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "MetricsRegistry.h"
+
+#include <cstdio>
+#include <iterator>
+
+namespace
+{
+    struct CounterSpec
+    {
+        const char* name;
+        const char* help;
+        OwnedCounter WorkerMetrics::* counter;
+    };
+
+    constexpr CounterSpec COUNTERS[] = {
+        {"ome_orders_total", "New orders and replacements that reached a book.", &WorkerMetrics::ordersReceived},
+        {"ome_orders_rejected_total", "Orders aborted by the book pipeline.", &WorkerMetrics::ordersRejected},
+        {"ome_fills_total", "Executions, one per matched resting order.", &WorkerMetrics::fills},
+        {"ome_filled_quantity_total", "Quantity executed.", &WorkerMetrics::filledQty},
+        {"ome_orders_cancelled_total", "Resting orders cancelled.", &WorkerMetrics::ordersCancelled},
+        {"ome_cancels_rejected_total", "Cancels and amends naming an order that is not resting.",
+         &WorkerMetrics::cancelsRejected},
+        {"ome_amends_total", "Amends applied.", &WorkerMetrics::amends},
+        {"ome_amends_rejected_total", "Amends of a resting order refused by quantity, lot, band or risk.",
+         &WorkerMetrics::amendsRejected},
+    };
+
+    constexpr const char* STAGE_NAMES[] = {"queue", "book", "end_to_end"};
+    static_assert(std::size(STAGE_NAMES) == static_cast<size_t>(Stage::COUNT));
+
+    constexpr double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+    void header(std::string& out, const char* name, const char* help, const char* type)
+    {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += '\n';
+    }
+
+    void number(std::string& out, const double v)
+    {
+        char buf[32];
+        const int n = std::snprintf(buf, sizeof(buf), "%.9g", v);
+        out.append(buf, static_cast<size_t>(n));
+    }
+}
+
+WorkerMetrics& MetricsRegistry::addWorker(const std::string& name)
+{
+    mWorkers.emplace_back(name, std::make_unique<WorkerMetrics>());
+    return *mWorkers.back().second;
+}
+
+void MetricsRegistry::addGauge(std::string name, std::string help, std::string label, GaugeFn fn)
+{
+    mGauges.push_back({std::move(name), std::move(help), std::move(label), std::move(fn)});
+}
+
+void MetricsRegistry::render(std::string& out) const
+{
+    for (const auto& spec : COUNTERS)
+    {
+        header(out, spec.name, spec.help, "counter");
+        for (const auto& [worker, m] : mWorkers)
+        {
+            out += spec.name;
+            out += "{worker=\"" + worker + "\"} ";
+            out += std::to_string(((*m).*spec.counter).value());
+            out += '\n';
+        }
+    }
+
+    constexpr const char* latency = "ome_stage_latency_seconds";
+    header(out, latency, "Latency of each stage of an order, from its ingress timestamp.", "summary");
+    for (const auto& [worker, m] : mWorkers)
+    {
+        for (size_t s = 0; s < m->stages.size(); s++)
+        {
+            const LatencyHistogram& h = m->stages[s];
+            const std::string labels = "worker=\"" + worker + "\",stage=\"" + STAGE_NAMES[s] + "\"";
+            for (const double q : QUANTILES)
+            {
+                out += latency;
+                out += '{' + labels + ",quantile=\"";
+                number(out, q);
+                out += "\"} ";
+                number(out, static_cast<double>(h.percentile(q)) / 1e9);
+                out += '\n';
+            }
+            out += latency;
+            out += "_sum{" + labels + "} ";
+            number(out, static_cast<double>(h.sum()) / 1e9);
+            out += '\n';
+            out += latency;
+            out += "_count{" + labels + "} " + std::to_string(h.count()) + '\n';
+        }
+    }
+
+    for (const auto& g : mGauges)
+    {
+        header(out, g.name.c_str(), g.help.c_str(), "gauge");
+        for (const auto& [value, v] : g.fn())
+        {
+            out += g.name + '{' + g.label + "=\"" + value + "\"} ";
+            number(out, v);
+            out += '\n';
+        }
+    }
+}
@@ -0,0 +1,61 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "WorkerMetrics.h"
+
+/**
+ * @class MetricsRegistry
+ * @brief Every metric the engine exports: the book workers' WorkerMetrics and gauges sampled on demand
+ * (queue depths), rendered in the Prometheus text exposition format.
+ *
+ * @details
+ * Registration happens while the engine is set up, before the workers start and before any export;
+ * the registry is not changed afterwards, so render() reads it without locking. Rendering only loads
+ * the workers' relaxed atomics: the workers are never stopped or synchronised with.
+ */
+class MetricsRegistry {
+public:
+    /** @brief Returns the current values of a gauge, one per label value. */
+    using GaugeFn = std::function<std::vector<std::pair<std::string, double>>()>;
+
+    /**
+     * @brief Creates the metrics block of one worker, exported with `worker="<name>"`.
+     * @return The block; it stays at the same address for the registry's lifetime.
+     */
+    WorkerMetrics& addWorker(const std::string& name);
+
+    /**
+     * @brief Registers a gauge family sampled at every render.
+     * @param name Metric name, e.g. `ome_queue_depth`.
+     * @param label Label the values of `fn` are exported under, e.g. `worker`.
+     */
+    void addGauge(std::string name, std::string help, std::string label, GaugeFn fn);
+
+    /** @brief Appends every metric to `out` in Prometheus text format (version 0.0.4). */
+    void render(std::string& out) const;
+
+private:
+    struct Gauge
+    {
+        std::string name;
+        std::string help;
+        std::string label;
+        GaugeFn fn;
+    };
+
+    std::vector<std::pair<std::string, std::unique_ptr<WorkerMetrics>>> mWorkers;
+    std::vector<Gauge> mGauges;
+};
+
+#endif //METRICSREGISTRY_H
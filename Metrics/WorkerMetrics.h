@@ -0,0 +1,72 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef WORKERMETRICS_H
+#define WORKERMETRICS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include "LatencyHistogram.h"
+
+/**
+ * @class OwnedCounter
+ * @brief Monotonic counter with one writing thread and any number of readers.
+ *
+ * The owner adds with a relaxed load and store, not a locked read-modify-write, so counting costs the
+ * same as a plain increment; readers get a value that is at most a few increments old.
+ */
+class OwnedCounter {
+public:
+    void add(const uint64_t n = 1) noexcept
+    {
+        mValue.store(mValue.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const noexcept { return mValue.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> mValue{0};
+};
+
+/**
+ * @brief Stages of an order's way through the engine that are timed, from its ingress timestamp.
+ */
+enum class Stage : uint8_t
+{
+    QUEUE = 0,   ///< Ingress to the book worker starting the task: decode, validation and both queues
+    BOOK = 1,    ///< The book worker's task: matching, risk, reports, resting
+    END_TO_END = 2, ///< Ingress to the book worker finishing the task
+    COUNT = 3
+};
+
+/**
+ * @struct WorkerMetrics
+ * @brief Counters and stage latencies of one book worker, written only by that worker.
+ *
+ * @details
+ * - One instance per worker, aligned to its own cache lines: workers never share a line they write,
+ *   and an exporter reading it costs the worker at most a line coming back now and then.
+ * - Everything is relaxed atomics updated with OwnedCounter / LatencyHistogram::recordOwned(), so
+ *   the exporter can read while the worker writes without locks and without undefined behaviour.
+ */
+struct alignas(64) WorkerMetrics
+{
+    OwnedCounter ordersReceived;   ///< New orders and replacements that reached a book
+    OwnedCounter ordersRejected;   ///< Of those, aborted by the book's pipeline (validation, risk...)
+    OwnedCounter fills;            ///< Executions, one per matched resting order
+    OwnedCounter filledQty;        ///< Quantity executed
+    OwnedCounter ordersCancelled;  ///< Resting orders cancelled, one by one or by mass cancel
+    OwnedCounter cancelsRejected;  ///< Cancels and amends naming an order that is not resting
+    OwnedCounter amends;           ///< Amends applied, in place or as cancel/replace
+    OwnedCounter amendsRejected;   ///< Amends of a resting order refused: quantity, lot, band or risk
+    std::array<LatencyHistogram, static_cast<size_t>(Stage::COUNT)> stages;
+
+    LatencyHistogram& stage(const Stage s) { return stages[static_cast<size_t>(s)]; }
+    const LatencyHistogram& stage(const Stage s) const { return stages[static_cast<size_t>(s)]; }
+};
+
+#endif //WORKERMETRICS_H
@@ -16,6 +16,32 @@
 #include "Types.h"        // OrderId, Side, Quantity, Symbol, Price, TIF, Status, Type
 #include "Validation.h"   // IValidator
 
+class Order;
+
+/**
+ * @class OrderResult
+ * @brief Outcome of a non-throwing Order factory: either the order or the reason it was refused
+ * (std::expected-style; the project targets C++20).
+ */
+class OrderResult
+{
+public:
+    OrderResult(std::unique_ptr<Order> order) noexcept : mOrder(std::move(order)) {}
+    OrderResult(const RejectReason error) noexcept : mError(error) {}
+
+    explicit operator bool() const noexcept { return mOrder != nullptr; }
+
+    /** @brief Reject code, RejectReason::NONE on success. */
+    RejectReason error() const noexcept { return mError; }
+
+    /** @brief Moves the order out. Only valid on success. */
+    std::unique_ptr<Order> take() noexcept { return std::move(mOrder); }
+
+private:
+    std::unique_ptr<Order> mOrder;
+    RejectReason mError{RejectReason::NONE};
+};
+
 class Order
 {
     // Order type payloads: there payloads are specific to oder 
@@ -131,6 +157,85 @@ public:
         return MakeStopLimit(id, side, qty, std::move(symbol), limitPrice, stopPrice, DefaultValidator(), tif);
     }
 
+    // ====================== Non-throwing static factories ======================
+    // Same orders as the factories above, but a validation failure is returned as a reject code
+    // instead of thrown, so a flood of bad orders costs no unwinding and no allocation.
+
+    static OrderResult TryMakeLimit(const OrderId id,
+                                    const Side side,
+                                    const Quantity qty,
+                                    Symbol symbol,
+                                    const Price limitPrice,
+                                    const TIF tif = TIF::DEFAULT,
+                                    const IValidator& validator = DefaultValidator())
+    {
+        return tryMakeAndValidate(id, side, qty, std::move(symbol),
+                                  Type::LIMIT, limitPrice, Price{0}, tif, validator);
+    }
+
+    static OrderResult TryMakeMarket(const OrderId id,
+                                     const Side side,
+                                     const Quantity qty,
+                                     Symbol symbol,
+                                     const TIF tif = TIF::DEFAULT,
+                                     const IValidator& validator = DefaultValidator())
+    {
+        return tryMakeAndValidate(id, side, qty, std::move(symbol),
+                                  Type::MARKET, Price{0}, Price{0}, tif, validator);
+    }
+
+    static OrderResult TryMakeStop(const OrderId id,
+                                   const Side side,
+                                   const Quantity qty,
+                                   Symbol symbol,
+                                   const Price stopPrice,
+                                   const TIF tif = TIF::DEFAULT,
+                                   const IValidator& validator = DefaultValidator())
+    {
+        return tryMakeAndValidate(id, side, qty, std::move(symbol),
+                                  Type::STOP, Price{0}, stopPrice, tif, validator);
+    }
+
+    static OrderResult TryMakeStopLimit(const OrderId id,
+                                        const Side side,
+                                        const Quantity qty,
+                                        Symbol symbol,
+                                        const Price limitPrice,
+                                        const Price stopPrice,
+                                        const TIF tif = TIF::DEFAULT,
+                                        const IValidator& validator = DefaultValidator())
+    {
+        return tryMakeAndValidate(id, side, qty, std::move(symbol),
+                                  Type::STOP_LIMIT, limitPrice, stopPrice, tif, validator);
+    }
+
+    // ============================ Snapshot restore ===========================
+
+    /**
+     * @brief Recreates a resting order from a book snapshot, exactly as it was saved.
+     * @remark Not validated: the order passed validation when it first arrived, and reference data
+     *   changed since must not evict orders that already rest.
+     */
+    static std::unique_ptr<Order> Restore(const OrderId id,
+                                          const Side side,
+                                          const Quantity qty,
+                                          const Quantity openQty,
+                                          Symbol symbol,
+                                          const Type type,
+                                          const Price price,
+                                          const Price stopPrice,
+                                          const TIF tif,
+                                          const Status status,
+                                          const AccountId account)
+    {
+        auto order = std::unique_ptr<Order>(
+            new Order{id, side, qty, std::move(symbol), type, price, stopPrice, tif});
+        order->mOpenQty = openQty;
+        order->mStatus = status;
+        order->mAccount = account;
+        return order;
+    }
+
     OrderId id()        const noexcept { return mId; }
     Side side()         const noexcept { return mSide; }
     Side oppositeSide() const noexcept { return (mSide == Side::BUY) ? Side::SELL : Side::BUY; }
@@ -143,16 +248,52 @@ public:
     Price price()       const noexcept { return mPrice; }
     Price stopPrice()   const noexcept { return mStopPrice; }
     TIF tif()           const noexcept { return mTif; }
+    SessionId session() const noexcept { return mSession; }
+    AccountId account() const noexcept { return mAccount; }
+
+    /** @brief Tags the order with the session its reports must be sent to. */
+    void setSession(const SessionId session) noexcept
+    {
+        mSession = session;
+    }
+
+    /** @brief Books the order to an account, whose pre-trade risk limits then apply. */
+    void setAccount(const AccountId account) noexcept
+    {
+        mAccount = account;
+    }
 
     void updateOpenQty(const Quantity& qty)
     {
         mOpenQty = qty;
     }
 
+    /**
+     * @brief Lowers the open quantity of a resting order in place (amend down). The total follows,
+     * so filled quantity stays qty() - openQty().
+     */
+    void reduceOpenQty(const Quantity newOpenQty)
+    {
+        mQty = mQty - mOpenQty + newOpenQty;
+        mOpenQty = newOpenQty;
+    }
+
     void updateStatus(const Status& status)
     {
         mStatus = status;
     }
+
+    /**
+     * @brief Applies a cancel/replace: the order keeps its id and rests (or matches) again with
+     * the new open quantity and limit price. Filled quantity is preserved in qty().
+     */
+    void replace(const Quantity newOpenQty, const Price newPrice)
+    {
+        mQty = mQty - mOpenQty + newOpenQty;
+        mOpenQty = newOpenQty;
+        mPrice = newPrice;
+        mStatus = Status::PENDING;
+    }
 private:
 
     static std::shared_ptr<const IValidator>& DefaultValidatorPtr()
@@ -196,6 +337,29 @@ private:
         return tmp;
     }
 
+    /**
+     * @brief Non-throwing counterpart of makeAndValidate().
+     * @remark The candidate is validated on the stack and only moved to the heap once accepted, so a
+     *   rejected order never allocates.
+     */
+    static OrderResult tryMakeAndValidate(const OrderId id,
+                                          const Side side,
+                                          const Quantity qty,
+                                          Symbol symbol,
+                                          const Type type,
+                                          const Price price,
+                                          const Price stopPrice,
+                                          const TIF tif,
+                                          const IValidator& validator)
+    {
+        Order candidate{id, side, qty, std::move(symbol), type, price, stopPrice, tif};
+        if (const RejectReason code = validator.check(candidate); code != RejectReason::NONE)
+        {
+            return code;
+        }
+        return std::unique_ptr<Order>(new Order{std::move(candidate)});
+    }
+
     /** @brief Core ctor kept private to enforce factories */
     Order(const OrderId id, const Side side, const Quantity qty, Symbol symbol,
           const Type type, const Price price, const Price stopPrice, const TIF tif)
@@ -222,6 +386,8 @@ private:
     Price mPrice;     // For LIMIT or STOP_LIMIT
     Price mStopPrice; // For STOP or STOP_LIMIT
     TIF mTif{TIF::DEFAULT};
+    SessionId mSession{NO_SESSION};
+    AccountId mAccount{NO_ACCOUNT};
 };
 
 using OrderRawPtr = Order*;
@@ -11,16 +11,23 @@
 #include <cstdint>
 #include <chrono>
 #include <utility>
+#include <limits>
 
 using Price = int64_t;
 using Quantity = uint64_t;
 using OrderId = uint64_t;
 using Count = uint64_t;
 using Symbol = std::string;
+using SymbolId = uint32_t; // Dense index of a symbol, assigned once at startup (see SymbolTable)
+using SessionId = uint32_t; // Client session an order came from, reports are routed back to it (see ReportRouter)
+using AccountId = uint32_t; // Trading account an order is booked to, pre-trade risk is kept per account (see RiskEngine)
 using Timestamp = std::chrono::system_clock::time_point;
 
 constexpr uint64_t MAX = std::numeric_limits<int64_t>::max();
 constexpr Price PRICE_MAX = MAX;
+constexpr SymbolId INVALID_SYMBOL_ID = std::numeric_limits<SymbolId>::max();
+constexpr SessionId NO_SESSION = 0; // Internal or replayed flow, nobody to report to
+constexpr AccountId NO_ACCOUNT = 0; // Order not booked to an account, no pre-trade risk
 
 enum Side
 {
@@ -52,4 +59,52 @@ enum TIF : uint32_t {
     DEFAULT = DAY
 };
 
+/**
+ * @brief Why a request was rejected. Travels on the wire (see ExecReport), values are stable.
+ */
+enum class RejectReason : uint16_t
+{
+    NONE = 0,
+    UNKNOWN_ORDER = 1,   ///< Cancel / amend of an order that is not resting
+    VALIDATION = 2,      ///< Order failed validation in the book pipeline, or a custom validator
+    DECODE_ERROR = 3,    ///< Message could not be decoded; `orderId` is set only if it was read
+    UNKNOWN_SYMBOL = 4,  ///< Symbol not traded by this engine
+    BAD_QUANTITY = 5,    ///< Quantity must be > 0, and a replace's total above what already filled
+    BAD_PRICE = 6,       ///< Limit / stop-limit without a limit price > 0
+    BAD_STOP_PRICE = 7,  ///< Stop / stop-limit without a stop price > 0
+    BAD_TICK = 8,        ///< Limit or stop price not a multiple of the symbol's tick size
+    BAD_LOT = 9,         ///< Quantity not a multiple of the symbol's lot size
+    QTY_OUT_OF_RANGE = 10, ///< Quantity outside the symbol's [min, max]
+    PRICE_OUT_OF_BAND = 11, ///< Limit price outside the band around the last trade
+    RISK_NOTIONAL = 12,  ///< Account's open notional limit would be exceeded
+    RISK_OPEN_ORDERS = 13, ///< Account's open order count limit would be exceeded
+    RISK_POSITION = 14,  ///< Account's position limit in the symbol would be exceeded
+    DUPLICATE_ORDER_ID = 15 ///< New order with the id of an order still resting in the book
+};
+
+/** @brief Human-readable name of a reject reason, for logs. */
+constexpr const char* toString(const RejectReason r)
+{
+    switch (r)
+    {
+        case RejectReason::NONE: return "NONE";
+        case RejectReason::UNKNOWN_ORDER: return "UNKNOWN_ORDER";
+        case RejectReason::VALIDATION: return "VALIDATION";
+        case RejectReason::DECODE_ERROR: return "DECODE_ERROR";
+        case RejectReason::UNKNOWN_SYMBOL: return "UNKNOWN_SYMBOL";
+        case RejectReason::BAD_QUANTITY: return "BAD_QUANTITY";
+        case RejectReason::BAD_PRICE: return "BAD_PRICE";
+        case RejectReason::BAD_STOP_PRICE: return "BAD_STOP_PRICE";
+        case RejectReason::BAD_TICK: return "BAD_TICK";
+        case RejectReason::BAD_LOT: return "BAD_LOT";
+        case RejectReason::QTY_OUT_OF_RANGE: return "QTY_OUT_OF_RANGE";
+        case RejectReason::PRICE_OUT_OF_BAND: return "PRICE_OUT_OF_BAND";
+        case RejectReason::RISK_NOTIONAL: return "RISK_NOTIONAL";
+        case RejectReason::RISK_OPEN_ORDERS: return "RISK_OPEN_ORDERS";
+        case RejectReason::RISK_POSITION: return "RISK_POSITION";
+        case RejectReason::DUPLICATE_ORDER_ID: return "DUPLICATE_ORDER_ID";
+    }
+    return "UNKNOWN";
+}
+
 #endif //TYPES_H
@@ -4,39 +4,54 @@
 
 #include "Validation.h"
 #include "Order.h"
+#include "StaticValidator.h"
 
-bool QuantityValidator::validate(const Order& order, std::string& reason) const
+namespace
 {
-    if (order.qty() <= Quantity{0})
+    template <typename Rule>
+    RejectReason checkRule(const Order& order)
     {
-        reason = "Quantity must be > 0";
-        return false;
+        return StaticValidator<Rule>::Check(order);
     }
-    return true;
-}
 
-bool LimitPriceRequiredValidator::validate(const Order& order, std::string& reason) const
-{
-    if (order.type() == Type::LIMIT || order.type() == Type::STOP_LIMIT)
+    template <typename Rule>
+    bool validateRule(const Order& order, std::string& reason)
     {
-        if (order.price() <= Price{0})
+        if (checkRule<Rule>(order) != RejectReason::NONE)
         {
-            reason = "Limit/stop-limit requires limit price > 0";
+            reason = Rule::TEXT;
             return false;
         }
+        return true;
     }
-    return true;
+}
+
+bool QuantityValidator::validate(const Order& order, std::string& reason) const
+{
+    return validateRule<QuantityRule>(order, reason);
+}
+
+RejectReason QuantityValidator::check(const Order& order) const
+{
+    return checkRule<QuantityRule>(order);
+}
+
+bool LimitPriceRequiredValidator::validate(const Order& order, std::string& reason) const
+{
+    return validateRule<LimitPriceRule>(order, reason);
+}
+
+RejectReason LimitPriceRequiredValidator::check(const Order& order) const
+{
+    return checkRule<LimitPriceRule>(order);
 }
 
 bool StopPriceRequiredValidator::validate(const Order& order, std::string& reason) const
 {
-    if (order.type() == Type::STOP || order.type() == Type::STOP_LIMIT)
-    {
-        if (order.stopPrice() <= Price{0})
-        {
-            reason = "Stop/stop-limit requires stop price > 0";
-            return false;
-        }
-    }
-    return true;
-}
\ No newline at end of file
+    return validateRule<StopPriceRule>(order, reason);
+}
+
+RejectReason StopPriceRequiredValidator::check(const Order& order) const
+{
+    return checkRule<StopPriceRule>(order);
+}
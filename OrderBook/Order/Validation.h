@@ -15,24 +15,38 @@ class IValidator
 public:
     virtual ~IValidator() = default;
     virtual bool validate(const Order& order, std::string& reason) const = 0;
+
+    /**
+     * @brief Allocation-free variant of validate() used by the non-throwing factories.
+     * @return RejectReason::NONE if the order is valid. The default maps any failure of validate()
+     * to RejectReason::VALIDATION; the built-in validators return their specific code.
+     */
+    virtual RejectReason check(const Order& order) const
+    {
+        std::string reason;
+        return validate(order, reason) ? RejectReason::NONE : RejectReason::VALIDATION;
+    }
 };
 
 class QuantityValidator final : public IValidator
 {
 public:
     bool validate(const Order& order, std::string& reason) const override;
+    RejectReason check(const Order& order) const override;
 };
 
 class LimitPriceRequiredValidator final : public IValidator
 {
 public:
     bool validate(const Order& order, std::string& reason) const override;
+    RejectReason check(const Order& order) const override;
 };
 
 class StopPriceRequiredValidator final : public IValidator
 {
 public:
     bool validate(const Order& order, std::string& reason) const override;
+    RejectReason check(const Order& order) const override;
 };
 
 /**
@@ -64,6 +78,19 @@ public:
         return true;
     }
 
+    /** @brief Same as validate(), first failing code wins. */
+    RejectReason check(const Order& order) const override
+    {
+        for (const auto& v : mChain)
+        {
+            if (const RejectReason code = v->check(order); code != RejectReason::NONE)
+            {
+                return code;
+            }
+        }
+        return RejectReason::NONE;
+    }
+
 private:
     std::vector<std::unique_ptr<IValidator>> mChain; // List of validators
 };
@@ -71,6 +98,7 @@ private:
 class NoOpValidator final : public IValidator {
 public:
     bool validate(const Order&, std::string&) const override { return true; }
+    RejectReason check(const Order&) const override { return RejectReason::NONE; }
 };
 
 #endif // ORDER_VALIDATOR_H
@@ -4,30 +4,88 @@
 //
 
 #include "OrderBook.h"
+#include "SymbolTable.h"
 #include <iostream>
 #include <valarray>
 
 OrderBook::OrderBook(Symbol symbol):
-mSymbol(std::move(symbol))
+mSymbol(std::move(symbol)), mSymbolId(SymbolTable::instance().find(mSymbol)),
+mLimits(ReferenceData::instance().get(mSymbolId)), mDepth(mSymbolId), mOrderEvents(mSymbolId),
+mBars(mSymbolId)
 {
     // Forming order tracker for both order sides
     mTrackerStore.insert({Side::BUY,Tracker(Side::BUY)});
     mTrackerStore.insert({Side::SELL,Tracker(Side::SELL)});
+    for(auto& [_, tracker] : mTrackerStore)
+    {
+        tracker.setDepthFeed(&mDepth);
+        tracker.setOrderFeed(&mOrderEvents);
+    }
 
     // Creating pipeline instance
     mOrderPipeline = PipelineFactory::createPipeline();
 }
 
 // current logic only has LIMIT order.
-void OrderBook::matchOrder(Order& order)
+RejectReason OrderBook::matchOrder(Order& order, const Price riskPrice, const bool reserved)
 {
     // Fetch order tracker of opposite side
     Tracker& oppTracker = getOrderTracker(order.oppositeSide());
 
     // create context (captures originalQty)
-    ProcessingContext ctx(order, oppTracker);
+    mTrades.clear();
+    ProcessingContext ctx(order, oppTracker, mTrades);
+    ctx.limits = &mLimits;
+    ctx.risk = reserved ? nullptr : mRisk;
+    ctx.symbolId = mSymbolId;
+    ctx.riskPrice = riskPrice;
 
     mOrderPipeline.process(ctx);
+    if(ctx.aborted())
+    {
+        return ctx.rejectCode;
+    }
+    if(!mTrades.empty())
+    {
+        mLimits.onTrade(mTrades.back().price);
+    }
+    return RejectReason::NONE;
+}
+
+Price OrderBook::riskPriceOf(const Order& order) const
+{
+    const bool hasLimit = order.type() == Type::LIMIT || order.type() == Type::STOP_LIMIT;
+    if(hasLimit)
+    {
+        return order.price();
+    }
+    // Nothing else touches the book between this and matching, so the levels the order can reach
+    // now are the ones it trades at.
+    return mRisk ? mTrackerStore.at(order.oppositeSide()).sweepHigh(order.openQty()) : 0;
+}
+
+void OrderBook::settleRisk(const Order& order, const Quantity openBefore, const Price riskPrice)
+{
+    Quantity filled = 0;
+    for(const auto& trade : mTrades)
+    {
+        filled += trade.qty;
+        // Resting orders are limit orders trading at their own price, the price they reserved at.
+        mRisk->onFill(trade.restingAccount, mSymbolId, order.oppositeSide(), trade.qty, trade.price,
+                      trade.restingLeaves == 0);
+    }
+    // All of the order's executions are freed at the one price it reserved at, so reserve() gets back
+    // exactly what it took; for an order without a limit that price is at or above every trade price.
+    const Quantity open = openBefore - filled;
+    const bool rests = order.status() == Status::PENDING || order.status() == Status::PARTIALLY_FILLED;
+    if(filled > 0)
+    {
+        mRisk->onFill(order.account(), mSymbolId, order.side(), filled, riskPrice, !rests && open == 0);
+    }
+    if(!rests && (open > 0 || filled == 0))
+    {
+        mRisk->onClose(order.account(), mSymbolId, order.side(), open, riskPrice);
+    }
 }
 
 OrderBook::Tracker& OrderBook::getOrderTracker(const Side side)
@@ -38,19 +96,380 @@ OrderBook::Tracker& OrderBook::getOrderTracker(const Side side)
 
 void OrderBook::addRestingOrder(OrderPtr order)
 {
-    auto tracker = getOrderTracker(order->side());
+    auto& tracker = getOrderTracker(order->side());
     tracker.addOrder(std::move(order));
 }
 
+void OrderBook::execute(OrderPtr order, const ExecType accepted, const bool reserved)
+{
+    if(mMetrics)
+    {
+        mMetrics->ordersReceived.add();
+    }
+    const Quantity openBefore = order->openQty();
+    const Price riskPrice = riskPriceOf(*order);
+    if(const RejectReason why = matchOrder(*order, riskPrice, reserved); why != RejectReason::NONE)
+    {
+        if(reserved && mRisk)
+        {
+            mRisk->onClose(order->account(), mSymbolId, order->side(), order->openQty(), riskPrice);
+        }
+        order->updateStatus(Status::CANCELLED);
+        ExecReport r;
+        r.type = ExecType::REJECTED;
+        r.reason = why;
+        r.status = order->status();
+        r.session = order->session();
+        r.orderId = order->id();
+        r.side = order->side();
+        report(r);
+        if(mMetrics)
+        {
+            mMetrics->ordersRejected.add();
+        }
+        if(reserved)
+        {
+            // Only stages reserveReplacement() does not repeat can get here, after the original left.
+            publishTop();
+        }
+        return;
+    }
+    const bool traded = !mTrades.empty();
+    if(traded)
+    {
+        recordTrades(*order);
+    }
+
+    if(mRisk)
+    {
+        settleRisk(*order, openBefore, riskPrice);
+    }
+    if(mReportSink)
+    {
+        reportExecution(*order, accepted, openBefore);
+    }
+
+    if(order->status() == Status::PENDING || order->status() == Status::PARTIALLY_FILLED){
+        addRestingOrder(std::move(order));
+    }
+    publishTop(traded);
+}
+
+void OrderBook::recordTrades(const Order& order)
+{
+    Quantity filled = 0;
+    for(const auto& trade : mTrades)
+    {
+        filled += trade.qty;
+        mStats.totalOrdersFulfilled += trade.restingLeaves == 0;
+        if(mBars.enabled())
+        {
+            mBars.onFill(trade.price, trade.qty);
+        }
+    }
+    const auto& last = mTrades.back();
+    mStats.totalTrades += mTrades.size();
+    mStats.totalVolume += filled;
+    mStats.totalOrdersFulfilled += order.status() == Status::FULFILLED;
+    mStats.lastTradePrice = static_cast<uint64_t>(last.price);
+    mStats.lastTradQty = last.qty;
+    mStats.marketPrice = mStats.lastTradePrice;
+    if(mMetrics)
+    {
+        mMetrics->fills.add(mTrades.size());
+        mMetrics->filledQty.add(filled);
+    }
+}
+
+void OrderBook::publishTop(const bool traded)
+{
+    Quote next = mQuote;
+    const PriceLevel* bid = getOrderTracker(Side::BUY).bestLevel();
+    const PriceLevel* ask = getOrderTracker(Side::SELL).bestLevel();
+    next.bidPrice = bid ? bid->getPrice() : 0;
+    next.bidQty = bid ? bid->getTotalQuantity() : 0;
+    next.askPrice = ask ? ask->getPrice() : 0;
+    next.askQty = ask ? ask->getTotalQuantity() : 0;
+    if(traded)
+    {
+        next.lastPrice = mTrades.back().price;
+        next.lastQty = mTrades.back().qty;
+    }
+    else if(next.sameAs(mQuote))
+    {
+        // Most operations happen behind the touch; not republishing spares readers the cache miss.
+        return;
+    }
+    next.version = mTop.publish(next);
+    mQuote = next;
+}
+
+void OrderBook::reportExecution(const Order& order, const ExecType accepted, const Quantity openBefore) const
+{
+    ExecReport mine;
+    mine.type = accepted;
+    mine.status = openBefore < order.qty() ? Status::PARTIALLY_FILLED : Status::PENDING;
+    mine.session = order.session();
+    mine.orderId = order.id();
+    mine.side = order.side();
+    mine.lastPrice = order.price();
+    mine.leavesQty = openBefore;
+    report(mine);
+
+    mine.type = ExecType::TRADE;
+    for(const auto& trade : mTrades)
+    {
+        mine.lastQty = trade.qty;
+        mine.lastPrice = trade.price;
+        mine.leavesQty -= trade.qty;
+        mine.status = mine.leavesQty == 0 ? Status::FULFILLED : Status::PARTIALLY_FILLED;
+        report(mine);
+
+        ExecReport resting;
+        resting.type = ExecType::TRADE;
+        resting.session = trade.restingSession;
+        resting.orderId = trade.restingOrderId;
+        resting.side = order.oppositeSide();
+        resting.lastQty = trade.qty;
+        resting.lastPrice = trade.price;
+        resting.leavesQty = trade.restingLeaves;
+        resting.status = trade.restingLeaves == 0 ? Status::FULFILLED : Status::PARTIALLY_FILLED;
+        report(resting);
+    }
+
+    if(order.status() == Status::CANCELLED || order.status() == Status::PARTIAL_FILL_CANCELLED)
+    {
+        reportCancelled(order);
+    }
+}
+
+void OrderBook::reportRejected(const OrderId id, const SessionId requester, const RejectReason why) const
+{
+    ExecReport r;
+    r.type = ExecType::REJECTED;
+    r.reason = why;
+    r.session = requester;
+    r.orderId = id;
+    report(r);
+    if(mMetrics)
+    {
+        // Anything but an unknown order means the order rests and the amend itself was refused.
+        (why == RejectReason::UNKNOWN_ORDER ? mMetrics->cancelsRejected : mMetrics->amendsRejected).add();
+    }
+}
+
+void OrderBook::reportCancelled(const Order& order) const
+{
+    ExecReport r;
+    r.type = ExecType::CANCELLED;
+    r.status = order.status();
+    r.session = order.session();
+    r.orderId = order.id();
+    r.side = order.side();
+    r.lastPrice = order.price();
+    report(r);
+}
+
 void OrderBook::processOrder(OrderPtr order)
 {
     // Order is tried to match and then order is
     mStats.totalOrdersAdded++;
-    mStats.totalVolume+=order->openQty();
 
-    matchOrder(*order);
+    // The locator is keyed by id: a second resting order with the same id could never be found again.
+    if(findTracker(order->id()))
+    {
+        ExecReport r;
+        r.type = ExecType::REJECTED;
+        r.reason = RejectReason::DUPLICATE_ORDER_ID;
+        r.status = Status::CANCELLED;
+        r.session = order->session();
+        r.orderId = order->id();
+        r.side = order->side();
+        report(r);
+        if(mMetrics)
+        {
+            mMetrics->ordersReceived.add();
+            mMetrics->ordersRejected.add();
+        }
+        return;
+    }
+    execute(std::move(order), ExecType::NEW);
+}
 
-    if(order->status() == Status::PENDING || order->status() == Status::PARTIALLY_FILLED){
-        addRestingOrder(std::move(order));
+OrderBook::Tracker* OrderBook::findTracker(const OrderId id)
+{
+    for(auto& [_, tracker] : mTrackerStore)
+    {
+        if(tracker.findOrder(id))
+        {
+            return &tracker;
+        }
+    }
+    return nullptr;
+}
+
+bool OrderBook::cancelOrder(const OrderId id, const SessionId requester)
+{
+    Tracker* tracker = findTracker(id);
+    if(!tracker || !mayModify(*tracker->findOrder(id), requester))
+    {
+        reportRejected(id, requester, RejectReason::UNKNOWN_ORDER);
+        return false;
+    }
+    const OrderPtr order = tracker->cancelOrder(id);
+    order->updateStatus(order->openQty() < order->qty() ? Status::PARTIAL_FILL_CANCELLED : Status::CANCELLED);
+    if(mRisk)
+    {
+        mRisk->onClose(order->account(), mSymbolId, order->side(), order->openQty(), order->price());
+    }
+    mStats.totalOrdersCancelled++;
+    if(mMetrics)
+    {
+        mMetrics->ordersCancelled.add();
+    }
+    reportCancelled(*order);
+    publishTop();
+    return true;
+}
+
+bool OrderBook::amendOrder(const OrderId id, const Quantity newOpenQty, const Price newPrice,
+                           const SessionId requester)
+{
+    if(newOpenQty == 0)
+    {
+        return cancelOrder(id, requester);
+    }
+
+    Tracker* tracker = findTracker(id);
+    if(!tracker || !mayModify(*tracker->findOrder(id), requester))
+    {
+        reportRejected(id, requester, RejectReason::UNKNOWN_ORDER);
+        return false;
+    }
+
+    const OrderRawPtr resting = tracker->findOrder(id);
+    if(newPrice == resting->price() && newOpenQty <= resting->openQty())
+    {
+        // Quantity down at the same price keeps the order's place in the queue. The price stays, so
+        // only the lot and quantity range apply; a band that moved since does not block a reduction.
+        if(const RejectReason why = mLimits.checkQty(newOpenQty); why != RejectReason::NONE)
+        {
+            reportRejected(id, requester, why);
+            return false;
+        }
+        if(mMetrics)
+        {
+            mMetrics->amends.add();
+        }
+        if(mRisk)
+        {
+            mRisk->onReduce(resting->account(), mSymbolId, resting->side(), resting->openQty() - newOpenQty,
+                            resting->price());
+        }
+        tracker->reduceOrder(id, newOpenQty);
+        ExecReport r;
+        r.type = ExecType::REPLACED;
+        r.status = resting->status();
+        r.session = resting->session();
+        r.orderId = id;
+        r.side = resting->side();
+        r.lastPrice = newPrice;
+        r.leavesQty = newOpenQty;
+        report(r);
+        publishTop();
+        return true;
+    }
+
+    // Cancel/replace: loses priority and may now cross the spread. The original only leaves the
+    // book once its replacement is known to be acceptable.
+    Order replacement = *resting;
+    replacement.replace(newOpenQty, newPrice);
+    if(const RejectReason why = reserveReplacement(*resting, replacement); why != RejectReason::NONE)
+    {
+        reportRejected(id, requester, why);
+        return false;
+    }
+    if(mMetrics)
+    {
+        mMetrics->amends.add();
+    }
+    OrderPtr order = tracker->cancelOrder(id);
+    order->replace(newOpenQty, newPrice);
+    execute(std::move(order), ExecType::REPLACED, true);
+    return true;
+}
+
+RejectReason OrderBook::reserveReplacement(const Order& resting, const Order& replacement)
+{
+    if(replacement.type() == Type::LIMIT && replacement.price() <= 0)
+    {
+        return RejectReason::BAD_PRICE;
+    }
+    if(const RejectReason why = mLimits.check(replacement); why != RejectReason::NONE)
+    {
+        return why;
+    }
+    if(!mRisk)
+    {
+        return RejectReason::NONE;
+    }
+
+    // The original's exposure is released first so it does not count against its own replacement.
+    mRisk->onClose(resting.account(), mSymbolId, resting.side(), resting.openQty(), riskPriceOf(resting));
+    const RejectReason why = mRisk->reserve(replacement, mSymbolId, riskPriceOf(replacement));
+    if(why != RejectReason::NONE)
+    {
+        // Accepted when it arrived, the original stays booked whatever the limits say now.
+        mRisk->rebook(resting, mSymbolId, riskPriceOf(resting));
+    }
+    return why;
+}
+
+bool OrderBook::replaceOrder(const OrderId id, const Quantity newTotalQty, const Price newPrice,
+                             const SessionId requester)
+{
+    Tracker* tracker = findTracker(id);
+    if(!tracker || !mayModify(*tracker->findOrder(id), requester))
+    {
+        reportRejected(id, requester, RejectReason::UNKNOWN_ORDER);
+        return false;
+    }
+    const OrderRawPtr resting = tracker->findOrder(id);
+    const Quantity filled = resting->qty() - resting->openQty();
+    if(newTotalQty <= filled)
+    {
+        // Nothing would be left open; FIX expects a cancel for that, not a replace.
+        reportRejected(id, requester, RejectReason::BAD_QUANTITY);
+        return false;
+    }
+    return amendOrder(id, newTotalQty - filled, newPrice, requester);
+}
+
+size_t OrderBook::massCancel(const std::optional<Side> side, const SessionId requester)
+{
+    size_t cancelled = 0;
+    for(auto& [trackerSide, tracker] : mTrackerStore)
+    {
+        if(side && *side != trackerSide)
+        {
+            continue;
+        }
+        for(const auto& order : requester == NO_SESSION ? tracker.cancelAll() : tracker.cancelAll(requester))
+        {
+            order->updateStatus(order->openQty() < order->qty() ? Status::PARTIAL_FILL_CANCELLED : Status::CANCELLED);
+            if(mRisk)
+            {
+                mRisk->onClose(order->account(), mSymbolId, order->side(), order->openQty(), order->price());
+            }
+            reportCancelled(*order);
+            cancelled++;
+        }
+    }
+    mStats.totalOrdersCancelled += cancelled;
+    if(mMetrics)
+    {
+        mMetrics->ordersCancelled.add(cancelled);
     }
+    publishTop();
+    return cancelled;
 }
\ No newline at end of file
@@ -13,9 +13,19 @@
 #include <sstream>
 #include <mutex>
 #include <iostream>
+#include <atomic>
+#include <vector>
 #include "OrderTracker/OrderTracker.h"
+#include "ReferenceData.h"
 #include "../Pipeline/PipelineFactory.h"
+#include "../Concurrency/EpochDomain.h"
+#include "../Reports/ExecReport.h"
+#include "../MarketData/TopOfBook.h"
+#include "../MarketData/Bar.h"
+#include "../Metrics/WorkerMetrics.h"
 
+class SnapshotWriter;
+class SnapshotReader;
 
 /**
  * @class OrderBook
@@ -50,12 +60,14 @@ class OrderBook {
     /**
      * @struct Stats
      * @brief Structure for tracking statistics of order book.
+     * @remarks Plain fields owned by the book's worker, like the rest of the book: not safe to read
+     * from another thread. Cross-thread readers use WorkerMetrics (counters) or quote() (prices).
      */
     struct Stats
     {
         // <===== Market States =====>
 
-        uint64_t marketPrice{0}; /// < Current market price
+        uint64_t marketPrice{0}; /// < Current market price (price of the last trade)
         uint64_t lastTradePrice{0}; /// < Price at which last trade was executed.
         uint64_t lastTradQty{0}; /// < Number of shares that were traded at the last trade.
 
@@ -63,13 +75,13 @@ class OrderBook {
 
         uint64_t totalOrdersCancelled{0};
         uint64_t totalOrdersAdded{0};
-        uint64_t totalOrdersFulfilled{0};
-        uint64_t totalVolume{0};
-        uint64_t totalTrades{0};
+        uint64_t totalOrdersFulfilled{0}; /// < Orders, incoming or resting, whose whole quantity traded
+        uint64_t totalVolume{0}; /// < Quantity executed
+        uint64_t totalTrades{0}; /// < Executions
 
         /**
          * @brief Reset all statistics counters to zero.
-         * This is atomic and thread-safe for each counter individually.
+         * @remarks Owning worker only.
          */
         void reset()
         {
@@ -105,26 +117,53 @@ class OrderBook {
      * @struct Registry
      * @brief Multiton registry: multiton mapping from Symbol -> shared_ptr<OrderBook>.
      * The Registry is thread-safe. It holds shared_ptr and allows lazy creation.
+     *
+     * @details
+     * Read-mostly, copy-on-write (RCU style). The map is immutable once published; readers load the
+     * current snapshot pointer inside an epoch read section and never take a lock, so concurrent
+     * lookups do not bounce a shared lock's cache line between cores. Writers (creation, erase,
+     * cleanup) are rare: they serialise on `writeMtx`, copy the map, publish the new version with a
+     * single atomic store and retire the old one, which is freed once no reader can still see it.
      * todo: check about weak_ptr to avoid reference cycles
      */
     struct Registry
     {
-        std::unordered_map<Symbol, std::shared_ptr<OrderBook>> registry; ///> Stores OrderBook belonging to symbol.
-        mutable std::shared_mutex  mtx; ///> Lock for registry data structure.
+        using Map = std::unordered_map<Symbol, std::shared_ptr<OrderBook>>;
+
+        std::atomic<const Map*> current; ///> Currently published snapshot. Never null.
+        EpochDomain epochs; ///> Tracks readers of `current` for safe reclamation.
+        std::mutex writeMtx; ///> Serialises writers.
+        std::vector<std::pair<uint64_t, const Map*>> retired; ///> Old snapshots awaiting reclamation (writeMtx).
+
+        Registry() : current(new Map()) {}
+        ~Registry();
 
+        /**
+         * @brief Publishes `next` as the current snapshot and retires the previous one.
+         * @pre Caller holds writeMtx.
+         */
+        void publish(std::unique_ptr<const Map> next);
+
+        /**
+         * @brief Frees retired snapshots no reader can still observe.
+         * @pre Caller holds writeMtx.
+         */
+        void reclaim();
+
+        /** @pre Caller holds writeMtx. */
         OrderBookPtr createOrderBook(const Symbol& symbol);
 
         /**
          *
-         * @brief Get order book if exists.
-         * @return may return nullptr if weak_ptr expired
+         * @brief Get order book if exists. Wait-free.
+         * @return nullptr if there is no order book for the symbol.
          */
         OrderBookPtr getOrderBook(const Symbol& symbol);
 
         /**
          *
-         * @brief Get order book if exists.
-         * @return may return nullptr if weak_ptr expired
+         * @brief Get order book if exists. Same as getOrderBook(), kept for existing callers.
+         * @return nullptr if there is no order book for the symbol.
          */
         OrderBookPtr getOrderBookSafe(const Symbol& symbol);
 
@@ -134,10 +173,12 @@ class OrderBook {
          */
         OrderBookPtr getOrCreateOrderBook(const Symbol& symbol);
 
-        bool exists(const Symbol& symbol) const;
+        bool exists(const Symbol& symbol);
         void erase(const Symbol& symbol);
+
+        /** @brief Removes entries that no longer hold an order book. Live books are kept. */
         void cleanupRegistry();
-        size_t size() const;
+        size_t size();
     };
     
     // BUY/SELL-specific order tracker
@@ -147,8 +188,19 @@ class OrderBook {
     using TrackerStore = std::map<Side,Tracker>;
 
     Symbol mSymbol; ///< Ticker symbol this order book is associated with
+    SymbolId mSymbolId; ///< Interned id of mSymbol, INVALID_SYMBOL_ID if it was never interned
     TrackerStore mTrackerStore; ///< Stores OrderTracker instances for each side (BUY and SELL)
     Stats mStats; ///< Aggregated statistics for the order book
+    std::vector<PriceLevel::MatchedTrade> mTrades; ///< Scratch buffer reused for the trades of each order
+    IReportSink* mReportSink{nullptr}; ///< Receives execution reports, null to not report
+    InstrumentLimits mLimits; ///< Tick, lot, quantity range and price band; the band follows this book's trades
+    RiskShard* mRisk{nullptr}; ///< Pre-trade risk of the owning worker, null when no account has limits
+    DepthFeed mDepth; ///< L2 updates of both trackers, sequenced per book
+    OrderFeed mOrderEvents; ///< L3 events of both trackers, sequenced per book
+    TopOfBook mTop; ///< Best bid/ask and last trade, readable from any thread
+    Quote mQuote; ///< Last quote published to mTop (owning worker only)
+    BarBuilder mBars; ///< Bar of the current interval, fed by every fill
+    WorkerMetrics* mMetrics{nullptr}; ///< Counters of the owning worker, null when not exported
 
 
     Pipeline mOrderPipeline; ///< Executes all sequential processing stages for each incoming order.
@@ -166,9 +218,26 @@ class OrderBook {
 
     /**
      * @brief Attempts to match an incoming order with orders from the opposite side.
+     * Trades are left in mTrades.
      * @param order Incoming order being matched.
+     * @param riskPrice Price the order's notional is reserved at, see riskPriceOf().
+     * @param reserved The caller already reserved the order in mRisk, the pipeline does not again.
+     * @return Why the pipeline aborted the order (nothing was matched), RejectReason::NONE if it did not.
      */
-    void matchOrder(Order& order);
+    RejectReason matchOrder(Order& order, Price riskPrice, bool reserved);
+
+    /**
+     * @brief Price an order's notional is booked at: its limit price or, for an order without one,
+     * the highest opposite level it can reach (OrderTracker::sweepHigh(), 0 if that side is empty).
+     */
+    Price riskPriceOf(const Order& order) const;
+
+    /**
+     * @brief Books the outcome of matching in mRisk: both sides of every trade in mTrades, resting
+     * orders that were filled and the order itself if it does not rest.
+     * @param openBefore Open quantity of the order before matching.
+     */
+    void settleRisk(const Order& order, Quantity openBefore, Price riskPrice);
 
     /**
      * @brief Persists the order in the order book. The order is stored in the appropriate
@@ -181,18 +250,75 @@ class OrderBook {
     void addRestingOrder(OrderPtr order);
 
     /**
-     * @brief Updates an order's state and determines its next action post-match.
-     *
-     * @details
-     * Sets the order's status based on its remaining `openQty`. If the order is a
-     * LIMIT order and is not fully filled, this function will add the remaining
-     * quantity to the order book as a new resting order.
-     *
-     * @pre It must be called after the matching has been attempted.
-     * 
-     * @todo Implement client notifications for fills or status changes.
+     * @brief Matches the order and rests whatever remains (shared by new orders and replaces).
+     * An order aborted by the pipeline is rejected and never rests.
+     * @param accepted Report sent when the order is accepted: NEW, or REPLACED for a cancel/replace.
+     * @param reserved The order's exposure is already booked in mRisk (a replacement, see
+     * reserveReplacement()).
+     */
+    void execute(OrderPtr order, ExecType accepted, bool reserved = false);
+
+    /**
+     * @brief Checks the terms of a cancel/replace before the original leaves the book: reference
+     * data, then pre-trade risk with the original's exposure swapped for the replacement's.
+     * @param replacement Copy of the resting order with the new terms applied.
+     * @return RejectReason::NONE with the replacement reserved in mRisk; otherwise the original's
+     * exposure is booked again and nothing changed.
+     */
+    RejectReason reserveReplacement(const Order& resting, const Order& replacement);
+
+    /** @brief Sends a report to the sink, if any, stamped with this book's symbol. */
+    void report(ExecReport r) const
+    {
+        if(mReportSink)
+        {
+            r.symbolId = mSymbolId;
+            mReportSink->onReport(r);
+        }
+    }
+
+    /**
+     * @brief Reports an order that went through matching: the acceptance, a fill for both sides of
+     * every trade in mTrades and, when the remainder was not kept, its cancellation.
+     * @param openBefore Open quantity of the order before matching.
+     */
+    void reportExecution(const Order& order, ExecType accepted, Quantity openBefore) const;
+
+    /** @brief Rejects a cancel or amend request back to the session that sent it. */
+    void reportRejected(OrderId id, SessionId requester, RejectReason why) const;
+
+    /** @brief Reports that an order left the book without trading its open quantity. */
+    void reportCancelled(const Order& order) const;
+
+    /**
+     * @brief Books the trades in mTrades of an order that just matched: stats, the bar in progress
+     * and the worker's counters.
+     * @pre mTrades is not empty.
      */
-    static void updateOrder(Order& order,Quantity remainingQty);
+    void recordTrades(const Order& order);
+
+    /**
+     * @brief Publishes best bid/ask and last trade to mTop if any of them changed since the last
+     * publish. Called at the end of every operation that can change the book.
+     * @param traded The operation traded: the last trade of mTrades is new even if it repeats the
+     * previous one's price and quantity, so the quote is published regardless.
+     */
+    void publishTop(bool traded = false);
+
+    /**
+     * @brief Finds the side an order id is resting on.
+     * @return Tracker holding the order, or nullptr if the order is not resting in this book.
+     */
+    Tracker* findTracker(OrderId id);
+
+    /**
+     * @brief A session may only cancel or amend its own orders; NO_SESSION (engine-internal requests,
+     * replay) may touch any.
+     */
+    static bool mayModify(const Order& order, const SessionId requester)
+    {
+        return requester == NO_SESSION || order.session() == requester;
+    }
 public:
 
     /** @brief Constructor */
@@ -217,10 +343,77 @@ public:
      return registry().getOrCreateOrderBook(symbol);
     }
     static bool contains(const Symbol& symbol) { return registry().exists(symbol); }
+
+    /**
+     * @warning The registry holds the owning reference. Book workers cache raw pointers to their
+     * books, so a book must be detached from its worker before it is removed here.
+     */
     static void removeFromRegistry(const Symbol& symbol) { return registry().erase(symbol); }
     static void cleanupRegistry() { return registry().cleanupRegistry(); }
     static size_t registrySize() { return registry().size(); }
 
+    /** @brief Reference data and current price band of this book. */
+    const InstrumentLimits& limits() const { return mLimits; }
+
+    /**
+     * @brief Sets where execution reports go (nullptr to stop reporting).
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     */
+    void setReportSink(IReportSink* sink) { mReportSink = sink; }
+
+    /**
+     * @brief Sets the pre-trade risk orders are checked against (nullptr to not check).
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance, before orders
+     * rest in the book: resting orders are settled in the shard that reserved them.
+     */
+    void setRiskShard(RiskShard* risk) { mRisk = risk; }
+
+    /**
+     * @brief Sets where price level updates go (nullptr to stop publishing them).
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     */
+    void setDepthSink(IDepthSink* sink) { mDepth.setSink(sink); }
+
+    /** @brief Sequence number of the last price level update this book published. */
+    uint64_t depthSequence() const { return mDepth.sequence(); }
+
+    /**
+     * @brief Sets where resting order events go (nullptr to stop publishing them).
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     */
+    void setOrderEventSink(IOrderEventSink* sink) { mOrderEvents.setSink(sink); }
+
+    /** @brief Sequence number of the last order event this book published. */
+    uint64_t orderEventSequence() const { return mOrderEvents.sequence(); }
+
+    /**
+     * @brief Sets the counters this book adds its orders, fills and cancels to (nullptr for none).
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance; the counters
+     * must be written by that worker only.
+     */
+    void setMetrics(WorkerMetrics* metrics) { mMetrics = metrics; }
+
+    /**
+     * @brief Sets where completed bars go (nullptr to stop building them).
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     */
+    void setBarSink(IBarSink* sink) { mBars.setSink(sink); }
+
+    /**
+     * @brief Closes the current bar as [startNs, endNs) and starts the next one.
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     */
+    void closeBar(const uint64_t startNs, const uint64_t endNs) { mBars.close(startNs, endNs); }
+
+    /**
+     * @brief Best bid/ask and last trade as of the last completed operation on this book.
+     * @remarks Safe from any thread, never blocks the owning worker; see TopOfBook.
+     */
+    Quote quote() const { return mTop.read(); }
+
+    /** @brief The seqlock behind quote(), for readers that want TopOfBook::tryRead(). */
+    const TopOfBook& topOfBook() const { return mTop; }
+
    /**
      * @brief Process an incoming order: attempt matching, execute trades, and
      * persist any remaining resting quantity if applicable.
@@ -229,12 +422,88 @@ public:
      * 1. Try to match the order against the best-priced orders on the opposite side.
      * 2. If the order is partially filled, handle remaining quantity based on order type.
      * 3. If unfulfilled (e.g., limit order not fully filled), persist it as a resting order.
+     *
+     * An order whose id is still resting in this book is rejected with DUPLICATE_ORDER_ID before any
+     * check or risk reservation.
      * 
      * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
      * 
      * @param order The incoming order to be matched.
      */
     void processOrder(OrderPtr order);
+
+    /**
+     * @brief Cancels a resting order.
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     * @param requester Session that asked, receives the reject if the order is not resting. A session
+     * other than the order's own gets UNKNOWN_ORDER, as if the order did not exist.
+     * @return false if the order is not resting in this book (unknown, filled or already cancelled)
+     * or belongs to another session.
+     */
+    bool cancelOrder(OrderId id, SessionId requester = NO_SESSION);
+
+    /**
+     * @brief Amends a resting order's open quantity and/or limit price.
+     *
+     * @details
+     * A pure quantity reduction at the same price is applied in place and keeps time priority.
+     * Any other change is a cancel/replace: the order leaves its level, is re-matched with the new
+     * terms and rests again at the back of its new level. A new quantity of 0 cancels the order.
+     * The new terms are checked against reference data and pre-trade risk first (an in-place
+     * reduction against the lot size and quantity range only): if they fail, only the amend is
+     * rejected and the original order keeps resting untouched.
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     * @param requester Session that asked, receives the reject if the order is not resting. A session
+     * other than the order's own gets UNKNOWN_ORDER, as if the order did not exist.
+     * @return false if the order is not resting in this book, belongs to another session or the new
+     * terms were rejected.
+     */
+    bool amendOrder(OrderId id, Quantity newOpenQty, Price newPrice, SessionId requester = NO_SESSION);
+
+    /**
+     * @brief Amends a resting order given its new total quantity, as a FIX cancel/replace states it:
+     * the new open quantity is `newTotalQty` minus what already filled, then see amendOrder().
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     * @return false if the order is not resting in this book, belongs to another session, the new
+     * total does not exceed the filled quantity (BAD_QUANTITY) or the new terms were rejected.
+     */
+    bool replaceOrder(OrderId id, Quantity newTotalQty, Price newPrice, SessionId requester = NO_SESSION);
+
+    /**
+     * @brief Cancels every resting order, or only those of one side.
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     * @param requester Only that session's orders are cancelled; NO_SESSION cancels everyone's.
+     * @return Number of orders cancelled.
+     */
+    size_t massCancel(std::optional<Side> side = std::nullopt, SessionId requester = NO_SESSION);
+
+    // <============== Snapshots (OrderBook_Snapshot.cpp) ==============>
+
+    /**
+     * @brief Appends the book to a snapshot image: its Stats, the positions pre-trade risk holds in
+     * its symbol and every resting order, bids then asks, in price-time priority.
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     */
+    void saveSnapshot(SnapshotWriter& out) const;
+
+    /**
+     * @brief Rebuilds the book from what saveSnapshot() wrote: the orders rest again in the same
+     * priority and are booked in pre-trade risk, the price band and last trade follow the saved
+     * Stats. Feeds see every restored order and level as new.
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance, after the
+     * risk shard is set.
+     * @return Resting orders loaded.
+     * @throws std::logic_error if the book is not empty.
+     * @throws std::runtime_error if the image is truncated.
+     */
+    size_t loadSnapshot(SnapshotReader& in);
+
+    /**
+     * @brief Highest session id a resting order is tagged with (local part, see ReportRouter), or
+     * NO_SESSION. Restored orders keep their session, so sessions opened after a restart start above it.
+     * @remarks Must be invoked by the worker thread that owns this OrderBook instance.
+     */
+    SessionId highestSession() const;
 };
 
 
@@ -4,18 +4,55 @@
 
 #include "OrderBook.h"
 
+OrderBook::Registry::~Registry()
+{
+    // Process teardown: no readers are left at this point.
+    for (const auto& [_, snapshot] : retired)
+    {
+        delete snapshot;
+    }
+    delete current.load(std::memory_order_acquire);
+}
+
+void OrderBook::Registry::publish(std::unique_ptr<const Map> next)
+{
+    const Map* prev = current.exchange(next.release(), std::memory_order_seq_cst);
+    retired.emplace_back(epochs.retire(), prev);
+    reclaim();
+}
+
+void OrderBook::Registry::reclaim()
+{
+    for (auto it = retired.begin(); it != retired.end();)
+    {
+        if (epochs.isSafeToFree(it->first))
+        {
+            delete it->second;
+            it = retired.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+}
+
 OrderBook::OrderBookPtr OrderBook::Registry::createOrderBook(const Symbol& symbol)
 {
-    // Caller must hold unique_lock on mtx. Creates shared_ptr and stores weak_ptr.
+    // Caller must hold writeMtx. Copies the current snapshot, adds the book and publishes.
     auto sp = std::make_shared<OrderBook>(symbol);
-    registry[symbol] = sp; // store weak_ptr implicitly
+    auto next = std::make_unique<Map>(*current.load(std::memory_order_acquire));
+    (*next)[symbol] = sp;
+    publish(std::move(next));
     return sp;
 }
 
 OrderBook::OrderBookPtr OrderBook::Registry::getOrderBook(const Symbol& symbol)
 {
-    const auto it = registry.find(symbol);
-    if (it == registry.end())
+    const auto guard = epochs.enter();
+    const Map* snapshot = current.load(std::memory_order_seq_cst);
+    const auto it = snapshot->find(symbol);
+    if (it == snapshot->end())
     {
         return nullptr;
     }
@@ -24,20 +61,19 @@ OrderBook::OrderBookPtr OrderBook::Registry::getOrderBook(const Symbol& symbol)
 
 OrderBook::OrderBookPtr OrderBook::Registry::getOrderBookSafe(const Symbol& symbol)
 {
-    std::shared_lock<std::shared_mutex> rlk(mtx);
     return getOrderBook(symbol);
 }
 
 OrderBook::OrderBookPtr OrderBook::Registry::getOrCreateOrderBook(const Symbol& symbol)
 {
-    // Fast (read) path - shared lock
-    if (const auto ob  = getOrderBookSafe(symbol); ob) {
+    // Fast (read) path - no lock
+    if (const auto ob  = getOrderBook(symbol); ob) {
         return ob;
     }
 
-    // Slow path: unique (write) lock + recheck
+    // Slow path: writer lock + recheck
     // Some other thread in meanwhile might have created the order book.
-    std::unique_lock<std::shared_mutex> wlk(mtx);
+    std::lock_guard<std::mutex> wlk(writeMtx);
     if(auto ob = getOrderBook(symbol); ob)
     {
         return ob;
@@ -47,40 +83,54 @@ OrderBook::OrderBookPtr OrderBook::Registry::getOrCreateOrderBook(const Symbol&
     return createOrderBook(symbol);
 }
 
-size_t OrderBook::Registry::size() const
+size_t OrderBook::Registry::size()
 {
-    return registry.size();
+    const auto guard = epochs.enter();
+    return current.load(std::memory_order_seq_cst)->size();
 }
 
-bool OrderBook::Registry::exists(const Symbol& symbol) const
+bool OrderBook::Registry::exists(const Symbol& symbol)
 {
-    return registry.contains(symbol);
+    const auto guard = epochs.enter();
+    return current.load(std::memory_order_seq_cst)->contains(symbol);
 }
 
 void OrderBook::Registry::erase(const Symbol& symbol)
 {
-    std::unique_lock<std::shared_mutex> wlk(mtx);
-    registry.erase(symbol);
+    std::lock_guard<std::mutex> wlk(writeMtx);
+    const Map* snapshot = current.load(std::memory_order_acquire);
+    if (!snapshot->contains(symbol))
+    {
+        return;
+    }
+    auto next = std::make_unique<Map>(*snapshot);
+    next->erase(symbol);
+    publish(std::move(next));
 }
 
 void OrderBook::Registry::cleanupRegistry()
 {
-    std::unique_lock<std::shared_mutex> wlk(mtx);
-    for(auto it = registry.begin(); it != registry.end();)
+    std::lock_guard<std::mutex> wlk(writeMtx);
+    auto next = std::make_unique<Map>(*current.load(std::memory_order_acquire));
+    size_t removed = 0;
+    for(auto it = next->begin(); it != next->end();)
     {
-        if(auto ob = it->second)
+        if(!it->second)
         {
-            it = registry.erase(it);
+            it = next->erase(it);
+            removed++;
         }
         else
         {
             it++;
         }
     }
+    if (removed > 0)
+    {
+        publish(std::move(next));
+    }
+    else
+    {
+        reclaim();
+    }
 }
-
-
-
-
-
-
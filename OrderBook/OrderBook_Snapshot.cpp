@@ -0,0 +1,137 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "OrderBook.h"
+#include "../Journal/Snapshot.h"
+#include "../Reports/ReportRouter.h"
+
+namespace
+{
+    // Order: id u64, qty u64, openQty u64, price i64, stopPrice i64, account u32, tif u32, session u32,
+    // type u8, status u8. The side is the section's. The session is kept so that the journal tail
+    // replays cancels and amends against the same owners as live.
+    constexpr size_t ORDER_BYTES = 5 * 8 + 3 * 4 + 2;
+}
+
+void OrderBook::saveSnapshot(SnapshotWriter& out) const
+{
+    out.put<uint64_t>(mStats.marketPrice);
+    out.put<uint64_t>(mStats.lastTradePrice);
+    out.put<uint64_t>(mStats.lastTradQty);
+    out.put<uint64_t>(mStats.totalOrdersCancelled);
+    out.put<uint64_t>(mStats.totalOrdersAdded);
+    out.put<uint64_t>(mStats.totalOrdersFulfilled);
+    out.put<uint64_t>(mStats.totalVolume);
+    out.put<uint64_t>(mStats.totalTrades);
+
+    const auto positions = mRisk ? mRisk->positions(mSymbolId) : std::vector<std::pair<AccountId, int64_t>>{};
+    out.put<uint32_t>(static_cast<uint32_t>(positions.size()));
+    for(const auto& [account, position] : positions)
+    {
+        out.put<uint32_t>(account);
+        out.put<int64_t>(position);
+    }
+
+    for(const Side side : {Side::BUY, Side::SELL})
+    {
+        const Tracker& tracker = mTrackerStore.at(side);
+        out.put<uint64_t>(tracker.orderCount());
+        uint8_t* p = out.extend(tracker.orderCount() * ORDER_BYTES);
+        tracker.forEachOrder([&p](const Order& order)
+        {
+            BinaryCodec::store<uint64_t>(p, order.id());
+            BinaryCodec::store<uint64_t>(p + 8, order.qty());
+            BinaryCodec::store<uint64_t>(p + 16, order.openQty());
+            BinaryCodec::store<int64_t>(p + 24, order.price());
+            BinaryCodec::store<int64_t>(p + 32, order.stopPrice());
+            BinaryCodec::store<uint32_t>(p + 40, order.account());
+            BinaryCodec::store<uint32_t>(p + 44, order.tif());
+            BinaryCodec::store<uint32_t>(p + 48, order.session());
+            p[52] = static_cast<uint8_t>(order.type());
+            p[53] = static_cast<uint8_t>(order.status());
+            p += ORDER_BYTES;
+        });
+    }
+}
+
+size_t OrderBook::loadSnapshot(SnapshotReader& in)
+{
+    if(mTrackerStore.at(Side::BUY).orderCount() || mTrackerStore.at(Side::SELL).orderCount())
+    {
+        throw std::logic_error("OrderBook: snapshot of " + mSymbol + " loaded into a book with resting orders");
+    }
+    mStats.marketPrice = in.get<uint64_t>();
+    mStats.lastTradePrice = in.get<uint64_t>();
+    mStats.lastTradQty = in.get<uint64_t>();
+    mStats.totalOrdersCancelled = in.get<uint64_t>();
+    mStats.totalOrdersAdded = in.get<uint64_t>();
+    mStats.totalOrdersFulfilled = in.get<uint64_t>();
+    mStats.totalVolume = in.get<uint64_t>();
+    mStats.totalTrades = in.get<uint64_t>();
+
+    const auto positions = in.get<uint32_t>();
+    for(uint32_t i = 0; i < positions; i++)
+    {
+        const auto account = in.get<uint32_t>();
+        const auto position = in.get<int64_t>();
+        if(mRisk)
+        {
+            mRisk->restorePosition(account, mSymbolId, position);
+        }
+    }
+
+    size_t loaded = 0;
+    for(const Side side : {Side::BUY, Side::SELL})
+    {
+        Tracker& tracker = getOrderTracker(side);
+        const auto count = in.get<uint64_t>();
+        if(count > in.remaining() / ORDER_BYTES)
+        {
+            throw std::runtime_error("Snapshot: image is truncated");
+        }
+        const uint8_t* p = in.take(count * ORDER_BYTES);
+        std::vector<OrderPtr> orders;
+        orders.reserve(count);
+        for(uint64_t i = 0; i < count; i++, p += ORDER_BYTES)
+        {
+            OrderPtr order = Order::Restore(BinaryCodec::load<uint64_t>(p), side, BinaryCodec::load<uint64_t>(p + 8),
+                                            BinaryCodec::load<uint64_t>(p + 16), mSymbol, static_cast<Type>(p[52]),
+                                            BinaryCodec::load<int64_t>(p + 24), BinaryCodec::load<int64_t>(p + 32),
+                                            static_cast<TIF>(BinaryCodec::load<uint32_t>(p + 44)),
+                                            static_cast<Status>(p[53]), BinaryCodec::load<uint32_t>(p + 40));
+            order->setSession(BinaryCodec::load<uint32_t>(p + 48));
+            if(mRisk)
+            {
+                mRisk->rebook(*order, mSymbolId, riskPriceOf(*order));
+            }
+            orders.push_back(std::move(order));
+        }
+        // Saved in price-time priority, so the side is rebuilt in one pass.
+        loaded += tracker.loadOrders(std::move(orders));
+    }
+
+    // Trades moved the band and set the last trade; replaying them would have done the same.
+    if(mStats.lastTradePrice)
+    {
+        mLimits.onTrade(static_cast<Price>(mStats.lastTradePrice));
+        mQuote.lastPrice = static_cast<Price>(mStats.lastTradePrice);
+        mQuote.lastQty = mStats.lastTradQty;
+        mQuote.version = mTop.publish(mQuote);
+    }
+    publishTop();
+    return loaded;
+}
+
+SessionId OrderBook::highestSession() const
+{
+    SessionId highest = NO_SESSION;
+    for(const auto& [_, tracker] : mTrackerStore)
+    {
+        tracker.forEachOrder([&highest](const Order& order)
+        {
+            highest = std::max(highest, order.session() & ReportRouter::LOCAL_MASK);
+        });
+    }
+    return highest;
+}
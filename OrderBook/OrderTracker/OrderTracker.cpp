@@ -5,10 +5,13 @@
 
 #include "OrderTracker.h"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <string>
 #include <valarray>
 
-OrderTracker::OrderTracker(const Side side):mSide(side){}
+OrderTracker::OrderTracker(const Side side):mSide(side), mPriceLevels(PriceComparator(side == Side::BUY)){}
 
 OrderTracker::PriceLevelPtr OrderTracker::createPriceLevel(const Price price)
 {
@@ -56,9 +59,63 @@ void OrderTracker::addOrder(OrderPtr order)
     const PriceLevelPtr priceLevel = getOrCreatePriceLevel(price);
     auto orderIt = priceLevel->addOrder(std::move(order));
     mOrderLocator[id] = std::make_pair(price, orderIt);
+    if(mOrders)
+    {
+        mOrders->add(id, mSide, price, (*orderIt)->openQty());
+    }
+    publishLevel(*priceLevel);
+}
+
+size_t OrderTracker::loadOrders(std::vector<OrderPtr> orders)
+{
+    if(!mOrderLocator.empty() || !mPriceLevels.empty())
+    {
+        throw std::logic_error("OrderTracker: bulk load into a side with resting orders");
+    }
+
+    // Levels come in map order, so each one is appended with an end hint instead of searched for.
+    mOrderLocator.reserve(orders.size());
+    const PriceComparator better = mPriceLevels.key_comp();
+    PriceLevel* level = nullptr;
+    for(auto& order : orders)
+    {
+        if(!order) continue;
+
+        const OrderId id = order->id();
+        const Price price = order->price();
+        if(order->side() != mSide || (level && price != level->getPrice() && !better(level->getPrice(), price)))
+        {
+            mOrderLocator.clear();
+            mPriceLevels.clear();
+            throw std::logic_error("OrderTracker: bulk load input is not in price-time priority for this side");
+        }
+        if(!level || price != level->getPrice())
+        {
+            level = mPriceLevels.emplace_hint(mPriceLevels.end(), price, std::make_shared<PriceLevel>(price))->second.get();
+        }
+        if(!mOrderLocator.try_emplace(id, price, level->addOrder(std::move(order))).second)
+        {
+            mOrderLocator.clear();
+            mPriceLevels.clear();
+            throw std::logic_error("OrderTracker: bulk load input repeats order id " + std::to_string(id));
+        }
+    }
+
+    for(const auto& [price, priceLevel] : mPriceLevels)
+    {
+        if(mOrders)
+        {
+            for(const auto& order : priceLevel->getOrders())
+            {
+                mOrders->add(order->id(), mSide, price, order->openQty());
+            }
+        }
+        publishLevel(*priceLevel);
+    }
+    return mOrderLocator.size();
 }
 
-bool OrderTracker::isPriceEligibleForMatch(int levelPrice, int limitPriced){
+bool OrderTracker::isPriceEligibleForMatch(const Price levelPrice, const Price limitPriced) const {
     if (mSide == Side::SELL){
         // SELL: valid if buyer's offer>= seller’s limit price.
         return levelPrice <= limitPriced; 
@@ -69,7 +126,7 @@ bool OrderTracker::isPriceEligibleForMatch(int levelPrice, int limitPriced){
     }
 }
 
-void OrderTracker::matchOrder(Condition& condition)
+void OrderTracker::matchOrder(Condition& condition, std::vector<PriceLevel::MatchedTrade>& trades)
 {
     // Begin matching using price–time priority:
     // For buy orders → start from the highest price level.
@@ -79,11 +136,11 @@ void OrderTracker::matchOrder(Condition& condition)
 
     // Points to the first price level (highest bid or lowest ask)
     auto it = mPriceLevels.begin();
-    int currDepth = 0; // Current price level depth being processed
+    uint32_t currDepth = 0; // Current price level depth being processed
     Quantity unitsNeeded = condition.qty; // Remaining quantity to match for the incoming order
 
     while(
-        unitsNeeded > 0 &&- // Still need more units to fulfill the order
+        unitsNeeded > 0 && // Still need more units to fulfill the order
         currDepth <= condition.depthLimit && // Stay within the allowed market depth
         it != mPriceLevels.end() && // No price level left to explore
         isPriceEligibleForMatch(it->first,condition.priceLimit) // Ensure price is within acceptable range
@@ -93,17 +150,168 @@ void OrderTracker::matchOrder(Condition& condition)
 
         if(!priceLevel || priceLevel->isEmpty()){
             // Price level is empty
-            it++;
-            currDepth++;
+            it = mPriceLevels.erase(it);
             continue;
         }
 
         // Attempt to match orders at this price level.
-        // It reduces `unitsNeeded` accordingly.
-        auto trades = priceLevel->matchOrders(unitsNeeded); // List of trades executed
+        // It reduces `unitsNeeded` accordingly and appends the executed trades.
+        const size_t firstTrade = trades.size();
+        priceLevel->matchOrders(unitsNeeded, trades);
+
+        // Fully filled resting orders have left the level, their cached iterators are dangling.
+        for(size_t i = firstTrade; i < trades.size(); i++)
+        {
+            if(mOrders)
+            {
+                mOrders->execute(trades[i].restingOrderId, mSide, trades[i].price, trades[i].qty);
+            }
+            if(trades[i].restingLeaves == 0)
+            {
+                mOrderLocator.erase(trades[i].restingOrderId);
+            }
+        }
+
+        publishLevel(*priceLevel);
 
         // Move to the next price level for further matching if needed
-        it++;
+        if(priceLevel->isEmpty())
+        {
+            it = mPriceLevels.erase(it);
+        }
+        else
+        {
+            it++;
+        }
         currDepth++;
     }
-}
\ No newline at end of file
+
+    // Report back what is left so finalization can decide the order's status.
+    condition.qty = unitsNeeded;
+}
+
+OrderPtr OrderTracker::cancelOrder(const OrderId id)
+{
+    const auto locIt = mOrderLocator.find(id);
+    if(locIt == mOrderLocator.end())
+    {
+        return nullptr;
+    }
+    const auto [price, orderIt] = locIt->second;
+    mOrderLocator.erase(locIt);
+
+    const auto levelIt = mPriceLevels.find(price);
+    OrderPtr order = levelIt->second->removeOrder(orderIt);
+    if(mOrders)
+    {
+        mOrders->remove(id, mSide, order->openQty());
+    }
+    publishLevel(*levelIt->second);
+    if(levelIt->second->isEmpty())
+    {
+        mPriceLevels.erase(levelIt);
+    }
+    return order;
+}
+
+bool OrderTracker::reduceOrder(const OrderId id, const Quantity newOpenQty)
+{
+    const auto locIt = mOrderLocator.find(id);
+    if(locIt == mOrderLocator.end())
+    {
+        return false;
+    }
+    const auto& [price, orderIt] = locIt->second;
+    const auto& level = mPriceLevels.find(price)->second;
+    const Quantity openQty = (*orderIt)->openQty();
+    if(mOrders)
+    {
+        mOrders->reduce(id, mSide, openQty - newOpenQty);
+    }
+    (*orderIt)->reduceOpenQty(newOpenQty);
+    level->updateQuantity(*orderIt, openQty, newOpenQty);
+    publishLevel(*level);
+    return true;
+}
+
+OrderRawPtr OrderTracker::findOrder(const OrderId id) const
+{
+    const auto locIt = mOrderLocator.find(id);
+    if(locIt == mOrderLocator.end())
+    {
+        return nullptr;
+    }
+    return locIt->second.second->get();
+}
+
+Price OrderTracker::sweepHigh(const Quantity qty) const
+{
+    // Asks are walked lowest first, bids highest first: the high is the last ask or the first bid.
+    Price high = 0;
+    Quantity reached = 0;
+    for(const auto& [price, level] : mPriceLevels)
+    {
+        high = std::max(high, price);
+        reached += level->getTotalQuantity();
+        if(reached >= qty)
+        {
+            break;
+        }
+    }
+    return high;
+}
+
+std::vector<OrderPtr> OrderTracker::cancelAll()
+{
+    std::vector<OrderPtr> removed;
+    removed.reserve(mOrderLocator.size());
+    for(auto& [_, level] : mPriceLevels)
+    {
+        while(!level->isEmpty())
+        {
+            removed.push_back(level->removeOrder(level->begin()));
+            if(mOrders)
+            {
+                mOrders->remove(removed.back()->id(), mSide, removed.back()->openQty());
+            }
+        }
+        publishLevel(*level);
+    }
+    mPriceLevels.clear();
+    mOrderLocator.clear();
+    return removed;
+}
+
+std::vector<OrderPtr> OrderTracker::cancelAll(const SessionId session)
+{
+    std::vector<OrderPtr> removed;
+    std::vector<OrderId> ids;
+    for(auto levelIt = mPriceLevels.begin(); levelIt != mPriceLevels.end();)
+    {
+        PriceLevel& level = *levelIt->second;
+        ids.clear();
+        for(const auto& order : level.getOrders())
+        {
+            if(order->session() == session)
+            {
+                ids.push_back(order->id());
+            }
+        }
+        for(const OrderId id : ids)
+        {
+            const auto locIt = mOrderLocator.find(id);
+            removed.push_back(level.removeOrder(locIt->second.second));
+            mOrderLocator.erase(locIt);
+            if(mOrders)
+            {
+                mOrders->remove(id, mSide, removed.back()->openQty());
+            }
+        }
+        if(!ids.empty())
+        {
+            publishLevel(level);
+        }
+        levelIt = level.isEmpty() ? mPriceLevels.erase(levelIt) : std::next(levelIt);
+    }
+    return removed;
+}
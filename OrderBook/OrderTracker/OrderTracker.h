@@ -27,7 +27,10 @@
 #define ORDERTRACKER_H
 
 #include "../PriceLevel/PriceLevel.h"
+#include "../../MarketData/DepthUpdate.h"
+#include "../../MarketData/OrderEvent.h"
 #include <map>
+#include <unordered_map>
 
 /**
  * @struct PriceComparator
@@ -67,12 +70,15 @@ class OrderTracker {
     using PriceLevelPtr = std::shared_ptr<PriceLevel>;
     using PriceLevels = std::map<Price, PriceLevelPtr, PriceComparator>;
 
-    /// Cache mapping OrderId → (Price, iterator in PriceLevel order list)
-    using OrderLocatorMap = std::map<OrderId, std::pair<Price, typename PriceLevel::OrderIterator>>;
+    /// Cache mapping OrderId → (Price, iterator in PriceLevel order list). Hashed: it is only ever
+    /// searched by id, and a bulk load can size it up front.
+    using OrderLocatorMap = std::unordered_map<OrderId, std::pair<Price, typename PriceLevel::OrderIterator>>;
 
     Side mSide; ///< The side (Buy/Sell) that this tracker represents
     OrderLocatorMap mOrderLocator; ///< Fast access cache for locating orders by ID
     PriceLevels mPriceLevels; ///< All active price levels for this side, sorted by price
+    DepthFeed* mDepth{nullptr}; ///< Book's L2 feed, told about every level change; null = not published
+    OrderFeed* mOrders{nullptr}; ///< Book's L3 feed, told about every resting order change; null = not published
 
     /**
      * @brief Get the PriceLevel object for the given price.
@@ -93,7 +99,16 @@ class OrderTracker {
      */
     PriceLevelPtr createPriceLevel(Price price);
 
-    bool isPriceEligibleForMatch(int levelPrice, int limitPriced);
+    bool isPriceEligibleForMatch(Price levelPrice, Price limitPriced) const;
+
+    /** @brief Publishes the current aggregate of a level to the depth feed, if any. */
+    void publishLevel(const PriceLevel& level) const
+    {
+        if(mDepth)
+        {
+            mDepth->level(mSide, level.getPrice(), level.getTotalQuantity(), level.getOrderCount());
+        }
+    }
 
 public:
     /** @brief Constructor */
@@ -116,14 +131,100 @@ public:
      */
     void addOrder(OrderPtr order);
 
+    /**
+     * @brief Fills an empty side from orders already in price-time priority, as a snapshot holds them.
+     *
+     * @details
+     * One linear pass: each level is appended at the end of the level map without searching it, and
+     * the locator is sized for every order before the first insert. Feeds are told about every
+     * order, and about each level once with its final aggregate.
+     * @throws std::logic_error if this side is not empty, an order is out of priority order or of
+     * the other side, or an id repeats; the side is left empty.
+     * @return Number of orders loaded.
+     */
+    size_t loadOrders(std::vector<OrderPtr> orders);
+
     /**
      * @brief Executes trades by matching an incoming order against the best-priced
      * resting orders.
      *
      * Consumes liquidity from the best-priced level on the opposite side of the book,
-     * up to the specified quantity.
+     * up to the specified quantity. `condition.qty` is updated to the quantity that is
+     * still unfilled. Fully filled resting orders and emptied price levels are removed.
+     * @param[out] trades Executions are appended in matching order (caller-owned scratch buffer).
      */
-    void matchOrder(Condition& condition);
+    void matchOrder(Condition& condition, std::vector<PriceLevel::MatchedTrade>& trades);
+
+    /**
+     * @brief Removes a resting order from the book in O(1) through the locator cache.
+     * @return Ownership of the removed order, or nullptr if the id is not resting on this side.
+     */
+    OrderPtr cancelOrder(OrderId id);
+
+    /**
+     * @brief Reduces the open quantity of a resting order in place, keeping its time priority.
+     * @pre 0 < newOpenQty <= current open quantity.
+     * @return false if the id is not resting on this side.
+     */
+    bool reduceOrder(OrderId id, Quantity newOpenQty);
+
+    /** @brief Returns the resting order with the given id, or nullptr. */
+    OrderRawPtr findOrder(OrderId id) const;
+
+    /**
+     * @brief Highest price an order without a limit can trade at when it takes `qty` from this side,
+     * over the levels from the best one to the one where `qty` is reached (or all of them, if this
+     * side holds less). Bounds the notional of such an order.
+     * @return 0 if nothing rests on this side.
+     */
+    Price sweepHigh(Quantity qty) const;
+
+    /**
+     * @brief Removes every resting order of this side.
+     * @return Ownership of the removed orders, in price-time priority.
+     */
+    std::vector<OrderPtr> cancelAll();
+
+    /**
+     * @brief Removes every resting order of this side that was sent by `session`.
+     * @return Ownership of the removed orders, in price-time priority.
+     */
+    std::vector<OrderPtr> cancelAll(SessionId session);
+
+    /**
+     * @brief Sets the feed that receives a DepthUpdate whenever a level's total quantity or order
+     * count changes (nullptr to stop). One update per level and operation: a sweep through three
+     * levels publishes three updates, not one per resting order filled.
+     */
+    void setDepthFeed(DepthFeed* feed) { mDepth = feed; }
+
+    /**
+     * @brief Sets the feed that receives an OrderEvent for every resting order added, executed,
+     * reduced or removed on this side (nullptr to stop).
+     */
+    void setOrderFeed(OrderFeed* feed) { mOrders = feed; }
+
+    /** @brief Best priced level of this side, or nullptr if nothing rests on it. */
+    const PriceLevel* bestLevel() const
+    {
+        return mPriceLevels.empty() ? nullptr : mPriceLevels.begin()->second.get();
+    }
+
+    /** @brief Number of resting orders on this side. */
+    size_t orderCount() const { return mOrderLocator.size(); }
+
+    /** @brief Calls `f(const Order&)` for every resting order in price-time priority. */
+    template <typename F>
+    void forEachOrder(F&& f) const
+    {
+        for(const auto& [_, level] : mPriceLevels)
+        {
+            for(const auto& order : level->getOrders())
+            {
+                f(*order);
+            }
+        }
+    }
 };
 
 
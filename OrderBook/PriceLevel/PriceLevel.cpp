@@ -15,14 +15,17 @@ PriceLevel::OrderIterator PriceLevel::addOrder(OrderPtr inBoundOrder)
     return mOrders.insert(mOrders.end(), std::move(inBoundOrder));
 }
 
-void PriceLevel::removeOrder(const OrderIterator& itr)
+OrderPtr PriceLevel::removeOrder(const OrderIterator& itr)
 {
-    if (itr != mOrders.end())
+    if (itr == mOrders.end())
     {
-        mTotalQuantity -= (*itr)->openQty();
-        mOrderCount--;
-        mOrders.erase(itr);
+        return nullptr;
     }
+    OrderPtr order = std::move(*itr);
+    mTotalQuantity -= order->openQty();
+    mOrderCount--;
+    mOrders.erase(itr);
+    return order;
 }
 
 void PriceLevel::updateQuantity(const OrderPtr& order, Quantity oldQty, Quantity newQty)
@@ -40,12 +43,8 @@ OrderRawPtr PriceLevel::frontOrder() const
 }
 
 
-PriceLevel::MatchResult PriceLevel::matchOrders(Quantity& reqQty)
+void PriceLevel::matchOrders(Quantity& reqQty, std::vector<MatchedTrade>& trades)
 {
-    MatchResult result; // final result
-
-    result.trades.reserve(mOrders.size()); // heuristic: avoid frequent reallocations
-
     // Begin matching according to price–time priority (FIFO)
     // Start from the earliest resting order at this price level.
     auto restingIt  = mOrders.begin(); // Iterator to  resting order
@@ -73,8 +72,11 @@ PriceLevel::MatchResult PriceLevel::matchOrders(Quantity& reqQty)
         mt.restingOrderId = restingOrder->id();
         mt.qty = fillAmt;
         mt.price = mPrice; // Price of this level
+        mt.restingLeaves = unitsAvailable - fillAmt;
+        mt.restingSession = restingOrder->session();
+        mt.restingAccount = restingOrder->account();
 
-        result.trades.push_back(std::move(mt));
+        trades.push_back(mt);
 
         if (unitsAvailable == fillAmt) {
             // resting order fully filled -> remove from level
@@ -97,6 +99,4 @@ PriceLevel::MatchResult PriceLevel::matchOrders(Quantity& reqQty)
             break;
         }
     }
-
-    return result;
 }
@@ -7,6 +7,8 @@
 #ifndef PRICE_LEVEL_H
 #define PRICE_LEVEL_H
 
+#include <list>
+#include <vector>
 #include "../Order/Order.h"
 
 
@@ -15,13 +17,14 @@
  * Each PriceLevel object maintains a list of orders at that price. 
  * 
  * @details
- *  - Orders are stored in FIFO by entry time.
+ *  - Orders are stored in FIFO by entry time, in a linked list so iterators cached by OrderTracker
+ *    stay valid while other orders are added, filled or cancelled.
  *  - Think of an order book like a building with floors, where each floor represents a different price.
  *  - Handles the logic matching, when price level is verified by OrderTracker
  */
 class PriceLevel{
 public:
-    using OrderList = std::vector<OrderPtr>;
+    using OrderList = std::list<OrderPtr>;
     using OrderIterator = typename OrderList::iterator;
 private:
     Price mPrice; /// > Price to which this PriceLevel object corresponds.
@@ -52,6 +55,11 @@ public:
         return mOrders.empty();
     }
 
+    // Iterator to the oldest resting order (FIFO head)
+    [[nodiscard]] OrderIterator begin() {
+        return mOrders.begin();
+    }
+
 
     /**
      * @brief Adds a new order to the list of tracked orders.
@@ -65,8 +73,9 @@ public:
      * @details
      * - This is typically called when an order is fully filled or cancelled.
      * - It updates the total quantity and order count accordingly.
+     * @return Ownership of the removed order.
      */
-    void removeOrder(const OrderIterator& itr);
+    OrderPtr removeOrder(const OrderIterator& itr);
 
     void updateQuantity(const OrderPtr& order, Quantity oldQty, Quantity newQty);
 
@@ -93,12 +102,15 @@ public:
      * the quantity traded, and the execution price.
      * @todo Add timestamp
      */
-    struct MatchedTrade { OrderId restingOrderId{}; Quantity qty{}; Price price{};};
-
-    /**
-     * Aggregate of all trades generated during the matching process for one incoming order.
-     */
-    struct MatchResult { std::vector<MatchedTrade> trades; };
+    struct MatchedTrade
+    {
+        OrderId restingOrderId{};
+        Quantity qty{};
+        Price price{};
+        Quantity restingLeaves{};
+        SessionId restingSession{NO_SESSION}; ///< Owner of the resting order, for its fill report
+        AccountId restingAccount{NO_ACCOUNT}; ///< Account of the resting order, for its risk
+    };
 
     /**
      * @brief Attempts to match up to `qty` units of an incoming (opposite-side) order
@@ -113,18 +125,17 @@ public:
      * - the inbound order is fully filled, or
      * - all resting orders at this level are exhausted.
      * 
-     * It then generates a list of all individual trade executions that occurred
-     * during matching
+     * Every individual trade execution is appended to `trades`. The caller owns (and reuses)
+     * the buffer, so matching does not allocate once it has grown to the usual sweep size.
      * 
      * @param[in,out] reqQty Quantity of the inbound order to match. Updated to remaining quantity.
+     * @param[out] trades Trades executed at this price level are appended here.
      * 
      * @attention
      * The parameter `reqQty` is passed by reference and will be decremented in place
      * to reflect the remaining unfilled quantity of the inbound order after matching.
-     * 
-     * @return List of trades executed at this price level
      */
-    MatchResult matchOrders(Quantity& reqQty);
+    void matchOrders(Quantity& reqQty, std::vector<MatchedTrade>& trades);
 };
 
 
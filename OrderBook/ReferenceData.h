@@ -0,0 +1,166 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef REFERENCEDATA_H
+#define REFERENCEDATA_H
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Order/Order.h"
+#include "Order/Types.h"
+
+/**
+ * @struct InstrumentSpec
+ * @brief Static trading parameters of one symbol, as configured.
+ */
+struct InstrumentSpec
+{
+    Price tickSize{1};
+    Quantity lotSize{1};
+    Quantity minQty{1};
+    Quantity maxQty{std::numeric_limits<Quantity>::max()};
+    uint32_t bandBps{0};     ///< Half-width of the price band around the last trade, in basis points. 0 = no band
+    Price referencePrice{0}; ///< Band centre until the first trade. 0 = no band before the first trade
+};
+
+/**
+ * @class InstrumentLimits
+ * @brief Reference data of one book: its InstrumentSpec plus the dynamic price band.
+ *
+ * @details
+ * Each OrderBook owns one, so it lives on the book's worker: onTrade() moves the band with plain
+ * writes, no lock and no atomic. check() is a handful of compares and two divisions; the band bounds
+ * are recomputed per trade, not per order.
+ */
+class InstrumentLimits {
+public:
+    explicit InstrumentLimits(const InstrumentSpec& spec = {}) : mSpec(spec)
+    {
+        recenter(mSpec.referencePrice);
+    }
+
+    /** @return RejectReason::NONE if the order fits the symbol's lot, quantity range, tick and band. */
+    RejectReason check(const Order& order) const noexcept
+    {
+        if (const RejectReason why = checkQty(order.openQty()); why != RejectReason::NONE)
+        {
+            return why;
+        }
+
+        const bool hasLimit = order.type() == Type::LIMIT || order.type() == Type::STOP_LIMIT;
+        const bool hasStop = order.type() == Type::STOP || order.type() == Type::STOP_LIMIT;
+        if ((hasLimit && order.price() % mSpec.tickSize != 0) || (hasStop && order.stopPrice() % mSpec.tickSize != 0))
+        {
+            return RejectReason::BAD_TICK;
+        }
+        if (hasLimit && (order.price() < mBandLow || order.price() > mBandHigh))
+        {
+            return RejectReason::PRICE_OUT_OF_BAND;
+        }
+        return RejectReason::NONE;
+    }
+
+    /**
+     * @return RejectReason::NONE if `qty` fits the symbol's lot and quantity range. The part of
+     * check() that applies to an amend which keeps the order's price.
+     */
+    RejectReason checkQty(const Quantity qty) const noexcept
+    {
+        if (qty % mSpec.lotSize != 0)
+        {
+            return RejectReason::BAD_LOT;
+        }
+        if (qty < mSpec.minQty || qty > mSpec.maxQty)
+        {
+            return RejectReason::QTY_OUT_OF_RANGE;
+        }
+        return RejectReason::NONE;
+    }
+
+    /** @brief Re-centres the band on a trade price. */
+    void onTrade(const Price price) noexcept
+    {
+        recenter(price);
+    }
+
+    const InstrumentSpec& spec() const noexcept { return mSpec; }
+    Price bandLow() const noexcept { return mBandLow; }
+    Price bandHigh() const noexcept { return mBandHigh; }
+
+    /** @brief Last trade price, or the configured reference before the first trade (0 if none). */
+    Price referencePrice() const noexcept { return mReference; }
+
+private:
+    InstrumentSpec mSpec;
+    Price mBandLow{0};
+    Price mBandHigh{PRICE_MAX};
+    Price mReference{0};
+
+    void recenter(const Price centre) noexcept
+    {
+        mReference = centre;
+        if (mSpec.bandBps == 0 || centre <= 0)
+        {
+            mBandLow = 0;
+            mBandHigh = PRICE_MAX;
+            return;
+        }
+        // centre * bps / 10000 without overflowing for any int64 centre (bps <= 10000).
+        const Price width = centre / 10000 * mSpec.bandBps + centre % 10000 * mSpec.bandBps / 10000;
+        mBandLow = centre - width;
+        mBandHigh = centre > PRICE_MAX - width ? PRICE_MAX : centre + width;
+    }
+};
+
+/**
+ * @class ReferenceData
+ * @brief Process-wide table of InstrumentSpecs, directly indexed by SymbolId.
+ *
+ * Filled during startup from the configuration, before the books are created; each book copies its
+ * entry into its own InstrumentLimits. After startup the table is read-only and takes no lock (same
+ * contract as SymbolTable). Symbols without an entry get a default spec: tick 1, lot 1, no band.
+ */
+class ReferenceData {
+    std::vector<InstrumentSpec> mSpecs;
+    InstrumentSpec mDefault;
+
+    ReferenceData() = default;
+
+public:
+    static ReferenceData& instance()
+    {
+        static ReferenceData t;
+        return t;
+    }
+
+    /**
+     * @brief Sets the spec of a symbol.
+     * @throws std::invalid_argument if the tick or lot size is 0, min > max or the band exceeds 100%.
+     * @warning Startup only. Must not run concurrently with lookups.
+     */
+    void set(const SymbolId id, const InstrumentSpec& spec)
+    {
+        if (spec.tickSize <= 0 || spec.lotSize == 0 || spec.minQty > spec.maxQty || spec.bandBps > 10000)
+        {
+            throw std::invalid_argument("ReferenceData: invalid spec for symbol id " + std::to_string(id));
+        }
+        if (id >= mSpecs.size())
+        {
+            mSpecs.resize(id + 1);
+        }
+        mSpecs[id] = spec;
+    }
+
+    /** @return Spec of the symbol, or the default spec. */
+    const InstrumentSpec& get(const SymbolId id) const
+    {
+        return id < mSpecs.size() ? mSpecs[id] : mDefault;
+    }
+};
+
+#endif //REFERENCEDATA_H
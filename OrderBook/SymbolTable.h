@@ -0,0 +1,83 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Order/Types.h"
+
+/**
+ * @class SymbolTable
+ * @brief Process-wide dictionary assigning a dense `SymbolId` to every traded symbol.
+ *
+ * @details
+ * Ids are handed out in registration order starting at 0, so they can index plain arrays (per-worker
+ * book tables, reference data, wire formats that carry ids instead of strings).
+ *
+ * All symbols are interned during startup, before any worker thread is started. After that the table
+ * is read-only and lookups take no lock; the happens-before edge is provided by std::thread creation.
+ */
+class SymbolTable {
+    /** @brief Transparent hash so lookups by std::string_view do not build a std::string. */
+    struct Hash
+    {
+        using is_transparent = void;
+        size_t operator()(const std::string_view sv) const noexcept
+        {
+            return std::hash<std::string_view>{}(sv);
+        }
+    };
+
+    std::unordered_map<Symbol, SymbolId, Hash, std::equal_to<>> mIds; ///< Symbol -> id
+    std::vector<Symbol> mNames; ///< id -> Symbol
+    std::mutex mWriteLock; ///< Serialises intern() calls during startup
+
+    SymbolTable() = default;
+
+public:
+    static SymbolTable& instance()
+    {
+        static SymbolTable t;
+        return t;
+    }
+
+    /**
+     * @brief Registers a symbol (idempotent) and returns its id.
+     * @warning Startup only. Must not run concurrently with lookups.
+     */
+    SymbolId intern(const Symbol& symbol)
+    {
+        std::lock_guard<std::mutex> lk(mWriteLock);
+        if (const auto it = mIds.find(symbol); it != mIds.end())
+        {
+            return it->second;
+        }
+        const auto id = static_cast<SymbolId>(mNames.size());
+        mIds.emplace(symbol, id);
+        mNames.push_back(symbol);
+        return id;
+    }
+
+    /** @return Id of the symbol, or INVALID_SYMBOL_ID if it was never interned. */
+    SymbolId find(const std::string_view symbol) const
+    {
+        const auto it = mIds.find(symbol);
+        return it == mIds.end() ? INVALID_SYMBOL_ID : it->second;
+    }
+
+    /** @pre `id` was returned by intern(). */
+    const Symbol& name(const SymbolId id) const { return mNames[id]; }
+
+    bool contains(const SymbolId id) const { return id < mNames.size(); }
+
+    size_t size() const { return mNames.size(); }
+};
+
+#endif //SYMBOLTABLE_H
@@ -15,6 +15,6 @@ class ExecutionHandler : public Handler {
             // No matching will be performed because the order is aborted.
             return;
         }
-        ctx.oppTracker.matchOrder(ctx.cond);
+        ctx.oppTracker.matchOrder(ctx.cond, ctx.trades);
     }
 };
\ No newline at end of file
@@ -22,6 +22,10 @@
 class FinalizeHandler : public Handler {
     protected:
     void process(ProcessingContext& ctx) override {
+        if(ctx.aborted()){
+            // Aborted orders are rejected by the book, there is nothing to finalize.
+            return;
+        }
         auto& order = ctx.order;
 
         // `remainingQty` is taken from the condition object, which the order tracker
@@ -5,6 +5,8 @@
 #include "PrepareConditionHandler.h"
 #include "TifAdjustHandler.h"
 #include "ValidationHandler.h"
+#include "ReferenceDataHandler.h"
+#include "RiskCheckHandler.h"
 #include "ExecutionHandler.h"
 #include "FinalizeHandler.h"
 #include "../Strategies/StrategyCache.h"
@@ -17,7 +19,7 @@
  * step in the order lifecycle:
  * 
  * PrepareConditionHandler -> TifAdjustHandler -> ValidationHandler
- * -> ExecutionHandler -> FinalizeHandler
+ * -> ReferenceDataHandler -> RiskCheckHandler -> ExecutionHandler -> FinalizeHandler
  * 
  * @details This use of the Chain-of-Responsibility pattern helps keep the logic
  * modular, testable, and easy to extend with new processing stages without
@@ -32,13 +34,17 @@ public:
         auto prepare = std::make_shared<PrepareConditionHandler>();
         auto tifAdjust = std::make_shared<TifAdjustHandler>();
         auto validation = std::make_shared<ValidationHandler>();
+        auto referenceData = std::make_shared<ReferenceDataHandler>();
+        auto risk = std::make_shared<RiskCheckHandler>();
         auto exec = std::make_shared<ExecutionHandler>();
         auto finalize = std::make_shared<FinalizeHandler>();
 
-        // chain: prepare -> tifAdjust -> validation -> liquidity -> exec -> finalize
+        // chain: prepare -> tifAdjust -> validation -> referenceData -> risk -> exec -> finalize
         prepare->setNext(tifAdjust);
         tifAdjust->setNext(validation);
-        validation->setNext(exec);
+        validation->setNext(referenceData);
+        referenceData->setNext(risk);
+        risk->setNext(exec);
         exec->setNext(finalize);
 
         return Pipeline(prepare);
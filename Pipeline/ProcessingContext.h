@@ -3,6 +3,8 @@
 #pragma once
 
 #include "OrderBook/OrderTracker/OrderTracker.h"
+#include "OrderBook/ReferenceData.h"
+#include "Risk/PreTradeRisk.h"
 #include <memory>
 #include <string>
 
@@ -21,24 +23,36 @@
  *  - `cond` describes the matching condition (price limit, required depth,
  *    quantity constraints, etc.). It's provided as part of the context so
  *    downstream stages have a single source of truth for match rules.
- *  - `matchedQty` is the cumulative quantity matched so far during this
- *    processing session.
+ *  - `trades` receives every execution of this order. It is the book's
+ *    scratch buffer, cleared by the book before each order.
+ *  - `limits` is the book's reference data (tick, lot, quantity range,
+ *    price band), null when the book does not check it.
+ *  - `risk` is the worker's pre-trade risk, null when no account has
+ *    limits. The order is checked in `symbolId` at `riskPrice`: its
+ *    limit price, or the highest level a market order can sweep.
  *  - Use `abortReason` (std::optional) to indicate failure; prefer this
  *    over a separate bool flag since presence of a reason is the single
- *    source of truth for abortion state.
+ *    source of truth for abortion state. `rejectCode` is the code of the
+ *    first abortion, reported to the client.
  */
 struct ProcessingContext {
     Order& order;                     ///< Incoming order (mutable — will be updated).
     OrderTracker& oppTracker;         ///< Opposite-side tracker / book used for matches.
     Condition cond;                   ///< Matching condition (qty, price limit, depth, etc.).
+    std::vector<PriceLevel::MatchedTrade>& trades; ///< Executions produced by matching.
+    const InstrumentLimits* limits{nullptr}; ///< Reference data checked by ReferenceDataHandler.
+    RiskShard* risk{nullptr};         ///< Pre-trade risk checked by RiskCheckHandler.
+    SymbolId symbolId{INVALID_SYMBOL_ID};
+    Price riskPrice{0};
 
     // - std::nullopt     => not aborted
     // - non-empty string => aborted with reason
     std::optional<std::string> abortReason;
+    RejectReason rejectCode{RejectReason::NONE};
 
     // Constructor: take Condition by value and move into member for efficiency.
-    ProcessingContext(Order& o, OrderTracker& t, Condition c = {})
-        : order(o), oppTracker(t), cond(std::move(c)) {}
+    ProcessingContext(Order& o, OrderTracker& t, std::vector<PriceLevel::MatchedTrade>& tr, Condition c = {})
+        : order(o), oppTracker(t), cond(std::move(c)), trades(tr) {}
 
     // <============= Helpers =============>
 
@@ -47,7 +61,10 @@ struct ProcessingContext {
         return abortReason.has_value(); 
     }
 
-    void addAbortionReason(std::string reason){
+    void addAbortionReason(std::string reason, const RejectReason code = RejectReason::VALIDATION){
+        if(rejectCode == RejectReason::NONE){
+            rejectCode = code;
+        }
         if(aborted()){
             *abortReason += ",";
             *abortReason += std::move(reason);
@@ -0,0 +1,21 @@
+// Created by Vaasu Bisht on 19/10/26.
+
+#pragma once
+
+#include "Handler.h"
+
+/**
+ * @brief Checks the order against its book's reference data: lot size, quantity range, tick size
+ * and the price band around the last trade. O(1), see InstrumentLimits::check().
+ */
+class ReferenceDataHandler : public Handler {
+    protected:
+    void process(ProcessingContext& ctx) override {
+        if(ctx.aborted() || !ctx.limits){
+            return;
+        }
+        if(const RejectReason code = ctx.limits->check(ctx.order); code != RejectReason::NONE){
+            ctx.addAbortionReason(toString(code), code);
+        }
+    }
+};
@@ -0,0 +1,23 @@
+// Created by Vaasu Bisht on 19/10/26.
+
+#pragma once
+
+#include "Handler.h"
+
+/**
+ * @brief Pre-trade risk: checks the order against its account's notional, open-order and position
+ * limits and books its exposure, see RiskShard::reserve(). Last check before execution, so an order
+ * that passes it always reaches matching and the book settles what it reserved.
+ */
+class RiskCheckHandler : public Handler {
+    protected:
+    void process(ProcessingContext& ctx) override {
+        if(ctx.aborted() || !ctx.risk){
+            return;
+        }
+        if(const RejectReason code = ctx.risk->reserve(ctx.order, ctx.symbolId, ctx.riskPrice);
+           code != RejectReason::NONE){
+            ctx.addAbortionReason(toString(code), code);
+        }
+    }
+};
@@ -0,0 +1,50 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "NumaTopology.h"
+
+#ifdef OME_HAVE_LIBNUMA
+#include <numa.h>
+#endif
+
+bool NumaTopology::available()
+{
+#ifdef OME_HAVE_LIBNUMA
+    static const bool ok = numa_available() >= 0;
+    return ok;
+#else
+    return false;
+#endif
+}
+
+size_t NumaTopology::nodeCount()
+{
+#ifdef OME_HAVE_LIBNUMA
+    if (available())
+    {
+        const int nodes = numa_num_configured_nodes();
+        return nodes > 0 ? static_cast<size_t>(nodes) : 1;
+    }
+#endif
+    return 1;
+}
+
+bool NumaTopology::bindCurrentThread(const int node)
+{
+#ifdef OME_HAVE_LIBNUMA
+    if (!available() || node < 0 || static_cast<size_t>(node) >= nodeCount())
+    {
+        return false;
+    }
+    if (numa_run_on_node(node) != 0)
+    {
+        return false;
+    }
+    numa_set_preferred(node);
+    return true;
+#else
+    (void)node;
+    return false;
+#endif
+}
@@ -0,0 +1,42 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef NUMATOPOLOGY_H
+#define NUMATOPOLOGY_H
+
+#include <cstddef>
+
+/**
+ * @class NumaTopology
+ * @brief Thin wrapper over libnuma used to place worker threads and their memory on a node.
+ *
+ * @details
+ * When the engine is built without libnuma (`OME_HAVE_LIBNUMA` undefined), or the kernel reports
+ * NUMA as unavailable, the machine is treated as a single node and every binding call is a no-op.
+ * This keeps the placement logic identical on laptops, CI runners and dual-socket servers.
+ */
+class NumaTopology {
+public:
+    static constexpr int NO_NODE = -1; ///< Marker for "not bound to any node"
+
+    /** @brief True when libnuma is linked and the kernel supports NUMA policies. */
+    static bool available();
+
+    /** @brief Number of configured memory nodes (1 in the single-node fallback). */
+    static size_t nodeCount();
+
+    /**
+     * @brief Binds the calling thread to the CPUs of `node` and makes `node` its preferred memory node.
+     *
+     * @details
+     * Memory is allocated on first touch, so every object the thread creates afterward (order books,
+     * price levels, locator nodes) is served from that node's memory.
+     * @return false if the binding could not be applied (fallback mode, invalid node).
+     */
+    static bool bindCurrentThread(int node);
+};
+
+#endif //NUMATOPOLOGY_H
@@ -0,0 +1,58 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef EXECREPORT_H
+#define EXECREPORT_H
+
+#include "../OrderBook/Order/Types.h"
+
+/**
+ * @brief What happened to an order.
+ */
+enum class ExecType : uint8_t
+{
+    NEW = 1,       ///< Accepted by the book (sent before any fill of the same order)
+    TRADE = 2,     ///< Fill; `lastQty` @ `lastPrice`, `leavesQty` still open
+    CANCELLED = 3, ///< Removed from the book: cancel request, mass cancel, or IOC/FOK/market remainder
+    REPLACED = 4,  ///< Amend applied; `leavesQty` / `lastPrice` carry the new open qty and limit price
+    REJECTED = 5,  ///< Order or request refused; `reason` tells why
+    REPORTS_LOST = 6 ///< Reports to `session` were dropped; only `session` is set, its order state is unknown
+};
+
+/**
+ * @struct ExecReport
+ * @brief Execution report produced by a book worker for one order.
+ *
+ * Plain data, no strings, so it can be copied into rings and encoded without allocating.
+ */
+struct ExecReport
+{
+    ExecType type{ExecType::NEW};
+    Side side{Side::BUY};
+    RejectReason reason{RejectReason::NONE};
+    Status status{Status::PENDING}; ///< Order's status after this event (not set for rejected cancels / amends)
+    SessionId session{NO_SESSION}; ///< Destination of the report
+    SymbolId symbolId{INVALID_SYMBOL_ID};
+    OrderId orderId{0};
+    Quantity lastQty{0};
+    Price lastPrice{0};
+    Quantity leavesQty{0};
+};
+
+/**
+ * @class IReportSink
+ * @brief Receives execution reports from the book workers.
+ *
+ * @remarks onReport() is called concurrently by every book worker, on their hot path, or by the
+ * consumers of a ReportStream: implementations must be thread-safe and must not block for long.
+ */
+class IReportSink {
+public:
+    virtual ~IReportSink() = default;
+    virtual void onReport(const ExecReport& report) = 0;
+};
+
+#endif //EXECREPORT_H
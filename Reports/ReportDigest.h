@@ -0,0 +1,75 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef REPORTDIGEST_H
+#define REPORTDIGEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include "ExecReport.h"
+
+/**
+ * @class ReportDigest
+ * @brief Folds every execution report, field by field, into a 64-bit FNV-1a hash.
+ *
+ * @details
+ * Two runs over the same input give the same digest only if they produced the same reports in the
+ * same order, which is what a backtest checks for. Other results (e.g. the final books) can be
+ * folded in with add().
+ * @remarks Not thread-safe: only for Scheduler::Execution::INLINE, where reports arrive on one thread.
+ */
+class ReportDigest final : public IReportSink {
+public:
+    void onReport(const ExecReport& r) override
+    {
+        mix(static_cast<uint64_t>(r.type));
+        mix(static_cast<uint64_t>(r.side));
+        mix(static_cast<uint64_t>(r.reason));
+        mix(static_cast<uint64_t>(r.status));
+        mix(r.session);
+        mix(r.symbolId);
+        mix(r.orderId);
+        mix(r.lastQty);
+        mix(static_cast<uint64_t>(r.lastPrice));
+        mix(r.leavesQty);
+        mReports++;
+        if(r.type == ExecType::TRADE)
+        {
+            mTrades++;
+        }
+    }
+
+    /** @brief Folds raw bytes into the digest. */
+    void add(const uint8_t* p, const size_t len)
+    {
+        for(size_t i = 0; i < len; i++)
+        {
+            mHash = (mHash ^ p[i]) * PRIME;
+        }
+    }
+
+    uint64_t value() const { return mHash; }
+    uint64_t reports() const { return mReports; }
+    uint64_t trades() const { return mTrades; } ///< TRADE reports, one per side of each execution
+
+private:
+    static constexpr uint64_t OFFSET = 0xcbf29ce484222325ULL;
+    static constexpr uint64_t PRIME = 0x100000001b3ULL;
+
+    uint64_t mHash{OFFSET};
+    uint64_t mReports{0};
+    uint64_t mTrades{0};
+
+    void mix(uint64_t v)
+    {
+        for(int i = 0; i < 8; i++, v >>= 8)
+        {
+            mHash = (mHash ^ (v & 0xff)) * PRIME;
+        }
+    }
+};
+
+#endif //REPORTDIGEST_H
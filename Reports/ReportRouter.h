@@ -0,0 +1,78 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef REPORTROUTER_H
+#define REPORTROUTER_H
+
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include "ExecReport.h"
+
+/**
+ * @class ReportRouter
+ * @brief Sends each execution report to the ingress source (gateway, shared memory, ...) that owns
+ * the report's session.
+ *
+ * @details
+ * A SessionId carries its source in the top 8 bits (see makeSession()), so routing is one shift and
+ * one array load, no lookup table shared between sources. Reports for NO_SESSION (replay, simulation)
+ * and for unregistered sources are dropped.
+ */
+class ReportRouter final : public IReportSink {
+public:
+    using SourceId = uint8_t;
+    static constexpr unsigned SOURCE_SHIFT = 24;
+    static constexpr SessionId LOCAL_MASK = (SessionId{1} << SOURCE_SHIFT) - 1;
+
+    static constexpr SessionId makeSession(const SourceId source, const SessionId local)
+    {
+        return (static_cast<SessionId>(source) << SOURCE_SHIFT) | (local & LOCAL_MASK);
+    }
+
+    static constexpr SourceId sourceOf(const SessionId session)
+    {
+        return static_cast<SourceId>(session >> SOURCE_SHIFT);
+    }
+
+    /**
+     * @brief Registers a source and returns the id its sessions must be built with.
+     * Source 0 is reserved so that NO_SESSION never routes anywhere.
+     * @remarks Call during startup, before the book workers produce reports.
+     * @throws std::runtime_error when all 255 source ids are taken.
+     */
+    SourceId registerSource(IReportSink* sink)
+    {
+        for(size_t i = 1; i < mSinks.size(); i++)
+        {
+            IReportSink* expected = nullptr;
+            if(mSinks[i].compare_exchange_strong(expected, sink, std::memory_order_acq_rel))
+            {
+                return static_cast<SourceId>(i);
+            }
+        }
+        throw std::runtime_error("ReportRouter: no free source id");
+    }
+
+    /** @brief Stops routing to a source. The sink may still be called by a report already in flight. */
+    void unregisterSource(const SourceId id)
+    {
+        mSinks[id].store(nullptr, std::memory_order_release);
+    }
+
+    void onReport(const ExecReport& report) override
+    {
+        if(IReportSink* sink = mSinks[sourceOf(report.session)].load(std::memory_order_acquire))
+        {
+            sink->onReport(report);
+        }
+    }
+
+private:
+    std::array<std::atomic<IReportSink*>, 256> mSinks{};
+};
+
+#endif //REPORTROUTER_H
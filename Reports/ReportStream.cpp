@@ -0,0 +1,123 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "ReportStream.h"
+#include <algorithm>
+#include <stdexcept>
+
+ReportStream::ReportStream(const size_t producers, const size_t slots, const size_t consumers,
+                           IReportSink& downstream) :
+    mConsumerCount(std::clamp<size_t>(consumers, 1, std::max<size_t>(producers, 1))),
+    mDownstream(downstream)
+{
+    if (producers == 0)
+    {
+        throw std::invalid_argument("ReportStream: needs at least one producer");
+    }
+    mProducers.reserve(producers);
+    for (size_t i = 0; i < producers; i++)
+    {
+        mProducers.push_back(std::make_unique<Producer>(slots));
+    }
+}
+
+ReportStream::~ReportStream()
+{
+    stop();
+}
+
+void ReportStream::start()
+{
+    if (mRunning.exchange(true))
+    {
+        return;
+    }
+    for (size_t c = 0; c < mConsumerCount; c++)
+    {
+        mConsumers.emplace_back([this, c] { consume(c); });
+    }
+}
+
+void ReportStream::stop()
+{
+    mRunning.store(false, std::memory_order_release);
+    for (auto& t : mConsumers)
+    {
+        if (t.joinable())
+        {
+            t.join();
+        }
+    }
+    mConsumers.clear();
+}
+
+uint64_t ReportStream::dropped() const
+{
+    uint64_t total = 0;
+    for (const auto& p : mProducers)
+    {
+        total += p->mDropped.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t ReportStream::unsignalled() const
+{
+    uint64_t total = 0;
+    for (const auto& p : mProducers)
+    {
+        total += p->mUnsignalled.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void ReportStream::consume(const size_t index)
+{
+    constexpr unsigned SPINS = 64;
+    constexpr unsigned YIELDS = 16;
+    unsigned idle = 0;
+    const auto deliver = [this](const ExecReport& r) { mDownstream.onReport(r); };
+    const auto markLost = [this](const SessionId session)
+    {
+        ExecReport r;
+        r.type = ExecType::REPORTS_LOST;
+        r.session = session;
+        mDownstream.onReport(r);
+    };
+
+    while (true)
+    {
+        // Read before draining: once it is false, a pass that finds every ring empty is the last one.
+        const bool running = mRunning.load(std::memory_order_acquire);
+        size_t n = 0;
+        for (size_t i = index; i < mProducers.size(); i += mConsumerCount)
+        {
+            n += mProducers[i]->mRing.drain(deliver, MAX_BATCH);
+            // After the ring: a marker follows every report of its session that was delivered.
+            mProducers[i]->mLost.drain(markLost);
+        }
+        if (n > 0)
+        {
+            mDelivered.fetch_add(n, std::memory_order_relaxed);
+            idle = 0;
+            continue;
+        }
+        if (!running)
+        {
+            return;
+        }
+        if (++idle <= SPINS)
+        {
+            continue;
+        }
+        if (idle <= SPINS + YIELDS)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            std::this_thread::sleep_for(IDLE_SLEEP);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef REPORTSTREAM_H
+#define REPORTSTREAM_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "ExecReport.h"
+#include "../Concurrency/SpscRing.h"
+
+/**
+ * @class ReportStream
+ * @brief Moves execution reports off the book workers: each worker publishes into its own SPSC ring,
+ * consumer threads drain the rings into the downstream sink (normally the ReportRouter).
+ *
+ * @details
+ * - Publishing is a copy into a preallocated slot and one release store. It never locks, waits or
+ *   allocates. A report that finds its ring full is dropped and counted (see dropped()): a slow
+ *   client or consumer costs reports, never matching latency.
+ * - A drop is never silent: its session is put on a second, small ring of the producer, and the
+ *   consumer delivers an ExecType::REPORTS_LOST marker for it after the reports that made it
+ *   through. The gateway disconnects such a session, as it does a client that stops reading.
+ *   Only when that ring is full too is the session left unmarked (see unsignalled()).
+ * - Ring i is drained by consumer i % consumers, so every report of one book reaches the downstream
+ *   sink in the order the book produced it. Per session, reports of different books may interleave.
+ * - Idle consumers spin briefly, then yield, then sleep up to IDLE_SLEEP between polls.
+ *
+ * Producers are obtained with producer() and handed to the books of one worker; a producer must only
+ * be used by that worker's thread.
+ */
+class ReportStream {
+public:
+    static constexpr size_t DEFAULT_RING_SLOTS = 65536;
+    static constexpr size_t MAX_BATCH = 256; ///< Reports a consumer takes from one ring before moving on
+    static constexpr size_t LOST_SLOTS = 4096; ///< Sessions with dropped reports a producer can hold
+    static constexpr auto IDLE_SLEEP = std::chrono::microseconds(50);
+
+    /** @brief The publishing end of one ring; an IReportSink a book can be given. */
+    class Producer final : public IReportSink {
+    public:
+        explicit Producer(const size_t slots) : mRing(slots), mLost(LOST_SLOTS) {}
+
+        void onReport(const ExecReport& report) override
+        {
+            if (mRing.tryPush(report))
+            {
+                mPublished.store(mPublished.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+            else
+            {
+                mDropped.store(mDropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                lose(report.session);
+            }
+        }
+
+    private:
+        friend class ReportStream;
+        SpscRing<ExecReport> mRing;
+        SpscRing<SessionId> mLost; ///< Sessions that had a report dropped, in the order of the drops
+        SessionId mLastLost{NO_SESSION}; ///< A burst of drops for one session is marked once
+        // Written by the producer only (load + store, no locked RMW), read by anyone.
+        std::atomic<uint64_t> mPublished{0};
+        std::atomic<uint64_t> mDropped{0};
+        std::atomic<uint64_t> mUnsignalled{0};
+
+        void lose(const SessionId session)
+        {
+            if (session == NO_SESSION || session == mLastLost)
+            {
+                return;
+            }
+            if (mLost.tryPush(session))
+            {
+                mLastLost = session;
+            }
+            else
+            {
+                mUnsignalled.store(mUnsignalled.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    /**
+     * @param producers Number of rings, one per book worker.
+     * @param slots Capacity of each ring, a power of two.
+     * @param consumers Draining threads, at least 1 and at most `producers` are used.
+     * @param downstream Receives every report that was not dropped, and a REPORTS_LOST marker per
+     * session that had some dropped, on the consumer threads.
+     */
+    ReportStream(size_t producers, size_t slots, size_t consumers, IReportSink& downstream);
+
+    /** @brief Stops the consumers (see stop()). */
+    ~ReportStream();
+
+    ReportStream(const ReportStream&) = delete;
+    ReportStream& operator=(const ReportStream&) = delete;
+
+    /** @brief Starts the consumer threads. */
+    void start();
+
+    /**
+     * @brief Stops the consumers once every ring is empty.
+     * @pre No producer publishes any more (the book workers are shut down).
+     */
+    void stop();
+
+    /** @brief Publishing end of ring `i`, for the books of one worker. */
+    Producer& producer(const size_t i) { return *mProducers.at(i); }
+
+    size_t producers() const { return mProducers.size(); }
+
+    /** @brief Reports handed to the downstream sink so far. */
+    uint64_t delivered() const { return mDelivered.load(std::memory_order_relaxed); }
+
+    /** @brief Reports dropped on a full ring so far, over all producers. */
+    uint64_t dropped() const;
+
+    /** @brief Drops whose session could not be marked REPORTS_LOST, both rings being full; should stay 0. */
+    uint64_t unsignalled() const;
+
+private:
+    std::vector<std::unique_ptr<Producer>> mProducers;
+    size_t mConsumerCount;
+    IReportSink& mDownstream;
+    std::vector<std::thread> mConsumers;
+    std::atomic<bool> mRunning{false};
+    std::atomic<uint64_t> mDelivered{0};
+
+    /** @brief Loop of consumer `index`: drains its rings until stopped and they are empty. */
+    void consume(size_t index);
+};
+
+#endif //REPORTSTREAM_H
@@ -0,0 +1,256 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#include "PreTradeRisk.h"
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    constexpr int64_t UNLIMITED = RiskLimits::UNLIMITED;
+
+    /** @brief price x qty, saturated at UNLIMITED. Prices <= 0 (nothing to price against) count as 0. */
+    int64_t notionalOf(const Price price, const Quantity qty) noexcept
+    {
+        if (price <= 0)
+        {
+            return 0;
+        }
+        const __int128 n = static_cast<__int128>(price) * qty;
+        return n > UNLIMITED ? UNLIMITED : static_cast<int64_t>(n);
+    }
+
+    /**
+     * @brief Takes at least `need` and at most `need + chunk` credit from a pool.
+     * @return Credit taken, 0 if the pool holds less than `need`.
+     */
+    int64_t lease(std::atomic<int64_t>& pool, const int64_t need, const int64_t chunk) noexcept
+    {
+        int64_t free = pool.load(std::memory_order_relaxed);
+        while (free >= need)
+        {
+            const int64_t take = std::min(free, need + chunk);
+            if (pool.compare_exchange_weak(free, free - take, std::memory_order_relaxed))
+            {
+                return take;
+            }
+        }
+        return 0;
+    }
+
+    /** @brief Keeps at most two chunks of unused credit, the surplus goes back to the pool. */
+    void trim(int64_t& held, std::atomic<int64_t>& pool, const int64_t chunk) noexcept
+    {
+        if (held > 2 * chunk)
+        {
+            const int64_t surplus = held - chunk;
+            pool.fetch_add(surplus, std::memory_order_relaxed);
+            held -= surplus;
+        }
+    }
+}
+
+void RiskEngine::set(const AccountId id, const RiskLimits& limits)
+{
+    if (id == NO_ACCOUNT || limits.maxNotional < 0 || limits.maxOpenOrders < 0 || limits.maxPosition < 0)
+    {
+        throw std::invalid_argument("RiskEngine: invalid limits for account " + std::to_string(id));
+    }
+    mAccounts[id] = std::make_unique<Account>(limits);
+}
+
+RiskShard::~RiskShard()
+{
+    for (auto& [_, c] : mCredits)
+    {
+        c.account->notionalFree.fetch_add(c.notional, std::memory_order_relaxed);
+        c.account->ordersFree.fetch_add(c.orders, std::memory_order_relaxed);
+    }
+}
+
+RiskShard::Exposure* RiskShard::exposure(const AccountId account, const SymbolId symbol)
+{
+    if (account == NO_ACCOUNT)
+    {
+        return nullptr;
+    }
+    const uint64_t key = static_cast<uint64_t>(account) << 32 | symbol;
+    if (const auto it = mExposure.find(key); it != mExposure.end())
+    {
+        return &it->second;
+    }
+
+    auto credit = mCredits.find(account);
+    if (credit == mCredits.end())
+    {
+        RiskEngine::Account* a = mEngine.find(account);
+        if (!a)
+        {
+            return nullptr;
+        }
+        credit = mCredits.emplace(account, Credit{a}).first;
+    }
+    return &mExposure.emplace(key, Exposure{&credit->second}).first->second;
+}
+
+RejectReason RiskShard::reserve(const Order& order, const SymbolId symbol, const Price price)
+{
+    Exposure* e = exposure(order.account(), symbol);
+    if (!e)
+    {
+        return RejectReason::NONE;
+    }
+    Credit& c = *e->credit;
+    RiskEngine::Account& a = *c.account;
+    const Quantity qty = order.openQty();
+
+    if (a.limits.maxPosition != UNLIMITED)
+    {
+        const __int128 worst = order.side() == Side::BUY
+            ? static_cast<__int128>(e->position) + e->openBuy + qty
+            : -static_cast<__int128>(e->position) + e->openSell + qty;
+        if (worst > a.limits.maxPosition)
+        {
+            return RejectReason::RISK_POSITION;
+        }
+    }
+
+    const bool countOrders = a.limits.maxOpenOrders != UNLIMITED;
+    if (countOrders && c.orders < 1)
+    {
+        c.orders += lease(a.ordersFree, 1 - c.orders, a.ordersChunk);
+        if (c.orders < 1)
+        {
+            return RejectReason::RISK_OPEN_ORDERS;
+        }
+    }
+
+    int64_t notional = 0;
+    if (a.limits.maxNotional != UNLIMITED)
+    {
+        notional = notionalOf(price, qty);
+        if (price <= 0 || notional > a.limits.maxNotional)
+        {
+            return RejectReason::RISK_NOTIONAL; // price <= 0: an order without a limit and nothing to bound it
+        }
+        if (c.notional < notional)
+        {
+            c.notional += lease(a.notionalFree, notional - c.notional, a.notionalChunk);
+            if (c.notional < notional)
+            {
+                return RejectReason::RISK_NOTIONAL; // leased credit stays with this shard for the next order
+            }
+        }
+    }
+
+    c.orders -= countOrders;
+    c.notional -= notional;
+    (order.side() == Side::BUY ? e->openBuy : e->openSell) += static_cast<int64_t>(qty);
+    return RejectReason::NONE;
+}
+
+void RiskShard::onFill(const AccountId account, const SymbolId symbol, const Side side, const Quantity qty,
+                       const Price price, const bool filled)
+{
+    if (Exposure* e = exposure(account, symbol))
+    {
+        e->position += side == Side::BUY ? static_cast<int64_t>(qty) : -static_cast<int64_t>(qty);
+        release(*e, side, qty, price, filled);
+    }
+}
+
+void RiskShard::onReduce(const AccountId account, const SymbolId symbol, const Side side, const Quantity qty,
+                         const Price price)
+{
+    if (Exposure* e = exposure(account, symbol))
+    {
+        release(*e, side, qty, price, 0);
+    }
+}
+
+void RiskShard::onClose(const AccountId account, const SymbolId symbol, const Side side, const Quantity openQty,
+                        const Price price)
+{
+    if (Exposure* e = exposure(account, symbol))
+    {
+        release(*e, side, openQty, price, 1);
+    }
+}
+
+int64_t RiskShard::position(const AccountId account, const SymbolId symbol) const
+{
+    const auto it = mExposure.find(static_cast<uint64_t>(account) << 32 | symbol);
+    return it == mExposure.end() ? 0 : it->second.position;
+}
+
+void RiskShard::rebook(const Order& order, const SymbolId symbol, const Price price)
+{
+    Exposure* e = exposure(order.account(), symbol);
+    if (!e)
+    {
+        return;
+    }
+    Credit& c = *e->credit;
+    RiskEngine::Account& a = *c.account;
+    const Quantity qty = order.openQty();
+
+    const bool countOrders = a.limits.maxOpenOrders != UNLIMITED;
+    if (countOrders && c.orders < 1)
+    {
+        c.orders += lease(a.ordersFree, 1 - c.orders, a.ordersChunk);
+    }
+    int64_t notional = 0;
+    if (a.limits.maxNotional != UNLIMITED)
+    {
+        notional = notionalOf(price, qty);
+        if (c.notional < notional)
+        {
+            c.notional += lease(a.notionalFree, notional - c.notional, a.notionalChunk);
+        }
+    }
+    // Booked whether or not the leases succeeded, so releasing the order later balances.
+    c.orders -= countOrders;
+    c.notional -= notional;
+    (order.side() == Side::BUY ? e->openBuy : e->openSell) += static_cast<int64_t>(qty);
+}
+
+std::vector<std::pair<AccountId, int64_t>> RiskShard::positions(const SymbolId symbol) const
+{
+    std::vector<std::pair<AccountId, int64_t>> out;
+    for (const auto& [key, e] : mExposure)
+    {
+        if (static_cast<SymbolId>(key) == symbol && e.position != 0)
+        {
+            out.emplace_back(static_cast<AccountId>(key >> 32), e.position);
+        }
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+void RiskShard::restorePosition(const AccountId account, const SymbolId symbol, const int64_t position)
+{
+    if (Exposure* e = exposure(account, symbol))
+    {
+        e->position = position;
+    }
+}
+
+void RiskShard::release(Exposure& e, const Side side, const Quantity qty, const Price price, const int64_t orders)
+{
+    (side == Side::BUY ? e.openBuy : e.openSell) -= static_cast<int64_t>(qty);
+
+    Credit& c = *e.credit;
+    RiskEngine::Account& a = *c.account;
+    if (a.limits.maxNotional != UNLIMITED)
+    {
+        c.notional += notionalOf(price, qty);
+        trim(c.notional, a.notionalFree, a.notionalChunk);
+    }
+    if (a.limits.maxOpenOrders != UNLIMITED)
+    {
+        c.orders += orders;
+        trim(c.orders, a.ordersFree, a.ordersChunk);
+    }
+}
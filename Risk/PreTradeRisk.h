@@ -0,0 +1,195 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+#pragma once
+
+#ifndef PRETRADERISK_H
+#define PRETRADERISK_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "../OrderBook/Order/Order.h"
+#include "../OrderBook/Order/Types.h"
+
+/**
+ * @struct RiskLimits
+ * @brief Pre-trade limits of one account, as configured. A limit left at its default is not checked.
+ */
+struct RiskLimits
+{
+    static constexpr int64_t UNLIMITED = std::numeric_limits<int64_t>::max();
+
+    int64_t maxNotional{UNLIMITED};   ///< Open (unfilled) notional over all symbols, in price ticks x quantity
+    int64_t maxOpenOrders{UNLIMITED}; ///< Orders accepted and not yet filled or cancelled, over all symbols
+    int64_t maxPosition{UNLIMITED};   ///< Per symbol: |filled position + open quantity on the order's side|
+};
+
+/**
+ * @class RiskEngine
+ * @brief Process-wide table of accounts: their limits and the credit not leased to any worker yet.
+ *
+ * @details
+ * Notional and open-order credit is global to an account, but orders of one account reach several
+ * book workers at once. Rather than every check touching one shared counter, workers lease credit
+ * from the account's pool in chunks of `limit / LEASE_DIVISOR` (one compare-and-swap) and check
+ * against their lease with plain arithmetic, see RiskShard. Positions are per symbol and a symbol
+ * lives on one worker, so they are never shared at all.
+ *
+ * Filled during startup from the configuration; afterwards the table itself is read-only and takes
+ * no lock (same contract as ReferenceData), only the pools change.
+ */
+class RiskEngine {
+public:
+    /** @brief Credit is leased to workers in chunks of limit / LEASE_DIVISOR. */
+    static constexpr int64_t LEASE_DIVISOR = 64;
+
+    /** @brief One account: its limits and the credit left in its pools. */
+    struct Account
+    {
+        RiskLimits limits;
+        int64_t notionalChunk{1};
+        int64_t ordersChunk{1};
+        alignas(64) std::atomic<int64_t> notionalFree{0}; ///< Notional credit not leased to a worker
+        alignas(64) std::atomic<int64_t> ordersFree{0};   ///< Open-order credit not leased to a worker
+
+        explicit Account(const RiskLimits& l) :
+            limits(l),
+            notionalChunk(std::max<int64_t>(1, l.maxNotional / LEASE_DIVISOR)),
+            ordersChunk(std::max<int64_t>(1, l.maxOpenOrders / LEASE_DIVISOR)),
+            notionalFree(l.maxNotional),
+            ordersFree(l.maxOpenOrders)
+        {}
+    };
+
+    static RiskEngine& instance()
+    {
+        static RiskEngine e;
+        return e;
+    }
+
+    /**
+     * @brief Sets the limits of an account.
+     * @throws std::invalid_argument for NO_ACCOUNT or a negative limit.
+     * @warning Startup only. Must not run concurrently with trading.
+     */
+    void set(AccountId id, const RiskLimits& limits);
+
+    /** @return The account, or nullptr if it has no limits (its orders are not checked). */
+    Account* find(const AccountId id) const
+    {
+        const auto it = mAccounts.find(id);
+        return it == mAccounts.end() ? nullptr : it->second.get();
+    }
+
+    bool empty() const { return mAccounts.empty(); }
+
+private:
+    std::unordered_map<AccountId, std::unique_ptr<Account>> mAccounts;
+
+    RiskEngine() = default;
+};
+
+/**
+ * @class RiskShard
+ * @brief One worker's view of pre-trade risk: its leases of every account's credit and the
+ * positions of the symbols it owns.
+ *
+ * @details
+ * Owned by a book worker and only used on that thread, like the books themselves. A check is one
+ * hash lookup (account and symbol) and a few compares; the account pools are touched only when a lease runs out, or
+ * when more than two chunks are idle and the surplus is given back. The price of sharding is that an
+ * account can be refused while part of its credit is leased to other workers: at most two chunks
+ * per worker and per account, i.e. 2 * workers / LEASE_DIVISOR of the limit.
+ *
+ * The book drives it over an order's life: reserve() when the order enters matching, onFill() for
+ * its executions, onReduce() when its open quantity shrinks in place and onClose() when it leaves
+ * the book unfilled. Orders of accounts without limits cost a failed lookup per call, orders
+ * without an account nothing.
+ */
+class RiskShard {
+public:
+    explicit RiskShard(RiskEngine& engine = RiskEngine::instance()) : mEngine(engine) {}
+
+    /** @brief Gives the leased credit back to the accounts' pools. */
+    ~RiskShard();
+
+    RiskShard(const RiskShard&) = delete;
+    RiskShard& operator=(const RiskShard&) = delete;
+
+    /**
+     * @brief Checks an order against its account's limits and, if it fits, books its open quantity
+     * and notional (at `price`) as exposure.
+     * @param price The order's limit, or for an order without one a bound on every price it can
+     * trade at. A notional-limited account's order is refused when `price` <= 0, no bound being known.
+     * @return RejectReason::NONE if accepted, otherwise the first limit it would breach.
+     */
+    RejectReason reserve(const Order& order, SymbolId symbol, Price price);
+
+    /**
+     * @brief Executions of `qty` at the order's reserved `price`: open exposure becomes position.
+     * @param filled The order has no open quantity left and leaves the book, which frees its slot.
+     */
+    void onFill(AccountId account, SymbolId symbol, Side side, Quantity qty, Price price, bool filled);
+
+    /** @brief The order's open quantity went down by `qty` and the order stays in the book. */
+    void onReduce(AccountId account, SymbolId symbol, Side side, Quantity qty, Price price);
+
+    /** @brief The order left the book with `openQty` unfilled: frees it and the order slot. */
+    void onClose(AccountId account, SymbolId symbol, Side side, Quantity openQty, Price price);
+
+    /** @return Net filled position of the account in the symbol, buys positive. */
+    int64_t position(AccountId account, SymbolId symbol) const;
+
+    // <===== Snapshot restore =====>
+
+    /**
+     * @brief Books a resting order restored from a snapshot like reserve() would, without checking
+     * the limits: the order was accepted when it arrived and rests regardless. Credit the pools
+     * cannot lease any more leaves this shard's credit negative until the exposure goes away.
+     */
+    void rebook(const Order& order, SymbolId symbol, Price price);
+
+    /** @return Non-zero positions in the symbol, by account, for a snapshot of its book. */
+    std::vector<std::pair<AccountId, int64_t>> positions(SymbolId symbol) const;
+
+    /** @brief Sets an account's position in the symbol from a snapshot. Ignored for accounts without limits. */
+    void restorePosition(AccountId account, SymbolId symbol, int64_t position);
+
+private:
+    struct Credit
+    {
+        RiskEngine::Account* account{nullptr}; ///< Account the credit is leased from
+        int64_t notional{0}; ///< Leased notional credit not used by an open order
+        int64_t orders{0};   ///< Leased open-order credit not used by an open order
+    };
+
+    struct Exposure
+    {
+        Credit* credit{nullptr}; ///< The account's entry in mCredits
+        int64_t position{0};
+        int64_t openBuy{0};
+        int64_t openSell{0};
+    };
+
+    RiskEngine& mEngine;
+    std::unordered_map<AccountId, Credit> mCredits; ///< Node-based: Exposure::credit stays valid
+    std::unordered_map<uint64_t, Exposure> mExposure; ///< By account << 32 | symbol
+
+    /**
+     * @return Exposure of the account in the symbol, created on first use; nullptr for NO_ACCOUNT and
+     * accounts without limits, which get no entry so unknown ids from the wire cannot grow the maps.
+     */
+    Exposure* exposure(AccountId account, SymbolId symbol);
+
+    /** @brief Frees notional and open quantity, then gives surplus credit back to the pools. */
+    void release(Exposure& e, Side side, Quantity qty, Price price, int64_t orders);
+};
+
+#endif //PRETRADERISK_H
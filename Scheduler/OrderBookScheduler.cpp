@@ -3,17 +3,96 @@
 //
 
 #include "OrderBookScheduler.h"
+#include <future>
 
-void OrderBookScheduler::processOrder(OrderPtr order)
+void OrderBookScheduler::start()
 {
-    const Worker::Id wid = getWorker(order->symbol());
+    Scheduler::start();
+    assignBooks();
+}
+
+void OrderBookScheduler::assignBooks()
+{
+    // With a stream, worker i publishes into ring i: a ring only ever has that worker as producer.
+    // Same for the depth publisher, the order feed and the bar publisher.
+    std::unordered_map<Worker::Id, IReportSink*> sinks;
+    std::unordered_map<Worker::Id, IDepthSink*> depthSinks;
+    std::unordered_map<Worker::Id, IOrderEventSink*> orderSinks;
+    std::unordered_map<Worker::Id, IBarSink*> barSinks;
+    std::unordered_map<Worker::Id, RiskShard*> risks;
+    const auto ids = workerIds();
+    for(size_t i = 0; i < ids.size(); i++)
+    {
+        sinks[ids[i]] = mReportStream ? &mReportStream->producer(i) : mReportSink;
+        depthSinks[ids[i]] = mDepthPublisher ? &mDepthPublisher->producer(i) : nullptr;
+        orderSinks[ids[i]] = mOrderFeed ? &mOrderFeed->producer(i) : nullptr;
+        barSinks[ids[i]] = mBarPublisher ? &mBarPublisher->producer(i) : nullptr;
+        // Inline workers share one thread, so the thread-local shard would merge their leases.
+        risks[ids[i]] = nullptr;
+        if(execution() == Execution::INLINE)
+        {
+            risks[ids[i]] = (mInlineRisk[ids[i]] = std::make_unique<RiskShard>()).get();
+        }
+    }
+
+    for(SymbolId id = 0; id < mWorkerBySymbolId.size(); id++)
+    {
+        if(mWorkerBySymbolId[id].empty())
+        {
+            continue;
+        }
+        submitTo(mWorkerBySymbolId[id],
+            [id, sink = sinks[mWorkerBySymbolId[id]], depth = depthSinks[mWorkerBySymbolId[id]],
+             orders = orderSinks[mWorkerBySymbolId[id]], bars = barSinks[mWorkerBySymbolId[id]],
+             risk = risks[mWorkerBySymbolId[id]],
+             metrics = mMetrics.count(mWorkerBySymbolId[id]) ? mMetrics.at(mWorkerBySymbolId[id]) : nullptr]
+            (const CancelToken&)
+            {
+                localMetrics() = metrics;
+                localBook(id)->setReportSink(sink);
+                localBook(id)->setDepthSink(depth);
+                localBook(id)->setOrderEventSink(orders);
+                localBook(id)->setBarSink(bars);
+                localBook(id)->setMetrics(metrics);
+                // Accounts are configured before start(); without any, orders skip risk entirely.
+                localBook(id)->setRiskShard(RiskEngine::instance().empty() ? nullptr : risk ? risk : &localRisk());
+            },
+            "OrderBookScheduler: assign book");
+    }
+}
+
+OrderBook* OrderBookScheduler::localBook(const SymbolId id)
+{
+    auto& books = localBooks();
+    if(id >= books.size())
+    {
+        books.resize(SymbolTable::instance().size(), nullptr);
+    }
+    if(!books[id])
+    {
+        // Registry keeps ownership, table only caches the raw pointer.
+        books[id] = OrderBook::getOrCreate(SymbolTable::instance().name(id)).get();
+    }
+    return books[id];
+}
+
+void OrderBookScheduler::processOrder(OrderPtr order, SymbolId symbolId, const uint64_t ingressNs)
+{
+    if(symbolId == INVALID_SYMBOL_ID)
+    {
+        symbolId = SymbolTable::instance().find(order->symbol());
+    }
+    if(symbolId == INVALID_SYMBOL_ID)
+    {
+        throw std::runtime_error("No worker mapping for " + order->symbol());
+    }
+    const Worker::Id& wid = getWorker(symbolId);
 
     // move-only lambda that owns order
-    auto move_only_lambda = [this, ord = std::move(order)](const CancelToken& cTok) mutable
+    auto move_only_lambda = [symbolId, ord = std::move(order), ingressNs, lat = latencySink(ingressNs)]
+        (const CancelToken& cTok) mutable
     {
-        const Symbol symbol = ord->symbol();
-        const auto& ob = OrderBook::getOrCreate(symbol);
-        ob->processOrder(std::move(ord)); // pass ownership if processOrder expects OrderPtr
+        runTimed(ingressNs, lat, [&] { localBook(symbolId)->processOrder(std::move(ord)); });
     };
 
     // wrap in a shared_ptr to make it copyable for std::function storage
@@ -28,3 +107,211 @@ void OrderBookScheduler::processOrder(OrderPtr order)
         "desc");
 }
 
+void OrderBookScheduler::processCancel(const SymbolId symbolId, const OrderId orderId, const SessionId session,
+                                       const uint64_t ingressNs)
+{
+    submitTo(getWorker(symbolId),
+        [symbolId, orderId, session, ingressNs, lat = latencySink(ingressNs)](const CancelToken&)
+        {
+            runTimed(ingressNs, lat, [&] { localBook(symbolId)->cancelOrder(orderId, session); });
+        },
+        "OrderBookScheduler: cancel");
+}
+
+void OrderBookScheduler::processAmend(const SymbolId symbolId, const OrderId orderId,
+                                      const Quantity newOpenQty, const Price newPrice, const SessionId session,
+                                      const uint64_t ingressNs)
+{
+    submitTo(getWorker(symbolId),
+        [symbolId, orderId, newOpenQty, newPrice, session, ingressNs, lat = latencySink(ingressNs)]
+        (const CancelToken&)
+        {
+            runTimed(ingressNs, lat, [&] { localBook(symbolId)->amendOrder(orderId, newOpenQty, newPrice, session); });
+        },
+        "OrderBookScheduler: amend");
+}
+
+void OrderBookScheduler::processReplace(const SymbolId symbolId, const OrderId orderId,
+                                        const Quantity newTotalQty, const Price newPrice, const SessionId session,
+                                        const uint64_t ingressNs)
+{
+    submitTo(getWorker(symbolId),
+        [symbolId, orderId, newTotalQty, newPrice, session, ingressNs, lat = latencySink(ingressNs)]
+        (const CancelToken&)
+        {
+            runTimed(ingressNs, lat, [&] { localBook(symbolId)->replaceOrder(orderId, newTotalQty, newPrice, session); });
+        },
+        "OrderBookScheduler: replace");
+}
+
+void OrderBookScheduler::processMassCancel(const SymbolId symbolId, const std::optional<Side> side,
+                                           const SessionId session)
+{
+    for(SymbolId id = 0; id < mWorkerBySymbolId.size(); id++)
+    {
+        if(mWorkerBySymbolId[id].empty() || (symbolId != INVALID_SYMBOL_ID && symbolId != id))
+        {
+            continue;
+        }
+        submitTo(mWorkerBySymbolId[id],
+            [id, side, session](const CancelToken&)
+            {
+                localBook(id)->massCancel(side, session);
+            },
+            "OrderBookScheduler: mass cancel");
+    }
+}
+
+void OrderBookScheduler::closeBars(const uint64_t startNs, const uint64_t endNs)
+{
+    for(const auto& wid : workerIds())
+    {
+        submitTo(wid,
+            [startNs, endNs](const CancelToken&)
+            {
+                for(OrderBook* book : localBooks())
+                {
+                    if(book)
+                    {
+                        book->closeBar(startNs, endNs);
+                    }
+                }
+            },
+            "OrderBookScheduler: close bars");
+    }
+}
+
+void OrderBookScheduler::snapshot(const size_t index, SnapshotFn done)
+{
+    const Worker::Id wid = workerIds().at(index);
+    submitTo(wid,
+        [this, wid, done = std::move(done)](const CancelToken&)
+        {
+            // Only the worker's own books: inline, the table holds every worker's.
+            const auto& books = localBooks();
+            const auto owned = [&](const SymbolId id)
+            {
+                return books[id] && ownsSymbol(id) && mWorkerBySymbolId[id] == wid;
+            };
+            uint32_t count = 0;
+            for(SymbolId id = 0; id < books.size(); id++)
+            {
+                count += owned(id) ? 1 : 0;
+            }
+            SnapshotStore::Image image;
+            SnapshotWriter out(image);
+            out.put<uint32_t>(count);
+            for(SymbolId id = 0; id < books.size(); id++)
+            {
+                if(owned(id))
+                {
+                    out.putString(SymbolTable::instance().name(id));
+                    books[id]->saveSnapshot(out);
+                }
+            }
+            done(std::move(image));
+        },
+        "OrderBookScheduler: snapshot");
+}
+
+uint64_t OrderBookScheduler::loadImage(const SnapshotStore::Image& image, const Worker::Id& wid) const
+{
+    SnapshotReader in(image.data(), image.size());
+    uint64_t loaded = 0;
+    const auto books = in.get<uint32_t>();
+    for(uint32_t i = 0; i < books; i++)
+    {
+        const Symbol symbol = in.getString();
+        const SymbolId id = SymbolTable::instance().find(symbol);
+        if(!ownsSymbol(id) || mWorkerBySymbolId[id] != wid)
+        {
+            throw std::runtime_error("Snapshot of " + wid + " holds " + symbol + ", which it does not own");
+        }
+        loaded += localBook(id)->loadSnapshot(in);
+    }
+    if(in.remaining() != 0)
+    {
+        throw std::runtime_error("Snapshot of " + wid + " has trailing bytes");
+    }
+    return loaded;
+}
+
+uint64_t OrderBookScheduler::loadSnapshots(const std::vector<SnapshotStore::Image>& images)
+{
+    const auto ids = workerIds();
+    std::vector<std::future<uint64_t>> loads;
+    for(size_t i = 0; i < images.size() && i < ids.size(); i++)
+    {
+        if(images[i].empty())
+        {
+            continue;
+        }
+        auto result = std::make_shared<std::promise<uint64_t>>();
+        loads.push_back(result->get_future());
+        submitTo(ids[i],
+            [this, result, &image = images[i], wid = ids[i]](const CancelToken&)
+            {
+                try
+                {
+                    result->set_value(loadImage(image, wid));
+                }
+                catch(...)
+                {
+                    result->set_exception(std::current_exception());
+                }
+            },
+            "OrderBookScheduler: load snapshot");
+    }
+
+    // Every load finishes before the images can go away, even when one of them failed.
+    uint64_t loaded = 0;
+    std::exception_ptr failed;
+    for(auto& load : loads)
+    {
+        try
+        {
+            loaded += load.get();
+        }
+        catch(...)
+        {
+            failed = failed ? failed : std::current_exception();
+        }
+    }
+    if(failed)
+    {
+        std::rethrow_exception(failed);
+    }
+    return loaded;
+}
+
+SessionId OrderBookScheduler::highestSession()
+{
+    std::vector<std::future<SessionId>> answers;
+    for(const auto& wid : workerIds())
+    {
+        auto result = std::make_shared<std::promise<SessionId>>();
+        answers.push_back(result->get_future());
+        submitTo(wid,
+            [this, result, wid](const CancelToken&)
+            {
+                SessionId highest = NO_SESSION;
+                const auto& books = localBooks();
+                for(SymbolId id = 0; id < books.size(); id++)
+                {
+                    if(books[id] && mWorkerBySymbolId[id] == wid)
+                    {
+                        highest = std::max(highest, books[id]->highestSession());
+                    }
+                }
+                result->set_value(highest);
+            },
+            "OrderBookScheduler: highest session");
+    }
+
+    SessionId highest = NO_SESSION;
+    for(auto& answer : answers)
+    {
+        highest = std::max(highest, answer.get());
+    }
+    return highest;
+}
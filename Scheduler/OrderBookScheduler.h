@@ -9,6 +9,17 @@
 
 #include "Scheduler.h"
 #include "../OrderBook/OrderBook.h"
+#include "../OrderBook/SymbolTable.h"
+#include "../Metrics/LatencyHistogram.h"
+#include "../Metrics/MetricsRegistry.h"
+#include "../Risk/PreTradeRisk.h"
+#include "../Reports/ReportStream.h"
+#include "../MarketData/ConflatingPublisher.h"
+#include "../MarketData/OrderFeedWriter.h"
+#include "../MarketData/BarPublisher.h"
+#include "../Journal/Snapshot.h"
+#include <algorithm>
+#include <functional>
 #include <iostream>
 /**
  * @class OrderBookScheduler
@@ -18,12 +29,34 @@
 class OrderBookScheduler final : public Scheduler {
 public:
  using SymbolToWorkerMap = std::unordered_map<Symbol, std::string>;
+
+ /** @brief Receives a worker's snapshot image, on that worker. */
+ using SnapshotFn = std::function<void(SnapshotStore::Image)>;
 private:
 
  SymbolToWorkerMap mSymbolToWorkerMap;
+ std::vector<Worker::Id> mWorkerBySymbolId; ///< SymbolId -> owning worker, immutable after construction
+ std::vector<size_t> mWorkerIndexBySymbolId; ///< SymbolId -> position of the owning worker in workerIds()
  std::string mPrefix;
  size_t mWorkersCnt;
  mutable std::shared_mutex mObsLock; ///< Mutex for SymbolToWorkerMap
+ std::atomic<LatencyHistogram*> mLatency{nullptr}; ///< End-to-end latency sink, null when not measured
+ IReportSink* mReportSink{nullptr}; ///< Handed to every book at assignment, set before start()
+ ReportStream* mReportStream{nullptr}; ///< When set, each worker's books publish into their own ring instead
+ ConflatingPublisher* mDepthPublisher{nullptr}; ///< Receives the books' L2 updates, one ring per worker; null = none
+ OrderFeedWriter* mOrderFeed{nullptr}; ///< Receives the books' L3 events, one ring per worker; null = none
+ BarPublisher* mBarPublisher{nullptr}; ///< Receives the books' completed bars, one ring per worker; null = none
+ std::unordered_map<Worker::Id, WorkerMetrics*> mMetrics; ///< Each worker's counters, empty = not exported
+ std::unordered_map<Worker::Id, std::unique_ptr<RiskShard>> mInlineRisk; ///< INLINE: each worker's risk, which cannot be thread-local
+
+ /**
+  * @brief Histogram a task submitted now should record into, or null if the message was not stamped
+  * or nobody is measuring.
+  */
+ LatencyHistogram* latencySink(const uint64_t ingressNs) const
+ {
+  return ingressNs ? mLatency.load(std::memory_order_acquire) : nullptr;
+ }
 
  /**
   * @brief Get worker from symbol.
@@ -40,21 +73,323 @@ private:
   return it->second;
  }
 
+ /**
+  * @brief Get the owning worker of an interned symbol.
+  * @throws std::runtime_error when the symbol is not assigned to any worker.
+  */
+ const Worker::Id& getWorker(const SymbolId id) const
+ {
+  if(id >= mWorkerBySymbolId.size() || mWorkerBySymbolId[id].empty())
+  {
+   throw std::runtime_error("No worker mapping for symbol id " + std::to_string(id));
+  }
+  return mWorkerBySymbolId[id];
+ }
+
+ /**
+  * @brief Books owned by the calling book worker, directly indexed by SymbolId.
+  *
+  * @details
+  * Each book worker exclusively owns its books, so it keeps raw pointers to them in a thread-local
+  * table filled at assignment time (see assignBooks()). The hot path then resolves a book with one
+  * array index instead of a registry lookup (shared lock, string hash, shared_ptr copy). The registry
+  * keeps the owning shared_ptr, which keeps the raw pointers valid; it is only used for creation and
+  * administration. With Execution::INLINE every worker runs on the caller's thread and the table
+  * holds all their books, each still under its own id.
+  */
+ static std::vector<OrderBook*>& localBooks()
+ {
+  thread_local std::vector<OrderBook*> books;
+  return books;
+ }
+
+ /**
+  * @brief Pre-trade risk of the calling worker, shared by all of its books. Per worker rather than
+  * per book, so a worker leases an account's credit once for every symbol it trades. With
+  * Execution::INLINE the books use their worker's entry of mInlineRisk instead, which leases the
+  * same way.
+  */
+ static RiskShard& localRisk()
+ {
+  thread_local RiskShard risk;
+  return risk;
+ }
+
+ /**
+  * @brief Counters of the calling worker, null when metrics are not exported. Set at assignment.
+  * With Execution::INLINE all workers share the thread and the stage timings land in one of them;
+  * the books' own counters stay per worker.
+  */
+ static WorkerMetrics*& localMetrics()
+ {
+  thread_local WorkerMetrics* metrics = nullptr;
+  return metrics;
+ }
+
+ /**
+  * @brief Runs a book operation on the calling worker and records its latencies: end-to-end into
+  * `lat` if set, and every Stage into the worker's metrics. Only stamped messages are timed.
+  */
+ template <typename F>
+ static void runTimed(const uint64_t ingressNs, LatencyHistogram* lat, F&& f)
+ {
+  WorkerMetrics* m = localMetrics();
+  if(!ingressNs || (!lat && !m))
+  {
+   f();
+   return;
+  }
+  const uint64_t startNs = LatencyHistogram::nowNs();
+  f();
+  const uint64_t endNs = LatencyHistogram::nowNs();
+  const uint64_t total = endNs > ingressNs ? endNs - ingressNs : 0;
+  if(lat)
+  {
+   lat->record(total);
+  }
+  if(m)
+  {
+   m->stage(Stage::QUEUE).recordOwned(startNs > ingressNs ? startNs - ingressNs : 0);
+   m->stage(Stage::BOOK).recordOwned(endNs - startNs);
+   m->stage(Stage::END_TO_END).recordOwned(total);
+  }
+ }
+
+ /**
+  * @brief Returns the calling worker's book for `id`, creating it through the registry and caching
+  * it in localBooks() on first use.
+  * @remarks Must be invoked by the worker that owns the symbol.
+  */
+ static OrderBook* localBook(SymbolId id);
+
+ /**
+  * @brief Creates every assigned book on its owning worker and fills that worker's local table.
+  * Posted as the first task of each worker, so it runs before any order for the worker's symbols.
+  */
+ void assignBooks();
+
+ /**
+  * @brief Loads a worker's snapshot image into its books.
+  * @remarks Must be invoked by worker `wid`.
+  * @return Resting orders loaded.
+  */
+ uint64_t loadImage(const SnapshotStore::Image& image, const Worker::Id& wid) const;
+
 public:
 
  /**
   * @brief Constructor.
   * Initializes the threads.
+  * @param maxBatch Max tasks each worker drains per lock acquisition (1 disables batching).
   */
  OrderBookScheduler(std::string  workerPrefix, const size_t cnt,
-                    SymbolToWorkerMap symbolToWorkerMap):
+                    SymbolToWorkerMap symbolToWorkerMap,
+                    const size_t maxBatch = Worker::DEFAULT_MAX_BATCH):
  mSymbolToWorkerMap(std::move(symbolToWorkerMap)), mPrefix(std::move(workerPrefix)),
  mWorkersCnt(cnt)
  {
-  createWorkers(mPrefix,mWorkersCnt);
+  // Intern in name order so a given symbol set always gets the same ids, which binary clients
+  // and recorded files rely on.
+  std::vector<const SymbolToWorkerMap::value_type*> sorted;
+  for(const auto& entry : mSymbolToWorkerMap)
+  {
+   sorted.push_back(&entry);
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const auto* a, const auto* b) { return a->first < b->first; });
+  for(const auto* entry : sorted)
+  {
+   const auto& [symbol, wid] = *entry;
+   const SymbolId id = SymbolTable::instance().intern(symbol);
+   if(id >= mWorkerBySymbolId.size())
+   {
+    mWorkerBySymbolId.resize(id + 1);
+   }
+   mWorkerBySymbolId[id] = wid;
+  }
+  createWorkers(mPrefix,mWorkersCnt,maxBatch);
+
+  const auto ids = workerIds();
+  mWorkerIndexBySymbolId.resize(mWorkerBySymbolId.size(), ids.size());
+  for(SymbolId id = 0; id < mWorkerBySymbolId.size(); id++)
+  {
+   const auto it = std::find(ids.begin(), ids.end(), mWorkerBySymbolId[id]);
+   mWorkerIndexBySymbolId[id] = static_cast<size_t>(it - ids.begin());
+  }
+ }
+
+ /**
+  * @brief Starts the workers and assigns each of them its order books.
+  */
+ void start() override;
+
+ /**
+  * @brief Sets where every book sends its execution reports.
+  * @remarks Must be called before start(); books pick the sink up when they are assigned.
+  */
+ void setReportSink(IReportSink* sink)
+ {
+  mReportSink = sink;
  }
 
- void processOrder(OrderPtr order);
+ /**
+  * @brief Makes the books publish their reports into `stream`, one ring per worker (in worker id
+  * order), instead of calling the report sink on the book workers. nullptr restores the sink.
+  * @remarks Must be called before start(). The stream needs a producer per worker and must outlive
+  * the workers.
+  * @throws std::invalid_argument if the stream has fewer producers than there are workers.
+  */
+ void setReportStream(ReportStream* stream)
+ {
+  if(stream && stream->producers() < mWorkersCnt)
+  {
+   throw std::invalid_argument("OrderBookScheduler: report stream needs one producer per worker");
+  }
+  mReportStream = stream;
+ }
+
+ /**
+  * @brief Makes the books publish their price level updates into `publisher`, one ring per worker
+  * (in worker id order). nullptr (the default) publishes nothing.
+  * @remarks Must be called before start(). The publisher must outlive the workers.
+  * @throws std::invalid_argument if the publisher has fewer producers than there are workers.
+  */
+ void setDepthPublisher(ConflatingPublisher* publisher)
+ {
+  if(publisher && publisher->producers() < mWorkersCnt)
+  {
+   throw std::invalid_argument("OrderBookScheduler: depth publisher needs one producer per worker");
+  }
+  mDepthPublisher = publisher;
+ }
+
+ /**
+  * @brief Makes the books publish their resting order events into `writer`, one ring per worker
+  * (in worker id order). nullptr (the default) publishes nothing.
+  * @remarks Must be called before start(). The writer must outlive the workers.
+  * @throws std::invalid_argument if the writer has fewer producers than there are workers.
+  */
+ void setOrderFeed(OrderFeedWriter* writer)
+ {
+  if(writer && writer->producers() < mWorkersCnt)
+  {
+   throw std::invalid_argument("OrderBookScheduler: order feed needs one producer per worker");
+  }
+  mOrderFeed = writer;
+ }
+
+ /**
+  * @brief Makes the books build bars and publish them into `publisher`, one ring per worker (in
+  * worker id order). nullptr (the default) builds none. The bars are closed by closeBars().
+  * @remarks Must be called before start(). The publisher must outlive the workers.
+  * @throws std::invalid_argument if the publisher has fewer producers than there are workers.
+  */
+ void setBarPublisher(BarPublisher* publisher)
+ {
+  if(publisher && publisher->producers() < mWorkersCnt)
+  {
+   throw std::invalid_argument("OrderBookScheduler: bar publisher needs one producer per worker");
+  }
+  mBarPublisher = publisher;
+ }
+
+ /**
+  * @brief Gives every worker its own WorkerMetrics in `registry`, labelled with the worker id; the
+  * books count into their worker's and the worker times every stamped message (see Stage).
+  * @remarks Must be called before start(). The registry must outlive the workers.
+  */
+ void setMetrics(MetricsRegistry& registry)
+ {
+  for(const auto& wid : workerIds())
+  {
+   mMetrics[wid] = &registry.addWorker(wid);
+  }
+ }
+
+ /**
+  * @brief Closes the current bar of every book as [startNs, endNs).
+  * @details One task per worker, queued behind the orders already submitted: each bar holds the
+  * fills of exactly the orders its worker processed before the close.
+  */
+ void closeBars(uint64_t startNs, uint64_t endNs);
+
+ /**
+  * @brief Encodes every book of the worker at `index` (in workerIds() order) into a snapshot image
+  * and hands it to `done`.
+  * @details Runs as a task on that worker, behind the ones already queued: the image holds exactly
+  * the messages routed before the call, and matching pauses only for the encoding, a linear copy of
+  * the resting orders. Writing the image out is up to `done`, which should hand it to another thread.
+  */
+ void snapshot(size_t index, SnapshotFn done);
+
+ /**
+  * @brief Loads one snapshot image per worker (in workerIds() order; an empty image loads nothing)
+  * into the books, on every worker at once, and waits for all of them.
+  * @remarks Call after start() and before any order is routed; the books must be empty.
+  * @return Resting orders loaded.
+  * @throws std::runtime_error if an image is damaged or holds a book its worker does not own.
+  */
+ uint64_t loadSnapshots(const std::vector<SnapshotStore::Image>& images);
+
+ /**
+  * @brief Highest session (local part) any resting order of any book is tagged with, asked of every
+  * worker at once. After recovery, new sessions must be numbered above it, see Gateway::start().
+  * @remarks Call after start(), while no order is routed.
+  */
+ SessionId highestSession();
+
+ /**
+  * @brief Sets the histogram that receives ingress-to-book latencies (nullptr to stop measuring).
+  * @remarks The histogram must outlive every task submitted while it is set; call drain() before
+  * destroying it.
+  */
+ void setLatencyHistogram(LatencyHistogram* h)
+ {
+  mLatency.store(h, std::memory_order_release);
+ }
+
+ /** @brief True if `id` is assigned to a book worker, i.e. orders for it can be routed. */
+ bool ownsSymbol(const SymbolId id) const
+ {
+  return id < mWorkerBySymbolId.size() && !mWorkerBySymbolId[id].empty();
+ }
+
+ /**
+  * @brief Position of the worker owning `id` in workerIds(), i.e. the ring or journal shard index
+  * it uses. Only meaningful if ownsSymbol(id).
+  */
+ size_t workerIndex(const SymbolId id) const
+ {
+  return mWorkerIndexBySymbolId[id];
+ }
+
+ /**
+  * @brief Routes an order to the worker owning its symbol.
+  * @param symbolId Symbol id if already known (binary input), otherwise resolved from the order.
+  * @param ingressNs Ingress timestamp (LatencyHistogram::nowNs()), 0 if not measured.
+  */
+ void processOrder(OrderPtr order, SymbolId symbolId = INVALID_SYMBOL_ID, uint64_t ingressNs = 0);
+
+ /**
+  * @brief Routes a cancel of a resting order to the worker owning the symbol.
+  * @param session Requesting session, receives the reject if the order is not resting.
+  */
+ void processCancel(SymbolId symbolId, OrderId orderId, SessionId session = NO_SESSION, uint64_t ingressNs = 0);
+
+ /** @brief Routes an amend (new open quantity / limit price) to the worker owning the symbol. */
+ void processAmend(SymbolId symbolId, OrderId orderId, Quantity newOpenQty, Price newPrice,
+                   SessionId session = NO_SESSION, uint64_t ingressNs = 0);
+
+ /** @brief Routes a cancel/replace (new total quantity / limit price) to the worker owning the symbol. */
+ void processReplace(SymbolId symbolId, OrderId orderId, Quantity newTotalQty, Price newPrice,
+                     SessionId session = NO_SESSION, uint64_t ingressNs = 0);
+
+ /**
+  * @brief Routes a mass cancel.
+  * @param symbolId Symbol to clear, or INVALID_SYMBOL_ID to clear every assigned book.
+  * @param side Side to clear, or std::nullopt for both.
+  * @param session Only that session's orders are cancelled; NO_SESSION cancels everyone's.
+  */
+ void processMassCancel(SymbolId symbolId, std::optional<Side> side, SessionId session = NO_SESSION);
 };
 
 
@@ -1,59 +1,252 @@
 
 
 #include "OrderInjectorScheduler.h"
+#include "../Codec/TextCodec.h"
+#include "../Codec/BinaryCodec.h"
+#include "../Codec/FixCodec.h"
+#include "../Ingress/Framing.h"
+#include <algorithm>
 
 
-Worker::Id OrderInjectorScheduler::getWorkerIdForOrder() const
+SymbolId OrderInjectorScheduler::routingSymbol(const std::string_view raw)
 {
-    const size_t id = mNextWorkerId++ % mWorkerCount;
-    return mWorkerPrefix + "_" + std::to_string(id);
+    if (BinaryCodec::isBinary(raw.data(), raw.size()))
+    {
+        return raw.size() >= BinaryCodec::HEADER_SIZE
+            ? BinaryCodec::load<uint32_t>(reinterpret_cast<const uint8_t*>(raw.data()) + 4)
+            : INVALID_SYMBOL_ID;
+    }
+
+    // FIX: "<SOH>55=", text: "symbol=" at the start or after ';'. The value ends at the next delimiter.
+    const bool fix = FixCodec::isFix(raw);
+    const std::string_view tag = fix ? std::string_view("\x01" "55=") : std::string_view("symbol=");
+    const char delimiter = fix ? FixCodec::SOH : ';';
+    size_t at = raw.find(tag);
+    while (!fix && at != std::string_view::npos && at > 0 && raw[at - 1] != ';')
+    {
+        at = raw.find(tag, at + 1);
+    }
+    if (at == std::string_view::npos)
+    {
+        return INVALID_SYMBOL_ID;
+    }
+    const size_t from = at + tag.size();
+    const size_t to = std::min(raw.find(delimiter, from), raw.size());
+    return SymbolTable::instance().find(raw.substr(from, to - from));
+}
+
+size_t OrderInjectorScheduler::workerIndexFor(const std::string_view message) const
+{
+    const SymbolId symbolId = routingSymbol(message);
+    if (symbolId == INVALID_SYMBOL_ID)
+    {
+        return 0;
+    }
+    return symbolId < mWorkerBySymbolId.size() ? mWorkerBySymbolId[symbolId] : symbolId % mWorkerCount;
+}
+
+
+OrderResult OrderInjectorScheduler::makeOrder(const OrderMessage& m)
+{
+    Symbol symbol{m.symbol};
+    switch (m.type)
+    {
+        case Type::LIMIT:
+            return Order::TryMakeLimit(m.id, m.side, m.qty, std::move(symbol), m.price, m.tif);
+        case Type::STOP:
+            return Order::TryMakeStop(m.id, m.side, m.qty, std::move(symbol), m.stopPrice, m.tif);
+        case Type::STOP_LIMIT:
+            return Order::TryMakeStopLimit(m.id, m.side, m.qty, std::move(symbol), m.price, m.stopPrice, m.tif);
+        case Type::MARKET:
+        default:
+            return Order::TryMakeMarket(m.id, m.side, m.qty, std::move(symbol), m.tif);
+    }
+}
+
+DecodeError OrderInjectorScheduler::decode(const std::string_view raw, InboundMessage& out)
+{
+    if (BinaryCodec::isBinary(raw.data(), raw.size()))
+    {
+        size_t consumed = 0;
+        const auto err = BinaryCodec::decode(reinterpret_cast<const uint8_t*>(raw.data()), raw.size(), out, consumed);
+        if (err == DecodeError::NONE && consumed != raw.size())
+        {
+            return DecodeError::BAD_LENGTH;
+        }
+        return err;
+    }
+    if (FixCodec::isFix(raw))
+    {
+        return FixCodec::decode(raw, out);
+    }
+
+    // Text fallback: new orders only, symbol resolved by name.
+    out = InboundMessage{};
+    out.kind = MessageKind::NEW_ORDER;
+    return TextCodec::decode(raw, out.order);
 }
 
+void OrderInjectorScheduler::dispatch(const InboundMessage& m, const bool journal)
+{
+    SymbolId symbolId = m.symbolId;
+    if (symbolId == INVALID_SYMBOL_ID && m.kind == MessageKind::NEW_ORDER)
+    {
+        symbolId = SymbolTable::instance().find(m.order.symbol);
+    }
+    if (m.kind != MessageKind::MASS_CANCEL && !mOrderBookScheduler->ownsSymbol(symbolId))
+    {
+        reject(m, RejectReason::UNKNOWN_SYMBOL, toString(RejectReason::UNKNOWN_SYMBOL));
+        return;
+    }
+
+    OrderPtr order;
+    if (m.kind == MessageKind::NEW_ORDER)
+    {
+        OrderResult result = makeOrder(m.order);
+        if (!result)
+        {
+            reject(m, result.error(), toString(result.error()));
+            return;
+        }
+        order = result.take();
+        order->setSession(m.session);
+        order->setAccount(m.order.account);
+    }
+
+    InboundMessage accepted = m;
+    accepted.symbolId = symbolId;
+    if (!mJournal || !journal)
+    {
+        apply(accepted, std::move(order));
+        return;
+    }
+
+    // Journaled in the shard of the worker that will apply it.
+    if (m.kind == MessageKind::MASS_CANCEL && symbolId == INVALID_SYMBOL_ID)
+    {
+        // A mass cancel of every book spans every shard: one record per book, each in its own shard.
+        for (SymbolId id = 0; id < SymbolTable::instance().size(); id++)
+        {
+            if (mOrderBookScheduler->ownsSymbol(id))
+            {
+                accepted.symbolId = id;
+                mJournal->append(mOrderBookScheduler->workerIndex(id), accepted, nullptr);
+            }
+        }
+    }
+    else if (mOrderBookScheduler->ownsSymbol(symbolId))
+    {
+        mJournal->append(mOrderBookScheduler->workerIndex(symbolId), accepted, std::move(order));
+    }
+}
+
+void OrderInjectorScheduler::apply(const InboundMessage& m, OrderPtr order)
+{
+    switch (m.kind)
+    {
+        case MessageKind::NEW_ORDER:
+            // Delegate to order book workers
+            mOrderBookScheduler->processOrder(std::move(order), m.symbolId, m.ingressNs);
+            break;
+        case MessageKind::CANCEL:
+            mOrderBookScheduler->processCancel(m.symbolId, m.order.id, m.session, m.ingressNs);
+            break;
+        case MessageKind::AMEND:
+            mOrderBookScheduler->processAmend(m.symbolId, m.order.id, m.order.qty, m.order.price, m.session,
+                                              m.ingressNs);
+            break;
+        case MessageKind::REPLACE:
+            mOrderBookScheduler->processReplace(m.symbolId, m.order.id, m.order.qty, m.order.price, m.session,
+                                                m.ingressNs);
+            break;
+        case MessageKind::MASS_CANCEL:
+            mOrderBookScheduler->processMassCancel(m.symbolId,
+                m.sideFilter == SideFilter::BOTH ? std::nullopt
+                    : std::optional<Side>(m.sideFilter == SideFilter::BUY_ONLY ? Side::BUY : Side::SELL),
+                m.session);
+            break;
+    }
+}
+
+void OrderInjectorScheduler::replayJournaled(const InboundMessage& m)
+{
+    dispatch(m, false);
+}
+
+void OrderInjectorScheduler::reject(const InboundMessage& m, const RejectReason reason, const char* detail) const
+{
+    if (m.session == NO_SESSION || !mReportSink)
+    {
+        std::cerr << "[OrderInjector]: dropped message (" << detail << ")" << std::endl;
+        return;
+    }
+    ExecReport r;
+    r.type = ExecType::REJECTED;
+    r.reason = reason;
+    r.session = m.session;
+    r.symbolId = m.symbolId;
+    r.orderId = m.order.id;
+    r.side = m.order.side;
+    mReportSink->onReport(r);
+}
 
 void OrderInjectorScheduler::processIncomingOrder(const std::string& orderMessage)
 {
-    const Worker::Id wid = getWorkerIdForOrder(); // Worker that will handle this order.
+    const Worker::Id wid = workerIdAt(workerIndexFor(orderMessage)); // Worker that will handle this order.
 
     // Submit the task to the injector worker
     submitTo(wid,
         [this, msg = orderMessage](const CancelToken& cTok) mutable
         {
-            // Paring order message
-            std::unordered_map<std::string, std::string> fields;
-            std::stringstream ss(msg);
-            std::string kv;
-            while (std::getline(ss, kv, ';')) {
-                if (auto pos = kv.find('='); pos != std::string::npos) {
-                    fields[kv.substr(0, pos)] = kv.substr(pos + 1);
-                }
-            }
+            // Decoding, constructing the order object and delegating to order book workers
+            handleMessage(msg, NO_SESSION);
+        },
+        "OrderInjector: parse & delegate order");
+}
 
-            // constructing order object
+void OrderInjectorScheduler::processIncomingView(const std::string_view message, const uint64_t ingressNs,
+                                                 const size_t index)
+{
+    submitTo(workerIdAt(index == SIZE_MAX ? workerIndexFor(message) : index),
+        [this, message, ingressNs](const CancelToken&)
+        {
+            handleMessage(message, NO_SESSION, ingressNs);
+        },
+        "OrderInjector: parse view");
+}
 
-            OrderPtr order = nullptr;
+void OrderInjectorScheduler::processFrames(std::string frames, const SessionId session, const uint64_t ingressNs)
+{
+    const Worker::Id wid = workerIdAt(session % mWorkerCount);
 
-            if(fields["type"] == "LIMIT")
-            {
-                 order =  Order::MakeLimit(
-                    std::stoi(fields["id"]),
-                    fields["side"] == "BUY" ? Side::BUY : Side::SELL,
-                    Quantity{static_cast<unsigned long long>(std::stoull(fields["qty"]))},
-                    Symbol{fields["symbol"]},
-                    Price{std::stoi(fields["price"])}
-                );
-            }
-            else
+    auto batch = std::make_shared<std::string>(std::move(frames));
+    submitTo(wid,
+        [this, batch, session, ingressNs](const CancelToken&)
+        {
+            const char* p = batch->data();
+            const char* end = p + batch->size();
+            std::string_view payload;
+            while (Framing::next(p, end, payload) == Framing::Status::OK)
             {
-                order = Order::MakeMarket(
-                    std::stoi(fields["id"]),
-                    fields["side"] == "BUY" ? Side::BUY : Side::SELL,
-                    Quantity{static_cast<unsigned long long>(std::stoull(fields["qty"]))},
-                    Symbol{fields["symbol"]}
-                );
+                // One bad order must not drop the rest of the batch.
+                handleMessage(payload, session, ingressNs);
             }
-
-            // Delegate to order book workers
-            mOrderBookScheduler->processOrder(std::move(order));
         },
-        "OrderInjector: parse & delegate order");
+        "OrderInjector: parse frames");
+}
+
+void OrderInjectorScheduler::handleMessage(const std::string_view raw, const SessionId session,
+                                           const uint64_t ingressNs)
+{
+    InboundMessage m;
+    const DecodeError err = decode(raw, m);
+    m.session = session;
+    m.ingressNs = ingressNs;
+    if (err != DecodeError::NONE)
+    {
+        reject(m, err == DecodeError::UNKNOWN_SYMBOL ? RejectReason::UNKNOWN_SYMBOL : RejectReason::DECODE_ERROR,
+               toString(err));
+        return;
+    }
+    dispatch(m);
 }
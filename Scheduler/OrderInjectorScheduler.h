@@ -8,6 +8,8 @@
 #define ORDERINJECTORSCHEDULER_H
 
 #include "OrderBookScheduler.h"
+#include "../Codec/OrderMessage.h"
+#include "../Journal/Journal.h"
 
 /**
  * @class OrderInjectorScheduler
@@ -21,34 +23,163 @@ class OrderInjectorScheduler  final : public Scheduler {
  std::string mWorkerPrefix;
  size_t mWorkerCount;
  std::shared_ptr<OrderBookScheduler> mOrderBookScheduler;
+ IReportSink* mReportSink{nullptr}; ///< Receives rejects of messages that never reach a book
+ Journal* mJournal{nullptr}; ///< Accepted messages go through it to the books, null = straight to the books
+ std::vector<size_t> mWorkerBySymbolId; ///< Injector of each symbol's sessionless messages, see setSymbolRouting()
 
- // For round-robin assignment to injector workers
- mutable std::atomic<size_t> mNextWorkerId{0};
+ /**
+  * @brief Symbol a raw message is about, read without decoding it: the binary header's symbol id,
+  * FIX tag 55 or the text `symbol=` tag, the last two looked up in the SymbolTable.
+  * @return INVALID_SYMBOL_ID if the message names none (e.g. a mass cancel of every book) or an
+  * unknown one.
+  */
+ static SymbolId routingSymbol(std::string_view raw);
+
+ /**
+  * @brief Builds an Order from a decoded message using the non-throwing factory matching its type.
+  * @return The order, or the reject code if it fails validation.
+  */
+ static OrderResult makeOrder(const OrderMessage& m);
+
+ /**
+  * @brief Decodes a raw message, binary, FIX or text, into `out`.
+  * @return DecodeError::NONE on success.
+  */
+ static DecodeError decode(std::string_view raw, InboundMessage& out);
+
+ /**
+  * @brief Hands a decoded message to the order book stage, or rejects it if it names a symbol no
+  * book trades or the order fails validation. Runs on an injector worker, never throws for bad input.
+  * @param journal Journal accepted messages first if a journal is set; false for messages that
+  * come out of the journal.
+  */
+ void dispatch(const InboundMessage& m, bool journal = true);
 
  /**
-  * @brief Get the worker id responsible for handling the order.
-  * It will be round-robin implementation.
-  * @return Worker ID.
+  * @brief Sends a REJECTED report for `m` to its session. Messages without a session (replay,
+  * simulation) or without a sink have nobody to tell, so they are logged instead.
+  * @param detail Log text, e.g. the decode error.
   */
- Worker::Id getWorkerIdForOrder() const;
+ void reject(const InboundMessage& m, RejectReason reason, const char* detail) const;
 
 public:
  /** @brief Constructor. Initializes workers */
  OrderInjectorScheduler(std::string workerPrefix, const size_t count,
-                       std::shared_ptr<OrderBookScheduler> obs)
+                       std::shared_ptr<OrderBookScheduler> obs,
+                       const size_t maxBatch = Worker::DEFAULT_MAX_BATCH)
      : mWorkerPrefix(std::move(workerPrefix)),
        mWorkerCount(count),
        mOrderBookScheduler(std::move(obs))
  {
-  createWorkers(mWorkerPrefix, mWorkerCount);
+  createWorkers(mWorkerPrefix, mWorkerCount, maxBatch);
+ }
+
+ /**
+  * @brief Sets where rejects produced by the injector (decode errors, unknown symbols, failed
+  * validation) are sent. Book-side reports go through OrderBookScheduler::setReportSink().
+  * @remarks Must be called before start().
+  */
+ void setReportSink(IReportSink* sink)
+ {
+  mReportSink = sink;
+ }
+
+ /**
+  * @brief Pins the sessionless messages of each symbol to an injector worker, e.g. one on the NUMA
+  * node of the symbol's book (see Application::placeWorkers()).
+  * @param workerBySymbolId Injector index per SymbolId; symbols past its end keep symbolId % workerCount().
+  * @remarks Must be called before start().
+  */
+ void setSymbolRouting(std::vector<size_t> workerBySymbolId)
+ {
+  mWorkerBySymbolId = std::move(workerBySymbolId);
  }
 
+ /**
+  * @brief Journals every accepted message before it may reach a book. The journal must be
+  * started with apply() as its apply function.
+  * @remarks Must be called before start(); nullptr (the default) sends messages straight to the books.
+  */
+ void setJournal(Journal* journal)
+ {
+  mJournal = journal;
+ }
+
+ /**
+  * @brief Routes an accepted message to its book: the last step of dispatch(), run by the journal
+  * once the message is journaled.
+  * @param m Message with its symbol id resolved.
+  * @param order The validated order of a NEW_ORDER, null otherwise.
+  */
+ void apply(const InboundMessage& m, OrderPtr order);
+
+ /**
+  * @brief Validates and applies a message read back from the journal at startup, without
+  * journaling it again (see Journal::recover()).
+  */
+ void replayJournaled(const InboundMessage& m);
+
  /**
   * @brief Process a raw incoming message (string from IPC). Converts it to an Order object
   * and delegates to OrderBookScheduler.
+  *
+  * Accepts the fixed-width binary format (BinaryCodec, detected by its magic byte), FIX 4.4
+  * NewOrderSingle / Cancel / CancelReplace (FixCodec, detected by `8=FIX`) and the legacy
+  * `key=value` text format as a fallback.
   * @param orderMessage Raw order data as string
   */
  void processIncomingOrder(const std::string& orderMessage);
+
+ /**
+  * @brief Zero-copy variant of processIncomingOrder() for sources that own stable buffers (replay
+  * files, shared memory).
+  *
+  * Only the view is queued, on the worker of the message's symbol (see workerIndexFor()); decoding
+  * reads the caller's bytes on the injector worker.
+  * @param message Raw message, any supported wire format.
+  * @param ingressNs Ingress timestamp (LatencyHistogram::nowNs()) carried to the book stage for
+  * latency measurement, 0 if not measured.
+  * @param index Injector worker, workerIndexFor(message) if the caller already has it.
+  * @warning The bytes behind `message` must stay valid until the task has run, e.g. until drain().
+  */
+ void processIncomingView(std::string_view message, uint64_t ingressNs = 0, size_t index = SIZE_MAX);
+
+ /**
+  * @brief Queues a batch of length-prefixed frames (see Framing) read from one client session.
+  *
+  * The whole batch is one task, so a socket read costs one allocation however many messages it
+  * carries. All batches of a session go to the same injector worker, which keeps the session's
+  * messages in order.
+  * @param frames Complete frames only.
+  * @param session Session the reports of these messages go back to.
+  * @param ingressNs Time the batch was read, 0 if not measured.
+  */
+ void processFrames(std::string frames, SessionId session, uint64_t ingressNs = 0);
+
+ /**
+  * @brief Decodes and dispatches one message synchronously, for sources that poll on an injector
+  * worker themselves (see ShmIngress). Decode errors and rejected orders are reported back to
+  * `session` (see reject()).
+  * @warning Must run on one of this scheduler's workers.
+  */
+ void handleMessage(std::string_view raw, SessionId session, uint64_t ingressNs = 0);
+
+ /**
+  * @brief Index of the injector worker that handles `message` when it has no session: every message
+  * of one symbol goes to the same worker, so they reach the book in the order they were submitted.
+  * That worker is the symbol's entry in setSymbolRouting(), or symbolId % workerCount(). Messages
+  * without a known symbol all go to worker 0.
+  */
+ size_t workerIndexFor(std::string_view message) const;
+
+ /** @brief Tasks waiting on injector worker `index`; lets a source throttle itself (see ReplaySource). */
+ size_t queueDepth(const size_t index) { return getWorker(workerIdAt(index))->queueDepth(); }
+
+ /** @brief Number of injector workers. */
+ size_t workerCount() const { return mWorkerCount; }
+
+ /** @brief Id of the injector worker with index `index` (0 <= index < workerCount()). */
+ Worker::Id workerIdAt(const size_t index) const { return mWorkerPrefix + "_" + std::to_string(index); }
 };
 
 
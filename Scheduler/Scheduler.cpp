@@ -13,7 +13,7 @@ Scheduler::~Scheduler()
 }
 
 
-void Scheduler::createWorker(const std::string& id)
+void Scheduler::createWorker(const std::string& id, const size_t maxBatch)
 {
     std::unique_lock wlk(mLock);
 
@@ -22,10 +22,10 @@ void Scheduler::createWorker(const std::string& id)
     {
         throw std::runtime_error("Worker: "+id+" already exists");
     }
-    mWorkers.emplace(id, std::make_unique<Worker>(id));
+    mWorkers.emplace(id, std::make_unique<Worker>(id, maxBatch));
 }
 
-void Scheduler::createWorkers(const std::string& prefix, const size_t cnt)
+void Scheduler::createWorkers(const std::string& prefix, const size_t cnt, const size_t maxBatch)
 {
     {
         std::shared_lock<std::shared_mutex> rlk(mLock);
@@ -36,12 +36,16 @@ void Scheduler::createWorkers(const std::string& prefix, const size_t cnt)
     }
     for(size_t i = 0 ; i < cnt ; i++)
     {
-        createWorker(prefix+"_"+std::to_string(i));
+        createWorker(prefix+"_"+std::to_string(i), maxBatch);
     }
 }
 
 void Scheduler::start()
 {
+    if(mExecution == Execution::INLINE)
+    {
+        return; // tasks run on the submitting thread
+    }
     std::unique_lock wlk(mLock);
     for (auto& [_, worker] : mWorkers)
     {
@@ -71,14 +75,58 @@ void Scheduler::shutdown()
     mWorkers.clear();
 }
 
+void Scheduler::drain()
+{
+    if(mExecution == Execution::INLINE)
+    {
+        return; // every task submitted has already run
+    }
+    std::vector<std::future<void>> barriers;
+    for(const auto& id : workerIds())
+    {
+        auto done = std::make_shared<std::promise<void>>();
+        barriers.push_back(done->get_future());
+        submitTo(id, [done](const CancelToken&) { done->set_value(); }, "Scheduler: drain barrier");
+    }
+    for(auto& b : barriers)
+    {
+        b.wait();
+    }
+}
+
 uint64_t Scheduler::submitTo(const std::string& wId, const TaskFn& func, const std::string& desc)
 {
     const auto t = makeTask(func,desc);
-    auto* w = getWorker(wId);
-    w->postTask(t);
+    post(getWorker(wId), t);
     return t.id;
 }
 
+void Scheduler::post(Worker* w, const Task& t)
+{
+    if(mExecution == Execution::THREADED)
+    {
+        w->postTask(t);
+        return;
+    }
+
+    // Only the outermost submit runs tasks: one submitted from a running task waits its turn,
+    // so each worker still sees its tasks in FIFO order.
+    if(mInlineRunning)
+    {
+        mInlineQueue.emplace(w, t);
+        return;
+    }
+    mInlineRunning = true;
+    w->execute(t);
+    while(!mInlineQueue.empty())
+    {
+        auto [worker, task] = std::move(mInlineQueue.front());
+        mInlineQueue.pop();
+        worker->execute(task);
+    }
+    mInlineRunning = false;
+}
+
 Task Scheduler::makeTask(const TaskFn& fn, const std::string& desc)
 {
     Task t;
@@ -133,7 +181,7 @@ auto Scheduler::submitToWithFuture(const std::string& wid, F&& f, Args&&... args
         }
     };
     auto t = makeTask(std::move(wrapper),"future_task");
-    getWorker(wid)->postTask(t);
+    post(getWorker(wid), t);
     return fut;
 }
 
@@ -149,6 +197,18 @@ std::vector<std::string> Scheduler::workerIds() const
     return ids;
 }
 
+std::vector<std::pair<std::string, size_t>> Scheduler::queueDepths() const
+{
+    std::vector<std::pair<std::string, size_t>> depths;
+    std::shared_lock<std::shared_mutex> rlk(mLock);
+    depths.reserve(mWorkers.size());
+    for(auto const& [id, worker] : mWorkers)
+    {
+        depths.emplace_back(id, worker->queueDepth());
+    }
+    return depths;
+}
+
 bool Scheduler::hasWorker(const std::string& id) const
 {
     std::shared_lock<std::shared_mutex> rlk(mLock);
@@ -8,6 +8,7 @@
 #define SCHEDULER_H
 
 #include <map>
+#include <queue>
 #include <shared_mutex>
 #include <future>
 #include <variant>
@@ -35,15 +36,37 @@ namespace Msg
  * Each worker maintains its own task queue and continuously processes task in FIFO order.  Task can
  * be submitted to specific workers using `submitTo()` or with a returnable `std::future` via
  * `submitToWithFuture()`.
+ *
+ * With Execution::INLINE no thread is started and tasks run on the thread that submits them (see
+ * setExecution()), which makes a run single-threaded and deterministic.
  */
 class Scheduler
 {
+public:
+ /** @brief Where the workers' tasks run. */
+ enum class Execution
+ {
+  THREADED, ///< Each worker runs its queue on its own thread
+  INLINE    ///< Tasks run on the submitting thread, in submission order; no thread is started
+ };
+
+private:
  // using WorkerMap = std::map<std::string, std::unique_ptr<Worker>>;
 
  // <====== Data Members ======>
  std::map<std::string, std::unique_ptr<Worker>> mWorkers; ///< Holds all the workers currently active by their id
  mutable  std::shared_mutex mLock; ///< Mutex for WorkerMap
  bool mShutdown{false}; ///> Indicates that all workers are shutdown
+ Execution mExecution{Execution::THREADED};
+ std::queue<std::pair<Worker*, Task>> mInlineQueue; ///< INLINE: tasks submitted while one of ours runs
+ bool mInlineRunning{false}; ///< INLINE: a task of this scheduler is running on the caller's stack
+
+ /**
+  * @brief Hands a task to its worker: queued for the worker's thread, or run right away in INLINE
+  * mode. A task submitted by one of this scheduler's own tasks runs once that task returns, as it
+  * would behind it in the worker's queue.
+  */
+ void post(Worker* w, const Task& t);
 
 public:
  /* @brief Default constructor. Initializes an empty scheduler */
@@ -61,29 +84,54 @@ public:
  /**
   * @brief Start all the workers
   */
- void start();
+ virtual void start();
+
+ /**
+  * @brief Selects where tasks run. INLINE turns the scheduler into a synchronous one for backtests:
+  * submitTo() returns once the task (and every task it submitted to this scheduler) has run, and
+  * drain() has nothing to wait for.
+  * @remarks Must be called before start(), from the thread that will submit every task. Components
+  * that own threads of their own (journal, report stream, feeds, bar clock) are not made inline.
+  */
+ void setExecution(const Execution execution)
+ {
+  mExecution = execution;
+ }
+
+ /** @brief Where tasks run, see setExecution(). */
+ Execution execution() const { return mExecution; }
 
  /**
   * @brief Gracefully stops all workers and joins their threads.
   */
  void shutdown();
 
+ /**
+  * @brief Blocks until every task posted before the call has been executed.
+  *
+  * Posts a barrier task to each worker and waits for all of them. Tasks posted concurrently by
+  * other threads may or may not be covered.
+  */
+ void drain();
+
  /**
    * @brief  Creates and reserves a single worker with a unique identifier.
    * @param id The string identifier for the worker (e.g., "worker_1")
+   * @param maxBatch Max tasks the worker drains per lock acquisition.
    * @throws std::runtime_error If a worker with the same id already exists.
    */
- void createWorker(const std::string& id);
+ void createWorker(const std::string& id, size_t maxBatch = Worker::DEFAULT_MAX_BATCH);
 
  /**
   * @brief Reserves multiple workers using a naming prefix.
   * @param prefix The prefix for worker's names.
   * @param cnt The number of workers to create.
+  * @param maxBatch Max tasks each worker drains per lock acquisition.
   *
   * @example
   * prefix = "workers", count = 3 -> creates 'worker_0', 'worker_1', 'worker_2'
   */
- void createWorkers(const std::string& prefix, size_t cnt);
+ void createWorkers(const std::string& prefix, size_t cnt, size_t maxBatch = Worker::DEFAULT_MAX_BATCH);
 
  /**
   * @brief Submits a fire-and-forget task to a worker
@@ -132,11 +180,26 @@ public:
  auto submitToWithFuture(const std::string& wid, F&& f, Args&&... args)
  ->std::future<std::invoke_result_t<F,Args...>>;
 
+ /**
+  * @brief Pins a worker's thread (and its allocations) to a NUMA node.
+  * @remarks Must be called before start(); has no effect on an already running worker.
+  * @throws std::runtime_error If the worker does not exist.
+  */
+ void bindWorkerToNode(const std::string& id, int node)
+ {
+  getWorker(id)->setNumaNode(node);
+ }
+
  /**
   * @brief Get all active worker's id.
   */
  std::vector<std::string> workerIds() const;
 
+ /**
+  * @brief Tasks waiting in each worker's queue, by worker id. Never takes a worker's queue lock.
+  */
+ std::vector<std::pair<std::string, size_t>> queueDepths() const;
+
  bool hasWorker(const std::string& id) const;
 
 };
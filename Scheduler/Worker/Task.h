@@ -7,6 +7,7 @@
 
 #ifndef TASK_H
 #define TASK_H
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
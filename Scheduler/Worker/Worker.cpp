@@ -4,7 +4,8 @@
 
 #include "Worker.h"
 #include <iostream>
-Worker::Worker(const std::string& id):mId(std::move(id)), mStop(false){}
+Worker::Worker(const std::string& id, const size_t maxBatch):mId(std::move(id)), mStop(false),
+mMaxBatch(maxBatch == 0 ? DEFAULT_MAX_BATCH : maxBatch){}
 
 void Worker::start()
 {
@@ -15,6 +16,10 @@ void Worker::start()
     }
     mThread = std::thread([this]
     {
+        if(mNumaNode != NumaTopology::NO_NODE)
+        {
+            NumaTopology::bindCurrentThread(mNumaNode);
+        }
         run();
     });
 }
@@ -31,6 +36,12 @@ void Worker::shutdown()
 
 void Worker::run()
 {
+    if(mMaxBatch > 1)
+    {
+        runBatched();
+        return;
+    }
+
     while(true)
     {
         Task t;
@@ -56,23 +67,74 @@ void Worker::run()
             // Adding task in queue
             t = std::move(mQueue.front());
             mQueue.pop();
+            mQueued.store(mQueue.size(), std::memory_order_relaxed);
             mRunningTasks.insert(t.id);
         }
-        try
+        execute(t);
+    }
+}
+
+void Worker::runBatched()
+{
+    // Thread-local buffer, only this worker's thread touches it.
+    std::queue<Task> batch;
+
+    while(true)
+    {
         {
-            if(!t.token.isCancelled())
+            std::unique_lock<std::mutex> lock(mQueueMutex);
+
+            mCv.wait(lock, [this]
+            {
+                return mStop || !mQueue.empty();
+            });
+
+            if(mQueue.empty() && mStop)
             {
-                t();
+                return;
+            }
+
+            if(mQueue.size() <= mMaxBatch)
+            {
+                // Whole pending queue fits in one batch, O(1) swap.
+                batch.swap(mQueue);
             }
             else
             {
-                // Skipped due to cancel
+                for(size_t i = 0; i < mMaxBatch; i++)
+                {
+                    batch.push(std::move(mQueue.front()));
+                    mQueue.pop();
+                }
             }
+            mQueued.store(mQueue.size(), std::memory_order_relaxed);
+        }
+
+        // Lock-free section: producers keep appending to mQueue meanwhile.
+        while(!batch.empty())
+        {
+            execute(batch.front());
+            batch.pop();
         }
-        catch(const std::exception& e)
+    }
+}
+
+void Worker::execute(const Task& t)
+{
+    try
+    {
+        if(!t.token.isCancelled())
         {
-            std::cerr<<"[Worker]: "<<mId<<" "<<std::endl;
+            t();
         }
+        else
+        {
+            // Skipped due to cancel
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr<<"[Worker]: "<<mId<<" "<<std::endl;
     }
 }
 
@@ -82,6 +144,7 @@ void Worker::postTask(const Task& t)
     {
         std::lock_guard<std::mutex> lock(mQueueMutex);
         mQueue.push((t));
+        mQueued.store(mQueue.size(), std::memory_order_relaxed);
         mPendingTasks.insert((t.id));
     }
     mCv.notify_one();
@@ -8,11 +8,15 @@
 #define WORKER_H
 
 #include<queue>
+#include <atomic>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "Task.h"
-#include "../Scheduler.h"
+#include "../../Platform/NumaTopology.h"
 
 struct Task;
 
@@ -34,6 +38,7 @@ struct Worker {
  using UnorderedTaskIdSet = std::unordered_set<uint64_t>;
     std::string mId;
     std::queue<Task> mQueue;
+    std::atomic<size_t> mQueued{0}; /// > Size of mQueue, stored under mQueueMutex, readable without it.
     std::mutex mQueueMutex;
     std::mutex mThreadMutex;
     std::condition_variable mCv;
@@ -44,8 +49,19 @@ struct Worker {
 
 
     bool mStop;
-    /** @brief Constructor */
-    explicit  Worker(const std::string& id);
+    size_t mMaxBatch; /// > Max tasks drained per lock acquisition (1 = pop one task at a time).
+    int mNumaNode{NumaTopology::NO_NODE}; /// > NUMA node the thread is bound to once started.
+
+    /** @brief Default batch size. Keeps the one-task-per-lock behaviour. */
+    static constexpr size_t DEFAULT_MAX_BATCH = 1;
+
+    /**
+     * @brief Constructor
+     * @param id Unique identifier of the worker.
+     * @param maxBatch Max number of tasks taken from the queue under a single lock. Values above 1
+     * enable drain-all batch mode (see runBatched()).
+     */
+    explicit  Worker(const std::string& id, size_t maxBatch = DEFAULT_MAX_BATCH);
 
     /**
      * @brief  Responsible for creating and launching work's dedicated thread
@@ -57,6 +73,14 @@ struct Worker {
     void start();
     void shutdown();
 
+    /**
+     * @brief Pins the worker to a NUMA node. Must be called before start().
+     *
+     * The thread binds itself as its first action, so everything it creates while running tasks
+     * (order books, price levels, locator nodes) comes from the node's local memory.
+     */
+    void setNumaNode(int node) { mNumaNode = node; }
+
     /**
      * @brief Worker's main loop.
      *
@@ -70,6 +94,27 @@ struct Worker {
      */
     void run();
 
+    /**
+     * @brief Worker's main loop in drain-all batch mode (used when `mMaxBatch` > 1).
+     *
+     * Takes the queue lock once, moves up to `mMaxBatch` tasks into a thread-local buffer and then
+     * executes the whole batch without holding the lock. When the pending queue fits in the batch it
+     * is swapped out in O(1), otherwise tasks are moved one by one up to the limit.
+     * @details
+     * Under saturation this turns one lock round trip per task into one per batch. The upper bound
+     * caps how long producers wait on the lock while a backlog is moved task by task, and the size
+     * of the buffer.
+     *
+     * Stopping works as in run(): the loop exits once `mStop` is set and the queue is empty, so
+     * every task queued before postStop() still runs (shutdown relies on that, e.g. for the last bar
+     * close). A large backlog therefore delays the exit by the time it takes to run it; the batch
+     * size does not change that.
+     */
+    void runBatched();
+
+    /** @brief Executes a single task, isolating the loop from exceptions thrown by the task. */
+    void execute(const Task& t);
+
  /**
   * @brief  Add new work (task) for the worker thread
   *
@@ -79,6 +124,11 @@ struct Worker {
   */
  void postTask(const Task& t);
 
+ /**
+  * @brief Tasks waiting in the queue, not yet taken by the worker. Any thread, no lock; a snapshot.
+  */
+ size_t queueDepth() const { return mQueued.load(std::memory_order_relaxed); }
+
  /**
   * @brief Signals the worker to exit gracefully.
   *
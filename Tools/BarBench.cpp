@@ -0,0 +1,228 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file BarBench.cpp
+ * @brief What OHLCV bar building costs the book worker, and whether the bars add up.
+ *
+ * - book: limit orders pushed straight into one OrderBook (no scheduler): rounds of resting buys over
+ *   a few price levels and one sell sweeping them. Without a bar sink, then with one. Best of `--rounds`.
+ * - timer: the same flow with a BarPublisher ticking every `--interval-ms`. Its boundary callback
+ *   queues the close for the book loop, like OrderBookScheduler::closeBars() queues it for the book
+ *   worker. A reader thread polls the bars while they are published and checks each of them; the
+ *   bars' volume and trade count must add up to what the book traded.
+ *
+ * Usage: OrderMatchingEngineBarBench [--orders 1000000] [--rounds 3] [--interval-ms 5]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../OrderBook/OrderBook.h"
+#include "../OrderBook/SymbolTable.h"
+#include "../MarketData/BarPublisher.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t orders{1'000'000};
+        size_t rounds{3};
+        size_t intervalMs{5};
+    };
+
+    constexpr Price BASE_PRICE = 10000;
+    constexpr size_t LEVELS = 8;
+    constexpr Quantity RESTING_QTY = 10;
+
+    /** @brief Rounds of LEVELS resting buys, one per level, then one sell sweeping all of them. */
+    std::vector<OrderPtr> makeOrders(const size_t n, const OrderId firstId, const char* symbol)
+    {
+        std::vector<OrderPtr> orders;
+        orders.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const size_t k = i % (LEVELS + 1);
+            const bool buy = k < LEVELS;
+            orders.push_back(Order::TryMakeLimit(firstId + i, buy ? Side::BUY : Side::SELL,
+                                                 buy ? RESTING_QTY : RESTING_QTY * LEVELS, symbol,
+                                                 buy ? BASE_PRICE + static_cast<Price>(k) : BASE_PRICE,
+                                                 TIF::GOOD_TILL_CANCELED).take());
+        }
+        return orders;
+    }
+
+    double runBook(OrderBook& book, std::vector<OrderPtr> orders)
+    {
+        const size_t n = orders.size();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& o : orders)
+        {
+            book.processOrder(std::move(o));
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / static_cast<double>(n);
+    }
+
+    /** @brief Counts bars, so the book comparison measures building them and nothing downstream. */
+    class CountingSink final : public IBarSink {
+    public:
+        void onBar(const Bar&) override { mBars++; }
+        uint64_t bars() const { return mBars; }
+    private:
+        uint64_t mBars{0};
+    };
+
+    void benchBook(const Options& opts)
+    {
+        OrderBook book("BARBENCH");
+        CountingSink sink;
+        double plain = 1e300;
+        double built = 1e300;
+        OrderId nextId = 1;
+        for (size_t r = 0; r < opts.rounds; r++)
+        {
+            book.setBarSink(nullptr);
+            plain = std::min(plain, runBook(book, makeOrders(opts.orders, nextId, "BARBENCH")));
+            nextId += opts.orders;
+            book.setBarSink(&sink);
+            built = std::min(built, runBook(book, makeOrders(opts.orders, nextId, "BARBENCH")));
+            nextId += opts.orders;
+            book.closeBar(0, 1);
+        }
+        book.setBarSink(nullptr);
+        const double fillsPerOrder = static_cast<double>(LEVELS) / static_cast<double>(LEVELS + 1);
+        std::cout << "book, " << opts.orders << " orders, best of " << opts.rounds << ":" << std::endl
+                  << "  no bars: " << plain << " ns/order" << std::endl
+                  << "  bars:    " << built << " ns/order (+" << built - plain << "), " << fillsPerOrder
+                  << " fills/order, ~" << (built - plain) / fillsPerOrder << " ns/fill" << std::endl;
+    }
+
+    struct ReaderCheck
+    {
+        uint64_t bars{0};
+        uint64_t trades{0};
+        Quantity volume{0};
+        uint64_t invalid{0};
+        uint64_t lost{0};
+    };
+
+    bool checkBar(const Bar& b, const uint64_t previousEnd)
+    {
+        const double vwap = b.vwap();
+        return b.trades > 0 && b.low <= b.open && b.open <= b.high && b.low <= b.close && b.close <= b.high
+            && vwap >= static_cast<double>(b.low) && vwap <= static_cast<double>(b.high)
+            && b.startNs < b.endNs && b.startNs >= previousEnd;
+    }
+
+    bool benchTimer(const Options& opts)
+    {
+        OrderBook book("BARTIMER");
+        BarPublisher publisher(1, BarPublisher::DEFAULT_RING_SLOTS, std::chrono::milliseconds(opts.intervalMs));
+        book.setBarSink(&publisher.producer(0));
+
+        // The boundary callback runs on the timer thread; the close itself must run on the book's thread.
+        std::mutex closesMutex;
+        std::vector<std::pair<uint64_t, uint64_t>> closes;
+        std::atomic<bool> closePending{false};
+        const auto applyCloses = [&]
+        {
+            std::lock_guard<std::mutex> lk(closesMutex);
+            for (const auto& [startNs, endNs] : closes)
+            {
+                book.closeBar(startNs, endNs);
+            }
+            closes.clear();
+            closePending.store(false, std::memory_order_relaxed);
+        };
+        publisher.start([&](const uint64_t startNs, const uint64_t endNs)
+        {
+            std::lock_guard<std::mutex> lk(closesMutex);
+            closes.emplace_back(startNs, endNs);
+            closePending.store(true, std::memory_order_release);
+        });
+
+        std::atomic<bool> done{false};
+        ReaderCheck check;
+        std::thread reader([&]
+        {
+            BarPublisher::Reader r = publisher.reader();
+            uint64_t previousEnd = 0;
+            const auto take = [&](const Bar& b)
+            {
+                check.invalid += !checkBar(b, previousEnd);
+                previousEnd = b.endNs;
+                check.bars++;
+                check.trades += b.trades;
+                check.volume += b.volume;
+            };
+            while (!done.load(std::memory_order_acquire))
+            {
+                if (r.poll(take) == 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+            r.poll(take);
+            check.lost = r.lost();
+        });
+
+        auto orders = makeOrders(opts.orders, 1, "BARTIMER");
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& o : orders)
+        {
+            book.processOrder(std::move(o));
+            if (closePending.load(std::memory_order_acquire))
+            {
+                applyCloses();
+            }
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        publisher.stop(); // queues the close of the last, partial interval
+        applyCloses();
+        done.store(true, std::memory_order_release);
+        reader.join();
+
+        const size_t sweeps = opts.orders / (LEVELS + 1);
+        const uint64_t expectedTrades = sweeps * LEVELS;
+        const Quantity expectedVolume = expectedTrades * RESTING_QTY;
+        std::cout << "timer, " << opts.orders << " orders in " << ms << " ms, " << opts.intervalMs
+                  << " ms bars:" << std::endl
+                  << "  " << check.bars << " bars read (" << publisher.published() << " published, " << check.lost
+                  << " lost), " << check.trades << "/" << expectedTrades << " trades, " << check.volume << "/"
+                  << expectedVolume << " volume, " << check.invalid << " invalid" << std::endl;
+        return check.invalid == 0 && (check.lost > 0
+            || (check.trades == expectedTrades && check.volume == expectedVolume));
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--orders") opts.orders = std::stoul(value);
+        else if (arg == "--rounds") opts.rounds = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--interval-ms") opts.intervalMs = std::max<size_t>(1, std::stoul(value));
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    // Whole rounds only, so the book is empty between runs.
+    opts.orders = std::max(opts.orders - opts.orders % (LEVELS + 1), LEVELS + 1);
+
+    SymbolTable::instance().intern("BARBENCH");
+    SymbolTable::instance().intern("BARTIMER");
+    benchBook(opts);
+    return benchTimer(opts) ? 0 : 1;
+}
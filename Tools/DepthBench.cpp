@@ -0,0 +1,176 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file DepthBench.cpp
+ * @brief What the L2 feed costs a book, and how much conflation saves downstream.
+ *
+ * Two measurements:
+ * - book: limit orders pushed straight into one OrderBook (no scheduler), half of them resting over
+ *   a few price levels, half sweeping them. First without a depth sink, then publishing into a
+ *   ConflatingPublisher ring. The difference is the per-order cost of the feed. Best of `--rounds`.
+ * - conflation: the same flow paced at `--rate` orders/s, published with several windows; prints
+ *   level updates produced by the book vs sent downstream, and checks the output sequence of the book
+ *   has no holes.
+ *
+ * Usage: OrderMatchingEngineDepthBench [--orders 2000000] [--rounds 3] [--rate 500000]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../OrderBook/OrderBook.h"
+#include "../OrderBook/SymbolTable.h"
+#include "../MarketData/ConflatingPublisher.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t orders{2'000'000};
+        size_t rounds{3};
+        size_t rate{500'000}; ///< Orders per second in the conflation run
+    };
+
+    constexpr Price BASE_PRICE = 10000;
+    constexpr size_t LEVELS = 8;
+
+    /** @brief Checks the per-book sequence it receives: it must count up by one. */
+    class SequenceCheck final : public IDepthSink {
+    public:
+        void onDepth(const DepthUpdate& u) override
+        {
+            if (u.seq != last + 1)
+            {
+                holes++;
+            }
+            last = u.seq;
+            received++;
+        }
+
+        uint64_t last{0};
+        uint64_t received{0};
+        uint64_t holes{0};
+    };
+
+    /**
+     * @brief Rounds of LEVELS buys resting one per level, then one sell sweeping all of them: every
+     * order changes at least one level, the book is empty after each round.
+     */
+    std::vector<OrderPtr> makeOrders(const size_t n, const OrderId firstId)
+    {
+        std::vector<OrderPtr> orders;
+        orders.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const size_t k = i % (LEVELS + 1);
+            if (k < LEVELS)
+            {
+                orders.push_back(Order::TryMakeLimit(firstId + i, Side::BUY, 10, "DEPTHBENCH",
+                                                     BASE_PRICE + static_cast<Price>(k), TIF::GOOD_TILL_CANCELED).take());
+            }
+            else
+            {
+                orders.push_back(Order::TryMakeLimit(firstId + i, Side::SELL, 10 * LEVELS, "DEPTHBENCH", BASE_PRICE,
+                                                     TIF::GOOD_TILL_CANCELED).take());
+            }
+        }
+        return orders;
+    }
+
+    double runBook(OrderBook& book, std::vector<OrderPtr> orders)
+    {
+        const size_t n = orders.size();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& o : orders)
+        {
+            book.processOrder(std::move(o));
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / static_cast<double>(n);
+    }
+
+    void benchBook(const Options& opts, OrderBook& book, OrderId& nextId)
+    {
+        double plain = 1e300;
+        double published = 1e300;
+        SequenceCheck sink;
+        ConflatingPublisher publisher(1, 1 << 20, std::chrono::microseconds(1000));
+        publisher.start(sink);
+        for (size_t r = 0; r < opts.rounds; r++)
+        {
+            book.setDepthSink(nullptr);
+            plain = std::min(plain, runBook(book, makeOrders(opts.orders, nextId)));
+            nextId += opts.orders;
+            book.setDepthSink(&publisher.producer(0));
+            published = std::min(published, runBook(book, makeOrders(opts.orders, nextId)));
+            nextId += opts.orders;
+        }
+        book.setDepthSink(nullptr);
+        publisher.stop();
+
+        std::cout << "book, " << opts.orders << " orders, best of " << opts.rounds << ":" << std::endl
+                  << "  no depth feed: " << plain << " ns/order" << std::endl
+                  << "  depth feed:    " << published << " ns/order (+" << published - plain << "), "
+                  << publisher.received() << " level updates, " << publisher.dropped() << " dropped" << std::endl;
+    }
+
+    void benchConflation(const Options& opts, OrderBook& book, OrderId& nextId)
+    {
+        const size_t n = std::min<size_t>(opts.orders, opts.rate); // about one second of flow
+        std::cout << "conflation, " << n << " orders at " << opts.rate << " orders/s:" << std::endl;
+        for (const auto window : {0, 100, 1000, 10000})
+        {
+            SequenceCheck sink;
+            ConflatingPublisher publisher(1, 1 << 20, std::chrono::microseconds(window));
+            publisher.start(sink);
+            book.setDepthSink(&publisher.producer(0));
+
+            std::vector<OrderPtr> orders = makeOrders(n, nextId);
+            nextId += n;
+            const auto start = std::chrono::steady_clock::now();
+            const auto gap = std::chrono::nanoseconds(1'000'000'000 / std::max<size_t>(opts.rate, 1));
+            for (size_t i = 0; i < n; i++)
+            {
+                while (std::chrono::steady_clock::now() < start + gap * i) {}
+                book.processOrder(std::move(orders[i]));
+            }
+            book.setDepthSink(nullptr);
+            publisher.stop();
+
+            std::cout << "  window " << window << " us: " << publisher.received() << " updates -> "
+                      << publisher.published() << " published ("
+                      << 100.0 * static_cast<double>(publisher.published())
+                         / static_cast<double>(std::max<uint64_t>(publisher.received(), 1))
+                      << "%), " << sink.holes << " sequence holes, " << publisher.dropped() << " dropped" << std::endl;
+        }
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--orders") opts.orders = std::stoul(value);
+        else if (arg == "--rounds") opts.rounds = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--rate") opts.rate = std::max<size_t>(1, std::stoul(value));
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    SymbolTable::instance().intern("DEPTHBENCH");
+    OrderBook book("DEPTHBENCH");
+    OrderId nextId = 1;
+    benchBook(opts, book, nextId);
+    benchConflation(opts, book, nextId);
+    return 0;
+}
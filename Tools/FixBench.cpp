@@ -0,0 +1,195 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file FixBench.cpp
+ * @brief FIX decode cost: FixCodec::decode() with the delimiter scanner picked for this CPU (AVX2 or
+ * SSE2) against FixCodec::decodeScalar(), the byte-at-a-time baseline, on the same messages.
+ *
+ * Messages come from a capture, one per line, with SOH or '|' as the field delimiter (the usual
+ * form of FIX logs). Without --file a built-in sample of order entry traffic is used: new orders,
+ * cancels and cancel/replaces with the session header fields a typical client sends. Symbols of
+ * tag 55 are interned before timing, so every message decodes completely. Both decoders must agree
+ * on every message, otherwise the bench fails.
+ *
+ * Usage: OrderMatchingEngineFixBench [--file capture.log] [--rounds N]
+ * (default: enough rounds for about two million decodes per decoder)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Codec/FixCodec.h"
+#include "../OrderBook/SymbolTable.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string file;
+        size_t rounds{0}; ///< 0 = about two million decodes
+    };
+
+    /** @brief Bodies (tag 35 to the last field before the trailer), in arrival order. */
+    const char* const SAMPLE[] = {
+        "35=D|49=CLIENT1|56=ENGINE|34=215|52=20261019-10:00:00.000|11=1001|1=7|55=TESLA|54=1|38=100|40=2|44=175.25|59=0|60=20261019-10:00:00.000|",
+        "35=D|49=CLIENT1|56=ENGINE|34=216|52=20261019-10:00:00.004|11=1002|1=7|55=TESLA|54=2|38=300|40=2|44=175.40|59=1|60=20261019-10:00:00.004|",
+        "35=D|49=CLIENT2|56=ENGINE|34=88|52=20261019-10:00:00.011|11=2001|55=AAPL|54=1|38=50|40=1|59=3|60=20261019-10:00:00.011|",
+        "35=G|49=CLIENT1|56=ENGINE|34=217|52=20261019-10:00:00.020|11=1003|41=1001|55=TESLA|54=1|38=80|40=2|44=175.30|60=20261019-10:00:00.020|",
+        "35=D|49=CLIENT3|56=ENGINE|34=1204|52=20261019-10:00:00.023|11=3001|1=12|55=MSFT|54=2|38=1000|40=4|44=402.10|99=402.50|59=0|18=G|60=20261019-10:00:00.023|",
+        "35=F|49=CLIENT1|56=ENGINE|34=218|52=20261019-10:00:00.031|11=1004|41=1002|55=TESLA|54=2|60=20261019-10:00:00.031|",
+        "35=D|49=CLIENT2|56=ENGINE|34=89|52=20261019-10:00:00.042|11=2002|55=AAPL|54=2|38=25|40=2|44=228.75|59=4|60=20261019-10:00:00.042|",
+        "35=F|49=CLIENT3|56=ENGINE|34=1205|52=20261019-10:00:00.050|11=3002|41=3001|55=MSFT|54=2|60=20261019-10:00:00.050|",
+    };
+
+    /** @brief Wraps a body in BeginString, BodyLength and CheckSum. */
+    std::string frame(std::string body)
+    {
+        for (auto& c : body)
+        {
+            c = c == '|' ? FixCodec::SOH : c;
+        }
+        std::string msg = "8=FIX.4.4" + std::string(1, FixCodec::SOH) + "9=" + std::to_string(body.size())
+            + FixCodec::SOH + body;
+        unsigned sum = 0;
+        for (const unsigned char c : msg)
+        {
+            sum += c;
+        }
+        char trailer[8];
+        std::snprintf(trailer, sizeof(trailer), "10=%03u", sum % 256);
+        return msg + trailer + FixCodec::SOH;
+    }
+
+    /** @brief Interns the value of every tag 55 in the message. */
+    void internSymbols(const std::string& msg)
+    {
+        const std::string tag = std::string(1, FixCodec::SOH) + "55=";
+        for (size_t at = msg.find(tag); at != std::string::npos; at = msg.find(tag, at + 1))
+        {
+            const size_t from = at + tag.size();
+            const size_t to = msg.find(FixCodec::SOH, from);
+            SymbolTable::instance().intern(msg.substr(from, to - from));
+        }
+    }
+
+    bool sameResult(const InboundMessage& a, const InboundMessage& b)
+    {
+        return a.kind == b.kind && a.symbolId == b.symbolId && a.order.id == b.order.id && a.order.qty == b.order.qty
+            && a.order.price == b.order.price && a.order.stopPrice == b.order.stopPrice && a.order.side == b.order.side
+            && a.order.type == b.order.type && a.order.tif == b.order.tif && a.order.account == b.order.account;
+    }
+
+    /** @brief Decodes every message `rounds` times; returns ns per message. */
+    template <typename Decode>
+    double run(const std::vector<std::string>& msgs, const size_t rounds, Decode decode, uint64_t& checksum)
+    {
+        InboundMessage out;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; r++)
+        {
+            for (const auto& msg : msgs)
+            {
+                checksum += static_cast<uint64_t>(decode(msg, out)) + out.order.id;
+            }
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / static_cast<double>(msgs.size() * rounds);
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--file") opts.file = value;
+        else if (arg == "--rounds") opts.rounds = std::stoul(value);
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> msgs;
+    if (opts.file.empty())
+    {
+        for (const char* body : SAMPLE)
+        {
+            msgs.push_back(frame(body));
+        }
+    }
+    else
+    {
+        std::ifstream in(opts.file);
+        if (!in)
+        {
+            std::cerr << "Cannot read " << opts.file << std::endl;
+            return 1;
+        }
+        for (std::string line; std::getline(in, line);)
+        {
+            for (auto& c : line)
+            {
+                c = c == '|' ? FixCodec::SOH : c;
+            }
+            if (FixCodec::isFix(line))
+            {
+                msgs.push_back(std::move(line));
+            }
+        }
+    }
+    if (msgs.empty())
+    {
+        std::cerr << "No FIX messages to decode" << std::endl;
+        return 1;
+    }
+
+    if (opts.rounds == 0)
+    {
+        opts.rounds = std::max<size_t>(1, 2'000'000 / msgs.size());
+    }
+
+    size_t bytes = 0;
+    size_t failed = 0;
+    for (const auto& msg : msgs)
+    {
+        internSymbols(msg);
+        bytes += msg.size();
+        InboundMessage simd;
+        InboundMessage scalar;
+        const DecodeError e1 = FixCodec::decode(msg, simd);
+        const DecodeError e2 = FixCodec::decodeScalar(msg, scalar);
+        if (e1 != e2 || (e1 == DecodeError::NONE && !sameResult(simd, scalar)))
+        {
+            std::cerr << "decoders disagree (" << toString(e1) << " / " << toString(e2) << ") on: " << msg << std::endl;
+            return 1;
+        }
+        failed += e1 != DecodeError::NONE;
+    }
+
+    uint64_t checksum = 0;
+    const auto decode = [](const std::string& m, InboundMessage& out) { return FixCodec::decode(m, out); };
+    const auto scalar = [](const std::string& m, InboundMessage& out) { return FixCodec::decodeScalar(m, out); };
+    run(msgs, opts.rounds / 10 + 1, decode, checksum); // warm-up
+    const double simdNs = run(msgs, opts.rounds, decode, checksum);
+    const double scalarNs = run(msgs, opts.rounds, scalar, checksum);
+
+    const double avg = static_cast<double>(bytes) / static_cast<double>(msgs.size());
+    std::cout << msgs.size() << " messages (" << avg << " bytes avg, " << failed << " rejected) x " << opts.rounds
+              << " rounds" << std::endl
+              << "  decode (" << FixCodec::scannerName() << ")  " << simdNs << " ns/msg, " << 1e3 / simdNs
+              << " M msg/s, " << avg / simdNs << " GB/s" << std::endl
+              << "  decodeScalar     " << scalarNs << " ns/msg, " << 1e3 / scalarNs << " M msg/s, "
+              << avg / scalarNs << " GB/s" << std::endl
+              << "  speedup          " << scalarNs / simdNs << "x" << " (checksum " << checksum << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,178 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file GatewayLoadGen.cpp
+ * @brief Local load generator for the order entry Gateway.
+ *
+ * Opens N client connections, each sending crossing binary limit orders in batches while a reader
+ * thread collects the execution reports. Reports submit-to-ack latency and throughput.
+ *
+ * Usage: OrderMatchingEngineLoadGen [--endpoint unix:/tmp/ome-gateway.sock] [--clients 4]
+ *        [--orders 100000] [--batch 64] [--symbol-id 0]
+ *
+ * Symbol ids are assigned in symbol name order at engine startup (APPLE = 0, TESLA = 1 with the
+ * default mapping).
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Ingress/GatewayClient.h"
+#include "../Metrics/LatencyHistogram.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string endpoint{"unix:/tmp/ome-gateway.sock"};
+        size_t clients{4};
+        size_t orders{100000};
+        size_t batch{64};
+        SymbolId symbolId{0};
+    };
+
+    struct ClientResult
+    {
+        uint64_t acks{0};
+        uint64_t fills{0};
+        uint64_t rejects{0};
+    };
+
+    void runClient(const Options& opts, const size_t clientIdx, LatencyHistogram& ackLatency, ClientResult& result)
+    {
+        GatewayClient client(Endpoint::Parse(opts.endpoint));
+        // Written by the sender before the batch goes out, read by the reader once it is acked.
+        std::vector<std::atomic<uint64_t>> sentAt(opts.orders);
+        const OrderId idBase = (static_cast<OrderId>(clientIdx) + 1) << 40;
+
+        // Reader: stops once every order has been acknowledged (or rejected), or the gateway hung up.
+        std::thread reader([&]
+        {
+            uint64_t answered = 0;
+            while (answered < opts.orders && client.poll([&](const ExecReport& r)
+            {
+                const auto idx = static_cast<size_t>(r.orderId - idBase - 1);
+                switch (r.type)
+                {
+                    case ExecType::NEW:
+                        result.acks++;
+                        answered++;
+                        if (idx < sentAt.size())
+                        {
+                            ackLatency.recordSince(sentAt[idx].load(std::memory_order_relaxed));
+                        }
+                        break;
+                    case ExecType::REJECTED:
+                        result.rejects++;
+                        answered++;
+                        break;
+                    case ExecType::TRADE:
+                        result.fills++;
+                        break;
+                    default:
+                        break;
+                }
+            })) {}
+        });
+
+        try
+        {
+            std::string frames;
+            for (size_t i = 0; i < opts.orders; i++)
+            {
+                InboundMessage m;
+                m.kind = MessageKind::NEW_ORDER;
+                m.symbolId = opts.symbolId;
+                m.order.id = idBase + i + 1;
+                m.order.side = (i & 1) ? Side::SELL : Side::BUY;
+                m.order.type = Type::LIMIT;
+                m.order.tif = TIF::GOOD_TILL_CANCELED;
+                m.order.qty = 10;
+                m.order.price = (i & 1) ? 9998 : 10002; // every sell crosses the buy before it
+                GatewayClient::appendMessage(frames, m);
+
+                if ((i + 1) % opts.batch == 0 || i + 1 == opts.orders)
+                {
+                    const uint64_t now = LatencyHistogram::nowNs();
+                    for (size_t k = i - (i % opts.batch); k <= i; k++)
+                    {
+                        sentAt[k].store(now, std::memory_order_relaxed);
+                    }
+                    client.send(frames);
+                    frames.clear();
+                }
+            }
+        }
+        catch (...)
+        {
+            client.disconnect(); // unblocks the reader
+            reader.join();
+            throw;
+        }
+        reader.join();
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--endpoint") opts.endpoint = value;
+        else if (arg == "--clients") opts.clients = std::stoul(value);
+        else if (arg == "--orders") opts.orders = std::stoul(value);
+        else if (arg == "--batch") opts.batch = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--symbol-id") opts.symbolId = static_cast<SymbolId>(std::stoul(value));
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    LatencyHistogram ackLatency;
+    std::vector<ClientResult> results(opts.clients);
+    std::vector<std::thread> clients;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < opts.clients; c++)
+    {
+        clients.emplace_back([&, c]
+        {
+            try
+            {
+                runClient(opts, c, ackLatency, results[c]);
+            }
+            catch (const std::exception& e)
+            {
+                std::cerr << "client " << c << ": " << e.what() << std::endl;
+            }
+        });
+    }
+    for (auto& t : clients)
+    {
+        t.join();
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ClientResult total;
+    for (const auto& r : results)
+    {
+        total.acks += r.acks;
+        total.fills += r.fills;
+        total.rejects += r.rejects;
+    }
+    const uint64_t sent = opts.orders * opts.clients;
+    std::cout << "clients=" << opts.clients << " sent=" << sent << " acks=" << total.acks
+              << " rejects=" << total.rejects << " fills=" << total.fills << " in " << secs << " s ("
+              << static_cast<uint64_t>(static_cast<double>(sent) / secs) << " orders/s)" << std::endl;
+    std::cout << "ack latency: " << ackLatency.summary() << std::endl;
+    return total.acks + total.rejects == sent ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file IoBackendBench.cpp
+ * @brief Loopback comparison of the Gateway I/O backends (epoll, io_uring, io_uring + SQPOLL).
+ *
+ * For every backend an echo server runs on its own I/O thread and N clients each send windows of
+ * framed messages over a local socket, waiting for every window to come back before sending the
+ * next one. Reports messages per second and the round-trip time of a window.
+ *
+ * Usage: OrderMatchingEngineIoBench [--endpoint tcp:127.0.0.1:19077] [--clients 4]
+ *        [--messages 200000] [--size 48] [--window 32] [--backends epoll,io_uring,io_uring+sqpoll]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "../Ingress/Endpoint.h"
+#include "../Ingress/Framing.h"
+#include "../Ingress/IoBackend.h"
+#include "../Metrics/LatencyHistogram.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string endpoint{"tcp:127.0.0.1:19077"};
+        size_t clients{4};
+        size_t messages{200000}; ///< Per client
+        size_t size{48};
+        size_t window{32};
+        std::string backends{"epoll,io_uring,io_uring+sqpoll"};
+    };
+
+    /** @brief Writes every complete frame straight back. */
+    class EchoHandler final : public IoBackend::Handler {
+    public:
+        IoBackend* backend{nullptr};
+
+        void onAccept(IoBackend::ConnId, int) override {}
+        void onClose(IoBackend::ConnId) override {}
+        void onWake() override {}
+
+        size_t onData(const IoBackend::ConnId id, const char* data, const size_t len) override
+        {
+            const char* p = data;
+            std::string_view payload;
+            while (Framing::next(p, data + len, payload) == Framing::Status::OK) {}
+            const auto n = static_cast<size_t>(p - data);
+            backend->write(id, data, n);
+            return n;
+        }
+    };
+
+    void runClient(const Options& opts, const Endpoint& ep, LatencyHistogram& rtt)
+    {
+        const int fd = ep.connect();
+        std::string window;
+        const std::string payload(opts.size, 'x');
+        for (size_t i = 0; i < opts.window; i++)
+        {
+            Framing::append(window, payload);
+        }
+        std::vector<char> in(window.size());
+
+        for (size_t sent = 0; sent < opts.messages; sent += opts.window)
+        {
+            const uint64_t start = LatencyHistogram::nowNs();
+            for (size_t off = 0; off < window.size();)
+            {
+                const ssize_t n = ::send(fd, window.data() + off, window.size() - off, MSG_NOSIGNAL);
+                if (n <= 0)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("send failed");
+                }
+                off += static_cast<size_t>(n);
+            }
+            for (size_t got = 0; got < window.size();)
+            {
+                const ssize_t n = ::recv(fd, in.data() + got, in.size() - got, 0);
+                if (n <= 0)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("connection closed");
+                }
+                got += static_cast<size_t>(n);
+            }
+            rtt.recordSince(start);
+        }
+        ::close(fd);
+    }
+
+    bool runBackend(const Options& opts, const std::string& which)
+    {
+        IoBackend::Options io;
+        io.kind = which == "epoll" ? IoBackend::Kind::EPOLL : IoBackend::Kind::IO_URING;
+        io.sqpoll = which == "io_uring+sqpoll";
+        io.maxConnections = opts.clients + 4;
+
+        const Endpoint ep = Endpoint::Parse(opts.endpoint);
+        std::unique_ptr<IoBackend> backend = IoBackend::Create(io);
+        if (which != "epoll" && std::string(backend->name()) == "epoll")
+        {
+            std::cout << which << ": unavailable, skipped" << std::endl;
+            return true;
+        }
+        EchoHandler echo;
+        echo.backend = backend.get();
+        backend->open(ep.listen(), echo);
+        std::atomic<bool> running{true};
+        std::thread ioThread([&] { backend->run(running); });
+
+        LatencyHistogram rtt;
+        std::atomic<bool> ok{true};
+        std::vector<std::thread> clients;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t c = 0; c < opts.clients; c++)
+        {
+            clients.emplace_back([&]
+            {
+                try
+                {
+                    runClient(opts, ep, rtt);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << which << " client: " << e.what() << std::endl;
+                    ok = false;
+                }
+            });
+        }
+        for (auto& t : clients)
+        {
+            t.join();
+        }
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        running = false;
+        backend->wake();
+        ioThread.join();
+        backend->shutdown();
+        if (ep.kind == Endpoint::Kind::UNIX)
+        {
+            ::unlink(ep.path.c_str());
+        }
+
+        const double total = static_cast<double>(opts.clients * opts.messages);
+        std::cout << backend->name() << ": " << static_cast<uint64_t>(total / secs) << " msgs/s, window rtt "
+                  << rtt.summary() << std::endl;
+        return ok;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--endpoint") opts.endpoint = value;
+        else if (arg == "--clients") opts.clients = std::stoul(value);
+        else if (arg == "--messages") opts.messages = std::stoul(value);
+        else if (arg == "--size") opts.size = std::stoul(value);
+        else if (arg == "--window") opts.window = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--backends") opts.backends = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << opts.clients << " clients x " << opts.messages << " messages of " << opts.size << " bytes, window "
+              << opts.window << " on " << opts.endpoint << std::endl;
+    bool ok = true;
+    std::stringstream names(opts.backends);
+    for (std::string which; std::getline(names, which, ',');)
+    {
+        ok = runBackend(opts, which) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file JournalBench.cpp
+ * @brief What journaling costs an order, and what group commit buys.
+ *
+ * `--threads` producers append cancels over `--shards` shards, as fast as they can or at `--rate`
+ * messages per second in total, like injector workers would, once with ASYNC durability and once with SYNC durability per group-commit window.
+ * The apply function stands in for the book: it records the time from append to apply, which for
+ * SYNC is the wait for the fdatasync covering the message. Each run's directory is then recovered
+ * by a fresh Journal, which must read back every message exactly once.
+ *
+ * Usage: OrderMatchingEngineJournalBench [--messages 1000000] [--threads 4] [--shards 4]
+ *                                        [--rate 0] [--dir /tmp/ome-journal-bench]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Journal/Journal.h"
+#include "../Metrics/LatencyHistogram.h"
+#include "../OrderBook/SymbolTable.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t messages{1'000'000};
+        size_t threads{4};
+        size_t shards{4};
+        std::string dir{"/tmp/ome-journal-bench"};
+        size_t rate{0}; ///< Messages per second over all producers, 0 = as fast as possible
+    };
+
+    constexpr size_t PACING_BATCH = 64; ///< Paced producers sleep once per this many messages
+
+    struct Run
+    {
+        const char* name;
+        Journal::Durability durability;
+        std::chrono::microseconds window;
+    };
+
+    bool bench(const Options& opts, const Run& run, const SymbolId symbol)
+    {
+        const std::string dir = opts.dir + "/" + run.name;
+        std::filesystem::remove_all(dir);
+
+        LatencyHistogram applyLatency;
+        std::atomic<uint64_t> applied{0};
+        Journal::Options jo;
+        jo.directory = dir;
+        jo.shards = opts.shards;
+        jo.durability = run.durability;
+        jo.groupCommitWindow = run.window;
+
+        double seconds = 0;
+        uint64_t syncs = 0;
+        {
+            Journal journal(jo);
+            journal.start([&](const InboundMessage& m, OrderPtr)
+            {
+                applyLatency.recordSince(m.ingressNs);
+                applied.fetch_add(1, std::memory_order_relaxed);
+            });
+
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> producers;
+            for (size_t t = 0; t < opts.threads; t++)
+            {
+                producers.emplace_back([&, t]
+                {
+                    InboundMessage m;
+                    m.kind = MessageKind::CANCEL;
+                    m.symbolId = symbol;
+                    const auto begin = std::chrono::steady_clock::now();
+                    size_t sent = 0;
+                    for (size_t i = t; i < opts.messages; i += opts.threads)
+                    {
+                        if (opts.rate && ++sent % PACING_BATCH == 0)
+                        {
+                            std::this_thread::sleep_until(begin + std::chrono::nanoseconds(
+                                static_cast<int64_t>(1e9 * static_cast<double>(sent * opts.threads) / static_cast<double>(opts.rate))));
+                        }
+                        m.order.id = i + 1;
+                        m.ingressNs = LatencyHistogram::nowNs();
+                        journal.append(i % opts.shards, m, nullptr);
+                    }
+                });
+            }
+            for (auto& p : producers)
+            {
+                p.join();
+            }
+            journal.stop();
+            seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            syncs = journal.syncs();
+        }
+
+        // Read the run back.
+        uint64_t recovered = 0;
+        uint64_t idSum = 0;
+        const auto recoverStart = std::chrono::steady_clock::now();
+        {
+            Journal journal(jo);
+            journal.recover([&](const InboundMessage& m)
+            {
+                recovered++;
+                idSum += m.order.id;
+            });
+        }
+        const double recoverSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - recoverStart).count();
+        const uint64_t n = opts.messages;
+        const bool ok = applied.load() == n && recovered == n && idSum == n * (n + 1) / 2;
+
+        std::cout << run.name << ": " << static_cast<uint64_t>(static_cast<double>(n) / seconds) << " msg/s, "
+                  << syncs << " fdatasyncs (" << (syncs ? n / syncs : 0) << " msg/sync)" << std::endl
+                  << "  append to apply: " << applyLatency.summary() << std::endl
+                  << "  recovered " << recovered << "/" << n << " in " << recoverSeconds * 1e3 << " ms"
+                  << (ok ? "" : "  MISMATCH") << std::endl;
+        std::filesystem::remove_all(dir);
+        return ok;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--messages") opts.messages = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--threads") opts.threads = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--shards") opts.shards = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--dir") opts.dir = value;
+        else if (arg == "--rate") opts.rate = std::stoul(value);
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const SymbolId symbol = SymbolTable::instance().intern("JOURNALBENCH");
+    const Run runs[] = {
+        {"async", Journal::Durability::ASYNC, std::chrono::microseconds(200)},
+        {"sync-50us", Journal::Durability::SYNC, std::chrono::microseconds(50)},
+        {"sync-200us", Journal::Durability::SYNC, std::chrono::microseconds(200)},
+        {"sync-1ms", Journal::Durability::SYNC, std::chrono::microseconds(1000)},
+    };
+    bool ok = true;
+    for (const auto& run : runs)
+    {
+        ok &= bench(opts, run, symbol);
+    }
+    return ok ? 0 : 1;
+}
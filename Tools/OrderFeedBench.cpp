@@ -0,0 +1,222 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file OrderFeedBench.cpp
+ * @brief What an L3 order event costs the book worker that emits it.
+ *
+ * Three measurements:
+ * - emit: OrderFeed events pushed into an OrderFeedWriter ring in a loop, the writer encoding them
+ *   to `--out` on its own thread. Producer-side ns/event.
+ * - book: limit orders pushed straight into one OrderBook (no scheduler), half of them resting over
+ *   a few price levels, half sweeping them; without an order event sink, then with the writer's
+ *   ring. The difference divided by the events emitted is the per-event cost in context.
+ *   Best of `--rounds`.
+ * - verify: the file is decoded back; per-book sequence numbers must count up by one and every
+ *   order added must have left the book again (the flow empties it).
+ *
+ * Usage: OrderMatchingEngineOrderFeedBench [--orders 1000000] [--rounds 3] [--out /tmp/ome-bench.l3]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../OrderBook/OrderBook.h"
+#include "../OrderBook/SymbolTable.h"
+#include "../Codec/BinaryCodec.h"
+#include "../MarketData/OrderFeedWriter.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t orders{1'000'000};
+        size_t rounds{3};
+        std::string out{"/tmp/ome-bench.l3"};
+    };
+
+    constexpr Price BASE_PRICE = 10000;
+    constexpr size_t LEVELS = 8;
+    constexpr size_t RING_SLOTS = 1 << 20;
+
+    double nsPer(const std::chrono::steady_clock::time_point start, const size_t n)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / static_cast<double>(n);
+    }
+
+    /** @brief Rounds of LEVELS resting buys, one per level, then one sell sweeping all of them. */
+    std::vector<OrderPtr> makeOrders(const size_t n, const OrderId firstId)
+    {
+        std::vector<OrderPtr> orders;
+        orders.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const size_t k = i % (LEVELS + 1);
+            const bool buy = k < LEVELS;
+            orders.push_back(Order::TryMakeLimit(firstId + i, buy ? Side::BUY : Side::SELL, buy ? 10 : 10 * LEVELS,
+                                                 "L3BENCH", buy ? BASE_PRICE + static_cast<Price>(k) : BASE_PRICE,
+                                                 TIF::GOOD_TILL_CANCELED).take());
+        }
+        return orders;
+    }
+
+    double runBook(OrderBook& book, std::vector<OrderPtr> orders)
+    {
+        const size_t n = orders.size();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& o : orders)
+        {
+            book.processOrder(std::move(o));
+        }
+        return nsPer(start, n);
+    }
+
+    void benchEmit(const Options& opts, OrderFeedWriter& writer)
+    {
+        OrderFeed feed(SymbolTable::instance().find("L3BENCH-EMIT"));
+        feed.setSink(&writer.producer(0));
+        const uint64_t droppedBefore = writer.dropped();
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < opts.orders; i++)
+        {
+            switch (i & 3)
+            {
+                case 0: feed.add(i, Side::BUY, BASE_PRICE, 10); break;
+                case 1: feed.execute(i - 1, Side::BUY, BASE_PRICE, 4); break;
+                case 2: feed.reduce(i - 2, Side::BUY, 2); break;
+                default: feed.remove(i - 3, Side::BUY, 4); break;
+            }
+        }
+        const double ns = nsPer(start, opts.orders);
+        std::cout << "emit, " << opts.orders << " events (add/execute/reduce/delete):" << std::endl
+                  << "  " << ns << " ns/event, " << writer.dropped() - droppedBefore << " dropped" << std::endl;
+    }
+
+    void benchBook(const Options& opts, OrderFeedWriter& writer)
+    {
+        OrderBook book("L3BENCH");
+        double plain = 1e300;
+        double published = 1e300;
+        uint64_t events = 0;
+        OrderId nextId = 1;
+        for (size_t r = 0; r < opts.rounds; r++)
+        {
+            book.setOrderEventSink(nullptr);
+            plain = std::min(plain, runBook(book, makeOrders(opts.orders, nextId)));
+            nextId += opts.orders;
+            const uint64_t before = book.orderEventSequence();
+            book.setOrderEventSink(&writer.producer(0));
+            published = std::min(published, runBook(book, makeOrders(opts.orders, nextId)));
+            nextId += opts.orders;
+            events = book.orderEventSequence() - before;
+        }
+        book.setOrderEventSink(nullptr);
+        const double perEvent = (published - plain) * static_cast<double>(opts.orders) / static_cast<double>(events);
+        std::cout << "book, " << opts.orders << " orders, best of " << opts.rounds << ":" << std::endl
+                  << "  no order feed: " << plain << " ns/order" << std::endl
+                  << "  order feed:    " << published << " ns/order (+" << published - plain << "), "
+                  << static_cast<double>(events) / static_cast<double>(opts.orders) << " events/order, ~"
+                  << perEvent << " ns/event" << std::endl;
+    }
+
+    bool verify(const std::string& path, const uint64_t dropped)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st{};
+        if (fd < 0 || ::fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            std::cerr << "cannot read " << path << std::endl;
+            return false;
+        }
+        const size_t size = static_cast<size_t>(st.st_size);
+        void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED)
+        {
+            std::cerr << "cannot map " << path << std::endl;
+            return false;
+        }
+        const auto* data = static_cast<const uint8_t*>(mapped);
+
+        std::unordered_map<SymbolId, uint64_t> lastSeq;
+        std::unordered_map<SymbolId, std::unordered_map<OrderId, Quantity>> open;
+        uint64_t events = 0;
+        uint64_t holes = 0;
+        size_t off = 0;
+        while (off < size)
+        {
+            OrderEvent e;
+            size_t consumed = 0;
+            if (BinaryCodec::decodeOrderEvent(data + off, size - off, e, consumed) != DecodeError::NONE)
+            {
+                std::cerr << "undecodable event at byte " << off << std::endl;
+                return false;
+            }
+            off += consumed;
+            events++;
+            holes += e.seq != lastSeq[e.symbolId] + 1;
+            lastSeq[e.symbolId] = e.seq;
+
+            auto& book = open[e.symbolId];
+            if (e.type == OrderEventType::ADD)
+            {
+                book[e.orderId] = e.qty;
+            }
+            else if (const auto it = book.find(e.orderId); it != book.end())
+            {
+                it->second -= std::min(it->second, e.qty);
+                if (it->second == 0 || e.type == OrderEventType::DELETE)
+                {
+                    book.erase(it);
+                }
+            }
+        }
+        ::munmap(const_cast<uint8_t*>(data), size);
+
+        const size_t resting = open[SymbolTable::instance().find("L3BENCH")].size();
+        std::cout << "verify: " << events << " events, " << size << " bytes ("
+                  << static_cast<double>(size) / static_cast<double>(events) << " bytes/event), "
+                  << holes << " sequence holes, " << resting << " orders left in the rebuilt book" << std::endl;
+        return dropped > 0 || (holes == 0 && resting == 0);
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--orders") opts.orders = std::stoul(value);
+        else if (arg == "--rounds") opts.rounds = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--out") opts.out = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    // Whole rounds only, so the book is empty between runs and the rebuilt book must end up empty.
+    opts.orders = std::max(opts.orders - opts.orders % (LEVELS + 1), LEVELS + 1);
+
+    SymbolTable::instance().intern("L3BENCH");
+    SymbolTable::instance().intern("L3BENCH-EMIT");
+    OrderFeedWriter writer(1, RING_SLOTS, opts.out);
+    writer.start();
+    benchEmit(opts, writer);
+    benchBook(opts, writer);
+    writer.stop();
+    std::cout << "writer: " << writer.written() << " events, " << writer.dropped() << " dropped" << std::endl;
+    return verify(opts.out, writer.dropped()) ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file RegistryBench.cpp
+ * @brief Concurrent lookups in the OrderBook registry: the copy-on-write registry (epoch read
+ * section, no lock) against the shared_mutex registry it replaced, with N reader threads.
+ *
+ * `--symbols` books are registered in both. Every reader then looks up `--lookups` symbols through
+ * OrderBook::getOrCreate() and through a copy of the old read path (shared_lock, find, copy the
+ * shared_ptr), starting at a different symbol per thread. With `--write-every-us` a writer thread
+ * registers a new symbol at that interval during the run, which makes the copy-on-write side copy
+ * its map and the locked side take the exclusive lock. Both return a shared_ptr copy, so the book's
+ * reference count is touched the same way on both sides.
+ *
+ * Usage: OrderMatchingEngineRegistryBench [--readers <cores>] [--lookups 2000000] [--symbols 64]
+ *                                         [--write-every-us 0]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../OrderBook/OrderBook.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t readers{std::max(1u, std::thread::hardware_concurrency())};
+        size_t lookups{2'000'000}; ///< Per reader
+        size_t symbols{64};
+        uint64_t writeEveryUs{0}; ///< 0 = no writer
+    };
+
+    /** @brief The registry's read path before copy-on-write: one shared_mutex over the map. */
+    class LockedRegistry {
+    public:
+        std::shared_ptr<OrderBook> getOrCreate(const Symbol& symbol)
+        {
+            {
+                std::shared_lock<std::shared_mutex> rlk(mMtx);
+                if (const auto it = mBooks.find(symbol); it != mBooks.end())
+                {
+                    return it->second;
+                }
+            }
+            std::unique_lock<std::shared_mutex> wlk(mMtx);
+            auto& book = mBooks[symbol];
+            if (!book)
+            {
+                book = std::make_shared<OrderBook>(symbol);
+            }
+            return book;
+        }
+
+    private:
+        std::shared_mutex mMtx;
+        std::unordered_map<Symbol, std::shared_ptr<OrderBook>> mBooks;
+    };
+
+    struct Result
+    {
+        double mLookupsPerSec{0}; ///< All readers together
+        double nsPerLookup{0};    ///< Mean over readers
+        uint64_t writes{0};
+    };
+
+    /** @brief Runs the readers (and the writer, if any) over `lookup`. */
+    template <typename Lookup>
+    Result run(const Options& opts, const std::vector<Symbol>& symbols, const std::string& writerPrefix, Lookup lookup)
+    {
+        std::atomic<bool> go{false};
+        std::atomic<size_t> done{0};
+        std::vector<double> ns(opts.readers);
+        std::vector<std::thread> readers;
+        for (size_t r = 0; r < opts.readers; r++)
+        {
+            readers.emplace_back([&, r]
+            {
+                while (!go.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                uint64_t found = 0;
+                size_t at = r * symbols.size() / opts.readers;
+                const auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < opts.lookups; i++)
+                {
+                    found += lookup(symbols[at]) != nullptr;
+                    at = at + 1 == symbols.size() ? 0 : at + 1;
+                }
+                ns[r] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                    / static_cast<double>(opts.lookups);
+                asm volatile("" : : "g"(&found) : "memory");
+                done.fetch_add(1, std::memory_order_release);
+            });
+        }
+
+        Result result;
+        std::thread writer;
+        if (opts.writeEveryUs > 0)
+        {
+            writer = std::thread([&]
+            {
+                while (!go.load(std::memory_order_acquire))
+                {
+                    std::this_thread::yield();
+                }
+                while (done.load(std::memory_order_acquire) < opts.readers)
+                {
+                    lookup(writerPrefix + std::to_string(result.writes++));
+                    std::this_thread::sleep_for(std::chrono::microseconds(opts.writeEveryUs));
+                }
+            });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& t : readers)
+        {
+            t.join();
+        }
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (writer.joinable())
+        {
+            writer.join();
+        }
+        result.mLookupsPerSec = static_cast<double>(opts.readers * opts.lookups) / secs / 1e6;
+        for (const double n : ns)
+        {
+            result.nsPerLookup += n / static_cast<double>(opts.readers);
+        }
+        return result;
+    }
+
+    void print(const char* name, const Result& r)
+    {
+        std::cout << "  " << name << r.mLookupsPerSec << " M lookups/s, " << r.nsPerLookup << " ns/lookup per reader";
+        if (r.writes)
+        {
+            std::cout << ", " << r.writes << " books registered meanwhile";
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--readers") opts.readers = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--lookups") opts.lookups = std::stoul(value);
+        else if (arg == "--symbols") opts.symbols = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--write-every-us") opts.writeEveryUs = std::stoull(value);
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Symbol> symbols;
+    LockedRegistry locked;
+    for (size_t i = 0; i < opts.symbols; i++)
+    {
+        symbols.push_back("SYM" + std::to_string(i));
+        OrderBook::getOrCreate(symbols.back());
+        locked.getOrCreate(symbols.back());
+    }
+
+    const Result cow = run(opts, symbols, "COW_NEW", [](const Symbol& s) { return OrderBook::getOrCreate(s); });
+    const Result rw = run(opts, symbols, "LOCKED_NEW", [&locked](const Symbol& s) { return locked.getOrCreate(s); });
+
+    std::cout << opts.readers << " reader(s) x " << opts.lookups << " lookups over " << opts.symbols << " symbols"
+              << (opts.writeEveryUs ? ", a writer every " + std::to_string(opts.writeEveryUs) + " us" : "")
+              << std::endl;
+    print("copy-on-write  ", cow);
+    print("shared_mutex   ", rw);
+    std::cout << "  speedup        " << cow.mLookupsPerSec / rw.mLookupsPerSec << "x" << std::endl;
+    return 0;
+}
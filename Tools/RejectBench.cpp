@@ -0,0 +1,215 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file RejectBench.cpp
+ * @brief Throughput of the reject path under a 50% bad-input mix.
+ *
+ * Two measurements:
+ * - factory: the throwing Order::MakeLimit (caught per order, as the injector used to) against the
+ *   non-throwing Order::TryMakeLimit, half of the orders failing validation.
+ * - injector: binary frames pushed through OrderInjectorScheduler::processFrames into one book,
+ *   half of them bad (zero quantity, zero limit price, unknown symbol, undecodable). Every bad
+ *   message must come back as a REJECTED report on its session.
+ *
+ * Usage: OrderMatchingEngineRejectBench [--orders 2000000] [--messages 1000000] [--batch 64]
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Codec/BinaryCodec.h"
+#include "../Ingress/Framing.h"
+#include "../OrderBook/Order/StaticValidator.h"
+#include "../Reports/ReportRouter.h"
+#include "../Scheduler/OrderInjectorScheduler.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t orders{2'000'000};
+        size_t messages{1'000'000};
+        size_t batch{64};
+    };
+
+    const Symbol BENCH_SYMBOL{"BENCH"};
+
+    /** @brief Counts reports by type; called concurrently by injector and book workers. */
+    class CountingSink final : public IReportSink {
+    public:
+        std::atomic<uint64_t> rejects{0};
+        std::atomic<uint64_t> accepted{0};
+
+        void onReport(const ExecReport& r) override
+        {
+            if (r.type == ExecType::REJECTED)
+            {
+                rejects.fetch_add(1, std::memory_order_relaxed);
+            }
+            else if (r.type == ExecType::NEW)
+            {
+                accepted.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    double secondsSince(const std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /** @brief Every other order is bad: zero quantity or zero limit price. */
+    void orderParams(const size_t i, Quantity& qty, Price& price)
+    {
+        qty = (i % 4 == 2) ? 0 : 10;
+        price = (i % 4 == 3) ? 0 : 10000;
+    }
+
+    void benchFactory(const Options& opts, const IValidator& validator)
+    {
+        size_t ok = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < opts.orders; i++)
+        {
+            Quantity qty;
+            Price price;
+            orderParams(i, qty, price);
+            try
+            {
+                const OrderPtr o = Order::MakeLimit(i + 1, Side::BUY, qty, BENCH_SYMBOL, price, validator);
+                ok++;
+            }
+            catch (const std::invalid_argument&) {}
+        }
+        const double throwing = secondsSince(start);
+
+        size_t okTry = 0;
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < opts.orders; i++)
+        {
+            Quantity qty;
+            Price price;
+            orderParams(i, qty, price);
+            OrderResult r = Order::TryMakeLimit(i + 1, Side::BUY, qty, BENCH_SYMBOL, price, TIF::DEFAULT, validator);
+            if (r)
+            {
+                okTry++;
+            }
+        }
+        const double nonThrowing = secondsSince(start);
+
+        const auto rate = [&](const double secs) { return static_cast<uint64_t>(opts.orders / secs); };
+        std::cout << "factory, " << opts.orders << " orders (" << opts.orders - ok << " bad):" << std::endl
+                  << "  MakeLimit + catch: " << rate(throwing) << " orders/s" << std::endl
+                  << "  TryMakeLimit:      " << rate(nonThrowing) << " orders/s ("
+                  << throwing / nonThrowing << "x)" << std::endl;
+        if (ok != okTry)
+        {
+            std::cerr << "factory mismatch: " << ok << " vs " << okTry << " accepted" << std::endl;
+        }
+    }
+
+    /** @brief One binary frame; i % 8 in 4..7 is bad. */
+    void appendMessage(std::string& frames, const size_t i, const SymbolId symbolId)
+    {
+        InboundMessage m;
+        m.kind = MessageKind::NEW_ORDER;
+        m.symbolId = symbolId;
+        m.order.id = i + 1;
+        m.order.side = (i & 1) ? Side::SELL : Side::BUY; // good orders cross each other, the book stays flat
+        m.order.type = Type::LIMIT;
+        m.order.tif = TIF::GOOD_TILL_CANCELED;
+        m.order.qty = 10;
+        m.order.price = 10000;
+        switch (i % 8)
+        {
+            case 4: m.order.qty = 0; break;
+            case 5: m.order.price = 0; break;
+            case 6: m.symbolId = symbolId + 1000; break;
+            case 7:
+                Framing::append(frames, std::string_view("\xB7garbage", 8));
+                return;
+            default: break;
+        }
+        uint8_t buf[BinaryCodec::MAX_MESSAGE_SIZE];
+        const size_t n = BinaryCodec::encode(m, buf, sizeof(buf));
+        Framing::append(frames, std::string_view(reinterpret_cast<const char*>(buf), n));
+    }
+
+    bool benchInjector(const Options& opts)
+    {
+        CountingSink sink;
+        auto obs = std::make_shared<OrderBookScheduler>("bench_ob", 1,
+            OrderBookScheduler::SymbolToWorkerMap{{BENCH_SYMBOL, "bench_ob_0"}});
+        auto injector = std::make_shared<OrderInjectorScheduler>("bench_oi", 1, obs);
+        obs->setReportSink(&sink);
+        injector->setReportSink(&sink);
+        obs->start();
+        injector->start();
+
+        const SymbolId id = SymbolTable::instance().find(BENCH_SYMBOL);
+        const SessionId session = ReportRouter::makeSession(1, 1);
+        std::vector<std::string> batches;
+        for (size_t i = 0; i < opts.messages; i += opts.batch)
+        {
+            std::string frames;
+            for (size_t j = i; j < std::min(opts.messages, i + opts.batch); j++)
+            {
+                appendMessage(frames, j, id);
+            }
+            batches.push_back(std::move(frames));
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& frames : batches)
+        {
+            injector->processFrames(std::move(frames), session);
+        }
+        injector->drain();
+        obs->drain();
+        const double secs = secondsSince(start);
+
+        injector->shutdown();
+        obs->shutdown();
+
+        const uint64_t expected = opts.messages / 2;
+        std::cout << "injector, " << opts.messages << " messages in batches of " << opts.batch << ":" << std::endl
+                  << "  " << static_cast<uint64_t>(opts.messages / secs) << " msgs/s, "
+                  << static_cast<uint64_t>(sink.rejects / secs) << " rejects/s (" << sink.rejects << " rejects, "
+                  << sink.accepted << " accepted)" << std::endl;
+        if (sink.rejects < expected)
+        {
+            std::cerr << "expected at least " << expected << " rejects" << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--orders") opts.orders = std::stoul(value);
+        else if (arg == "--messages") opts.messages = std::stoul(value);
+        else if (arg == "--batch") opts.batch = std::max<size_t>(1, std::stoul(value));
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const auto chain = std::make_shared<StandardValidator>(); // same default as the engine
+    Order::SetDefaultValidator(chain);
+
+    benchFactory(opts, *chain);
+    return benchInjector(opts) ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file ReportStreamBench.cpp
+ * @brief What execution reporting costs a book worker: calling a client sink directly against
+ * publishing into a ReportStream ring.
+ *
+ * N producer threads stand in for book workers and emit reports as fast as they can. The client sink
+ * is shaped like the gateway's: a mutex and an append to a per-client buffer. Reported per mode:
+ * producer-side ns/report and the p99.9 of a single publish, plus delivered / dropped counts. The
+ * `slow` mode adds `--slow-ns` of work per report in the sink, a client that cannot keep up: the
+ * direct path slows the producers down, the stream drops instead.
+ *
+ * Usage: OrderMatchingEngineReportStreamBench [--producers 2] [--reports 2000000] [--slots 65536]
+ *        [--consumers 1] [--slow-ns 200]
+ */
+
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Metrics/LatencyHistogram.h"
+#include "../Reports/ReportStream.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t producers{2};
+        size_t reports{2'000'000}; ///< Per producer
+        size_t slots{ReportStream::DEFAULT_RING_SLOTS};
+        size_t consumers{1};
+        uint64_t slowNs{200};
+    };
+
+    /** @brief Per-client output buffers behind one lock, like Gateway::onReport(). */
+    class ClientSink final : public IReportSink {
+    public:
+        explicit ClientSink(const uint64_t workNs) : mWorkNs(workNs) {}
+
+        void onReport(const ExecReport& r) override
+        {
+            std::lock_guard<std::mutex> lk(mMtx);
+            std::string& out = mOut[r.session % mOut.size()];
+            out.append(reinterpret_cast<const char*>(&r), sizeof(r));
+            if (out.size() > (1 << 20))
+            {
+                out.clear(); // "sent"
+            }
+            if (mWorkNs > 0)
+            {
+                const uint64_t until = LatencyHistogram::nowNs() + mWorkNs;
+                while (LatencyHistogram::nowNs() < until) {}
+            }
+            received++;
+        }
+
+        uint64_t received{0}; ///< Under mMtx
+
+    private:
+        std::mutex mMtx;
+        std::vector<std::string> mOut{std::vector<std::string>(16)};
+        uint64_t mWorkNs;
+    };
+
+    /** @brief Runs the producers against one sink per producer; returns producer ns/report. */
+    double produce(const Options& opts, const std::vector<IReportSink*>& sinks, LatencyHistogram& publish)
+    {
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t p = 0; p < opts.producers; p++)
+        {
+            threads.emplace_back([&, p]
+            {
+                ExecReport r;
+                r.type = ExecType::TRADE;
+                for (size_t i = 0; i < opts.reports; i++)
+                {
+                    r.orderId = i;
+                    r.session = static_cast<SessionId>(i);
+                    // Sample one publish in 64: timing every call would dominate the cost measured.
+                    if ((i & 63) == 0)
+                    {
+                        const uint64_t t0 = LatencyHistogram::nowNs();
+                        sinks[p]->onReport(r);
+                        publish.recordSince(t0);
+                    }
+                    else
+                    {
+                        sinks[p]->onReport(r);
+                    }
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / static_cast<double>(opts.reports);
+    }
+
+    void runDirect(const Options& opts, const uint64_t workNs, const char* name)
+    {
+        ClientSink sink(workNs);
+        LatencyHistogram publish;
+        const double ns = produce(opts, std::vector<IReportSink*>(opts.producers, &sink), publish);
+        std::cout << "  direct " << name << ": " << ns << " ns/report per producer, publish " << publish.summary()
+                  << ", delivered " << sink.received << std::endl;
+    }
+
+    void runStream(const Options& opts, const uint64_t workNs, const char* name)
+    {
+        ClientSink sink(workNs);
+        ReportStream stream(opts.producers, opts.slots, opts.consumers, sink);
+        std::vector<IReportSink*> sinks;
+        for (size_t p = 0; p < opts.producers; p++)
+        {
+            sinks.push_back(&stream.producer(p));
+        }
+        stream.start();
+        LatencyHistogram publish;
+        const double ns = produce(opts, sinks, publish);
+        stream.stop();
+        std::cout << "  stream " << name << ": " << ns << " ns/report per producer, publish " << publish.summary()
+                  << ", delivered " << stream.delivered() << ", dropped " << stream.dropped() << std::endl;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--producers") opts.producers = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--reports") opts.reports = std::stoul(value);
+        else if (arg == "--slots") opts.slots = std::stoul(value);
+        else if (arg == "--consumers") opts.consumers = std::stoul(value);
+        else if (arg == "--slow-ns") opts.slowNs = std::stoull(value);
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << opts.producers << " producers x " << opts.reports << " reports, " << opts.slots << " slots, "
+              << opts.consumers << " consumers" << std::endl;
+    runDirect(opts, 0, "fast");
+    runStream(opts, 0, "fast");
+    runDirect(opts, opts.slowNs, "slow");
+    runStream(opts, opts.slowNs, "slow");
+    return 0;
+}
@@ -0,0 +1,175 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file RiskBench.cpp
+ * @brief Per-order cost of pre-trade risk.
+ *
+ * Two measurements:
+ * - book: limit orders that cross each other pushed straight into one OrderBook (no scheduler),
+ *   without a RiskShard, then with one and every order booked to an account with limits. The
+ *   difference is what the risk stage adds to an order that trades. Best of `--rounds`.
+ * - shards: N threads, each with its own RiskShard, reserve and close orders of one shared account.
+ *   With leasing the account's pools are touched once per chunk, not once per order.
+ *
+ * Usage: OrderMatchingEngineRiskBench [--orders 2000000] [--threads 4] [--rounds 3]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../OrderBook/OrderBook.h"
+#include "../OrderBook/SymbolTable.h"
+#include "../Risk/PreTradeRisk.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t orders{2'000'000};
+        size_t threads{4};
+        size_t rounds{3};
+    };
+
+    constexpr AccountId ACCOUNT_A = 1;
+    constexpr AccountId ACCOUNT_B = 2;
+
+    double nsPerOrder(const std::chrono::steady_clock::time_point start, const size_t orders)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / static_cast<double>(orders);
+    }
+
+    /**
+     * @brief Alternating buys and sells at one price: every sell fills the buy before it, the book stays
+     * flat. The two accounts take turns buying, so both are flat after every four orders.
+     */
+    std::vector<OrderPtr> makeOrders(const size_t n, const OrderId firstId)
+    {
+        std::vector<OrderPtr> orders;
+        orders.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const Side side = (i & 1) ? Side::SELL : Side::BUY;
+            OrderPtr o = Order::TryMakeLimit(firstId + i, side, 10, "RISKBENCH", 10000, TIF::GOOD_TILL_CANCELED).take();
+            o->setAccount(((i >> 1) & 1) == (i & 1) ? ACCOUNT_A : ACCOUNT_B);
+            orders.push_back(std::move(o));
+        }
+        return orders;
+    }
+
+    double runBook(OrderBook& book, std::vector<OrderPtr> orders)
+    {
+        const size_t n = orders.size();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& o : orders)
+        {
+            book.processOrder(std::move(o));
+        }
+        return nsPerOrder(start, n);
+    }
+
+    bool benchBook(const Options& opts)
+    {
+        OrderBook book("RISKBENCH");
+        RiskShard shard;
+        double plain = 1e300;
+        double checked = 1e300;
+        OrderId nextId = 1;
+        for (size_t r = 0; r < opts.rounds; r++, nextId += 2 * opts.orders)
+        {
+            book.setRiskShard(nullptr);
+            plain = std::min(plain, runBook(book, makeOrders(opts.orders, nextId)));
+            book.setRiskShard(&shard);
+            checked = std::min(checked, runBook(book, makeOrders(opts.orders, nextId + opts.orders)));
+        }
+
+        std::cout << "book, " << opts.orders << " crossing limit orders, best of " << opts.rounds << ":" << std::endl
+                  << "  no risk:   " << plain << " ns/order" << std::endl
+                  << "  with risk: " << checked << " ns/order (+" << checked - plain << ")" << std::endl;
+        const SymbolId id = SymbolTable::instance().find("RISKBENCH");
+        if (shard.position(ACCOUNT_A, id) != 0 || shard.position(ACCOUNT_B, id) != 0)
+        {
+            std::cerr << "positions did not net out: " << shard.position(ACCOUNT_A, id) << ", "
+                      << shard.position(ACCOUNT_B, id) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool benchShards(const Options& opts)
+    {
+        const size_t perThread = opts.orders / opts.threads;
+        std::vector<std::thread> threads;
+        std::vector<size_t> rejected(opts.threads, 0);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < opts.threads; t++)
+        {
+            threads.emplace_back([&, t]
+            {
+                RiskShard shard;
+                const auto id = static_cast<SymbolId>(t);
+                OrderPtr o = Order::TryMakeLimit(t + 1, Side::BUY, 10, "RISKBENCH", 10000).take();
+                o->setAccount(ACCOUNT_A);
+                for (size_t i = 0; i < perThread; i++)
+                {
+                    if (shard.reserve(*o, id, o->price()) != RejectReason::NONE)
+                    {
+                        rejected[t]++;
+                        continue;
+                    }
+                    shard.onClose(ACCOUNT_A, id, Side::BUY, o->openQty(), o->price());
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        const double ns = nsPerOrder(start, perThread * opts.threads);
+
+        size_t rejects = 0;
+        for (const size_t r : rejected)
+        {
+            rejects += r;
+        }
+        std::cout << "shards, " << opts.threads << " threads x " << perThread << " reserve + close on one account:"
+                  << std::endl
+                  << "  " << ns << " ns/order, " << rejects << " rejected" << std::endl;
+        return rejects == 0;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--orders") opts.orders = std::stoul(value);
+        else if (arg == "--threads") opts.threads = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--rounds") opts.rounds = std::max<size_t>(1, std::stoul(value));
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    SymbolTable::instance().intern("RISKBENCH");
+    // Limits the benchmark stays well inside: measures the checks, not the rejects.
+    RiskLimits limits;
+    limits.maxNotional = 1'000'000'000;
+    limits.maxOpenOrders = 10'000;
+    limits.maxPosition = 1'000'000;
+    RiskEngine::instance().set(ACCOUNT_A, limits);
+    RiskEngine::instance().set(ACCOUNT_B, limits);
+
+    const bool ok = benchBook(opts);
+    return benchShards(opts) && ok ? 0 : 1;
+}
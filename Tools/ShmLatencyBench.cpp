@@ -0,0 +1,147 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file ShmLatencyBench.cpp
+ * @brief Cross-process one-way latency of the shared-memory ingress transport.
+ *
+ * Creates a one-ring region, forks a producer process that pushes binary limit orders through
+ * ShmClient at a fixed interval, and busy-polls the ring in the parent the way an injector worker
+ * does (drain + BinaryCodec decode). Latency is the time from the producer's slot timestamp to the
+ * consumer decoding the message.
+ *
+ * Usage: OrderMatchingEngineShmBench [--messages 1000000] [--gap-ns 1000] [--slots 4096]
+ *        [--name /ome-shm-bench]
+ *
+ * Pin producer and consumer to different cores (e.g. with taskset) for meaningful numbers; on a
+ * single core the result is dominated by scheduler time slices.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../Ingress/ShmClient.h"
+#include "../Metrics/LatencyHistogram.h"
+#include "../OrderBook/SymbolTable.h"
+
+namespace
+{
+    struct Options
+    {
+        uint64_t messages{1'000'000};
+        uint64_t gapNs{1000};
+        uint32_t slots{4096};
+        std::string name{"/ome-shm-bench"};
+    };
+
+    const Symbol BENCH_SYMBOL{"BENCH"};
+
+    int runProducer(const Options& opts)
+    {
+        ShmClient client(opts.name);
+        InboundMessage m;
+        m.kind = MessageKind::NEW_ORDER;
+        m.symbolId = SymbolTable::instance().find(BENCH_SYMBOL);
+        m.order.type = Type::LIMIT;
+        m.order.tif = TIF::GOOD_TILL_CANCELED;
+        m.order.qty = 10;
+        m.order.price = 10000;
+
+        uint64_t next = LatencyHistogram::nowNs();
+        for (uint64_t i = 0; i < opts.messages; i++)
+        {
+            while (LatencyHistogram::nowNs() < next) {}
+            m.order.id = i + 1;
+            m.order.side = (i & 1) ? Side::SELL : Side::BUY;
+            client.push(m);
+            next += opts.gapNs;
+        }
+        return 0;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--messages") opts.messages = std::stoull(value);
+        else if (arg == "--gap-ns") opts.gapNs = std::stoull(value);
+        else if (arg == "--slots") opts.slots = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--name") opts.name = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    SymbolTable::instance().intern(BENCH_SYMBOL); // before fork, so both sides share the id
+    ShmRegion region = ShmRegion::Create(opts.name, 1, opts.slots);
+    const pid_t child = ::fork();
+    if (child < 0)
+    {
+        std::cerr << "fork failed" << std::endl;
+        return 1;
+    }
+    if (child == 0)
+    {
+        int rc = 1;
+        try
+        {
+            rc = runProducer(opts);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "producer: " << e.what() << std::endl;
+        }
+        ::_exit(rc); // the region object belongs to the parent
+    }
+
+    LatencyHistogram latency;
+    uint64_t received = 0;
+    uint64_t malformed = 0;
+    bool producerDone = false;
+    const auto start = std::chrono::steady_clock::now();
+    while (received < opts.messages)
+    {
+        const size_t n = region.drain(0,
+            [&](const std::string_view payload, const uint64_t sendNs)
+            {
+                InboundMessage m;
+                size_t consumed = 0;
+                if (BinaryCodec::decode(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), m, consumed)
+                    != DecodeError::NONE)
+                {
+                    malformed++;
+                }
+                latency.recordSince(sendNs);
+            },
+            256);
+        received += n;
+        if (n == 0 && producerDone)
+        {
+            break; // producer failed early
+        }
+        if (n == 0 && !producerDone)
+        {
+            producerDone = ::waitpid(child, nullptr, WNOHANG) == child;
+        }
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!producerDone)
+    {
+        ::waitpid(child, nullptr, 0);
+    }
+
+    std::cout << "received=" << received << "/" << opts.messages << " malformed=" << malformed << " in " << secs
+              << " s (" << static_cast<uint64_t>(static_cast<double>(received) / secs) << " msgs/s), gap "
+              << opts.gapNs << " ns" << std::endl;
+    std::cout << "one-way latency: " << latency.summary() << std::endl;
+    return received == opts.messages && malformed == 0 ? 0 : 1;
+}
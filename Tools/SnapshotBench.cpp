@@ -0,0 +1,223 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file SnapshotBench.cpp
+ * @brief What a book snapshot costs the book's worker, and how fast a book comes back from one.
+ *
+ * One OrderBook is filled with `--orders` resting limit orders over `--levels` price levels per side
+ * (after a trade, so the stats and last trade are set). The bench then times, per million resting
+ * orders:
+ * - rebuilding the book by matching every order again, what replaying a journal from the start costs
+ *   before decoding;
+ * - encoding it (saveSnapshot), the pause a snapshot imposes on matching, best of `--rounds`;
+ * - writing the file through a SnapshotStore and reading it back;
+ * - loading the image into a fresh book (loadSnapshot), best of `--rounds`;
+ * - filling one OrderTracker side with the buy half of those orders, once through addOrder per order
+ *   and once through the bulk loadOrders, best of `--rounds` each.
+ * The restored book is encoded again and must give the same image.
+ *
+ * Usage: OrderMatchingEngineSnapshotBench [--orders 1000000] [--levels 1000] [--rounds 3]
+ *                                         [--dir /tmp/ome-snapshot-bench]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Journal/Snapshot.h"
+#include "../OrderBook/OrderBook.h"
+#include "../OrderBook/SymbolTable.h"
+#include "../OrderBook/OrderTracker/OrderTracker.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t orders{1'000'000};
+        size_t levels{1000};
+        size_t rounds{3};
+        std::string dir{"/tmp/ome-snapshot-bench"};
+    };
+
+    constexpr Price BASE_PRICE = 100000;
+
+    using Clock = std::chrono::steady_clock;
+
+    double msPerMillion(const Clock::duration took, const size_t orders)
+    {
+        return std::chrono::duration<double, std::milli>(took).count() * 1e6 / static_cast<double>(orders);
+    }
+
+    /** @brief One trade at BASE_PRICE, then buys below it and sells above it, spread over the levels. */
+    std::vector<OrderPtr> makeOrders(const Options& opts, const Symbol& symbol)
+    {
+        std::vector<OrderPtr> orders;
+        orders.reserve(opts.orders + 2);
+        orders.push_back(Order::TryMakeLimit(1, Side::BUY, 10, symbol, BASE_PRICE, TIF::GOOD_TILL_CANCELED).take());
+        orders.push_back(Order::TryMakeLimit(2, Side::SELL, 10, symbol, BASE_PRICE, TIF::GOOD_TILL_CANCELED).take());
+        for (size_t i = 0; i < opts.orders; i++)
+        {
+            const bool buy = i % 2 == 0;
+            const auto offset = static_cast<Price>(1 + (i / 2) % opts.levels);
+            orders.push_back(Order::TryMakeLimit(3 + i, buy ? Side::BUY : Side::SELL, 10 + i % 7, symbol,
+                                                 buy ? BASE_PRICE - offset : BASE_PRICE + offset,
+                                                 TIF::GOOD_TILL_CANCELED).take());
+        }
+        return orders;
+    }
+
+    /** @brief The buy side of makeOrders' book, resting, in price-time priority. */
+    std::vector<OrderPtr> makeBuySide(const Options& opts, const Symbol& symbol)
+    {
+        const size_t count = (opts.orders + 1) / 2;
+        std::vector<OrderPtr> orders;
+        orders.reserve(count);
+        for (size_t level = 0; level < opts.levels; level++)
+        {
+            for (size_t i = 2 * level; i / 2 < count; i += 2 * opts.levels)
+            {
+                orders.push_back(Order::Restore(3 + i, Side::BUY, 10 + i % 7, 10 + i % 7, symbol, Type::LIMIT,
+                                                BASE_PRICE - static_cast<Price>(1 + level), 0,
+                                                TIF::GOOD_TILL_CANCELED, Status::PENDING, NO_ACCOUNT));
+            }
+        }
+        return orders;
+    }
+
+    SnapshotStore::Image encode(const OrderBook& book)
+    {
+        SnapshotStore::Image image;
+        SnapshotWriter out(image);
+        book.saveSnapshot(out);
+        return image;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--orders") opts.orders = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--levels") opts.levels = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--rounds") opts.rounds = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--dir") opts.dir = value;
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    const Symbol source = "SNAPBENCH";
+    SymbolTable::instance().intern(source);
+    OrderBook book(source);
+    auto orders = makeOrders(opts, source);
+    auto start = Clock::now();
+    for (auto& o : orders)
+    {
+        book.processOrder(std::move(o));
+    }
+    const auto rebuild = Clock::now() - start;
+
+    SnapshotStore::Image image;
+    Clock::duration save = Clock::duration::max();
+    for (size_t r = 0; r < opts.rounds; r++)
+    {
+        start = Clock::now();
+        image = encode(book);
+        save = std::min(save, Clock::now() - start);
+    }
+
+    // Through the files, as at a restart.
+    std::filesystem::remove_all(opts.dir);
+    SnapshotStore::Image loadedImage;
+    Clock::duration write{};
+    Clock::duration read{};
+    {
+        SnapshotStore store({opts.dir, 1, std::chrono::seconds(0), 2});
+        store.start(nullptr);
+        start = Clock::now();
+        store.submit(0, opts.orders, image);
+        store.stop();
+        write = Clock::now() - start;
+
+        start = Clock::now();
+        auto loaded = store.load(0);
+        read = Clock::now() - start;
+        if (!loaded || loaded->seq != opts.orders)
+        {
+            std::cerr << "snapshot not read back" << std::endl;
+            return 1;
+        }
+        loadedImage = std::move(loaded->image);
+    }
+    std::filesystem::remove_all(opts.dir);
+
+    Clock::duration restore = Clock::duration::max();
+    bool identical = true;
+    for (size_t r = 0; r < opts.rounds; r++)
+    {
+        const Symbol target = "SNAPBENCH" + std::to_string(r);
+        SymbolTable::instance().intern(target);
+        auto restored = std::make_unique<OrderBook>(target);
+        SnapshotReader in(loadedImage.data(), loadedImage.size());
+        start = Clock::now();
+        const size_t n = restored->loadSnapshot(in);
+        restore = std::min(restore, Clock::now() - start);
+        identical &= n == opts.orders && encode(*restored) == image;
+        const Quote a = book.quote();
+        const Quote b = restored->quote();
+        identical &= a.bidPrice == b.bidPrice && a.bidQty == b.bidQty && a.askPrice == b.askPrice
+            && a.askQty == b.askQty && a.lastPrice == b.lastPrice && a.lastQty == b.lastQty;
+    }
+
+    Clock::duration incremental = Clock::duration::max();
+    Clock::duration bulk = Clock::duration::max();
+    size_t sideOrders = 0;
+    for (size_t r = 0; r < opts.rounds; r++)
+    {
+        auto one = makeBuySide(opts, source);
+        auto all = makeBuySide(opts, source);
+        sideOrders = all.size();
+        OrderTracker byOrder(Side::BUY);
+        start = Clock::now();
+        for (auto& o : one)
+        {
+            byOrder.addOrder(std::move(o));
+        }
+        incremental = std::min(incremental, Clock::now() - start);
+
+        OrderTracker byBulk(Side::BUY);
+        start = Clock::now();
+        identical &= byBulk.loadOrders(std::move(all)) == sideOrders;
+        bulk = std::min(bulk, Clock::now() - start);
+        identical &= byOrder.orderCount() == byBulk.orderCount() && byBulk.bestLevel()
+            && byOrder.bestLevel()->getPrice() == byBulk.bestLevel()->getPrice()
+            && byOrder.bestLevel()->getTotalQuantity() == byBulk.bestLevel()->getTotalQuantity();
+    }
+
+    std::cout << opts.orders << " resting orders over " << opts.levels << " levels per side, image "
+              << image.size() << " bytes (" << image.size() / opts.orders << " per order)" << std::endl
+              << "per million resting orders:" << std::endl
+              << "  rebuild by matching: " << msPerMillion(rebuild, opts.orders) << " ms" << std::endl
+              << "  encode (worker pause), best of " << opts.rounds << ": " << msPerMillion(save, opts.orders) << " ms" << std::endl
+              << "  write + fsync: " << msPerMillion(write, opts.orders) << " ms" << std::endl
+              << "  read + verify: " << msPerMillion(read, opts.orders) << " ms" << std::endl
+              << "  restore, best of " << opts.rounds << ": " << msPerMillion(restore, opts.orders) << " ms"
+              << std::endl
+              << "  one side of " << sideOrders << " orders, best of " << opts.rounds << ": addOrder each "
+              << msPerMillion(incremental, sideOrders) << " ms, loadOrders "
+              << msPerMillion(bulk, sideOrders) << " ms ("
+              << std::chrono::duration<double>(incremental) / std::chrono::duration<double>(bulk) << "x)"
+              << std::endl
+              << "restored books " << (identical ? "identical" : "DIFFER") << std::endl;
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,199 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file TextCodecBench.cpp
+ * @brief Parse-only throughput of the `key=value` text format: TextCodec::decode() against the
+ * std::stringstream / std::unordered_map parser the injector used before it, in messages per second
+ * per core.
+ *
+ * Every thread parses its own copy of the messages, so with --threads N the per-core figure shows
+ * whether parsing scales (the old parser allocates, and the allocator is shared). Messages come from
+ * a file, one per line, or from a built-in mix of limit, market, stop and stop-limit orders. Both
+ * parsers must read the same id and quantity from every message, otherwise the bench fails.
+ *
+ * Usage: OrderMatchingEngineTextCodecBench [--file orders.txt] [--messages 2000000] [--threads 1]
+ * (--messages per thread; the old parser runs a tenth of them)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../Codec/TextCodec.h"
+
+namespace
+{
+    struct Options
+    {
+        std::string file;
+        size_t messages{2'000'000};
+        size_t threads{1};
+    };
+
+    const char* const SAMPLE[] = {
+        "id=1001;side=BUY;qty=100;symbol=TESLA;price=17525;type=LIMIT;tif=GTC",
+        "id=1002;side=SELL;qty=300;symbol=TESLA;price=17540;type=LIMIT;tif=IOC;account=7",
+        "id=1003;side=BUY;qty=50;symbol=AAPL;type=MARKET",
+        "id=1004;side=SELL;qty=1000;symbol=MSFT;price=40210;stop=40250;type=STOP_LIMIT;tif=DAY",
+        "id=1005;side=BUY;qty=25;symbol=AAPL;stop=22875;type=STOP;tif=GTC",
+        "id=1006;side=SELL;qty=75;symbol=TESLA;price=17530;type=LIMIT;tif=FOK;account=12",
+    };
+
+    /** @brief Fields both parsers agree on, enough to check they read the same message. */
+    struct Parsed
+    {
+        uint64_t id{0};
+        uint64_t qty{0};
+        bool ok{false};
+    };
+
+    Parsed parseText(const std::string& msg)
+    {
+        OrderMessage out;
+        const bool ok = TextCodec::decode(msg, out) == DecodeError::NONE;
+        return {out.id, out.qty, ok};
+    }
+
+    /** @brief The injector's parser before TextCodec: split, map, std::stoull. */
+    Parsed parseLegacy(const std::string& msg)
+    {
+        std::unordered_map<std::string, std::string> fields;
+        std::stringstream ss(msg);
+        std::string kv;
+        while (std::getline(ss, kv, ';'))
+        {
+            if (const auto pos = kv.find('='); pos != std::string::npos)
+            {
+                fields[kv.substr(0, pos)] = kv.substr(pos + 1);
+            }
+        }
+        try
+        {
+            return {std::stoull(fields["id"]), std::stoull(fields["qty"]), !fields["symbol"].empty()};
+        }
+        catch (const std::exception&)
+        {
+            return {};
+        }
+    }
+
+    /** @brief Runs `parse` over the messages on `threads` threads; returns messages per second per thread. */
+    template <typename Parse>
+    double perCore(const std::vector<std::string>& msgs, const size_t perThread, const size_t threads, Parse parse)
+    {
+        std::vector<double> rates(threads);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&, t]
+            {
+                const std::vector<std::string> local = msgs; // no sharing between cores
+                uint64_t checksum = 0;
+                const auto start = std::chrono::steady_clock::now();
+                for (size_t i = 0; i < perThread; i++)
+                {
+                    const Parsed p = parse(local[i % local.size()]);
+                    checksum += p.id + p.ok;
+                }
+                const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                asm volatile("" : : "g"(&checksum) : "memory");
+                rates[t] = static_cast<double>(perThread) / secs;
+            });
+        }
+        for (auto& w : workers)
+        {
+            w.join();
+        }
+        double total = 0;
+        for (const double r : rates)
+        {
+            total += r;
+        }
+        return total / static_cast<double>(threads);
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--file") opts.file = value;
+        else if (arg == "--messages") opts.messages = std::stoul(value);
+        else if (arg == "--threads") opts.threads = std::max<size_t>(1, std::stoul(value));
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> msgs;
+    if (opts.file.empty())
+    {
+        msgs.assign(std::begin(SAMPLE), std::end(SAMPLE));
+    }
+    else
+    {
+        std::ifstream in(opts.file);
+        if (!in)
+        {
+            std::cerr << "Cannot read " << opts.file << std::endl;
+            return 1;
+        }
+        for (std::string line; std::getline(in, line);)
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (!line.empty())
+            {
+                msgs.push_back(std::move(line));
+            }
+        }
+    }
+    if (msgs.empty())
+    {
+        std::cerr << "No messages to parse" << std::endl;
+        return 1;
+    }
+
+    size_t bytes = 0;
+    size_t failed = 0;
+    for (const auto& msg : msgs)
+    {
+        bytes += msg.size();
+        const Parsed text = parseText(msg);
+        const Parsed legacy = parseLegacy(msg);
+        if (text.ok && (!legacy.ok || text.id != legacy.id || text.qty != legacy.qty))
+        {
+            std::cerr << "parsers disagree on: " << msg << std::endl;
+            return 1;
+        }
+        failed += !text.ok;
+    }
+
+    perCore(msgs, opts.messages / 10 + 1, opts.threads, parseText); // warm-up
+    const double textRate = perCore(msgs, opts.messages, opts.threads, parseText);
+    const double legacyRate = perCore(msgs, opts.messages / 10 + 1, opts.threads, parseLegacy);
+
+    const double avg = static_cast<double>(bytes) / static_cast<double>(msgs.size());
+    std::cout << msgs.size() << " messages (" << avg << " bytes avg, " << failed << " rejected), "
+              << opts.threads << " thread(s)" << std::endl
+              << "  TextCodec::decode  " << textRate / 1e6 << " M msg/s per core, " << 1e9 / textRate << " ns/msg"
+              << std::endl
+              << "  stringstream/map   " << legacyRate / 1e6 << " M msg/s per core, " << 1e9 / legacyRate
+              << " ns/msg" << std::endl
+              << "  speedup            " << textRate / legacyRate << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,157 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file TopOfBookBench.cpp
+ * @brief Does reading a book's top of book from other threads slow down the book's worker?
+ *
+ * Limit orders are pushed straight into one OrderBook (no scheduler): rounds of resting buys over a
+ * few price levels and one sell sweeping them, so the best bid and the last trade move all the time.
+ * The flow runs with no readers, then with `--readers` threads calling TopOfBook::tryRead() in a
+ * loop. Best of `--rounds`. Readers also check every snapshot they get: versions never go back and
+ * the book is never shown crossed.
+ *
+ * Usage: OrderMatchingEngineTopOfBookBench [--orders 1000000] [--rounds 3] [--readers 2]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../OrderBook/OrderBook.h"
+#include "../OrderBook/SymbolTable.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t orders{1'000'000};
+        size_t rounds{3};
+        size_t readers{2};
+    };
+
+    constexpr Price BASE_PRICE = 10000;
+    constexpr size_t LEVELS = 8;
+
+    struct ReaderStats
+    {
+        uint64_t reads{0};
+        uint64_t retries{0};
+        uint64_t invalid{0};
+    };
+
+    /** @brief Rounds of LEVELS resting buys, one per level, then one sell sweeping all of them. */
+    std::vector<OrderPtr> makeOrders(const size_t n, const OrderId firstId)
+    {
+        std::vector<OrderPtr> orders;
+        orders.reserve(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            const size_t k = i % (LEVELS + 1);
+            const bool buy = k < LEVELS;
+            orders.push_back(Order::TryMakeLimit(firstId + i, buy ? Side::BUY : Side::SELL, buy ? 10 : 10 * LEVELS,
+                                                 "TOBBENCH", buy ? BASE_PRICE + static_cast<Price>(k) : BASE_PRICE,
+                                                 TIF::GOOD_TILL_CANCELED).take());
+        }
+        return orders;
+    }
+
+    void readLoop(const TopOfBook& top, const std::atomic<bool>& stop, ReaderStats& stats)
+    {
+        ReaderStats local;
+        uint64_t lastVersion = 0;
+        Quote q;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            if (!top.tryRead(q))
+            {
+                local.retries++;
+                continue;
+            }
+            local.reads++;
+            const bool crossed = q.bidQty > 0 && q.askQty > 0 && q.bidPrice >= q.askPrice;
+            local.invalid += q.version < lastVersion || crossed;
+            lastVersion = q.version;
+        }
+        stats = local;
+    }
+
+    /** @return Writer ns/order. */
+    double run(OrderBook& book, std::vector<OrderPtr> orders, const size_t readers, ReaderStats& total)
+    {
+        std::atomic<bool> stop{false};
+        std::vector<ReaderStats> stats(readers);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < readers; i++)
+        {
+            threads.emplace_back(readLoop, std::cref(book.topOfBook()), std::cref(stop), std::ref(stats[i]));
+        }
+
+        const size_t n = orders.size();
+        const auto start = std::chrono::steady_clock::now();
+        for (auto& o : orders)
+        {
+            book.processOrder(std::move(o));
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / static_cast<double>(n);
+
+        stop.store(true, std::memory_order_relaxed);
+        for (size_t i = 0; i < readers; i++)
+        {
+            threads[i].join();
+            total.reads += stats[i].reads;
+            total.retries += stats[i].retries;
+            total.invalid += stats[i].invalid;
+        }
+        return ns;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--orders") opts.orders = std::stoul(value);
+        else if (arg == "--rounds") opts.rounds = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--readers") opts.readers = std::stoul(value);
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+    opts.orders = std::max(opts.orders - opts.orders % (LEVELS + 1), LEVELS + 1);
+
+    SymbolTable::instance().intern("TOBBENCH");
+    OrderBook book("TOBBENCH");
+    double alone = 1e300;
+    double read = 1e300;
+    ReaderStats stats;
+    OrderId nextId = 1;
+    for (size_t r = 0; r < opts.rounds; r++)
+    {
+        ReaderStats none;
+        alone = std::min(alone, run(book, makeOrders(opts.orders, nextId), 0, none));
+        nextId += opts.orders;
+        read = std::min(read, run(book, makeOrders(opts.orders, nextId), opts.readers, stats));
+        nextId += opts.orders;
+    }
+
+    const Quote last = book.quote();
+    std::cout << "book, " << opts.orders << " orders, best of " << opts.rounds << ":" << std::endl
+              << "  no readers:  " << alone << " ns/order" << std::endl
+              << "  " << opts.readers << " readers:   " << read << " ns/order (" << (read - alone >= 0 ? "+" : "")
+              << read - alone << ")" << std::endl
+              << "readers: " << stats.reads << " snapshots, " << stats.retries << " retries, "
+              << stats.invalid << " invalid" << std::endl
+              << "quotes published: " << last.version << std::endl;
+    return stats.invalid == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file ValidationBench.cpp
+ * @brief Cost of the validation chain per order: the virtual OrderValidator chain, the statically
+ * composed StandardValidator, and StandardValidator::CheckBatch() over structure-of-arrays columns.
+ *
+ * Orders are a mix of limit, market, stop and stop-limit orders with a quarter of them invalid.
+ *
+ * Usage: OrderMatchingEngineValidationBench [--orders 1000000] [--rounds 20]
+ */
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../OrderBook/Order/StaticValidator.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t orders{1'000'000};
+        size_t rounds{20};
+    };
+
+    /** @brief Keeps a result alive so the measured loop is not optimized away. */
+    template <typename T>
+    void keep(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    double nsPerOrder(const std::chrono::steady_clock::time_point start, const size_t orders)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+            / static_cast<double>(orders);
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--orders") opts.orders = std::stoul(value);
+        else if (arg == "--rounds") opts.rounds = std::stoul(value);
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<OrderPtr> orders;
+    OrderBatch batch;
+    orders.reserve(opts.orders);
+    batch.reserve(opts.orders);
+    for (size_t i = 0; i < opts.orders; i++)
+    {
+        const Quantity qty = (i % 8 == 3) ? 0 : 10;
+        const Price price = (i % 8 == 5) ? 0 : 10000;
+        const Price stop = (i % 8 == 6) ? 0 : 9000;
+        OrderPtr o;
+        switch (i % 4)
+        {
+            case 0: o = Order::MakeLimit(i, Side::BUY, qty, "BENCH", price, NoOpValidator{}); break;
+            case 1: o = Order::MakeMarket(i, Side::SELL, qty, "BENCH", NoOpValidator{}); break;
+            case 2: o = Order::MakeStop(i, Side::BUY, qty, "BENCH", stop, NoOpValidator{}); break;
+            default: o = Order::MakeStopLimit(i, Side::SELL, qty, "BENCH", price, stop, NoOpValidator{}); break;
+        }
+        batch.push(o->qty(), o->price(), o->stopPrice(), o->type());
+        orders.push_back(std::move(o));
+    }
+
+    OrderValidator chain;
+    chain.add(std::make_unique<QuantityValidator>());
+    chain.add(std::make_unique<LimitPriceRequiredValidator>());
+    chain.add(std::make_unique<StopPriceRequiredValidator>());
+    const StandardValidator standard;
+    const IValidator& dynamicChain = chain;
+    const IValidator& staticChain = standard;
+    const size_t total = opts.orders * opts.rounds;
+
+    size_t rejected = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < opts.rounds; r++)
+    {
+        for (const auto& o : orders)
+        {
+            std::string reason;
+            rejected += !dynamicChain.validate(*o, reason);
+        }
+    }
+    keep(rejected);
+    const double chainValidate = nsPerOrder(start, total);
+    const size_t expected = rejected / opts.rounds;
+
+    rejected = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < opts.rounds; r++)
+    {
+        for (const auto& o : orders)
+        {
+            rejected += dynamicChain.check(*o) != RejectReason::NONE;
+        }
+    }
+    keep(rejected);
+    const double chainCheck = nsPerOrder(start, total);
+
+    rejected = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < opts.rounds; r++)
+    {
+        for (const auto& o : orders)
+        {
+            rejected += staticChain.check(*o) != RejectReason::NONE;
+        }
+    }
+    keep(rejected);
+    const double staticCheck = nsPerOrder(start, total);
+
+    std::vector<RejectReason> codes(opts.orders);
+    rejected = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t r = 0; r < opts.rounds; r++)
+    {
+        rejected += StandardValidator::CheckBatch(batch, codes.data());
+        keep(codes);
+    }
+    const double batchCheck = nsPerOrder(start, total);
+
+    std::cout << opts.orders << " orders x " << opts.rounds << " rounds, " << expected << " invalid per round"
+              << std::endl
+              << "  OrderValidator::validate     " << chainValidate << " ns/order" << std::endl
+              << "  OrderValidator::check        " << chainCheck << " ns/order" << std::endl
+              << "  StandardValidator::check     " << staticCheck << " ns/order" << std::endl
+              << "  StandardValidator::CheckBatch " << batchCheck << " ns/order" << std::endl;
+
+    if (rejected / opts.rounds != expected)
+    {
+        std::cerr << "batch found " << rejected / opts.rounds << " invalid orders, expected " << expected << std::endl;
+        return 1;
+    }
+    return 0;
+}
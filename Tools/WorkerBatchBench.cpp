@@ -0,0 +1,148 @@
+//
+// Created by Vaasu Bisht on 19/10/26.
+//
+
+/**
+ * @file WorkerBatchBench.cpp
+ * @brief Worker throughput under saturation for each batch size: one task per lock (batch 1, run())
+ * against drain-all batches (runBatched()).
+ *
+ * Two loads per batch size, both through Scheduler::submitTo() on one worker:
+ * - prefilled: `--tasks` tasks are queued before the worker starts, the pure dequeue cost;
+ * - live: `--producers` threads submit `--tasks` tasks between them while the worker runs, so the
+ *   worker and the producers fight over the queue lock.
+ * Every task does `--work-ns` of busy work (0 = none). Throughput is tasks from start until drain()
+ * returns.
+ *
+ * Usage: OrderMatchingEngineWorkerBatchBench [--tasks 2000000] [--producers 2] [--work-ns 0]
+ *                                            [--batches 1,16,64,1024]
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Metrics/LatencyHistogram.h"
+#include "../Scheduler/Scheduler.h"
+
+namespace
+{
+    struct Options
+    {
+        size_t tasks{2'000'000};
+        size_t producers{2};
+        uint64_t workNs{0};
+        std::vector<size_t> batches{1, 16, 64, 1024};
+    };
+
+    const std::string WORKER = "bench_0";
+
+    TaskFn makeWork(const uint64_t workNs, std::atomic<uint64_t>& ran)
+    {
+        return [workNs, &ran](const CancelToken&)
+        {
+            if (workNs > 0)
+            {
+                const uint64_t until = LatencyHistogram::nowNs() + workNs;
+                while (LatencyHistogram::nowNs() < until) {}
+            }
+            ran.store(ran.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); // worker thread only
+        };
+    }
+
+    /** @brief Queues every task, then starts the worker; returns M tasks/s. */
+    double prefilled(const Options& opts, const size_t batch)
+    {
+        std::atomic<uint64_t> ran{0};
+        Scheduler scheduler;
+        scheduler.createWorker(WORKER, batch);
+        const TaskFn work = makeWork(opts.workNs, ran);
+        for (size_t i = 0; i < opts.tasks; i++)
+        {
+            scheduler.submitTo(WORKER, work);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        scheduler.start();
+        scheduler.drain();
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        scheduler.shutdown();
+        return static_cast<double>(ran.load()) / secs / 1e6;
+    }
+
+    /** @brief Producers submit while the worker runs; returns M tasks/s. */
+    double live(const Options& opts, const size_t batch)
+    {
+        std::atomic<uint64_t> ran{0};
+        Scheduler scheduler;
+        scheduler.createWorker(WORKER, batch);
+        scheduler.start();
+        const TaskFn work = makeWork(opts.workNs, ran);
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < opts.producers; p++)
+        {
+            const size_t count = opts.tasks / opts.producers + (p < opts.tasks % opts.producers ? 1 : 0);
+            producers.emplace_back([&scheduler, &work, count]
+            {
+                for (size_t i = 0; i < count; i++)
+                {
+                    scheduler.submitTo(WORKER, work);
+                }
+            });
+        }
+        for (auto& t : producers)
+        {
+            t.join();
+        }
+        scheduler.drain();
+        const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        scheduler.shutdown();
+        return static_cast<double>(ran.load()) / secs / 1e6;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    Options opts;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        const std::string arg = argv[i];
+        const std::string value = argv[i + 1];
+        if (arg == "--tasks") opts.tasks = std::stoul(value);
+        else if (arg == "--producers") opts.producers = std::max<size_t>(1, std::stoul(value));
+        else if (arg == "--work-ns") opts.workNs = std::stoull(value);
+        else if (arg == "--batches")
+        {
+            opts.batches.clear();
+            std::stringstream ss(value);
+            for (std::string b; std::getline(ss, b, ',');)
+            {
+                opts.batches.push_back(std::max<size_t>(1, std::stoul(b)));
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << opts.tasks << " tasks, " << opts.workNs << " ns of work each, " << opts.producers
+              << " live producer(s)" << std::endl;
+    double base[2] = {0, 0};
+    for (const size_t batch : opts.batches)
+    {
+        const double pre = prefilled(opts, batch);
+        const double run = live(opts, batch);
+        base[0] = base[0] > 0 ? base[0] : pre;
+        base[1] = base[1] > 0 ? base[1] : run;
+        std::cout << "  batch " << batch << ": prefilled " << pre << " M tasks/s (" << pre / base[0] << "x), live "
+                  << run << " M tasks/s (" << run / base[1] << "x)" << std::endl;
+    }
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <csignal>
 #include "Application.h"
 #include "Config/ConfigReader.h"
+#include "OrderBook/Order/StaticValidator.h"
 
 std::unique_ptr<Application> gApp; // Global instance of application
 
@@ -15,13 +16,81 @@ void signalHandler(const int signum)
     exit(signum);
 }
 
-int main()
+/**
+ * @brief Command line: `OrderMatchingEngine [--replay <file> [--pace max|original] [--speed <x>]]`
+ * or `OrderMatchingEngine --backtest <file>`. Without either the built-in simulation runs and the
+ * engine waits for 'q'. A backtest runs the books single-threaded (Scheduler::Execution::INLINE).
+ */
+struct CliOptions
 {
-    // Constructing validation chain
-    const auto chain = std::make_shared<OrderValidator>();
-    chain->add(std::make_unique<QuantityValidator>());
-    chain->add(std::make_unique<LimitPriceRequiredValidator>());
-    chain->add(std::make_unique<StopPriceRequiredValidator>());
+    std::string replayPath;
+    std::string backtestPath;
+    ReplaySource::Pacing pacing{ReplaySource::Pacing::MAX_SPEED};
+    double speed{1.0};
+};
+
+bool parseArgs(const int argc, char** argv, CliOptions& opts)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--replay")
+        {
+            opts.replayPath = value;
+        }
+        else if (arg == "--backtest")
+        {
+            opts.backtestPath = value;
+        }
+        else if (arg == "--pace" && (value == "max" || value == "original"))
+        {
+            opts.pacing = value == "max" ? ReplaySource::Pacing::MAX_SPEED : ReplaySource::Pacing::ORIGINAL;
+        }
+        else if (arg == "--speed")
+        {
+            opts.speed = std::stod(value);
+        }
+        else
+        {
+            std::cerr << "Unknown option " << arg << " " << value << std::endl;
+            return false;
+        }
+    }
+    if (!opts.replayPath.empty() && !opts.backtestPath.empty())
+    {
+        std::cerr << "--replay and --backtest are exclusive" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(const int argc, char** argv)
+{
+    CliOptions opts;
+    try
+    {
+        if (!parseArgs(argc, argv, opts))
+        {
+            std::cerr << "Usage: " << argv[0] << " [--replay <file> [--pace max|original] [--speed <x>]]"
+                      << " | --backtest <file>" << std::endl;
+            return 1;
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Invalid option value: " << e.what() << std::endl;
+        return 1;
+    }
+
+    // Constructing validation chain: built-in rules composed at compile time. Custom IValidator rules
+    // go into an OrderValidator next to it.
+    const auto chain = std::make_shared<StandardValidator>();
     // Setting default configuration
     Order::SetDefaultValidator(chain);
 
@@ -42,7 +111,8 @@ int main()
     }
 
     // Instantiate the Application
-    gApp = std::make_unique<Application>(config);
+    gApp = std::make_unique<Application>(config, opts.backtestPath.empty() ? Scheduler::Execution::THREADED
+                                                                         : Scheduler::Execution::INLINE);
 
     // Start the Application
     try
@@ -55,6 +125,40 @@ int main()
         return 1;
     }
 
+    // Replay a recorded file and exit once it has been fully applied
+    if (!opts.replayPath.empty())
+    {
+        int rc = 0;
+        try
+        {
+            gApp->replay(opts.replayPath, opts.pacing, opts.speed);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Replay failed: " << e.what() << std::endl;
+            rc = 1;
+        }
+        gApp->shutdown();
+        return rc;
+    }
+
+    // Run a recorded file through the books on this thread and exit
+    if (!opts.backtestPath.empty())
+    {
+        int rc = 0;
+        try
+        {
+            gApp->backtest(opts.backtestPath);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "Backtest failed: " << e.what() << std::endl;
+            rc = 1;
+        }
+        gApp->shutdown();
+        return rc;
+    }
+
     // Run the simulation
     gApp->simulate();
 
@@ -14,5 +14,5 @@ if [[ "$OS" == "Darwin" ]]; then
 else
   # assume Debian/Ubuntu
   sudo apt-get update
-  sudo apt-get install -y libtinyxml2-dev
+  sudo apt-get install -y libtinyxml2-dev libnuma-dev
 fi
\ No newline at end of file